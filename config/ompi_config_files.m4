@@ -56,5 +56,6 @@ AC_DEFUN([OMPI_CONFIG_FILES],[
         ompi/tools/wrappers/ompi-fort.pc
         ompi/tools/wrappers/mpijavac.pl
         ompi/tools/mpisync/Makefile
+        ompi/tools/ompi_coll_tuner/Makefile
     ])
 ])
@@ -121,6 +121,21 @@ int mca_coll_base_comm_select(struct ompi_communicator_t *comm);
  */
 int mca_coll_base_comm_unselect(struct ompi_communicator_t *comm);
 
+/**
+ * Notify the coll modules of a communicator of its topology.
+ *
+ * @param comm The communicator a graph or distributed graph topology
+ * was just attached to.
+ *
+ * @retval OMPI_SUCCESS, or the first error of the modules.
+ *
+ * This function is invoked by all the processes of the communicator,
+ * once its topology is set, since this happens after
+ * mca_coll_base_comm_select(). It invokes the coll_module_topo callback
+ * of each module of the neighborhood collectives, once per module.
+ */
+int mca_coll_base_comm_topo(struct ompi_communicator_t *comm);
+
 /*
  * Globals
  */
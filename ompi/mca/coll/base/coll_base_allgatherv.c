@@ -286,6 +286,468 @@ int ompi_coll_base_allgatherv_intra_ring(const void *sbuf, int scount,
     return err;
 }
 
+/*
+ * ompi_coll_base_allgatherv_intra_ring_segmented
+ *
+ * Function:     pipelined allgatherv using O(N) steps.
+ * Accepts:      Same arguments as MPI_Allgatherv, and the segment size
+ * Returns:      MPI_SUCCESS or error code
+ *
+ * Description:  Same steps as ompi_coll_base_allgatherv_intra_ring, but the
+ *               blocks are split in segments of (about) segsize bytes,
+ *               and each segment is forwarded to (r + 1) as soon as it
+ *               arrived from (r - 1), while the next segments are being
+ *               received, so that a large block goes through all the
+ *               ring at the same time instead of one step at a time.
+ *               The messages sent by (r - 1) are received in order: its
+ *               own block, then the blocks (r - 2) ... (r + 1) that it
+ *               forwards. Each block is made of at least one (possibly
+ *               empty) segment.
+ * Memory requirements:
+ *               No additional memory requirements.
+ *
+ */
+int ompi_coll_base_allgatherv_intra_ring_segmented(const void *sbuf, int scount,
+                                                   struct ompi_datatype_t *sdtype,
+                                                   void* rbuf, const int *rcounts, const int *rdisps,
+                                                   struct ompi_datatype_t *rdtype,
+                                                   struct ompi_communicator_t *comm,
+                                                   mca_coll_base_module_t *module,
+                                                   uint32_t segsize)
+{
+    int line = -1, rank, size, sendto, recvfrom, i, block, count, segcount, err = 0;
+    int sstep = 0, sseg = 0, pstep = 0, pseg = 0, rstep = 0, rseg = 0;
+    int nsent = 0, nposted = 0, nrecvd = 0;
+    size_t typelng;
+    ptrdiff_t rlb, rext;
+    char *tmpsend = NULL, *tmprecv = NULL;
+    /* the two receives in flight, then the two sends */
+    ompi_request_t *reqs[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                               MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allgatherv_intra_ring_segmented rank %d", rank));
+
+    err = ompi_datatype_get_extent (rdtype, &rlb, &rext);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* Initialization step:
+       - if send buffer is not MPI_IN_PLACE, copy send buffer to
+       the appropriate block of receive buffer
+    */
+    tmprecv = (char*) rbuf + (ptrdiff_t)rdisps[rank] * rext;
+    if (MPI_IN_PLACE != sbuf) {
+        tmpsend = (char*) sbuf;
+        err = ompi_datatype_sndrcv(tmpsend, scount, sdtype,
+                                   tmprecv, rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl;  }
+    }
+
+    /* Determine segment count based on the suggested segment size */
+    err = ompi_datatype_type_size(rdtype, &typelng);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    segcount = rcounts[0];
+    for (i = 1; i < size; i++) {
+        if (segcount < rcounts[i]) segcount = rcounts[i];
+    }
+    COLL_BASE_COMPUTED_SEGCOUNT(segsize, typelng, segcount)
+
+    /* Communication step:
+       The send step t sends the block of rank (r - t) and the receive step
+       t receives the block of rank (r - t - 1), for t = 0 .. P-2. The send
+       step t > 0 forwards the segments of the receive step (t - 1).
+       In the loop:
+       - keep two receives posted
+       - send the segments available, at most one ahead of the receives
+       (all of them once everything is received)
+       - wait for the next segment
+    */
+    sendto = (rank + 1) % size;
+    recvfrom  = (rank - 1 + size) % size;
+
+    while (true) {
+        while (pstep < size - 1 && nposted < nrecvd + 2) {
+            block = (rank - pstep - 1 + size) % size;
+            count = rcounts[block] - pseg * segcount;
+            if (count > segcount) count = segcount;
+            tmprecv = (char*)rbuf + ((ptrdiff_t)rdisps[block] + (ptrdiff_t)pseg * segcount) * rext;
+            err = MCA_PML_CALL(irecv(tmprecv, count, rdtype, recvfrom,
+                                     MCA_COLL_BASE_TAG_ALLGATHERV, comm,
+                                     &reqs[nposted & 0x1]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            if (++pseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+                pseg = 0;
+                pstep++;
+            }
+            nposted++;
+        }
+
+        while (sstep < size - 1 && (nsent <= nrecvd + 1 || rstep == size - 1) &&
+               (0 == sstep || sstep - 1 < rstep || sseg < rseg)) {
+            block = (rank - sstep + size) % size;
+            count = rcounts[block] - sseg * segcount;
+            if (count > segcount) count = segcount;
+            tmpsend = (char*)rbuf + ((ptrdiff_t)rdisps[block] + (ptrdiff_t)sseg * segcount) * rext;
+
+            /* Wait for the send before last to complete */
+            err = ompi_request_wait(&reqs[2 + (nsent & 0x1)], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(isend(tmpsend, count, rdtype, sendto,
+                                     MCA_COLL_BASE_TAG_ALLGATHERV,
+                                     MCA_PML_BASE_SEND_STANDARD, comm,
+                                     &reqs[2 + (nsent & 0x1)]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            if (++sseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+                sseg = 0;
+                sstep++;
+            }
+            nsent++;
+        }
+
+        if (rstep == size - 1) {
+            break;
+        }
+
+        /* Wait for the next segment */
+        err = ompi_request_wait(&reqs[nrecvd & 0x1], MPI_STATUS_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        block = (rank - rstep - 1 + size) % size;
+        if (++rseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+            rseg = 0;
+            rstep++;
+        }
+        nrecvd++;
+    }
+
+    err = ompi_request_wait_all(2, reqs + 2, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    return OMPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    (void)line;  // silence compiler warning
+    ompi_coll_base_free_reqs(reqs, 4);
+    return err;
+}
+
+typedef struct {
+    int count;
+    int rank;
+} allgatherv_knomial_block_t;
+
+/* larger blocks first, then by rank */
+static int allgatherv_knomial_block_cmp(const void *a, const void *b)
+{
+    const allgatherv_knomial_block_t *ba = (const allgatherv_knomial_block_t*)a;
+    const allgatherv_knomial_block_t *bb = (const allgatherv_knomial_block_t*)b;
+
+    if (ba->count != bb->count) {
+        return ba->count > bb->count ? -1 : 1;
+    }
+    return ba->rank < bb->rank ? -1 : (ba->rank > bb->rank);
+}
+
+/*
+ * Order the processes by decreasing contribution (all the processes know
+ * all the counts, so they all compute the same order). The algorithm runs
+ * on these virtual ranks: perm[v] is the rank of virtual rank v. With
+ * equal counts, perm is not needed (the identity) and *balanced is false.
+ */
+static int
+allgatherv_knomial_balance(const int *rcounts, int size, int *perm, bool *balanced)
+{
+    allgatherv_knomial_block_t *blocks;
+    int i;
+
+    *balanced = false;
+    for (i = 1; i < size && rcounts[i] == rcounts[0]; i++);
+    if (i == size) {
+        return MPI_SUCCESS;
+    }
+
+    blocks = (allgatherv_knomial_block_t*)malloc(size * sizeof(allgatherv_knomial_block_t));
+    if (NULL == blocks) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < size; i++) {
+        blocks[i].count = rcounts[i];
+        blocks[i].rank = i;
+    }
+    qsort(blocks, size, sizeof(allgatherv_knomial_block_t), allgatherv_knomial_block_cmp);
+    for (i = 0; i < size; i++) {
+        perm[i] = blocks[i].rank;
+    }
+    free(blocks);
+    *balanced = true;
+    return MPI_SUCCESS;
+}
+
+/*
+ * Describe the blocks of the virtual ranks (vrank - first - i * stride)
+ * for i = 0 .. nblocks-1 of rbuf as a single message: the block itself
+ * when only one of them is not empty, an indexed datatype otherwise
+ * (*created is then set and the caller has to destroy the datatype).
+ * *count is 0 when all the blocks are empty and no message has to be
+ * exchanged.
+ */
+static int
+allgatherv_knomial_blocks(void *rbuf, const int *rcounts, const int *rdispls,
+                          struct ompi_datatype_t *rdtype, ptrdiff_t rext,
+                          const int *perm, int vrank, int size,
+                          int first, int stride, int nblocks,
+                          int *bcounts, int *bdispls,
+                          char **buf, int *count,
+                          struct ompi_datatype_t **dtype, bool *created)
+{
+    int i, block, nonempty = 0, err;
+
+    *created = false;
+    *count = 0;
+    for (i = 0; i < nblocks; i++) {
+        block = (int)(((ptrdiff_t)vrank - first - (ptrdiff_t)i * stride) % size);
+        if (block < 0) block += size;
+        if (NULL != perm) block = perm[block];
+        if (0 == rcounts[block]) continue;
+        bcounts[nonempty] = rcounts[block];
+        bdispls[nonempty] = rdispls[block];
+        nonempty++;
+    }
+    if (0 == nonempty) {
+        return MPI_SUCCESS;
+    }
+    if (1 == nonempty) {
+        *buf = (char*)rbuf + (ptrdiff_t)bdispls[0] * rext;
+        *count = bcounts[0];
+        *dtype = rdtype;
+        return MPI_SUCCESS;
+    }
+    err = ompi_datatype_create_indexed(nonempty, bcounts, bdispls, rdtype, dtype);
+    if (MPI_SUCCESS != err) return err;
+    err = ompi_datatype_commit(dtype);
+    if (MPI_SUCCESS != err) {
+        ompi_datatype_destroy(dtype);
+        return err;
+    }
+    *created = true;
+    *buf = (char*)rbuf;
+    *count = 1;
+    return MPI_SUCCESS;
+}
+
+/*
+ * ompi_coll_base_allgatherv_intra_k_nomial
+ *
+ * Function:     allgatherv using O(log_k(N)) steps.
+ * Accepts:      Same arguments as MPI_Allgatherv, plus the radix k
+ * Returns:      MPI_SUCCESS or error code
+ *
+ * Description:  Distance-decreasing k-nomial dissemination, the
+ *               generalization of the Sparbit algorithm described by
+ *               Loch and Koslovski in "Sparbit: a new logarithmic-cost
+ *               and data locality-aware MPI Allgather algorithm" (2021).
+ *               The distance d starts at the largest power of k below N
+ *               and is divided by k at every step. During a step, rank r
+ *               sends all the blocks it holds, (r - i * k * d), to the
+ *               ranks (r + j * d), j = 1 .. k-1, and receives the blocks
+ *               (r - j * d - i * k * d) from the ranks (r - j * d).
+ *               Only the blocks within distance N - 1 of their owner
+ *               travel, so the processes never exchange a block twice,
+ *               for any N.
+ *               Unlike in bruck, the blocks are received directly in
+ *               their final location and the large contributions are not
+ *               delayed behind the neighbors on a ring: each block
+ *               reaches every process through a k-nomial tree rooted at
+ *               its owner, in log_k(N) steps. The blocks going to the
+ *               same peer are sent as one message through an indexed
+ *               datatype, and the empty contributions are not sent at
+ *               all, so skewed counts only cost the bytes actually
+ *               contributed.
+ *               At the step of distance d, each process sends the blocks
+ *               of its residue class modulo k * d. With unequal counts,
+ *               the algorithm runs on virtual ranks ordered by decreasing
+ *               contribution, so that the m largest blocks fall in
+ *               different classes for every m = k * d, and the bytes sent
+ *               by the processes at each step are balanced.
+ * Memory requirements:
+ *               The virtual ranks and the temporary datatypes.
+ *
+ * Example on 6 nodes, k = 2 (blocks held by each process):
+ *   Step 0 (d = 4): r sends [r] to r + 4 and receives [r - 4] from r - 4
+ *    #     0      1      2      3      4      5
+ *         [0]    [1]    [2]    [3]    [4]    [5]
+ *         [2]    [3]    [4]    [5]    [0]    [1]
+ *   Step 1 (d = 2): r sends [r] to r + 2 and receives [r - 2] from r - 2.
+ *           [r - 4] is not forwarded, (r - 4 - 2) is its own block.
+ *    #     0      1      2      3      4      5
+ *         [0]    [1]    [2]    [3]    [4]    [5]
+ *         [2]    [3]    [4]    [5]    [0]    [1]
+ *         [4]    [5]    [0]    [1]    [2]    [3]
+ *   Step 2 (d = 1): r sends its 3 blocks to r + 1 and receives the
+ *           3 others from r - 1.
+ */
+int ompi_coll_base_allgatherv_intra_k_nomial(const void *sbuf, int scount,
+                                             struct ompi_datatype_t *sdtype,
+                                             void *rbuf, const int *rcounts,
+                                             const int *rdispls,
+                                             struct ompi_datatype_t *rdtype,
+                                             struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module,
+                                             int radix)
+{
+    int line = -1, err = 0, rank, vrank, size, distance, j, nblocks, nreqs, ndtypes = 0;
+    int *bcounts = NULL, *bdispls = NULL, *perm = NULL, count, sendto, recvfrom;
+    ptrdiff_t rlb, rext;
+    char *tmpsend = NULL, *tmprecv = NULL;
+    struct ompi_datatype_t **dtypes = NULL, *dtype;
+    ompi_request_t **reqs = NULL;
+    bool created, balanced;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    if (radix < 2) radix = 2;
+    if (radix > size) radix = size;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allgatherv_intra_k_nomial rank %d radix %d", rank, radix));
+
+    err = ompi_datatype_get_extent (rdtype, &rlb, &rext);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* Initialization step:
+       - if send buffer is not MPI_IN_PLACE, copy send buffer to block rank of
+       the receive buffer.
+    */
+    tmprecv = (char*) rbuf + (ptrdiff_t)rdispls[rank] * rext;
+    if (MPI_IN_PLACE != sbuf) {
+        tmpsend = (char*) sbuf;
+        err = ompi_datatype_sndrcv(tmpsend, scount, sdtype,
+                                   tmprecv, rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    if (size < 2) {
+        return MPI_SUCCESS;
+    }
+
+    bcounts = (int*) malloc(3 * size * sizeof(int));
+    dtypes = (struct ompi_datatype_t **) malloc(2 * (radix - 1) * sizeof(struct ompi_datatype_t *));
+    if (NULL == bcounts || NULL == dtypes) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+    bdispls = bcounts + size;
+    perm = bdispls + size;
+    err = allgatherv_knomial_balance(rcounts, size, perm, &balanced);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    vrank = rank;
+    if (balanced) {
+        for (vrank = 0; perm[vrank] != rank; vrank++);
+    } else {
+        perm = NULL;
+    }
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, 2 * (radix - 1));
+    if (NULL == reqs) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+
+    for (distance = 1; distance < (size + radix - 1) / radix; distance *= radix);
+
+    /* Communication step:
+       At the step of distance d, the blocks held by virtual rank v are at
+       the distances (i * k * d) < N of v, and the peer (v + j * d) is
+       missing those at (i * k * d + j * d) < N.
+    */
+    for (; distance > 0; distance /= radix) {
+        nreqs = 0;
+        for (j = 1; j < radix && j * distance < size; j++) {
+            int stride = radix * distance;
+            nblocks = (size - j * distance + stride - 1) / stride;
+            sendto = (vrank + j * distance) % size;
+            recvfrom = (vrank - j * distance + size) % size;
+
+            err = allgatherv_knomial_blocks(rbuf, rcounts, rdispls, rdtype, rext,
+                                            perm, vrank, size, j * distance, stride, nblocks,
+                                            bcounts, bdispls, &tmprecv, &count,
+                                            &dtype, &created);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            if (created) dtypes[ndtypes++] = dtype;
+            if (0 != count) {
+                err = MCA_PML_CALL(irecv(tmprecv, count, dtype,
+                                         NULL != perm ? perm[recvfrom] : recvfrom,
+                                         MCA_COLL_BASE_TAG_ALLGATHERV, comm,
+                                         &reqs[nreqs++]));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            }
+
+            err = allgatherv_knomial_blocks(rbuf, rcounts, rdispls, rdtype, rext,
+                                            perm, sendto, size,
+                                            j * distance, stride, nblocks,
+                                            bcounts, bdispls, &tmpsend, &count,
+                                            &dtype, &created);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            if (created) dtypes[ndtypes++] = dtype;
+            if (0 != count) {
+                err = MCA_PML_CALL(isend(tmpsend, count, dtype,
+                                         NULL != perm ? perm[sendto] : sendto,
+                                         MCA_COLL_BASE_TAG_ALLGATHERV,
+                                         MCA_PML_BASE_SEND_STANDARD, comm,
+                                         &reqs[nreqs++]));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            }
+        }
+
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+        while (ndtypes > 0) {
+            ompi_datatype_destroy(&dtypes[--ndtypes]);
+        }
+    }
+
+    free(dtypes);
+    free(bcounts);
+
+    return OMPI_SUCCESS;
+
+ err_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, 2 * (radix - 1));
+    }
+    while (ndtypes > 0) {
+        ompi_datatype_destroy(&dtypes[--ndtypes]);
+    }
+    if (NULL != dtypes) free(dtypes);
+    if (NULL != bcounts) free(bcounts);
+    return err;
+}
+
+/*
+ * ompi_coll_base_allgatherv_intra_sparbit
+ *
+ * Function:     allgatherv using O(log(N)) steps.
+ * Accepts:      Same arguments as MPI_Allgatherv
+ * Returns:      MPI_SUCCESS or error code
+ *
+ * Description:  Sparbit: the binomial (k = 2) case of the k-nomial
+ *               algorithm above. The distance halves at every step and
+ *               each process talks to a single peer per step.
+ */
+int ompi_coll_base_allgatherv_intra_sparbit(const void *sbuf, int scount,
+                                            struct ompi_datatype_t *sdtype,
+                                            void *rbuf, const int *rcounts,
+                                            const int *rdispls,
+                                            struct ompi_datatype_t *rdtype,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    return ompi_coll_base_allgatherv_intra_k_nomial(sbuf, scount, sdtype,
+                                                    rbuf, rcounts, rdispls, rdtype,
+                                                    comm, module, 2);
+}
+
 /*
  * ompi_coll_base_allgatherv_intra_neighborexchange
  *
@@ -1243,3 +1243,236 @@ int ompi_coll_base_allreduce_intra_redscat_allgather(
 }
 
 /* copied function (with appropriate renaming) ends here */
+
+/*
+ * Split the communicator size into a sequence of radices, each not larger
+ * than max_radix (or than the prime factor it contains), whose product is
+ * exactly comm_size. The prime factors are packed greedily, largest first,
+ * into the radix with the most room left. Returns the number of radices, or
+ * -1 if a prime factor is too large to be exchanged in a single step.
+ */
+static int
+ompi_coll_base_allreduce_knomial_radices(int comm_size, int max_radix,
+                                         int *radices, int max_steps)
+{
+    int primes[32], nprimes = 0, nsteps = 0, n = comm_size, f, i, j, best;
+
+    for (f = 2; (f * f) <= n; f++) {
+        while (0 == (n % f)) {
+            primes[nprimes++] = f;
+            n /= f;
+        }
+    }
+    if (n > 1) primes[nprimes++] = n;
+    /* The factors are found in increasing order, pack from the largest */
+    for (i = nprimes - 1; i >= 0; i--) {
+        if (primes[i] > 4 * max_radix) return -1;
+        for (best = -1, j = 0; j < nsteps; j++) {
+            if ((radices[j] * primes[i]) <= max_radix &&
+                (-1 == best || radices[j] < radices[best])) {
+                best = j;
+            }
+        }
+        if (-1 != best) {
+            radices[best] *= primes[i];
+        } else {
+            if (nsteps == max_steps) return -1;
+            radices[nsteps++] = primes[i];
+        }
+    }
+    return nsteps;
+}
+
+/*
+ * ompi_coll_base_allreduce_intra_redscat_allgather_knomial
+ *
+ * Function:  Allreduce using a radix-k reduce-scatter followed by a radix-k
+ *            allgather.
+ * Accepts:   Same arguments as MPI_Allreduce, plus the radix
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description: a generalization of Rabenseifner's algorithm (see above) to
+ * exchanges among groups of k processes instead of pairs.
+ *
+ * The communicator size p is written as a product of radices
+ * p = k_0 * k_1 * ... * k_{s-1}, each one not larger than the requested
+ * radix (unless p has a larger prime factor). In step i of the reduce-scatter
+ * each process splits its current window of the vector in k_i blocks, sends
+ * block j to the j-th member of its group (the processes whose ranks only
+ * differ in the i-th digit of the mixed-radix representation of the rank),
+ * receives the copies of its own block from all the other members and
+ * reduces them. After s steps each process holds 1 / p of the total result.
+ * The allgather then executes the same exchanges in the reverse order, each
+ * process sending its reduced block to the members of its group.
+ *
+ * As p is factorized exactly there is no need to fold the extra processes
+ * like the power-of-two algorithm does: every process moves the same amount
+ * of data, 2 * (p - 1) / p * count elements, in 2 * s steps, with at most
+ * k - 1 concurrent messages per step.
+ *
+ * Limitations:
+ *   count >= p, otherwise recursive doubling is used
+ *   commutative operations only, otherwise recursive doubling is used
+ *   prime factors of p not larger than 4 * k, otherwise Rabenseifner's
+ *   algorithm is used
+ *   intra-communicators only
+ *
+ * Memory requirements (per process):
+ *   (count + k) * typesize = O(count)
+ */
+int ompi_coll_base_allreduce_intra_redscat_allgather_knomial(
+    const void *sbuf, void *rbuf, int count, struct ompi_datatype_t *dtype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module, int radix)
+{
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    int radices[32], wstart[32], wcount[32], digit[32], distance[32];
+    int nsteps, max_radix = 0, nreqs, step, j, k, err = MPI_SUCCESS;
+    ompi_request_t **reqs = NULL;
+    char *tmp_buf = NULL, *tmp_buf_raw = NULL;
+    ptrdiff_t lb, extent, dsize, gap = 0;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_redscat_allgather_knomial: rank %d/%d radix %d",
+                 rank, comm_size, radix));
+
+    if (1 == comm_size) {
+        if (MPI_IN_PLACE != sbuf) {
+            return ompi_datatype_copy_content_same_ddt(dtype, count, (char *)rbuf,
+                                                       (char *)sbuf);
+        }
+        return MPI_SUCCESS;
+    }
+
+    if (count < comm_size || !ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_redscat_allgather_knomial: rank %d/%d "
+                     "count %d switching to recursive doubling allreduce",
+                     rank, comm_size, count));
+        return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                                op, comm, module);
+    }
+
+    if (radix < 2) radix = 2;
+    nsteps = ompi_coll_base_allreduce_knomial_radices(comm_size, radix, radices, 32);
+    if (nsteps < 0) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_redscat_allgather_knomial: rank %d/%d "
+                     "switching to Rabenseifner allreduce",
+                     rank, comm_size));
+        return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype,
+                                                                op, comm, module);
+    }
+    for (step = 0; step < nsteps; step++) {
+        if (radices[step] > max_radix) max_radix = radices[step];
+    }
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    /* Room for the k - 1 blocks received during the first step, each of at
+     * most \ceil{count / k} elements */
+    dsize = opal_datatype_span(&dtype->super, count + max_radix, &gap);
+    tmp_buf_raw = (char *)malloc(dsize);
+    if (NULL == tmp_buf_raw) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    tmp_buf = tmp_buf_raw - gap;
+
+    nreqs = 2 * (max_radix - 1);
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, nreqs);
+    if (NULL == reqs) { err = OMPI_ERR_OUT_OF_RESOURCE; goto cleanup_and_return; }
+
+    if (MPI_IN_PLACE != sbuf) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, count, (char *)rbuf,
+                                                  (char *)sbuf);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+/* Block j of the window of step s: first element and number of elements */
+#define KNOMIAL_BLOCK_COUNT(s, j)                                       \
+    (wcount[s] / radices[s] + (((j) < wcount[s] % radices[s]) ? 1 : 0))
+#define KNOMIAL_BLOCK_START(s, j)                                       \
+    (wstart[s] + (j) * (wcount[s] / radices[s]) +                       \
+     (((j) < wcount[s] % radices[s]) ? (j) : wcount[s] % radices[s]))
+
+    /*
+     * Reduce-scatter: the window of each step is the block kept by this
+     * process during the previous step.
+     */
+    wstart[0] = 0;
+    wcount[0] = count;
+    for (step = 0; step < nsteps; step++) {
+        int r = radices[step], maxblock = (wcount[step] + r - 1) / r;
+        int rcount;
+
+        distance[step] = (0 == step) ? 1 : distance[step - 1] * radices[step - 1];
+        digit[step] = (rank / distance[step]) % r;
+        rcount = KNOMIAL_BLOCK_COUNT(step, digit[step]);
+
+        for (nreqs = 0, k = 0, j = 0; j < r; j++) {
+            int peer = rank + (j - digit[step]) * distance[step];
+            if (j == digit[step]) continue;
+            err = MCA_PML_CALL(irecv(tmp_buf + (ptrdiff_t)k * maxblock * extent,
+                                     rcount, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            err = MCA_PML_CALL(isend((char *)rbuf + (ptrdiff_t)KNOMIAL_BLOCK_START(step, j) * extent,
+                                     KNOMIAL_BLOCK_COUNT(step, j), dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            k++;
+        }
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+
+        /* Local reduce: rbuf[block] = tmp_buf[k] <op> rbuf[block] */
+        for (k = 0; k < r - 1; k++) {
+            ompi_op_reduce(op, tmp_buf + (ptrdiff_t)k * maxblock * extent,
+                           (char *)rbuf + (ptrdiff_t)KNOMIAL_BLOCK_START(step, digit[step]) * extent,
+                           rcount, dtype);
+        }
+
+        if (step + 1 < nsteps) {
+            wstart[step + 1] = KNOMIAL_BLOCK_START(step, digit[step]);
+            wcount[step + 1] = rcount;
+        }
+    }
+
+    /*
+     * Allgather: the same exchanges in the reverse order, each process
+     * sending the reduced block it owns and receiving the other blocks
+     * of the window in place.
+     */
+    for (step = nsteps - 1; step >= 0; step--) {
+        int r = radices[step];
+
+        for (nreqs = 0, j = 0; j < r; j++) {
+            int peer = rank + (j - digit[step]) * distance[step];
+            if (j == digit[step]) continue;
+            err = MCA_PML_CALL(irecv((char *)rbuf + (ptrdiff_t)KNOMIAL_BLOCK_START(step, j) * extent,
+                                     KNOMIAL_BLOCK_COUNT(step, j), dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            err = MCA_PML_CALL(isend((char *)rbuf + (ptrdiff_t)KNOMIAL_BLOCK_START(step, digit[step]) * extent,
+                                     KNOMIAL_BLOCK_COUNT(step, digit[step]), dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+    nreqs = 0;
+
+#undef KNOMIAL_BLOCK_COUNT
+#undef KNOMIAL_BLOCK_START
+
+  cleanup_and_return:
+    if (MPI_SUCCESS != err && NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, nreqs);
+    }
+    if (NULL != tmp_buf_raw)
+        free(tmp_buf_raw);
+    return err;
+}
@@ -34,6 +34,8 @@
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/op/op.h"
+#include "opal/datatype/opal_convertor.h"
 #include "coll_base_topo.h"
 #include "coll_base_util.h"
 
@@ -290,3 +292,465 @@ ompi_coll_base_alltoallv_intra_basic_linear(const void *sbuf, const int *scounts
 
     return err;
 }
+
+/*
+ * alltoallv_intra_sparse
+ *
+ * Function:       Linear implementation of alltoallv skipping the peers
+ *                 exchanging no data.
+ * Accepts:        Same as MPI_Alltoallv()
+ * Returns:        MPI_SUCCESS or error code
+ *
+ * Description:    As in MPI_Alltoallv the type signature sent by a process
+ *                 to a peer always matches the one the peer expects from
+ *                 it, both sides know which exchanges are empty. They are
+ *                 found from the number of bytes rather than the count, as
+ *                 a non-zero count of an empty datatype matches a zero
+ *                 count on the other side. Only the non-empty
+ *                 receives and sends are posted, all at once, and completed
+ *                 with a single wait: there is no synchronization with the
+ *                 peers we do not exchange data with, and the number of
+ *                 requests is proportional to the number of actual
+ *                 neighbors instead of the size of the communicator.
+ */
+int
+ompi_coll_base_alltoallv_intra_sparse(const void *sbuf, const int *scounts, const int *sdisps,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, const int *rcounts, const int *rdisps,
+                                      struct ompi_datatype_t *rdtype,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    int i, peer, size, rank, err = MPI_SUCCESS, nreqs = 0, nneighbors = 0;
+    ptrdiff_t sext, rext;
+    size_t sdsize, rdsize;
+    ompi_request_t **reqs = NULL;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace (rbuf, rcounts, rdisps,
+                                                             rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_sparse rank %d", rank));
+
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+    ompi_datatype_type_size(sdtype, &sdsize);
+    ompi_datatype_type_size(rdtype, &rdsize);
+
+    if (0 != scounts[rank]) {
+        err = ompi_datatype_sndrcv((char *) sbuf + (ptrdiff_t)sdisps[rank] * sext,
+                                   scounts[rank], sdtype,
+                                   (char *) rbuf + (ptrdiff_t)rdisps[rank] * rext,
+                                   rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    for (i = 0; i < size; ++i) {
+        if (i == rank) continue;
+        if (0 != rcounts[i] * rdsize) nneighbors++;
+        if (0 != scounts[i] * sdsize) nneighbors++;
+    }
+    if (0 == nneighbors) {
+        return MPI_SUCCESS;
+    }
+
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, nneighbors);
+    if (NULL == reqs) { return OMPI_ERR_OUT_OF_RESOURCE; }
+
+    /* Post the receives first, then the sends, both starting with the next
+     * peer to spread the load */
+    for (i = 1; i < size; ++i) {
+        peer = (rank + i) % size;
+        if (0 == rcounts[peer] * rdsize) continue;
+        err = MCA_PML_CALL(irecv((char *) rbuf + (ptrdiff_t)rdisps[peer] * rext,
+                                 rcounts[peer], rdtype, peer,
+                                 MCA_COLL_BASE_TAG_ALLTOALLV, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { goto err_hndl; }
+    }
+    for (i = 1; i < size; ++i) {
+        peer = (rank + size - i) % size;
+        if (0 == scounts[peer] * sdsize) continue;
+        err = MCA_PML_CALL(isend((char *) sbuf + (ptrdiff_t)sdisps[peer] * sext,
+                                 scounts[peer], sdtype, peer,
+                                 MCA_COLL_BASE_TAG_ALLTOALLV,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { goto err_hndl; }
+    }
+
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS == err) {
+        return MPI_SUCCESS;
+    }
+
+ err_hndl:
+    /* find a real error code */
+    if (MPI_ERR_IN_STATUS == err) {
+        for( i = 0; i < nreqs; i++ ) {
+            if (MPI_REQUEST_NULL == reqs[i]) continue;
+            if (MPI_ERR_PENDING == reqs[i]->req_status.MPI_ERROR) continue;
+            err = reqs[i]->req_status.MPI_ERROR;
+            break;
+        }
+    }
+    ompi_coll_base_free_reqs(reqs, nreqs);
+    return err;
+}
+
+/*
+ * Post the receive from the next peer, in increasing order of ranks, which
+ * sends us some data. *peer is the last peer considered and *left the number
+ * of peers not considered yet. The request is set to MPI_REQUEST_NULL when
+ * there is no receive left.
+ */
+static inline int
+alltoallv_irecv_next(void *rbuf, const int *rcounts, const int *rdisps,
+                     struct ompi_datatype_t *rdtype, ptrdiff_t rext, size_t rdsize,
+                     struct ompi_communicator_t *comm,
+                     int *peer, int *left, ompi_request_t **req)
+{
+    int size = ompi_comm_size(comm);
+
+    while (*left > 0) {
+        *peer = (*peer + 1) % size;
+        (*left)--;
+        if (0 == rcounts[*peer] * rdsize) continue;
+        return MCA_PML_CALL(irecv((char *) rbuf + (ptrdiff_t)rdisps[*peer] * rext,
+                                  rcounts[*peer], rdtype, *peer,
+                                  MCA_COLL_BASE_TAG_ALLTOALLV, comm, req));
+    }
+    *req = MPI_REQUEST_NULL;
+    return MPI_SUCCESS;
+}
+
+/*
+ * Same as above for the sends, in decreasing order of ranks.
+ */
+static inline int
+alltoallv_isend_next(const void *sbuf, const int *scounts, const int *sdisps,
+                     struct ompi_datatype_t *sdtype, ptrdiff_t sext, size_t sdsize,
+                     struct ompi_communicator_t *comm,
+                     int *peer, int *left, ompi_request_t **req)
+{
+    int size = ompi_comm_size(comm);
+
+    while (*left > 0) {
+        *peer = (*peer + size - 1) % size;
+        (*left)--;
+        if (0 == scounts[*peer] * sdsize) continue;
+        return MCA_PML_CALL(isend((char *) sbuf + (ptrdiff_t)sdisps[*peer] * sext,
+                                  scounts[*peer], sdtype, *peer,
+                                  MCA_COLL_BASE_TAG_ALLTOALLV,
+                                  MCA_PML_BASE_SEND_STANDARD, comm, req));
+    }
+    *req = MPI_REQUEST_NULL;
+    return MPI_SUCCESS;
+}
+
+/*
+ * alltoallv_intra_linear_sync
+ *
+ * Function:       Linear implementation of alltoallv with limited number
+ *                 of outstanding requests.
+ * Accepts:        Same as MPI_Alltoallv(), and the maximum number of
+ *                 outstanding requests (actual number is 2 * max, since
+ *                 we count receive and send requests separately).
+ * Returns:        MPI_SUCCESS or error code
+ *
+ * Description:    Same as the alltoall linear_sync algorithm, skipping the
+ *                 peers exchanging no data like the sparse algorithm:
+ *                 1) post K irecvs, K <= N
+ *                 2) post K isends, K <= N
+ *                 3) while not done
+ *                    - wait for any request to complete
+ *                    - replace that request by the new one of the same type.
+ */
+int
+ompi_coll_base_alltoallv_intra_linear_sync(const void *sbuf, const int *scounts, const int *sdisps,
+                                           struct ompi_datatype_t *sdtype,
+                                           void *rbuf, const int *rcounts, const int *rdisps,
+                                           struct ompi_datatype_t *rdtype,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module,
+                                           int max_outstanding_reqs)
+{
+    int i, line = -1, err = MPI_SUCCESS, size, rank, nwin, nreqs = 0, completed;
+    int ri, si, rleft, sleft;
+    ptrdiff_t sext, rext;
+    size_t sdsize, rdsize;
+    ompi_request_t **reqs = NULL;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace (rbuf, rcounts, rdisps,
+                                                             rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_linear_sync rank %d", rank));
+
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+    ompi_datatype_type_size(sdtype, &sdsize);
+    ompi_datatype_type_size(rdtype, &rdsize);
+
+    if (0 != scounts[rank]) {
+        err = ompi_datatype_sndrcv((char *) sbuf + (ptrdiff_t)sdisps[rank] * sext,
+                                   scounts[rank], sdtype,
+                                   (char *) rbuf + (ptrdiff_t)rdisps[rank] * rext,
+                                   rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* If only one process, we're done. */
+    if (1 == size) {
+        return MPI_SUCCESS;
+    }
+
+    nwin = (((max_outstanding_reqs > (size - 1)) ||
+             (max_outstanding_reqs <= 0)) ?
+            (size - 1) : (max_outstanding_reqs));
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, 2 * nwin);
+    if (NULL == reqs) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+
+    /* The receive requests are in reqs[0, nwin), the send ones
+     * in reqs[nwin, 2 * nwin) */
+    ri = si = rank;
+    rleft = sleft = size - 1;
+    for (nreqs = 0; nreqs < nwin; nreqs++) {
+        err = alltoallv_irecv_next(rbuf, rcounts, rdisps, rdtype, rext, rdsize, comm,
+                                   &ri, &rleft, &reqs[nreqs]);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    for (; nreqs < 2 * nwin; nreqs++) {
+        err = alltoallv_isend_next(sbuf, scounts, sdisps, sdtype, sext, sdsize, comm,
+                                   &si, &sleft, &reqs[nreqs]);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    if (nwin == size - 1) {
+        /* All requests have been posted */
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        return MPI_SUCCESS;
+    }
+
+    /* As requests complete, replace them with the next request of the same
+     * type, until all of them are inactive */
+    while (1) {
+        err = ompi_request_wait_any(nreqs, reqs, &completed, MPI_STATUS_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        if (MPI_UNDEFINED == completed) break;
+        if (completed < nwin) {
+            err = alltoallv_irecv_next(rbuf, rcounts, rdisps, rdtype, rext, rdsize, comm,
+                                       &ri, &rleft, &reqs[completed]);
+        } else {
+            err = alltoallv_isend_next(sbuf, scounts, sdisps, sdtype, sext, sdsize, comm,
+                                       &si, &sleft, &reqs[completed]);
+        }
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    return MPI_SUCCESS;
+
+ err_hndl:
+    /* find a real error code */
+    if (MPI_ERR_IN_STATUS == err) {
+        for( i = 0; i < nreqs; i++ ) {
+            if (MPI_REQUEST_NULL == reqs[i]) continue;
+            if (MPI_ERR_PENDING == reqs[i]->req_status.MPI_ERROR) continue;
+            err = reqs[i]->req_status.MPI_ERROR;
+            break;
+        }
+    }
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "%s:%4d\tError occurred %d, rank %2d", __FILE__, line, err,
+                 rank));
+    (void)line;  // silence compiler warning
+    ompi_coll_base_free_reqs(reqs, nreqs);
+    return err;
+}
+
+/*
+ * alltoallv_intra_bruck
+ *
+ * Function:       Bruck's algorithm for alltoallv.
+ * Accepts:        Same as MPI_Alltoallv()
+ * Returns:        MPI_SUCCESS or error code
+ *
+ * Description:    The alltoall Bruck algorithm exchanges \ceil{\log_2 p}
+ *                 messages per process instead of p - 1, which pays off
+ *                 when the blocks are only a few bytes. With alltoallv the
+ *                 processes do not know the size of the blocks they forward
+ *                 on behalf of others, so each block is packed in a
+ *                 temporary buffer behind a header holding its size, and
+ *                 the buffer is sized after the largest block of the
+ *                 communicator (found with an allreduce). The messages
+ *                 only carry the actual content of the blocks.
+ *
+ * Memory requirements (per process):
+ *   2 * p * (largest block + sizeof(int))
+ */
+int
+ompi_coll_base_alltoallv_intra_bruck(const void *sbuf, const int *scounts, const int *sdisps,
+                                     struct ompi_datatype_t *sdtype,
+                                     void *rbuf, const int *rcounts, const int *rdisps,
+                                     struct ompi_datatype_t *rdtype,
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module)
+{
+    int i, line = -1, err = MPI_SUCCESS, size, rank, distance, sendto, recvfrom;
+    int nblocks, blen;
+    ptrdiff_t sext, rext;
+    size_t sdsize, blk, pos, max_data;
+    long maxbytes = 0;
+    char *tmpbuf = NULL, *packbuf = NULL;
+    opal_convertor_t convertor;
+    struct iovec iov;
+    uint32_t iov_count;
+
+    if (MPI_IN_PLACE == sbuf) {
+        return mca_coll_base_alltoallv_intra_basic_inplace (rbuf, rcounts, rdisps,
+                                                             rdtype, comm, module);
+    }
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:alltoallv_intra_bruck rank %d", rank));
+
+    ompi_datatype_type_extent(sdtype, &sext);
+    ompi_datatype_type_extent(rdtype, &rext);
+    ompi_datatype_type_size(sdtype, &sdsize);
+
+    if (0 != scounts[rank]) {
+        err = ompi_datatype_sndrcv((char *) sbuf + (ptrdiff_t)sdisps[rank] * sext,
+                                   scounts[rank], sdtype,
+                                   (char *) rbuf + (ptrdiff_t)rdisps[rank] * rext,
+                                   rcounts[rank], rdtype);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* If only one process, we're done. */
+    if (1 == size) {
+        return MPI_SUCCESS;
+    }
+
+    /* Size of the largest block of the communicator */
+    for (i = 0; i < size; ++i) {
+        if ((i != rank) && ((long)sdsize * scounts[i] > maxbytes)) {
+            maxbytes = (long)sdsize * scounts[i];
+        }
+    }
+    err = ompi_coll_base_allreduce_intra_recursivedoubling(MPI_IN_PLACE, &maxbytes, 1,
+                                                           MPI_LONG, MPI_MAX, comm, module);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    /* Block i of tmpbuf holds the data going i ranks further */
+    blk = sizeof(int) + (size_t)maxbytes;
+    tmpbuf = (char *) malloc((size_t)size * blk);
+    packbuf = (char *) malloc((size_t)(2 * ((size + 1) / 2)) * blk);
+    if (NULL == tmpbuf || NULL == packbuf) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+    }
+
+    /* Step 1 - local rotation and packing of the blocks */
+    for (i = 1; i < size; ++i) {
+        sendto = (rank + i) % size;
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor, &sdtype->super,
+                                                 scounts[sendto],
+                                                 (char *) sbuf + (ptrdiff_t)sdisps[sendto] * sext,
+                                                 0, &convertor);
+        iov.iov_base = tmpbuf + i * blk + sizeof(int);
+        iov.iov_len = max_data = (size_t)maxbytes;
+        iov_count = 1;
+        err = opal_convertor_pack(&convertor, &iov, &iov_count, &max_data);
+        OBJ_DESTRUCT(&convertor);
+        /* the block fits by construction: anything but a complete pack is
+         * an error */
+        if (1 != err) {
+            err = (err < 0) ? err : OMPI_ERROR; line = __LINE__; goto err_hndl;
+        }
+        blen = (int)max_data;
+        memcpy(tmpbuf + i * blk, &blen, sizeof(int));
+    }
+
+    /* Step 2 - send the blocks whose index has the bit of the distance set
+     * to the process that far after us, and receive the same blocks from
+     * the process that far before us */
+    for (distance = 1; distance < size; distance <<= 1) {
+        char *recvpack = packbuf + ((size + 1) / 2) * blk;
+
+        sendto = (rank + distance) % size;
+        recvfrom = (rank - distance + size) % size;
+
+        for (pos = 0, nblocks = 0, i = 1; i < size; ++i) {
+            if (0 == (i & distance)) continue;
+            memcpy(&blen, tmpbuf + i * blk, sizeof(int));
+            memcpy(packbuf + pos, tmpbuf + i * blk, sizeof(int) + blen);
+            pos += sizeof(int) + blen;
+            nblocks++;
+        }
+
+        err = ompi_coll_base_sendrecv(packbuf, (int)pos, MPI_BYTE, sendto,
+                                      MCA_COLL_BASE_TAG_ALLTOALLV,
+                                      recvpack, (int)(nblocks * blk), MPI_BYTE, recvfrom,
+                                      MCA_COLL_BASE_TAG_ALLTOALLV,
+                                      comm, MPI_STATUS_IGNORE, rank);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+        for (pos = 0, i = 1; i < size; ++i) {
+            if (0 == (i & distance)) continue;
+            memcpy(&blen, recvpack + pos, sizeof(int));
+            memcpy(tmpbuf + i * blk, recvpack + pos, sizeof(int) + blen);
+            pos += sizeof(int) + blen;
+        }
+    }
+
+    /* Step 3 - block i now holds the data from i ranks before */
+    for (i = 1; i < size; ++i) {
+        recvfrom = (rank - i + size) % size;
+        memcpy(&blen, tmpbuf + i * blk, sizeof(int));
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor, &rdtype->super,
+                                                 rcounts[recvfrom],
+                                                 (char *) rbuf + (ptrdiff_t)rdisps[recvfrom] * rext,
+                                                 0, &convertor);
+        iov.iov_base = tmpbuf + i * blk + sizeof(int);
+        iov.iov_len = max_data = (size_t)blen;
+        iov_count = 1;
+        err = opal_convertor_unpack(&convertor, &iov, &iov_count, &max_data);
+        OBJ_DESTRUCT(&convertor);
+        if (err < 0) { line = __LINE__; goto err_hndl; }
+        /* the block did not fit in the receive buffer */
+        if (max_data != (size_t)blen) {
+            err = MPI_ERR_TRUNCATE; line = __LINE__; goto err_hndl;
+        }
+    }
+    err = MPI_SUCCESS;
+
+ err_hndl:
+    if (MPI_SUCCESS != err) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "%s:%4d\tError occurred %d, rank %2d", __FILE__, line, err,
+                     rank));
+        (void)line;  // silence compiler warning
+    }
+    if (NULL != tmpbuf) free(tmpbuf);
+    if (NULL != packbuf) free(packbuf);
+    return err;
+}
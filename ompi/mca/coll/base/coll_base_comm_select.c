@@ -304,6 +304,53 @@ int mca_coll_base_comm_select(ompi_communicator_t * comm)
     return OMPI_SUCCESS;
 }
 
+#define NOTIFY_TOPO(comm, func, modules, nmodules, ret)                    \
+    do {                                                                 \
+        mca_coll_base_module_t *m = comm->c_coll->coll_ ## func ## _module; \
+        int i;                                                           \
+        for (i = 0; i < nmodules && modules[i] != m; ++i);               \
+        if (NULL != m && i == nmodules) {                                \
+            modules[nmodules++] = m;                                     \
+            if (NULL != m->coll_module_topo) {                           \
+                int rc = m->coll_module_topo(m, comm);                   \
+                if (OMPI_SUCCESS == ret) ret = rc;                       \
+            }                                                            \
+        }                                                                \
+    } while (0)
+
+/*
+ * This function is called once a graph or distributed graph topology is
+ * attached to a communicator, after its coll selection. The modules of
+ * the neighborhood collectives are notified in the same order on all the
+ * processes, since their callbacks may communicate, and all of them are
+ * notified even if one fails.
+ */
+int mca_coll_base_comm_topo(ompi_communicator_t * comm)
+{
+    mca_coll_base_module_t *modules[15];
+    int nmodules = 0, ret = OMPI_SUCCESS;
+
+    NOTIFY_TOPO(comm, neighbor_allgather, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_allgatherv, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoall, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoallv, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoallw, modules, nmodules, ret);
+
+    NOTIFY_TOPO(comm, ineighbor_allgather, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, ineighbor_allgatherv, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, ineighbor_alltoall, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, ineighbor_alltoallv, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, ineighbor_alltoallw, modules, nmodules, ret);
+
+    NOTIFY_TOPO(comm, neighbor_allgather_init, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_allgatherv_init, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoall_init, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoallv_init, modules, nmodules, ret);
+    NOTIFY_TOPO(comm, neighbor_alltoallw_init, modules, nmodules, ret);
+
+    return ret;
+}
+
 static int avail_coll_compare (opal_list_item_t **a,
                                opal_list_item_t **b) {
     avail_coll_t *acoll = (avail_coll_t *) *a;
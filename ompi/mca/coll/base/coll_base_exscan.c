@@ -221,3 +221,258 @@ cleanup_and_return:
         free(tmprecv_raw);
     return err;
 }
+
+/*
+ * ompi_coll_base_exscan_intra_binomial
+ *
+ * Function:  Binomial up-sweep/down-sweep algorithm for exclusive scan.
+ * Accepts:   Same as MPI_Exscan
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  Same sweeps as ompi_coll_base_scan_intra_binomial, on the
+ *               processes numbered from 1 (i = rank + 1). In the up-sweep,
+ *               process i accumulates the partial results of its children
+ *               into recvbuf, i.e. the reduction of (i - lowbit(i), i - 1],
+ *               and sends this reduction with its value to i + lowbit(i).
+ *               In the down-sweep, the prefix received from process
+ *               i - lowbit(i) completes recvbuf, and the prefix of i is
+ *               sent to the processes i + lowbit(i) / 2, ..., i + 1.
+ *               The algorithm preserves order of operations so it can
+ *               be used both by commutative and non-commutative operations.
+ *
+ * Time complexity: 2\ceil(\log_2(p))(\alpha + m\beta + m\gamma) on the
+ *                  critical path, with a total of at most 3pm\gamma of
+ *                  computation.
+ * Memory requirements (per process): 2 * count * typesize = O(count)
+ * Limitations: intra-communicators only
+ */
+int ompi_coll_base_exscan_intra_binomial(
+    const void *sendbuf, void *recvbuf, int count, struct ompi_datatype_t *datatype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module)
+{
+    int err = MPI_SUCCESS;
+    char *tmpsend_raw = NULL, *tmprecv_raw = NULL;
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    int vrank = rank + 1, lowbit = vrank & -vrank;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "coll:base:exscan_intra_binomial: rank %d/%d",
+                 rank, comm_size));
+    if (count == 0)
+        return MPI_SUCCESS;
+    if (comm_size < 2)
+        return MPI_SUCCESS;
+
+    ptrdiff_t dsize, gap;
+    dsize = opal_datatype_span(&datatype->super, count, &gap);
+    tmpsend_raw = malloc(dsize);
+    tmprecv_raw = malloc(dsize);
+    if (NULL == tmpsend_raw || NULL == tmprecv_raw) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup_and_return;
+    }
+    char *psend = tmpsend_raw - gap;
+    char *precv = tmprecv_raw - gap;
+    if (sendbuf != MPI_IN_PLACE) {
+        err = ompi_datatype_copy_content_same_ddt(datatype, count, psend, (char *)sendbuf);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    } else {
+        err = ompi_datatype_copy_content_same_ddt(datatype, count, psend, recvbuf);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+    /* Up-sweep: recvbuf = reduction of (vrank - lowbit, vrank - 1] */
+    for (int mask = 1; mask < lowbit; mask <<= 1) {
+        if (1 == mask) {
+            err = MCA_PML_CALL(recv(recvbuf, count, datatype, rank - mask,
+                                    MCA_COLL_BASE_TAG_EXSCAN, comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        } else {
+            err = MCA_PML_CALL(recv(precv, count, datatype, rank - mask,
+                                    MCA_COLL_BASE_TAG_EXSCAN, comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            /* recvbuf = precv <op> recvbuf */
+            ompi_op_reduce(op, precv, recvbuf, count, datatype);
+        }
+    }
+    if (lowbit > 1) {
+        /* Partial result: psend = recvbuf <op> psend */
+        ompi_op_reduce(op, recvbuf, psend, count, datatype);
+    }
+    if (vrank + lowbit <= comm_size) {
+        err = MCA_PML_CALL(send(psend, count, datatype, rank + lowbit,
+                                MCA_COLL_BASE_TAG_EXSCAN,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+    /* Down-sweep: recvbuf = prefix of vrank - lowbit <op> recvbuf */
+    if (vrank != lowbit) {
+        if (1 == lowbit) {
+            err = MCA_PML_CALL(recv(recvbuf, count, datatype, rank - lowbit,
+                                    MCA_COLL_BASE_TAG_EXSCAN, comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        } else {
+            err = MCA_PML_CALL(recv(precv, count, datatype, rank - lowbit,
+                                    MCA_COLL_BASE_TAG_EXSCAN, comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            ompi_op_reduce(op, precv, recvbuf, count, datatype);
+            /* Prefix of vrank: psend = precv <op> psend */
+            ompi_op_reduce(op, precv, psend, count, datatype);
+        }
+    }
+    for (int mask = lowbit >> 1; mask > 0; mask >>= 1) {
+        if (vrank + mask <= comm_size) {
+            err = MCA_PML_CALL(send(psend, count, datatype, rank + mask,
+                                    MCA_COLL_BASE_TAG_EXSCAN,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+    }
+
+cleanup_and_return:
+    if (NULL != tmpsend_raw)
+        free(tmpsend_raw);
+    if (NULL != tmprecv_raw)
+        free(tmprecv_raw);
+    return err;
+}
+
+/*
+ * ompi_coll_base_exscan_intra_pipeline
+ *
+ * Function:  Pipelined linear algorithm for exclusive scan.
+ * Accepts:   Same as MPI_Exscan, and the segment size
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  Same as ompi_coll_base_exscan_intra_linear, but the data is
+ *               split in segments of (about) segsize bytes: each process
+ *               forwards its prefix of a segment to the next one as soon as
+ *               the prefix of the previous process arrived, while it
+ *               receives the next segment.
+ *               The algorithm preserves order of operations so it can
+ *               be used both by commutative and non-commutative operations.
+ *
+ * Time complexity: (p - 1 + m/s)(\alpha + s\beta + s\gamma) for segments
+ *                  of s bytes
+ * Memory requirements (per process): 4 * segsize
+ * Limitations: intra-communicators only
+ */
+int ompi_coll_base_exscan_intra_pipeline(
+    const void *sendbuf, void *recvbuf, int count, struct ompi_datatype_t *datatype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module, uint32_t segsize)
+{
+    int err = MPI_SUCCESS, segcount = count, num_segments;
+    char *inbuf_raw[2] = {NULL, NULL}, *inbuf[2] = {NULL, NULL};
+    char *outbuf_raw[2] = {NULL, NULL}, *outbuf[2] = {NULL, NULL};
+    ompi_request_t *reqs[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                               MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    const char *psrc = (sendbuf == MPI_IN_PLACE) ? (const char *)recvbuf : (const char *)sendbuf;
+    ptrdiff_t extent, dsize, gap;
+    size_t typelng;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "coll:base:exscan_intra_pipeline: rank %d/%d",
+                 rank, comm_size));
+    if (count == 0)
+        return MPI_SUCCESS;
+    if (comm_size < 2)
+        return MPI_SUCCESS;
+
+    ompi_datatype_type_size(datatype, &typelng);
+    ompi_datatype_type_extent(datatype, &extent);
+    COLL_BASE_COMPUTED_SEGCOUNT(segsize, typelng, segcount)
+    num_segments = COLL_BASE_COMPUTE_NUM_SEGMENTS(count, segcount);
+
+    /* The segments are received in recvbuf, unless it holds the values
+       (MPI_IN_PLACE), and the processes but the first and the last
+       compute their prefix in outbuf */
+    dsize = opal_datatype_span(&datatype->super, segcount, &gap);
+    for (int i = 0; i < 2; i++) {
+        if (rank > 0 && sendbuf == MPI_IN_PLACE) {
+            inbuf_raw[i] = malloc(dsize);
+            if (NULL == inbuf_raw[i]) {
+                err = OMPI_ERR_OUT_OF_RESOURCE;
+                goto cleanup_and_return;
+            }
+            inbuf[i] = inbuf_raw[i] - gap;
+        }
+        if (rank > 0 && rank < comm_size - 1) {
+            outbuf_raw[i] = malloc(dsize);
+            if (NULL == outbuf_raw[i]) {
+                err = OMPI_ERR_OUT_OF_RESOURCE;
+                goto cleanup_and_return;
+            }
+            outbuf[i] = outbuf_raw[i] - gap;
+        }
+    }
+
+    /* reqs[0..1]: receives of the segments, reqs[2..3]: sends */
+    for (int seg = -1; seg < num_segments; seg++) {
+        ptrdiff_t off = (ptrdiff_t)seg * segcount * extent;
+        int cnt = count - seg * segcount;
+        if (cnt > segcount) cnt = segcount;
+
+        /* post the receive of the next segment */
+        if (rank > 0 && seg + 1 < num_segments) {
+            int next = count - (seg + 1) * segcount;
+            char *pin = (NULL != inbuf[0]) ? inbuf[(seg + 1) & 0x1] :
+                (char *)recvbuf + (ptrdiff_t)(seg + 1) * segcount * extent;
+            err = MCA_PML_CALL(irecv(pin, next < segcount ? next : segcount, datatype,
+                                     rank - 1, MCA_COLL_BASE_TAG_EXSCAN, comm,
+                                     &reqs[(seg + 1) & 0x1]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+        if (seg < 0) {
+            continue;
+        }
+
+        const char *pout = psrc + off;
+        char *pin = (char *)recvbuf + off;
+        if (rank > 0) {
+            err = ompi_request_wait(&reqs[seg & 0x1], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            if (NULL != inbuf[0]) {
+                pin = inbuf[seg & 0x1];
+            }
+        }
+        if (rank > 0 && rank < comm_size - 1) {
+            /* outbuf = prefix of rank - 1 <op> my value */
+            err = ompi_request_wait(&reqs[2 + (seg & 0x1)], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            err = ompi_datatype_copy_content_same_ddt(datatype, cnt, outbuf[seg & 0x1],
+                                                      (char *)pout);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            ompi_op_reduce(op, pin, outbuf[seg & 0x1], cnt, datatype);
+            pout = outbuf[seg & 0x1];
+        }
+        if (rank > 0 && NULL != inbuf[0]) {
+            err = ompi_datatype_copy_content_same_ddt(datatype, cnt, (char *)recvbuf + off, pin);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+        if (rank < comm_size - 1) {
+            if (0 == rank) {
+                err = ompi_request_wait(&reqs[2 + (seg & 0x1)], MPI_STATUS_IGNORE);
+                if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            }
+            err = MCA_PML_CALL(isend(pout, cnt, datatype, rank + 1, MCA_COLL_BASE_TAG_EXSCAN,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[2 + (seg & 0x1)]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+    }
+    err = ompi_request_wait_all(2, reqs + 2, MPI_STATUSES_IGNORE);
+
+cleanup_and_return:
+    if (MPI_SUCCESS != err)
+        ompi_coll_base_free_reqs(reqs, 4);
+    for (int i = 0; i < 2; i++) {
+        if (NULL != inbuf_raw[i])
+            free(inbuf_raw[i]);
+        if (NULL != outbuf_raw[i])
+            free(outbuf_raw[i]);
+    }
+    return err;
+}
@@ -51,6 +51,7 @@ static void coll_base_module_construct(mca_coll_base_module_t *m)
     /* zero out all functions */
     memset ((char *) m + sizeof (m->super), 0, sizeof (*m) - sizeof (m->super));
     m->coll_module_disable = NULL;
+    m->coll_module_topo = NULL;
     m->base_data = NULL;
 }
 
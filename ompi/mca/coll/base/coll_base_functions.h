@@ -196,9 +196,12 @@ int ompi_coll_base_allgather_intra_two_procs(ALLGATHER_ARGS);
 /* All GatherV */
 int ompi_coll_base_allgatherv_intra_bruck(ALLGATHERV_ARGS);
 int ompi_coll_base_allgatherv_intra_ring(ALLGATHERV_ARGS);
+int ompi_coll_base_allgatherv_intra_ring_segmented(ALLGATHERV_ARGS, uint32_t segsize);
 int ompi_coll_base_allgatherv_intra_neighborexchange(ALLGATHERV_ARGS);
 int ompi_coll_base_allgatherv_intra_basic_default(ALLGATHERV_ARGS);
 int ompi_coll_base_allgatherv_intra_two_procs(ALLGATHERV_ARGS);
+int ompi_coll_base_allgatherv_intra_sparbit(ALLGATHERV_ARGS);
+int ompi_coll_base_allgatherv_intra_k_nomial(ALLGATHERV_ARGS, int radix);
 
 /* All Reduce */
 int ompi_coll_base_allreduce_intra_nonoverlapping(ALLREDUCE_ARGS);
@@ -207,6 +210,7 @@ int ompi_coll_base_allreduce_intra_ring(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_ring_segmented(ALLREDUCE_ARGS, uint32_t segsize);
 int ompi_coll_base_allreduce_intra_basic_linear(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_redscat_allgather(ALLREDUCE_ARGS);
+int ompi_coll_base_allreduce_intra_redscat_allgather_knomial(ALLREDUCE_ARGS, int radix);
 
 /* AlltoAll */
 int ompi_coll_base_alltoall_intra_pairwise(ALLTOALL_ARGS);
@@ -222,6 +226,9 @@ int mca_coll_base_alltoall_intra_basic_inplace(const void *rbuf, int rcount,
 /* AlltoAllV */
 int ompi_coll_base_alltoallv_intra_pairwise(ALLTOALLV_ARGS);
 int ompi_coll_base_alltoallv_intra_basic_linear(ALLTOALLV_ARGS);
+int ompi_coll_base_alltoallv_intra_sparse(ALLTOALLV_ARGS);
+int ompi_coll_base_alltoallv_intra_linear_sync(ALLTOALLV_ARGS, int max_requests);
+int ompi_coll_base_alltoallv_intra_bruck(ALLTOALLV_ARGS);
 int mca_coll_base_alltoallv_intra_basic_inplace(const void *rbuf, const int *rcounts, const int *rdisps,
                                                 struct ompi_datatype_t *rdtype,
                                                 struct ompi_communicator_t *comm,
@@ -253,6 +260,8 @@ int ompi_coll_base_bcast_intra_scatter_allgather_ring(BCAST_ARGS, uint32_t segsi
 int ompi_coll_base_exscan_intra_recursivedoubling(EXSCAN_ARGS);
 int ompi_coll_base_exscan_intra_linear(EXSCAN_ARGS);
 int ompi_coll_base_exscan_intra_recursivedoubling(EXSCAN_ARGS);
+int ompi_coll_base_exscan_intra_binomial(EXSCAN_ARGS);
+int ompi_coll_base_exscan_intra_pipeline(EXSCAN_ARGS, uint32_t segsize);
 
 /* Gather */
 int ompi_coll_base_gather_intra_basic_linear(GATHER_ARGS);
@@ -260,6 +269,8 @@ int ompi_coll_base_gather_intra_binomial(GATHER_ARGS);
 int ompi_coll_base_gather_intra_linear_sync(GATHER_ARGS, int first_segment_size);
 
 /* GatherV */
+int ompi_coll_base_gatherv_intra_basic_linear(GATHERV_ARGS);
+int ompi_coll_base_gatherv_intra_binomial(GATHERV_ARGS);
 
 /* Reduce */
 int ompi_coll_base_reduce_generic(REDUCE_ARGS, ompi_coll_tree_t* tree, int count_by_segment, int max_outstanding_reqs);
@@ -275,6 +286,7 @@ int ompi_coll_base_reduce_intra_redscat_gather(REDUCE_ARGS);
 int ompi_coll_base_reduce_scatter_intra_nonoverlapping(REDUCESCATTER_ARGS);
 int ompi_coll_base_reduce_scatter_intra_basic_recursivehalving(REDUCESCATTER_ARGS);
 int ompi_coll_base_reduce_scatter_intra_ring(REDUCESCATTER_ARGS);
+int ompi_coll_base_reduce_scatter_intra_ring_segmented(REDUCESCATTER_ARGS, uint32_t segsize);
 int ompi_coll_base_reduce_scatter_intra_butterfly(REDUCESCATTER_ARGS);
 
 /* Reduce_scatter_block */
@@ -282,17 +294,22 @@ int ompi_coll_base_reduce_scatter_block_basic_linear(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_recursivedoubling(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_recursivehalving(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_butterfly(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_base_reduce_scatter_block_intra_ring_segmented(REDUCESCATTERBLOCK_ARGS, uint32_t segsize);
 
 /* Scan */
 int ompi_coll_base_scan_intra_recursivedoubling(SCAN_ARGS);
 int ompi_coll_base_scan_intra_linear(SCAN_ARGS);
 int ompi_coll_base_scan_intra_recursivedoubling(SCAN_ARGS);
+int ompi_coll_base_scan_intra_binomial(SCAN_ARGS);
+int ompi_coll_base_scan_intra_pipeline(SCAN_ARGS, uint32_t segsize);
 
 /* Scatter */
 int ompi_coll_base_scatter_intra_basic_linear(SCATTER_ARGS);
 int ompi_coll_base_scatter_intra_binomial(SCATTER_ARGS);
 
 /* ScatterV */
+int ompi_coll_base_scatterv_intra_basic_linear(SCATTERV_ARGS);
+int ompi_coll_base_scatterv_intra_binomial(SCATTERV_ARGS);
 
 /* Reduce_local */
 int mca_coll_base_reduce_local(const void *inbuf, void *inoutbuf, int count,
@@ -431,6 +448,14 @@ do {                                                                           \
         EARLY_BLOCK_COUNT = EARLY_BLOCK_COUNT + 1;                           \
     }                                                                        \
 
+/**
+ * This macro gives the number of segments of at most SEGCOUNT elements
+ * of a block of COUNT elements. A block always has at least one
+ * (possibly empty) segment, so that all the blocks are sent.
+ */
+#define COLL_BASE_COMPUTE_NUM_SEGMENTS( COUNT, SEGCOUNT )                    \
+    (((COUNT) <= (SEGCOUNT)) ? 1 : ((COUNT) - 1) / (SEGCOUNT) + 1)
+
 /*
  * Data structure for hanging data off the communicator
  * i.e. per module instance
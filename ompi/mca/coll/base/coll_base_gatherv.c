@@ -0,0 +1,301 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2017 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "coll_base_topo.h"
+#include "coll_base_util.h"
+
+/*
+ * ompi_coll_base_gatherv_intra_binomial
+ *
+ * Function:  Binomial tree algorithm for gatherv
+ * Accepts:   Same as MPI_Gatherv
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description: the processes are organized in the same in-order binomial
+ * tree as for gather, so the subtree of each process is a contiguous range
+ * of ranks (relative to the root). As only the root knows the counts, the
+ * data travels packed, and each process first sends to its parent the size
+ * in bytes of the data of its subtree, then the data itself: its own block
+ * followed by the blocks of its children. The sizes travel up the tree
+ * ahead of the data. The root unpacks the blocks in the receive buffer
+ * according to the counts and displacements.
+ *
+ * Time complexity: 2 * \alpha\log(p) + \beta*m,
+ *                  where m is the total amount of data
+ *
+ * Memory requirements (per process):
+ *   root process: m
+ *   non-root, non-leaf process: the size of the data of its subtree
+ */
+int
+ompi_coll_base_gatherv_intra_binomial(const void *sbuf, int scount,
+                                      struct ompi_datatype_t *sdtype,
+                                      void *rbuf, const int *rcounts, const int *disps,
+                                      struct ompi_datatype_t *rdtype,
+                                      int root,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    int line = -1, i, err = MPI_SUCCESS, rank, size, nchildren, nreqs = 0, pcount;
+    uint64_t *sizes = NULL, total = 0;
+    ompi_datatype_t *ptype;
+    size_t typesize, pos;
+    ptrdiff_t extent, lb;
+    char *tmpbuf = NULL;
+    ompi_coll_tree_t *bmtree;
+    ompi_request_t **reqs = NULL;
+    mca_coll_base_module_t *base_module = (mca_coll_base_module_t*) module;
+    mca_coll_base_comm_t *data = base_module->base_data;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "ompi_coll_base_gatherv_intra_binomial rank %d", rank));
+
+    /* create the binomial tree */
+    COLL_BASE_UPDATE_IN_ORDER_BMTREE( comm, base_module, root );
+    bmtree = data->cached_in_order_bmtree;
+    nchildren = bmtree->tree_nextsize;
+
+    if (nchildren > 0) {
+        sizes = (uint64_t *) malloc(nchildren * sizeof(uint64_t));
+        reqs = ompi_coll_base_comm_get_reqs(data, nchildren);
+        if (NULL == sizes || NULL == reqs) {
+            err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+        }
+    }
+
+    /* Step 1: the size of the data of the subtree of each child */
+    for (i = 0; i < nchildren; i++) {
+        err = MCA_PML_CALL(irecv(&sizes[i], 1, MPI_UINT64_T, bmtree->tree_next[i],
+                                 MCA_COLL_BASE_TAG_GATHERV, comm, &reqs[nreqs++]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    nreqs = 0;
+
+    for (i = 0; i < nchildren; i++) {
+        total += sizes[i];
+    }
+
+    if (rank != root) {
+        ompi_datatype_type_size(sdtype, &typesize);
+        pos = typesize * (size_t)scount;
+        total += pos;
+
+        err = MCA_PML_CALL(send(&total, 1, MPI_UINT64_T, bmtree->tree_prev,
+                                MCA_COLL_BASE_TAG_GATHERV,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+        if (0 == nchildren) {
+            /* leaf nodes send their data as is */
+            if (scount > 0) {
+                err = MCA_PML_CALL(send(sbuf, scount, sdtype, bmtree->tree_prev,
+                                        MCA_COLL_BASE_TAG_GATHERV,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+                if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            }
+            goto done;
+        }
+
+        if (total > 0) {
+            tmpbuf = (char *) malloc(total);
+            if (NULL == tmpbuf) {
+                err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+            }
+        }
+        if (pos > 0) {
+            err = ompi_coll_base_packed_type(pos, &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = ompi_datatype_sndrcv((void *)sbuf, scount, sdtype,
+                                       tmpbuf, pcount, ptype);
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    } else {
+        ompi_datatype_get_extent(rdtype, &lb, &extent);
+        if (MPI_IN_PLACE != sbuf && scount > 0 && rcounts[rank] > 0) {
+            err = ompi_datatype_sndrcv((void *)sbuf, scount, sdtype,
+                                       (char *)rbuf + (ptrdiff_t)disps[rank] * extent,
+                                       rcounts[rank], rdtype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        if (total > 0) {
+            tmpbuf = (char *) malloc(total);
+            if (NULL == tmpbuf) {
+                err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+            }
+        }
+        pos = 0;
+    }
+
+    /* Step 2: the data of the children, stored after ours in the order of
+     * the ranks */
+    for (i = 0; i < nchildren; i++) {
+        if (0 == sizes[i]) continue;
+        err = ompi_coll_base_packed_type(sizes[i], &pcount, &ptype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        err = MCA_PML_CALL(irecv(tmpbuf + pos, pcount, ptype,
+                                 bmtree->tree_next[i], MCA_COLL_BASE_TAG_GATHERV,
+                                 comm, &reqs[nreqs++]));
+        ompi_coll_base_packed_type_free(&ptype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        pos += sizes[i];
+    }
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    nreqs = 0;
+
+    if (rank != root) {
+        if (total > 0) {
+            err = ompi_coll_base_packed_type(total, &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(send(tmpbuf, pcount, ptype, bmtree->tree_prev,
+                                    MCA_COLL_BASE_TAG_GATHERV,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    } else {
+        /* unpack the blocks of all the other processes */
+        ompi_datatype_type_size(rdtype, &typesize);
+        for (pos = 0, i = 1; i < size; i++) {
+            int peer = (i + root) % size;
+            size_t bytes = typesize * (size_t)rcounts[peer];
+            if (0 == bytes) continue;
+            err = ompi_coll_base_packed_type(bytes, &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = ompi_datatype_sndrcv(tmpbuf + pos, pcount, ptype,
+                                       (char *)rbuf + (ptrdiff_t)disps[peer] * extent,
+                                       rcounts[peer], rdtype);
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            pos += bytes;
+        }
+    }
+
+ done:
+    if (NULL != tmpbuf) free(tmpbuf);
+    if (NULL != sizes) free(sizes);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, nreqs);
+    }
+    if (NULL != tmpbuf) free(tmpbuf);
+    if (NULL != sizes) free(sizes);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    (void)line;  // silence compiler warning
+    return err;
+}
+
+/*
+ * Linear functions are copied from the basic coll module.  For
+ * some small number of nodes and/or small data sizes they are just as
+ * fast as base/tree based segmenting operations and as such may be
+ * selected by the decision functions.  These are copied into this module
+ * due to the way we select modules in V1. i.e. in V2 we will handle this
+ * differently and so will not have to duplicate code.
+ */
+
+/*
+ *	gatherv_intra_basic_linear
+ *
+ *	Function:	- basic gatherv operation
+ *	Accepts:	- same arguments as MPI_Gatherv()
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_base_gatherv_intra_basic_linear(const void *sbuf, int scount,
+                                          struct ompi_datatype_t *sdtype,
+                                          void *rbuf, const int *rcounts, const int *disps,
+                                          struct ompi_datatype_t *rdtype,
+                                          int root,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module)
+{
+    int i, rank, size, err = MPI_SUCCESS;
+    char *ptmp;
+    ptrdiff_t lb, extent;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    /* Everyone but root sends data and returns.  Don't send anything
+       for sendcounts of 0. */
+
+    if (rank != root) {
+        if (scount > 0) {
+            return MCA_PML_CALL(send(sbuf, scount, sdtype, root,
+                                     MCA_COLL_BASE_TAG_GATHERV,
+                                     MCA_PML_BASE_SEND_STANDARD, comm));
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* I am the root, loop receiving data. */
+
+    err = ompi_datatype_get_extent(rdtype, &lb, &extent);
+    if (OMPI_SUCCESS != err) {
+        return OMPI_ERROR;
+    }
+
+    for (i = 0; i < size; ++i) {
+        ptmp = ((char *) rbuf) + (extent * disps[i]);
+
+        if (i == rank) {
+            /* simple optimization */
+            if (MPI_IN_PLACE != sbuf && (0 < scount) && (0 < rcounts[i])) {
+                err = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                           ptmp, rcounts[i], rdtype);
+            }
+        } else {
+            /* Only receive if there is something to receive */
+            if (rcounts[i] > 0) {
+                err = MCA_PML_CALL(recv(ptmp, rcounts[i], rdtype, i,
+                                        MCA_COLL_BASE_TAG_GATHERV,
+                                        comm, MPI_STATUS_IGNORE));
+            }
+        }
+
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* All done */
+
+    return MPI_SUCCESS;
+}
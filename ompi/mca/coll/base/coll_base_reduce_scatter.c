@@ -622,6 +622,209 @@ ompi_coll_base_reduce_scatter_intra_ring( const void *sbuf, void *rbuf, const in
     return ret;
 }
 
+/*
+ *   ompi_coll_base_reduce_scatter_intra_ring_segmented
+ *
+ *   Function:       Pipelined ring algorithm for reduce_scatter operation
+ *   Accepts:        Same as MPI_Reduce_scatter(), and the segment size
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Same steps as ompi_coll_base_reduce_scatter_intra_ring,
+ *                   but the blocks are split in segments of (about) segsize
+ *                   bytes, and each segment is reduced and forwarded to
+ *                   (r+1) as soon as it arrived from (r-1), while the next
+ *                   segments are being received. The neighbors thus work
+ *                   on the same block at the same time instead of waiting
+ *                   for it to be complete, and the reduction overlaps the
+ *                   communications.
+ *                   The messages sent by (r-1) are received in order: its
+ *                   own block (r-2), then the blocks (r-3) ... (r) that
+ *                   it forwards. Each block is made of at least one
+ *                   (possibly empty) segment.
+ *                   Algorithm requires total_count + 2 * segcount extra
+ *                   buffering.
+ *
+ *   Limitations:    The algorithm DOES NOT preserve order of operations so it
+ *                   can be used only for commutative operations.
+ */
+int
+ompi_coll_base_reduce_scatter_intra_ring_segmented(const void *sbuf, void *rbuf, const int *rcounts,
+                                                   struct ompi_datatype_t *dtype,
+                                                   struct ompi_op_t *op,
+                                                   struct ompi_communicator_t *comm,
+                                                   mca_coll_base_module_t *module,
+                                                   uint32_t segsize)
+{
+    int ret, line, rank, size, i, recv_from, send_to, total_count, max_block_count;
+    int segcount, block, count, *displs = NULL;
+    int sstep = 0, sseg = 0, pstep = 0, pseg = 0, rstep = 0, rseg = 0;
+    int nsent = 0, nposted = 0, nrecvd = 0;
+    size_t typelng;
+    char *tmpbuf, *accumbuf = NULL, *accumbuf_free = NULL;
+    char *inbuf_free[2] = {NULL, NULL}, *inbuf[2] = {NULL, NULL};
+    ptrdiff_t extent, max_real_segsize, dsize, gap = 0;
+    /* the two receives in flight, then the two sends */
+    ompi_request_t *reqs[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                               MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:reduce_scatter_intra_ring_segmented rank %d, size %d",
+                 rank, size));
+
+    displs = (int*) malloc(size * sizeof(int));
+    if (NULL == displs) { ret = -1; line = __LINE__; goto error_hndl; }
+    displs[0] = 0;
+    total_count = rcounts[0];
+    max_block_count = rcounts[0];
+    for (i = 1; i < size; i++) {
+        displs[i] = total_count;
+        total_count += rcounts[i];
+        if (max_block_count < rcounts[i]) max_block_count = rcounts[i];
+    }
+
+    /* Special case for size == 1 */
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, total_count,
+                                                      (char*)rbuf, (char*)sbuf);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+        free(displs);
+        return MPI_SUCCESS;
+    }
+
+    /* Determine segment count based on the suggested segment size */
+    ret = ompi_datatype_type_size(dtype, &typelng);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    segcount = max_block_count;
+    COLL_BASE_COMPUTED_SEGCOUNT(segsize, typelng, segcount)
+
+    ret = ompi_datatype_type_extent(dtype, &extent);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    max_real_segsize = opal_datatype_span(&dtype->super, segcount, &gap);
+    dsize = opal_datatype_span(&dtype->super, total_count, &gap);
+
+    accumbuf_free = (char*)malloc(dsize);
+    if (NULL == accumbuf_free) { ret = -1; line = __LINE__; goto error_hndl; }
+    accumbuf = accumbuf_free - gap;
+
+    for (i = 0; i < 2; i++) {
+        inbuf_free[i] = (char*)malloc(max_real_segsize);
+        if (NULL == inbuf_free[i]) { ret = -1; line = __LINE__; goto error_hndl; }
+        inbuf[i] = inbuf_free[i] - gap;
+    }
+
+    /* Handle MPI_IN_PLACE for size > 1 */
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    ret = ompi_datatype_copy_content_same_ddt(dtype, total_count,
+                                              accumbuf, (char*)sbuf);
+    if (ret < 0) { line = __LINE__; goto error_hndl; }
+
+    /*
+       The send step t sends block (r-1-t) and the receive step t receives
+       block (r-2-t), for t = 0 .. n-2. The send step t > 0 forwards the
+       segments of the receive step (t-1) once they are reduced.
+       In the loop:
+       - keep two receives posted
+       - send the segments available, at most one ahead of the receives
+       (all of them once everything is received)
+       - wait for the next segment and reduce it
+    */
+    send_to = (rank + 1) % size;
+    recv_from = (rank + size - 1) % size;
+
+    while (true) {
+        while (pstep < size - 1 && nposted < nrecvd + 2) {
+            block = (rank - 2 - pstep + 2 * size) % size;
+            count = rcounts[block] - pseg * segcount;
+            if (count > segcount) count = segcount;
+            ret = MCA_PML_CALL(irecv(inbuf[nposted & 0x1], count, dtype, recv_from,
+                                     MCA_COLL_BASE_TAG_REDUCE_SCATTER, comm,
+                                     &reqs[nposted & 0x1]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            if (++pseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+                pseg = 0;
+                pstep++;
+            }
+            nposted++;
+        }
+
+        while (sstep < size - 1 && (nsent <= nrecvd + 1 || rstep == size - 1) &&
+               (0 == sstep || sstep - 1 < rstep || sseg < rseg)) {
+            block = (rank - 1 - sstep + size) % size;
+            count = rcounts[block] - sseg * segcount;
+            if (count > segcount) count = segcount;
+            tmpbuf = accumbuf + ((ptrdiff_t)displs[block] + (ptrdiff_t)sseg * segcount) * extent;
+
+            /* Wait for the send before last to complete */
+            ret = ompi_request_wait(&reqs[2 + (nsent & 0x1)], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            ret = MCA_PML_CALL(isend(tmpbuf, count, dtype, send_to,
+                                     MCA_COLL_BASE_TAG_REDUCE_SCATTER,
+                                     MCA_PML_BASE_SEND_STANDARD, comm,
+                                     &reqs[2 + (nsent & 0x1)]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            if (++sseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+                sseg = 0;
+                sstep++;
+            }
+            nsent++;
+        }
+
+        if (rstep == size - 1) {
+            break;
+        }
+
+        /* Wait for the next segment and reduce it:
+           accumbuf[segment] = inbuf (op) accumbuf[segment] */
+        ret = ompi_request_wait(&reqs[nrecvd & 0x1], MPI_STATUS_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        block = (rank - 2 - rstep + 2 * size) % size;
+        count = rcounts[block] - rseg * segcount;
+        if (count > segcount) count = segcount;
+        tmpbuf = accumbuf + ((ptrdiff_t)displs[block] + (ptrdiff_t)rseg * segcount) * extent;
+        ompi_op_reduce(op, inbuf[nrecvd & 0x1], tmpbuf, count, dtype);
+        if (++rseg == COLL_BASE_COMPUTE_NUM_SEGMENTS(rcounts[block], segcount)) {
+            rseg = 0;
+            rstep++;
+        }
+        nrecvd++;
+    }
+
+    ret = ompi_request_wait_all(2, reqs + 2, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+    /* Copy my block to rbuf */
+    tmpbuf = accumbuf + (ptrdiff_t)displs[rank] * extent;
+    ret = ompi_datatype_copy_content_same_ddt(dtype, rcounts[rank], (char *)rbuf, tmpbuf);
+    if (ret < 0) { line = __LINE__; goto error_hndl; }
+
+    if (NULL != displs) free(displs);
+    if (NULL != accumbuf_free) free(accumbuf_free);
+    if (NULL != inbuf_free[0]) free(inbuf_free[0]);
+    if (NULL != inbuf_free[1]) free(inbuf_free[1]);
+
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    ompi_coll_base_free_reqs(reqs, 4);
+    if (NULL != displs) free(displs);
+    if (NULL != accumbuf_free) free(accumbuf_free);
+    if (NULL != inbuf_free[0]) free(inbuf_free[0]);
+    if (NULL != inbuf_free[1]) free(inbuf_free[1]);
+    return ret;
+}
+
 /*
  * ompi_sum_counts: Returns sum of counts [lo, hi]
  *                  lo, hi in {0, 1, ..., nprocs_pof2 - 1}
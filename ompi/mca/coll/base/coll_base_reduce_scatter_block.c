@@ -890,3 +890,41 @@ cleanup_and_return:
         free(tmpbuf[1]);
     return err;
 }
+
+/*
+ * ompi_coll_base_reduce_scatter_block_intra_ring_segmented
+ *
+ * Function:  Pipelined ring algorithm for reduce_scatter_block
+ * Accepts:   Same as MPI_Reduce_scatter_block, and the segment size
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  ompi_coll_base_reduce_scatter_intra_ring_segmented with
+ *               blocks of rcount elements.
+ *
+ * Limitations:  The algorithm can be used only for commutative operations.
+ */
+int
+ompi_coll_base_reduce_scatter_block_intra_ring_segmented(
+    const void *sbuf, void *rbuf, int rcount, struct ompi_datatype_t *dtype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module, uint32_t segsize)
+{
+    int comm_size = ompi_comm_size(comm), *rcounts, err;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:reduce_scatter_block_intra_ring_segmented: rank %d/%d",
+                 ompi_comm_rank(comm), comm_size));
+
+    rcounts = (int *)malloc(comm_size * sizeof(int));
+    if (NULL == rcounts) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (int i = 0; i < comm_size; i++) {
+        rcounts[i] = rcount;
+    }
+
+    err = ompi_coll_base_reduce_scatter_intra_ring_segmented(sbuf, rbuf, rcounts, dtype, op,
+                                                             comm, module, segsize);
+    free(rcounts);
+    return err;
+}
@@ -228,3 +228,212 @@ cleanup_and_return:
         free(tmprecv_raw);
     return err;
 }
+
+/*
+ * ompi_coll_base_scan_intra_binomial
+ *
+ * Function:  Binomial up-sweep/down-sweep algorithm for inclusive scan.
+ * Accepts:   Same as MPI_Scan
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  Work-efficient (Blelloch-style) scan on the binomial trees
+ *               of the processes numbered from 1 (i = rank + 1), lowbit(i)
+ *               being the largest power of two dividing i.
+ *               Up-sweep: process i reduces the partial results of processes
+ *               i - 1, i - 2, i - 4, ..., i - lowbit(i) / 2 into its value,
+ *               so that it holds the reduction of (i - lowbit(i), i], and
+ *               sends it to process i + lowbit(i).
+ *               Down-sweep: process i receives the prefix reduction of
+ *               process i - lowbit(i) (unless i is a power of two), reduces
+ *               it with its partial result to get its own prefix, and sends
+ *               it to the processes i + lowbit(i) / 2, ..., i + 2, i + 1.
+ *               The algorithm preserves order of operations so it can
+ *               be used both by commutative and non-commutative operations.
+ *
+ * Example for 6 processes and operation MPI_SUM (i = 1 .. 6):
+ * Process:   1        2          3          4              5          6
+ *  Up-sweep: [1]      [1+2]      [3]        [(1+2)+(3+4)]  [5]        [5+6]
+ *  Down:                         [(1+2)+3]                 [(1..4)+5] [(1..4)+(5+6)]
+ *
+ * Time complexity: 2\ceil(\log_2(p))(\alpha + m\beta + m\gamma) on the
+ *                  critical path, with a total of at most 2pm\gamma of
+ *                  computation instead of p\ceil(\log_2(p))m\gamma for the
+ *                  recursive doubling.
+ * Memory requirements (per process): count * typesize = O(count)
+ * Limitations: intra-communicators only
+ */
+int ompi_coll_base_scan_intra_binomial(
+    const void *sendbuf, void *recvbuf, int count, struct ompi_datatype_t *datatype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module)
+{
+    int err = MPI_SUCCESS;
+    char *tmprecv_raw = NULL;
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    int vrank = rank + 1, lowbit = vrank & -vrank;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:scan_intra_binomial: rank %d/%d",
+                 rank, comm_size));
+    if (count == 0)
+        return MPI_SUCCESS;
+
+    if (sendbuf != MPI_IN_PLACE) {
+        err = ompi_datatype_copy_content_same_ddt(datatype, count, recvbuf, (char *)sendbuf);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+    if (comm_size < 2)
+        return MPI_SUCCESS;
+
+    ptrdiff_t dsize, gap;
+    dsize = opal_datatype_span(&datatype->super, count, &gap);
+    tmprecv_raw = malloc(dsize);
+    if (NULL == tmprecv_raw) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup_and_return;
+    }
+    char *precv = tmprecv_raw - gap;
+
+    /* Up-sweep: recvbuf = reduction of (vrank - lowbit, vrank] */
+    for (int mask = 1; mask < lowbit; mask <<= 1) {
+        err = MCA_PML_CALL(recv(precv, count, datatype, rank - mask,
+                                MCA_COLL_BASE_TAG_SCAN, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        /* recvbuf = precv <op> recvbuf */
+        ompi_op_reduce(op, precv, recvbuf, count, datatype);
+    }
+    if (vrank + lowbit <= comm_size) {
+        err = MCA_PML_CALL(send(recvbuf, count, datatype, rank + lowbit,
+                                MCA_COLL_BASE_TAG_SCAN,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+    /* Down-sweep: prefix of vrank - lowbit <op> recvbuf */
+    if (vrank != lowbit) {
+        err = MCA_PML_CALL(recv(precv, count, datatype, rank - lowbit,
+                                MCA_COLL_BASE_TAG_SCAN, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        ompi_op_reduce(op, precv, recvbuf, count, datatype);
+    }
+    for (int mask = lowbit >> 1; mask > 0; mask >>= 1) {
+        if (vrank + mask <= comm_size) {
+            err = MCA_PML_CALL(send(recvbuf, count, datatype, rank + mask,
+                                    MCA_COLL_BASE_TAG_SCAN,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+    }
+
+cleanup_and_return:
+    if (NULL != tmprecv_raw)
+        free(tmprecv_raw);
+    return err;
+}
+
+/*
+ * ompi_coll_base_scan_intra_pipeline
+ *
+ * Function:  Pipelined linear algorithm for inclusive scan.
+ * Accepts:   Same as MPI_Scan, and the segment size
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  Same as ompi_coll_base_scan_intra_linear, but the data is
+ *               split in segments of (about) segsize bytes: each process
+ *               forwards the prefix of a segment to the next one as soon as
+ *               it is reduced, while it receives the next segment, so that
+ *               all the processes work at the same time on large counts.
+ *               The algorithm preserves order of operations so it can
+ *               be used both by commutative and non-commutative operations.
+ *
+ * Time complexity: (p - 1 + m/s)(\alpha + s\beta + s\gamma) for segments
+ *                  of s bytes
+ * Memory requirements (per process): 2 * segsize
+ * Limitations: intra-communicators only
+ */
+int ompi_coll_base_scan_intra_pipeline(
+    const void *sendbuf, void *recvbuf, int count, struct ompi_datatype_t *datatype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module, uint32_t segsize)
+{
+    int err = MPI_SUCCESS, segcount = count, num_segments;
+    char *inbuf_raw[2] = {NULL, NULL}, *inbuf[2];
+    ompi_request_t *reqs[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                               MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+    ptrdiff_t extent, dsize, gap;
+    size_t typelng;
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:scan_intra_pipeline: rank %d/%d",
+                 rank, comm_size));
+    if (count == 0)
+        return MPI_SUCCESS;
+
+    if (sendbuf != MPI_IN_PLACE) {
+        err = ompi_datatype_copy_content_same_ddt(datatype, count, recvbuf, (char *)sendbuf);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+    if (comm_size < 2)
+        return MPI_SUCCESS;
+
+    ompi_datatype_type_size(datatype, &typelng);
+    ompi_datatype_type_extent(datatype, &extent);
+    COLL_BASE_COMPUTED_SEGCOUNT(segsize, typelng, segcount)
+    num_segments = COLL_BASE_COMPUTE_NUM_SEGMENTS(count, segcount);
+
+    if (rank > 0) {
+        dsize = opal_datatype_span(&datatype->super, segcount, &gap);
+        for (int i = 0; i < 2; i++) {
+            inbuf_raw[i] = malloc(dsize);
+            if (NULL == inbuf_raw[i]) {
+                err = OMPI_ERR_OUT_OF_RESOURCE;
+                goto cleanup_and_return;
+            }
+            inbuf[i] = inbuf_raw[i] - gap;
+        }
+        err = MCA_PML_CALL(irecv(inbuf[0], segcount < count ? segcount : count, datatype,
+                                 rank - 1, MCA_COLL_BASE_TAG_SCAN, comm, &reqs[0]));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+    /* reqs[0..1]: receives of the segments, reqs[2..3]: sends */
+    for (int seg = 0; seg < num_segments; seg++) {
+        char *pseg = (char *)recvbuf + (ptrdiff_t)seg * segcount * extent;
+        int cnt = count - seg * segcount;
+        if (cnt > segcount) cnt = segcount;
+
+        if (rank > 0) {
+            if (seg + 1 < num_segments) {
+                int next = count - (seg + 1) * segcount;
+                err = MCA_PML_CALL(irecv(inbuf[(seg + 1) & 0x1], next < segcount ? next : segcount,
+                                         datatype, rank - 1, MCA_COLL_BASE_TAG_SCAN, comm,
+                                         &reqs[(seg + 1) & 0x1]));
+                if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            }
+            err = ompi_request_wait(&reqs[seg & 0x1], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            /* pseg = inbuf <op> pseg */
+            ompi_op_reduce(op, inbuf[seg & 0x1], pseg, cnt, datatype);
+        }
+        if (rank < comm_size - 1) {
+            err = ompi_request_wait(&reqs[2 + (seg & 0x1)], MPI_STATUS_IGNORE);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            err = MCA_PML_CALL(isend(pseg, cnt, datatype, rank + 1, MCA_COLL_BASE_TAG_SCAN,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[2 + (seg & 0x1)]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+    }
+    err = ompi_request_wait_all(2, reqs + 2, MPI_STATUSES_IGNORE);
+
+cleanup_and_return:
+    if (MPI_SUCCESS != err)
+        ompi_coll_base_free_reqs(reqs, 4);
+    if (NULL != inbuf_raw[0])
+        free(inbuf_raw[0]);
+    if (NULL != inbuf_raw[1])
+        free(inbuf_raw[1]);
+    return err;
+}
@@ -0,0 +1,310 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
+ *                         University Research and Technology
+ *                         Corporation.  All rights reserved.
+ * Copyright (c) 2004-2017 The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
+ *                         University of Stuttgart.  All rights reserved.
+ * Copyright (c) 2004-2005 The Regents of the University of California.
+ *                         All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "coll_base_topo.h"
+#include "coll_base_util.h"
+
+/*
+ * ompi_coll_base_scatterv_intra_binomial
+ *
+ * Function:  Binomial tree algorithm for scatterv
+ * Accepts:   Same as MPI_Scatterv
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description: the processes are organized in the same in-order binomial
+ * tree as for scatter, so the subtree of each process is a contiguous range
+ * of ranks (relative to the root). As only the root knows the counts, the
+ * root packs the blocks in the order of the ranks, and each process sends
+ * to each child with more than one process in its subtree the sizes in
+ * bytes of the blocks of this subtree, followed by the blocks themselves.
+ * The leaves know the size of their block, and directly receive it in
+ * their receive buffer.
+ *
+ * Time complexity: 2 * \alpha\log(p) + \beta*m,
+ *                  where m is the total amount of data
+ *
+ * Memory requirements (per process):
+ *   root process: m + p * sizeof(uint64_t)
+ *   non-root, non-leaf process: the size of the data of its subtree
+ */
+int
+ompi_coll_base_scatterv_intra_binomial(const void *sbuf, const int *scounts,
+                                       const int *disps, struct ompi_datatype_t *sdtype,
+                                       void *rbuf, int rcount,
+                                       struct ompi_datatype_t *rdtype,
+                                       int root,
+                                       struct ompi_communicator_t *comm,
+                                       mca_coll_base_module_t *module)
+{
+    int line = -1, i, err = MPI_SUCCESS, rank, vrank, size, nchildren, nreqs = 0;
+    int vkid, subtree, pcount;
+    uint64_t *sizes = NULL;
+    ompi_datatype_t *ptype;
+    size_t typesize, pos, total = 0;
+    ptrdiff_t extent, lb;
+    char *tmpbuf = NULL;
+    ompi_coll_tree_t *bmtree;
+    ompi_request_t **reqs = NULL;
+    mca_coll_base_module_t *base_module = (mca_coll_base_module_t*) module;
+    mca_coll_base_comm_t *data = base_module->base_data;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "ompi_coll_base_scatterv_intra_binomial rank %d", rank));
+
+    /* create the binomial tree */
+    COLL_BASE_UPDATE_IN_ORDER_BMTREE( comm, base_module, root );
+    bmtree = data->cached_in_order_bmtree;
+    nchildren = bmtree->tree_nextsize;
+    vrank = (rank - root + size) % size;
+
+    /* Number of processes in my subtree */
+    subtree = (0 == vrank) ? size : (vrank & -vrank);
+    if (subtree > size - vrank) subtree = size - vrank;
+
+    if (1 == subtree) {
+        /* leaf nodes directly receive their block */
+        if (rcount > 0) {
+            err = MCA_PML_CALL(recv(rbuf, rcount, rdtype, bmtree->tree_prev,
+                                    MCA_COLL_BASE_TAG_SCATTERV,
+                                    comm, MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* sizes[i] is the size of the block of the vrank + i process */
+    sizes = (uint64_t *) malloc(subtree * sizeof(uint64_t));
+    reqs = ompi_coll_base_comm_get_reqs(data, 2 * nchildren);
+    if (NULL == sizes || NULL == reqs) {
+        err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+    }
+
+    if (rank == root) {
+        /* keep our block out of the packed buffer */
+        ompi_datatype_get_extent(sdtype, &lb, &extent);
+        ompi_datatype_type_size(sdtype, &typesize);
+        sizes[0] = 0;
+        for (i = 1; i < size; i++) {
+            sizes[i] = typesize * (size_t)scounts[(i + root) % size];
+            total += sizes[i];
+        }
+        if (total > 0) {
+            tmpbuf = (char *) malloc(total);
+            if (NULL == tmpbuf) {
+                err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+            }
+        }
+        for (pos = 0, i = 1; i < size; i++) {
+            int peer = (i + root) % size;
+            if (0 == sizes[i]) continue;
+            err = ompi_coll_base_packed_type(sizes[i], &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = ompi_datatype_sndrcv((char *)sbuf + (ptrdiff_t)disps[peer] * extent,
+                                       scounts[peer], sdtype,
+                                       tmpbuf + pos, pcount, ptype);
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            pos += sizes[i];
+        }
+        if (MPI_IN_PLACE != rbuf && rcount > 0 && scounts[rank] > 0) {
+            err = ompi_datatype_sndrcv((char *)sbuf + (ptrdiff_t)disps[rank] * extent,
+                                       scounts[rank], sdtype, rbuf, rcount, rdtype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    } else {
+        err = MCA_PML_CALL(recv(sizes, subtree, MPI_UINT64_T, bmtree->tree_prev,
+                                MCA_COLL_BASE_TAG_SCATTERV,
+                                comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        for (i = 0; i < subtree; i++) {
+            total += sizes[i];
+        }
+        if (total > 0) {
+            tmpbuf = (char *) malloc(total);
+            if (NULL == tmpbuf) {
+                err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl;
+            }
+            err = ompi_coll_base_packed_type(total, &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(recv(tmpbuf, pcount, ptype, bmtree->tree_prev,
+                                    MCA_COLL_BASE_TAG_SCATTERV,
+                                    comm, MPI_STATUS_IGNORE));
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    /* Forward its part to each child, starting with the largest subtree */
+    for (i = nchildren - 1; i >= 0; i--) {
+        int k, kid_subtree;
+        size_t bytes = 0;
+
+        vkid = (bmtree->tree_next[i] - root + size) % size;
+        kid_subtree = vkid - vrank;
+        if (kid_subtree > size - vkid) kid_subtree = size - vkid;
+        for (pos = 0, k = 0; k < vkid - vrank; k++) {
+            pos += sizes[k];
+        }
+        for (k = 0; k < kid_subtree; k++) {
+            bytes += sizes[vkid - vrank + k];
+        }
+        if (kid_subtree > 1) {
+            err = MCA_PML_CALL(isend(&sizes[vkid - vrank], kid_subtree, MPI_UINT64_T,
+                                     bmtree->tree_next[i], MCA_COLL_BASE_TAG_SCATTERV,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        if (bytes > 0) {
+            err = ompi_coll_base_packed_type(bytes, &pcount, &ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(isend(tmpbuf + pos, pcount, ptype,
+                                     bmtree->tree_next[i], MCA_COLL_BASE_TAG_SCATTERV,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            ompi_coll_base_packed_type_free(&ptype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    /* Our own block comes first */
+    if (rank != root && sizes[0] > 0) {
+        err = ompi_coll_base_packed_type(sizes[0], &pcount, &ptype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        err = ompi_datatype_sndrcv(tmpbuf, pcount, ptype, rbuf, rcount, rdtype);
+        ompi_coll_base_packed_type_free(&ptype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+
+    if (NULL != tmpbuf) free(tmpbuf);
+    free(sizes);
+    return MPI_SUCCESS;
+
+ err_hndl:
+    if (NULL != reqs) {
+        ompi_coll_base_free_reqs(reqs, nreqs);
+    }
+    if (NULL != tmpbuf) free(tmpbuf);
+    if (NULL != sizes) free(sizes);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    (void)line;  // silence compiler warning
+    return err;
+}
+
+/*
+ * Linear functions are copied from the basic coll module.  For
+ * some small number of nodes and/or small data sizes they are just as
+ * fast as base/tree based segmenting operations and as such may be
+ * selected by the decision functions.  These are copied into this module
+ * due to the way we select modules in V1. i.e. in V2 we will handle this
+ * differently and so will not have to duplicate code.
+ */
+
+/*
+ *	scatterv_intra_basic_linear
+ *
+ *	Function:	- basic scatterv operation
+ *	Accepts:	- same arguments as MPI_Scatterv()
+ *	Returns:	- MPI_SUCCESS or error code
+ */
+int
+ompi_coll_base_scatterv_intra_basic_linear(const void *sbuf, const int *scounts,
+                                           const int *disps, struct ompi_datatype_t *sdtype,
+                                           void *rbuf, int rcount,
+                                           struct ompi_datatype_t *rdtype,
+                                           int root,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    int i, rank, size, err;
+    char *ptmp;
+    ptrdiff_t lb, extent;
+
+    /* Initialize */
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    /* If not root, receive data. */
+
+    if (rank != root) {
+        /* Only receive if there is something to receive */
+        if (rcount > 0) {
+            return MCA_PML_CALL(recv(rbuf, rcount, rdtype,
+                                     root, MCA_COLL_BASE_TAG_SCATTERV,
+                                     comm, MPI_STATUS_IGNORE));
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* I am the root, loop sending data. */
+
+    err = ompi_datatype_get_extent(sdtype, &lb, &extent);
+    if (OMPI_SUCCESS != err) {
+        return OMPI_ERROR;
+    }
+
+    for (i = 0; i < size; ++i) {
+        ptmp = ((char *) sbuf) + (extent * disps[i]);
+
+        /* simple optimization */
+
+        if (i == rank) {
+            /* Just return if we have nothing to do */
+            if (MPI_IN_PLACE != rbuf && (0 < scounts[i]) && (0 < rcount)) {
+                err = ompi_datatype_sndrcv(ptmp, scounts[i], sdtype,
+                                           rbuf, rcount, rdtype);
+            } else {
+                err = MPI_SUCCESS;
+            }
+        } else {
+            /* Only send if there is something to send */
+            if (scounts[i] > 0) {
+                err = MCA_PML_CALL(send(ptmp, scounts[i], sdtype, i,
+                                        MCA_COLL_BASE_TAG_SCATTERV,
+                                        MCA_PML_BASE_SEND_STANDARD, comm));
+            } else {
+                err = MPI_SUCCESS;
+            }
+        }
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* All done */
+
+    return MPI_SUCCESS;
+}
@@ -105,6 +105,44 @@ int ompi_rounddown(int num, int factor)
     return num * factor;    /* floor(num / factor) * factor */
 }
 
+int ompi_coll_base_packed_type(size_t size, int *count, ompi_datatype_t **dtype)
+{
+    const size_t chunk = (size_t)1 << 30;
+    ompi_datatype_t *chunk_type, *types[2];
+    ptrdiff_t disps[2];
+    int blens[2], err;
+
+    if (size <= (size_t)INT_MAX) {
+        *count = (int)size;
+        *dtype = MPI_PACKED;
+        return OMPI_SUCCESS;
+    }
+
+    /* chunks of 1 GiB followed by the remainder */
+    err = ompi_datatype_create_contiguous((int)chunk, MPI_PACKED, &chunk_type);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    blens[0] = (int)(size / chunk);
+    blens[1] = (int)(size % chunk);
+    disps[0] = 0;
+    disps[1] = (ptrdiff_t)(size - size % chunk);
+    types[0] = chunk_type;
+    types[1] = MPI_PACKED;
+    err = ompi_datatype_create_struct(2, blens, disps, types, dtype);
+    ompi_datatype_destroy(&chunk_type);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    err = ompi_datatype_commit(dtype);
+    if (OMPI_SUCCESS != err) {
+        ompi_datatype_destroy(dtype);
+        return err;
+    }
+    *count = 1;
+    return OMPI_SUCCESS;
+}
+
 static void release_objs_callback(struct ompi_coll_base_nbc_request_t *request) {
     if (NULL != request->data.objs.objs[0]) {
         OBJ_RELEASE(request->data.objs.objs[0]);
@@ -115,6 +115,22 @@ unsigned int ompi_mirror_perm(unsigned int x, int nbits);
  */
 int ompi_rounddown(int num, int factor);
 
+/**
+ * Describes size bytes of packed data as a count and a datatype: count
+ * bytes of MPI_PACKED up to INT_MAX bytes, a single element of a derived
+ * datatype above. The derived datatype must be released with
+ * ompi_coll_base_packed_type_free, which can be done as soon as the
+ * communications using it are posted.
+ */
+int ompi_coll_base_packed_type(size_t size, int *count, ompi_datatype_t **dtype);
+
+static inline void ompi_coll_base_packed_type_free(ompi_datatype_t **dtype)
+{
+    if (MPI_PACKED != *dtype) {
+        ompi_datatype_destroy(dtype);
+    }
+}
+
 int ompi_coll_base_retain_op( ompi_request_t *request,
                               ompi_op_t *op,
                               ompi_datatype_t *type);
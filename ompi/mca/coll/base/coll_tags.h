@@ -42,7 +42,9 @@
 #define MCA_COLL_BASE_TAG_SCATTER -25
 #define MCA_COLL_BASE_TAG_SCATTERV -26
 #define MCA_COLL_BASE_TAG_NONBLOCKING_BASE -27
-#define MCA_COLL_BASE_TAG_NONBLOCKING_END ((-1 * INT_MAX/2) + 1)
+#define MCA_COLL_BASE_TAG_NONBLOCKING_END ((-1 * INT_MAX/4) + 1)
+#define MCA_COLL_BASE_TAG_PERSISTENT_BASE (-1 * INT_MAX/4)
+#define MCA_COLL_BASE_TAG_PERSISTENT_END ((-1 * INT_MAX/2) + 1)
 #define MCA_COLL_BASE_TAG_HCOLL_BASE (-1 * INT_MAX/2)
 #define MCA_COLL_BASE_TAG_HCOLL_END (-1 * INT_MAX)
 #endif /* MCA_COLL_BASE_TAGS_H */
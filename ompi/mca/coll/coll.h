@@ -196,6 +196,22 @@ typedef int
 (*mca_coll_base_module_disable_1_2_0_fn_t)(struct mca_coll_base_module_2_3_0_t* module,
                                           struct ompi_communicator_t *comm);
 
+/**
+ * Notify the module of the topology of the communicator
+ *
+ * Graph and distributed graph topologies are attached to a communicator
+ * after the selection of its modules. This optional callback is then
+ * invoked once on each module of the neighborhood collectives, by all the
+ * processes of the communicator, so that it may prepare for them. It is
+ * blocking and collective, and may thus communicate on the communicator.
+ *
+ * @param[in/out] module     Module of neighborhood collectives
+ * @param[in]     comm       Communicator with the new topology
+ */
+typedef int
+(*mca_coll_base_module_topo_1_0_0_fn_t)(struct mca_coll_base_module_2_3_0_t* module,
+                                        struct ompi_communicator_t *comm);
+
 /* blocking collectives */
 typedef int (*mca_coll_base_module_allgather_fn_t)
   (const void *sbuf, int scount, struct ompi_datatype_t *sdtype,
@@ -596,6 +612,10 @@ struct mca_coll_base_module_2_3_0_t {
         be used for the given communicator */
     mca_coll_base_module_disable_1_2_0_fn_t coll_module_disable;
 
+    /** Optional function called once a graph or distributed graph
+        topology is attached to the communicator */
+    mca_coll_base_module_topo_1_0_0_fn_t coll_module_topo;
+
     mca_coll_base_module_reduce_local_fn_t coll_reduce_local;
 
     /** Data storage for all the algorithms defined in the base. Should
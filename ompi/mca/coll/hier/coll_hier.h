@@ -0,0 +1,196 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Hierarchical (node-aware) collectives.
+ *
+ * The communicator is split into an intra-node communicator (low
+ * level) and a communicator containing one leader per node (up
+ * level).  Each collective is composed from calls on these two
+ * sub-communicators, which select their own coll modules in the usual
+ * way (typically sm for the low level and tuned for the up level).
+ * Large bcast, reduce and allreduce operations are segmented, and the
+ * up level operation on one segment overlaps the low level operation
+ * on the previous one.
+ *
+ * The sub-communicators are created lazily on the first collective
+ * call.  Whenever the hierarchical algorithm does not apply (only one
+ * node, one process per node, non-commutative operations, ...) the
+ * module forwards the call to the collective that was selected before
+ * it on the communicator.
+ */
+
+#ifndef MCA_COLL_HIER_EXPORT_H
+#define MCA_COLL_HIER_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/mca/mca.h"
+#include "opal/util/output.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+
+BEGIN_C_DECLS
+
+/**
+ * State of the hierarchy attached to a module
+ */
+enum {
+    MCA_COLL_HIER_UNINIT = 0,   /**< sub-communicators not yet created */
+    MCA_COLL_HIER_SETUP,        /**< sub-communicators being created */
+    MCA_COLL_HIER_ACTIVE,       /**< hierarchical algorithms in use */
+    MCA_COLL_HIER_DISABLED      /**< always use the previous collectives */
+};
+
+/**
+ * Structure to hold the hier coll component.  First it holds the
+ * base coll component, and then holds a bunch of
+ * hier-coll-component-specific stuff (e.g., current MCA param
+ * values).
+ */
+typedef struct mca_coll_hier_component_t {
+    /** Base coll component */
+    mca_coll_base_component_2_0_0_t super;
+
+    /** MCA parameter: Priority of this component */
+    int hier_priority;
+
+    /** MCA parameter: Segment size (in bytes) used to pipeline the
+        two levels of bcast, reduce and allreduce */
+    int hier_segsize;
+
+    /** MCA parameter: Messages smaller than this (in bytes) are not
+        segmented */
+    int hier_pipeline_min;
+
+    /** Output stream */
+    int hier_output;
+} mca_coll_hier_component_t;
+
+/**
+ * Global component instance
+ */
+OMPI_MODULE_DECLSPEC extern mca_coll_hier_component_t mca_coll_hier_component;
+
+/**
+ * Module
+ */
+typedef struct mca_coll_hier_module_t {
+    mca_coll_base_module_t super;
+
+    /** Collectives selected on the communicator before us; used as
+        the fallback and during the creation of the sub-communicators */
+    mca_coll_base_comm_coll_t previous;
+
+    /** One of the MCA_COLL_HIER_* states */
+    int state;
+
+    /** Processes sharing a node with us */
+    ompi_communicator_t *low_comm;
+    /** One process per node (MPI_COMM_NULL on non-leaders) */
+    ompi_communicator_t *up_comm;
+
+    /** Number of nodes, and index of our node (rank of our leader in
+        up_comm) */
+    int nnodes;
+    int my_node;
+
+    /** Number of processes on each node */
+    int *node_sizes;
+    /** Position of the first process of each node in the node-major
+        ordering */
+    int *node_offsets;
+    /** Global rank of the process at each position of the node-major
+        ordering */
+    int *topo_order;
+    /** Node index of each global rank */
+    int *rank_to_node;
+
+    /** True if the node-major ordering is the identity, i.e. each
+        node holds a contiguous range of ranks in increasing order */
+    bool ordered;
+} mca_coll_hier_module_t;
+OBJ_CLASS_DECLARATION(mca_coll_hier_module_t);
+
+/*
+ * coll API functions
+ */
+int mca_coll_hier_init_query(bool enable_progress_threads,
+                             bool enable_mpi_threads);
+mca_coll_base_module_t *
+mca_coll_hier_comm_query(struct ompi_communicator_t *comm, int *priority);
+
+int mca_coll_hier_lazy_enable(mca_coll_hier_module_t *module,
+                              struct ompi_communicator_t *comm);
+
+int mca_coll_hier_reorder(mca_coll_hier_module_t *module,
+                          struct ompi_datatype_t *dtype, int count,
+                          char *rank_buf, char *node_buf, bool to_rank_order);
+
+int mca_coll_hier_allgather_intra(ALLGATHER_ARGS);
+int mca_coll_hier_allgatherv_intra(ALLGATHERV_ARGS);
+int mca_coll_hier_allreduce_intra(ALLREDUCE_ARGS);
+int mca_coll_hier_barrier_intra(BARRIER_ARGS);
+int mca_coll_hier_bcast_intra(BCAST_ARGS);
+int mca_coll_hier_gather_intra(GATHER_ARGS);
+int mca_coll_hier_reduce_intra(REDUCE_ARGS);
+int mca_coll_hier_scatter_intra(SCATTER_ARGS);
+
+/**
+ * Make sure the hierarchy is available before running a hierarchical
+ * algorithm.  Returns true if the caller must use the previous
+ * collective instead.
+ */
+static inline bool
+mca_coll_hier_use_fallback(mca_coll_hier_module_t *hier_module,
+                           struct ompi_communicator_t *comm)
+{
+    if (OPAL_UNLIKELY(MCA_COLL_HIER_UNINIT == hier_module->state)) {
+        (void) mca_coll_hier_lazy_enable(hier_module, comm);
+    }
+    return (MCA_COLL_HIER_ACTIVE != hier_module->state);
+}
+
+/**
+ * Leader (rank 0 of the low communicator) of the node hosting a
+ * given global rank, expressed as a rank in the up communicator.
+ */
+#define MCA_COLL_HIER_NODE_OF(module, rank) ((module)->rank_to_node[(rank)])
+
+/**
+ * Compute the number of elements in a pipeline segment for a message
+ * of count elements of dtype.  Returns count when the message is not
+ * to be segmented.
+ */
+static inline int
+mca_coll_hier_segcount(struct ompi_datatype_t *dtype, int count)
+{
+    size_t typelng;
+    int segcount = count;
+
+    ompi_datatype_type_size(dtype, &typelng);
+    if ((typelng * (size_t)count) < (size_t)mca_coll_hier_component.hier_pipeline_min) {
+        return count;
+    }
+    COLL_BASE_COMPUTED_SEGCOUNT((size_t)mca_coll_hier_component.hier_segsize,
+                                typelng, segcount);
+    return segcount;
+}
+
+END_C_DECLS
+
+#endif /* MCA_COLL_HIER_EXPORT_H */
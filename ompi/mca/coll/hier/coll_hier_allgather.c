@@ -0,0 +1,244 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "coll_hier.h"
+
+/*
+ *	allgather
+ *
+ *	Function:	- hierarchical allgather
+ *	Accepts:	- same arguments as MPI_Allgather()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Gather on the leaders, allgatherv of the node blocks among the
+ *	leaders, and broadcast of the whole buffer inside each node.
+ *	The data travels in node-major order, directly in rbuf when the
+ *	communicator is block ordered.
+ */
+int mca_coll_hier_allgather_intra(const void *sbuf, int scount,
+                                  struct ompi_datatype_t *sdtype,
+                                  void *rbuf, int rcount,
+                                  struct ompi_datatype_t *rdtype,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    int rank, size, node, i, err = OMPI_SUCCESS;
+    int *counts = NULL, *displs = NULL;
+    ptrdiff_t extent, lb, gap = 0;
+    char *free_buf = NULL, *buf;
+    bool leader;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_allgather(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                    comm,
+                                                    hier_module->previous.coll_allgather_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    leader = (0 == ompi_comm_rank(low_comm));
+    node = hier_module->my_node;
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = (char*)rbuf + (ptrdiff_t)rank * rcount * extent;
+        scount = rcount;
+        sdtype = rdtype;
+    }
+
+    if (hier_module->ordered) {
+        buf = (char*)rbuf;
+    } else {
+        ptrdiff_t dsize = opal_datatype_span(&rdtype->super, (int64_t)size * rcount, &gap);
+        free_buf = (char*)malloc(dsize);
+        if (NULL == free_buf && 0 != dsize) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        buf = free_buf - gap;
+    }
+
+    /* Intra-node gather.  In the ordered case the leader's block
+       lives at its final place, which may already hold the data. */
+    err = low_comm->c_coll->coll_gather((leader && hier_module->ordered &&
+                                         sbuf == buf + (ptrdiff_t)rank * rcount * extent) ?
+                                        MPI_IN_PLACE : sbuf, scount, sdtype,
+                                        buf + (ptrdiff_t)hier_module->node_offsets[node] * rcount * extent,
+                                        rcount, rdtype, 0, low_comm,
+                                        low_comm->c_coll->coll_gather_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* Exchange the node blocks between the leaders */
+    if (leader) {
+        counts = (int*)malloc(2 * hier_module->nnodes * sizeof(int));
+        if (NULL == counts) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        displs = counts + hier_module->nnodes;
+        for (i = 0; i < hier_module->nnodes; i++) {
+            counts[i] = hier_module->node_sizes[i] * rcount;
+            displs[i] = hier_module->node_offsets[i] * rcount;
+        }
+        err = up_comm->c_coll->coll_allgatherv(MPI_IN_PLACE, 0, rdtype, buf, counts, displs,
+                                               rdtype, up_comm,
+                                               up_comm->c_coll->coll_allgatherv_module);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+
+    err = low_comm->c_coll->coll_bcast(buf, size * rcount, rdtype, 0, low_comm,
+                                       low_comm->c_coll->coll_bcast_module);
+    if (OMPI_SUCCESS == err && !hier_module->ordered) {
+        err = mca_coll_hier_reorder(hier_module, rdtype, rcount, (char*)rbuf, buf, true);
+    }
+
+ cleanup:
+    if (NULL != counts) {
+        free(counts);
+    }
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    return err;
+}
+
+/*
+ *	allgatherv
+ *
+ *	Function:	- hierarchical allgatherv
+ *	Accepts:	- same arguments as MPI_Allgatherv()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Same scheme as allgather, on a packed node-major buffer whose
+ *	blocks are then copied to their displacements in rbuf.
+ */
+int mca_coll_hier_allgatherv_intra(const void *sbuf, int scount,
+                                   struct ompi_datatype_t *sdtype,
+                                   void *rbuf, const int *rcounts, const int *disps,
+                                   struct ompi_datatype_t *rdtype,
+                                   struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    int rank, size, node, nnodes, node_size, i, p, total, err = OMPI_SUCCESS;
+    int *pos_displs = NULL, *low_counts, *low_displs, *up_counts, *up_displs;
+    ptrdiff_t extent, lb, gap = 0, dsize;
+    char *free_buf = NULL, *buf;
+    bool leader;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_allgatherv(sbuf, scount, sdtype, rbuf, rcounts, disps,
+                                                     rdtype, comm,
+                                                     hier_module->previous.coll_allgatherv_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    leader = (0 == ompi_comm_rank(low_comm));
+    node = hier_module->my_node;
+    nnodes = hier_module->nnodes;
+    node_size = hier_module->node_sizes[node];
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = (char*)rbuf + (ptrdiff_t)disps[rank] * extent;
+        scount = rcounts[rank];
+        sdtype = rdtype;
+    }
+
+    /* Displacement of each position of the node-major ordering in
+       the packed buffer, followed by the counts and displacements of
+       the intra-node and inter-node steps */
+    pos_displs = (int*)malloc((size + 1 + 2 * node_size + 2 * nnodes) * sizeof(int));
+    if (NULL == pos_displs) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    low_counts = pos_displs + size + 1;
+    low_displs = low_counts + node_size;
+    up_counts = low_displs + node_size;
+    up_displs = up_counts + nnodes;
+
+    pos_displs[0] = 0;
+    for (p = 0; p < size; p++) {
+        pos_displs[p + 1] = pos_displs[p] + rcounts[hier_module->topo_order[p]];
+    }
+    total = pos_displs[size];
+    for (i = 0; i < node_size; i++) {
+        p = hier_module->node_offsets[node] + i;
+        low_counts[i] = rcounts[hier_module->topo_order[p]];
+        low_displs[i] = pos_displs[p] - pos_displs[hier_module->node_offsets[node]];
+    }
+    for (i = 0; i < nnodes; i++) {
+        p = hier_module->node_offsets[i];
+        up_displs[i] = pos_displs[p];
+        up_counts[i] = pos_displs[p + hier_module->node_sizes[i]] - pos_displs[p];
+    }
+
+    dsize = opal_datatype_span(&rdtype->super, (int64_t)total, &gap);
+    free_buf = (char*)malloc(dsize);
+    if (NULL == free_buf && 0 != dsize) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+    buf = free_buf - gap;
+
+    err = low_comm->c_coll->coll_gatherv(sbuf, scount, sdtype,
+                                         buf + (ptrdiff_t)up_displs[node] * extent,
+                                         low_counts, low_displs, rdtype, 0, low_comm,
+                                         low_comm->c_coll->coll_gatherv_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    if (leader) {
+        err = up_comm->c_coll->coll_allgatherv(MPI_IN_PLACE, 0, rdtype, buf, up_counts, up_displs,
+                                               rdtype, up_comm,
+                                               up_comm->c_coll->coll_allgatherv_module);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+    }
+
+    err = low_comm->c_coll->coll_bcast(buf, total, rdtype, 0, low_comm,
+                                       low_comm->c_coll->coll_bcast_module);
+    for (p = 0; p < size && OMPI_SUCCESS == err; p++) {
+        int r = hier_module->topo_order[p];
+        err = ompi_datatype_copy_content_same_ddt(rdtype, rcounts[r],
+                                                  (char*)rbuf + (ptrdiff_t)disps[r] * extent,
+                                                  buf + (ptrdiff_t)pos_displs[p] * extent);
+    }
+
+ cleanup:
+    free(pos_displs);
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    return err;
+}
@@ -0,0 +1,126 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/op/op.h"
+#include "coll_hier.h"
+
+/*
+ *	allreduce
+ *
+ *	Function:	- hierarchical allreduce
+ *	Accepts:	- same arguments as MPI_Allreduce()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Each segment goes through three stages: a reduce to the node
+ *	leader, an allreduce among the leaders and a broadcast from
+ *	the leader.  The leaders run the inter-node allreduce of
+ *	segment i in the background while the nodes broadcast segment
+ *	i-1 and reduce segment i+1.  The hierarchical order of the
+ *	reduction requires a commutative operation.
+ */
+int mca_coll_hier_allreduce_intra(const void *sbuf, void *rbuf, int count,
+                                  struct ompi_datatype_t *dtype,
+                                  struct ompi_op_t *op,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    ompi_request_t *req = MPI_REQUEST_NULL;
+    int segcount, num_segments, step, err = OMPI_SUCCESS;
+    ptrdiff_t extent, lb;
+    bool leader;
+
+    if (!ompi_op_is_commute(op) || mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_allreduce(sbuf, rbuf, count, dtype, op, comm,
+                                                    hier_module->previous.coll_allreduce_module);
+    }
+
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    leader = (0 == ompi_comm_rank(low_comm));
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    segcount = mca_coll_hier_segcount(dtype, count);
+    num_segments = (0 == segcount) ? 1 : (count + segcount - 1) / segcount;
+
+#define HIER_SEG_COUNT(s) (((s) == num_segments - 1) ? count - (s) * segcount : segcount)
+#define HIER_SEG_OFFSET(s) ((ptrdiff_t)(s) * segcount * extent)
+
+    for (step = 0; step <= num_segments; step++) {
+        /* Stage 1: reduce segment [step] on the leader */
+        if (step < num_segments) {
+            char *rseg = (char*)rbuf + HIER_SEG_OFFSET(step);
+            if (leader) {
+                err = low_comm->c_coll->coll_reduce((MPI_IN_PLACE == sbuf) ? MPI_IN_PLACE :
+                                                    (char*)sbuf + HIER_SEG_OFFSET(step),
+                                                    rseg, HIER_SEG_COUNT(step), dtype, op, 0,
+                                                    low_comm, low_comm->c_coll->coll_reduce_module);
+            } else {
+                err = low_comm->c_coll->coll_reduce((MPI_IN_PLACE == sbuf) ? rseg :
+                                                    (char*)sbuf + HIER_SEG_OFFSET(step),
+                                                    NULL, HIER_SEG_COUNT(step), dtype, op, 0,
+                                                    low_comm, low_comm->c_coll->coll_reduce_module);
+            }
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+
+        if (leader) {
+            /* Stage 2: complete segment [step-1] between the nodes,
+               and start segment [step] */
+            if (MPI_REQUEST_NULL != req) {
+                err = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+                if (OMPI_SUCCESS != err) {
+                    return err;
+                }
+            }
+            if (step < num_segments) {
+                err = up_comm->c_coll->coll_iallreduce(MPI_IN_PLACE,
+                                                       (char*)rbuf + HIER_SEG_OFFSET(step),
+                                                       HIER_SEG_COUNT(step), dtype, op, up_comm,
+                                                       &req, up_comm->c_coll->coll_iallreduce_module);
+                if (OMPI_SUCCESS != err) {
+                    return err;
+                }
+            }
+        }
+
+        /* Stage 3: broadcast segment [step-1] inside the node */
+        if (step > 0) {
+            err = low_comm->c_coll->coll_bcast((char*)rbuf + HIER_SEG_OFFSET(step - 1),
+                                               HIER_SEG_COUNT(step - 1), dtype, 0, low_comm,
+                                               low_comm->c_coll->coll_bcast_module);
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+    }
+
+#undef HIER_SEG_COUNT
+#undef HIER_SEG_OFFSET
+
+    return OMPI_SUCCESS;
+
+ cleanup:
+    if (MPI_REQUEST_NULL != req) {
+        (void) ompi_request_wait(&req, MPI_STATUS_IGNORE);
+    }
+    return err;
+}
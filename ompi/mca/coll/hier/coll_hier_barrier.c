@@ -0,0 +1,56 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "coll_hier.h"
+
+/*
+ *	barrier
+ *
+ *	Function:	- hierarchical barrier
+ *	Accepts:	- same arguments as MPI_Barrier()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Once the first intra-node barrier completes the leader knows
+ *	its whole node arrived; the second one releases the node only
+ *	after the leaders went through their own barrier.
+ */
+int mca_coll_hier_barrier_intra(struct ompi_communicator_t *comm,
+                                mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    int err;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_barrier(comm, hier_module->previous.coll_barrier_module);
+    }
+
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+
+    err = low_comm->c_coll->coll_barrier(low_comm, low_comm->c_coll->coll_barrier_module);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    if (0 == ompi_comm_rank(low_comm)) {
+        err = up_comm->c_coll->coll_barrier(up_comm, up_comm->c_coll->coll_barrier_module);
+        if (OMPI_SUCCESS != err) {
+            return err;
+        }
+    }
+    return low_comm->c_coll->coll_barrier(low_comm, low_comm->c_coll->coll_barrier_module);
+}
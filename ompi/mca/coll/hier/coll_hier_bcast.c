@@ -0,0 +1,116 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "coll_hier.h"
+
+/*
+ *	bcast
+ *
+ *	Function:	- hierarchical broadcast
+ *	Accepts:	- same arguments as MPI_Bcast()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	If the root is not the leader of its node it first hands the
+ *	buffer to its leader.  The leaders then broadcast each segment
+ *	among themselves, while the previous segment is broadcast
+ *	inside the nodes.
+ */
+int mca_coll_hier_bcast_intra(void *buff, int count,
+                              struct ompi_datatype_t *datatype, int root,
+                              struct ompi_communicator_t *comm,
+                              mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    ompi_request_t *req = MPI_REQUEST_NULL;
+    int rank, root_node, segcount, num_segments, seg, err = OMPI_SUCCESS;
+    ptrdiff_t extent, lb;
+    bool leader;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_bcast(buff, count, datatype, root, comm,
+                                                hier_module->previous.coll_bcast_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    leader = (0 == ompi_comm_rank(low_comm));
+    root_node = MCA_COLL_HIER_NODE_OF(hier_module, root);
+
+    /* Move the data to the leader of the root's node */
+    if (hier_module->topo_order[hier_module->node_offsets[root_node]] != root) {
+        if (rank == root) {
+            err = MCA_PML_CALL(send(buff, count, datatype,
+                                    hier_module->topo_order[hier_module->node_offsets[root_node]],
+                                    MCA_COLL_BASE_TAG_BCAST, MCA_PML_BASE_SEND_STANDARD, comm));
+        } else if (leader && hier_module->my_node == root_node) {
+            err = MCA_PML_CALL(recv(buff, count, datatype, root,
+                                    MCA_COLL_BASE_TAG_BCAST, comm, MPI_STATUS_IGNORE));
+        }
+        if (OMPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    ompi_datatype_get_extent(datatype, &lb, &extent);
+    segcount = mca_coll_hier_segcount(datatype, count);
+    num_segments = (0 == segcount) ? 1 : (count + segcount - 1) / segcount;
+
+    /* Prime the pipeline with the first segment */
+    if (leader) {
+        err = up_comm->c_coll->coll_bcast(buff, (segcount < count) ? segcount : count,
+                                          datatype, root_node, up_comm,
+                                          up_comm->c_coll->coll_bcast_module);
+        if (OMPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    for (seg = 0; seg < num_segments; seg++) {
+        char *segbuf = (char*)buff + (ptrdiff_t)seg * segcount * extent;
+        int this_count = (seg == num_segments - 1) ? count - seg * segcount : segcount;
+
+        /* Start moving the next segment between the nodes */
+        if (leader && (seg + 1) < num_segments) {
+            int next_count = (seg + 1 == num_segments - 1) ? count - (seg + 1) * segcount : segcount;
+            err = up_comm->c_coll->coll_ibcast(segbuf + (ptrdiff_t)segcount * extent, next_count,
+                                               datatype, root_node, up_comm, &req,
+                                               up_comm->c_coll->coll_ibcast_module);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+
+        err = low_comm->c_coll->coll_bcast(segbuf, this_count, datatype, 0, low_comm,
+                                           low_comm->c_coll->coll_bcast_module);
+        if (MPI_REQUEST_NULL != req) {
+            int ret = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS == err) {
+                err = ret;
+            }
+        }
+        if (OMPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    return OMPI_SUCCESS;
+}
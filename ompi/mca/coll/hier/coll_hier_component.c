@@ -0,0 +1,135 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * These symbols are in a file by themselves to provide nice linker
+ * semantics.  Since linkers generally pull in symbols by object
+ * files, keeping these symbols as the only symbols in this file
+ * prevents utility programs such as "ompi_info" from having to import
+ * entire components just to query their version and parameters.
+ */
+
+#include "ompi_config.h"
+
+#include "opal/util/output.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "coll_hier.h"
+
+/*
+ * Public string showing the coll ompi_hier component version number
+ */
+const char *mca_coll_hier_component_version_string =
+    "Open MPI hier collective MCA component version " OMPI_VERSION;
+
+/*
+ * Local functions
+ */
+static int hier_register(void);
+static int hier_open(void);
+static int hier_close(void);
+
+/*
+ * Instantiate the public struct with all of our public information
+ * and pointers to our public functions in it
+ */
+
+mca_coll_hier_component_t mca_coll_hier_component = {
+    /* First, fill in the super */
+    {
+        /* First, the mca_component_t struct containing meta information
+           about the component itself */
+        .collm_version = {
+            MCA_COLL_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+            .mca_component_name = "hier",
+            MCA_BASE_MAKE_VERSION(component, OMPI_MAJOR_VERSION, OMPI_MINOR_VERSION,
+                                  OMPI_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = hier_open,
+            .mca_close_component = hier_close,
+            .mca_register_component_params = hier_register,
+        },
+        .collm_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+
+        /* Initialization / querying functions */
+
+        .collm_init_query = mca_coll_hier_init_query,
+        .collm_comm_query = mca_coll_hier_comm_query,
+    },
+
+    /* hier-component specific information */
+
+    /* (default) priority */
+    35,
+    /* (default) pipeline segment size */
+    65536,
+    /* (default) smallest segmented message */
+    262144,
+    /* output stream */
+    -1
+};
+
+
+static int hier_register(void)
+{
+    mca_base_component_t *c = &mca_coll_hier_component.super.collm_version;
+    mca_coll_hier_component_t *cs = &mca_coll_hier_component;
+
+    /* Higher than tuned, so that the hierarchical algorithms are
+       preferred on multi-node communicators */
+    cs->hier_priority = 35;
+    (void) mca_base_component_var_register(c, "priority",
+                                           "Priority of the hier coll component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->hier_priority);
+
+    cs->hier_segsize = 65536;
+    (void) mca_base_component_var_register(c, "segsize",
+                                           "Segment size in bytes used to pipeline the intra-node and inter-node steps of bcast, reduce and allreduce",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->hier_segsize);
+
+    cs->hier_pipeline_min = 262144;
+    (void) mca_base_component_var_register(c, "pipeline_min",
+                                           "Messages smaller than this many bytes are not pipelined between the intra-node and inter-node steps",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->hier_pipeline_min);
+
+    return OMPI_SUCCESS;
+}
+
+static int hier_open(void)
+{
+    mca_coll_hier_component.hier_output = ompi_coll_base_framework.framework_output;
+
+    if (mca_coll_hier_component.hier_segsize <= 0) {
+        mca_coll_hier_component.hier_segsize = 65536;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int hier_close(void)
+{
+    return OMPI_SUCCESS;
+}
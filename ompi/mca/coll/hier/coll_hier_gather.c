@@ -0,0 +1,178 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "coll_hier.h"
+
+/*
+ *	gather
+ *
+ *	Function:	- hierarchical gather
+ *	Accepts:	- same arguments as MPI_Gather()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Each leader gathers the blocks of its node, then the leaders
+ *	gatherv their node blocks onto the leader of the root's node.
+ *	The data travels in node-major order, and is put back in rank
+ *	order on the root unless the communicator is block ordered.
+ *	Leaders other than the root only know the send signature, so
+ *	they stage the data as scount elements of sdtype per process.
+ */
+int mca_coll_hier_gather_intra(const void *sbuf, int scount,
+                               struct ompi_datatype_t *sdtype,
+                               void *rbuf, int rcount,
+                               struct ompi_datatype_t *rdtype,
+                               int root,
+                               struct ompi_communicator_t *comm,
+                               mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    int rank, size, root_node, root_leader, node, nblocks, pos0, blk_count, i;
+    int *counts = NULL, *displs = NULL, err = OMPI_SUCCESS;
+    struct ompi_datatype_t *blk_type, *my_sdtype = sdtype;
+    const char *my_sbuf = (const char*)sbuf;
+    int my_scount = scount;
+    ptrdiff_t blk_extent, rextent, lb, gap = 0, dsize;
+    char *free_buf = NULL, *lbuf = NULL;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_gather(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                 root, comm,
+                                                 hier_module->previous.coll_gather_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    node = hier_module->my_node;
+    root_node = MCA_COLL_HIER_NODE_OF(hier_module, root);
+    root_leader = hier_module->topo_order[hier_module->node_offsets[root_node]];
+
+    if (rank == root && MPI_IN_PLACE == sbuf) {
+        ompi_datatype_get_extent(rdtype, &lb, &rextent);
+        my_sbuf = (char*)rbuf + (ptrdiff_t)rank * rcount * rextent;
+        my_scount = rcount;
+        my_sdtype = rdtype;
+    }
+
+    if (0 != ompi_comm_rank(low_comm)) {
+        err = low_comm->c_coll->coll_gather(my_sbuf, my_scount, my_sdtype,
+                                            NULL, my_scount, my_sdtype, 0, low_comm,
+                                            low_comm->c_coll->coll_gather_module);
+        if (OMPI_SUCCESS != err || rank != root) {
+            return err;
+        }
+        /* A root that is not a leader receives the node-major data
+           from its leader */
+        if (hier_module->ordered) {
+            return MCA_PML_CALL(recv(rbuf, size * rcount, rdtype, root_leader,
+                                     MCA_COLL_BASE_TAG_GATHER, comm, MPI_STATUS_IGNORE));
+        }
+        dsize = opal_datatype_span(&rdtype->super, (int64_t)size * rcount, &gap);
+        free_buf = (char*)malloc(dsize);
+        if (NULL == free_buf && 0 != dsize) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        err = MCA_PML_CALL(recv(free_buf - gap, size * rcount, rdtype, root_leader,
+                                MCA_COLL_BASE_TAG_GATHER, comm, MPI_STATUS_IGNORE));
+        if (OMPI_SUCCESS == err) {
+            err = mca_coll_hier_reorder(hier_module, rdtype, rcount, rbuf, free_buf - gap, true);
+        }
+        free(free_buf);
+        return err;
+    }
+
+    /* Layout of the leader buffer: the root node holds all the
+       blocks, the others only their own node */
+    if (rank == root) {
+        blk_type = rdtype;
+        blk_count = rcount;
+    } else {
+        blk_type = sdtype;
+        blk_count = scount;
+    }
+    nblocks = (node == root_node) ? size : hier_module->node_sizes[node];
+    pos0 = (node == root_node) ? hier_module->node_offsets[node] : 0;
+    ompi_datatype_get_extent(blk_type, &lb, &blk_extent);
+
+    if (rank == root && hier_module->ordered) {
+        lbuf = (char*)rbuf;
+    } else {
+        dsize = opal_datatype_span(&blk_type->super, (int64_t)nblocks * blk_count, &gap);
+        free_buf = (char*)malloc(dsize);
+        if (NULL == free_buf && 0 != dsize) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        lbuf = free_buf - gap;
+    }
+
+    /* Intra-node step; in the ordered case the root's own block is
+       already at the right place */
+    err = low_comm->c_coll->coll_gather((rank == root && MPI_IN_PLACE == sbuf && hier_module->ordered) ?
+                                        MPI_IN_PLACE : my_sbuf, my_scount, my_sdtype,
+                                        lbuf + (ptrdiff_t)pos0 * blk_count * blk_extent,
+                                        blk_count, blk_type, 0, low_comm,
+                                        low_comm->c_coll->coll_gather_module);
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* Inter-node step */
+    if (node == root_node) {
+        counts = (int*)malloc(2 * hier_module->nnodes * sizeof(int));
+        if (NULL == counts) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        displs = counts + hier_module->nnodes;
+        for (i = 0; i < hier_module->nnodes; i++) {
+            counts[i] = hier_module->node_sizes[i] * blk_count;
+            displs[i] = hier_module->node_offsets[i] * blk_count;
+        }
+        err = up_comm->c_coll->coll_gatherv(MPI_IN_PLACE, 0, blk_type,
+                                            lbuf, counts, displs, blk_type, root_node,
+                                            up_comm, up_comm->c_coll->coll_gatherv_module);
+        if (OMPI_SUCCESS != err) {
+            goto cleanup;
+        }
+        if (rank != root) {
+            err = MCA_PML_CALL(send(lbuf, size * blk_count, blk_type, root,
+                                    MCA_COLL_BASE_TAG_GATHER, MCA_PML_BASE_SEND_STANDARD, comm));
+        } else if (!hier_module->ordered) {
+            err = mca_coll_hier_reorder(hier_module, rdtype, rcount, rbuf, lbuf, true);
+        }
+    } else {
+        err = up_comm->c_coll->coll_gatherv(lbuf, nblocks * blk_count, blk_type,
+                                            NULL, NULL, NULL, blk_type, root_node,
+                                            up_comm, up_comm->c_coll->coll_gatherv_module);
+    }
+
+ cleanup:
+    if (NULL != counts) {
+        free(counts);
+    }
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    return err;
+}
@@ -0,0 +1,393 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/group/group.h"
+#include "ompi/proc/proc.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+#include "coll_hier.h"
+
+static int hier_module_enable(mca_coll_base_module_t *module,
+                              struct ompi_communicator_t *comm);
+
+static void mca_coll_hier_module_construct(mca_coll_hier_module_t *module)
+{
+    memset(&(module->previous), 0, sizeof(module->previous));
+    module->state = MCA_COLL_HIER_UNINIT;
+    module->low_comm = NULL;
+    module->up_comm = NULL;
+    module->nnodes = 0;
+    module->my_node = -1;
+    module->node_sizes = NULL;
+    module->node_offsets = NULL;
+    module->topo_order = NULL;
+    module->rank_to_node = NULL;
+    module->ordered = false;
+}
+
+static void hier_free_topology(mca_coll_hier_module_t *module)
+{
+    if (NULL != module->node_sizes) {
+        free(module->node_sizes);
+        module->node_sizes = NULL;
+    }
+    if (NULL != module->node_offsets) {
+        free(module->node_offsets);
+        module->node_offsets = NULL;
+    }
+    if (NULL != module->topo_order) {
+        free(module->topo_order);
+        module->topo_order = NULL;
+    }
+    if (NULL != module->rank_to_node) {
+        free(module->rank_to_node);
+        module->rank_to_node = NULL;
+    }
+    if (NULL != module->low_comm && MPI_COMM_NULL != module->low_comm) {
+        ompi_comm_free(&module->low_comm);
+    }
+    module->low_comm = NULL;
+    if (NULL != module->up_comm && MPI_COMM_NULL != module->up_comm) {
+        ompi_comm_free(&module->up_comm);
+    }
+    module->up_comm = NULL;
+}
+
+#define HIER_RELEASE_PREVIOUS(m, name)                          \
+    if (NULL != (m)->previous.coll_ ## name ## _module) {       \
+        OBJ_RELEASE((m)->previous.coll_ ## name ## _module);    \
+    }
+
+static void mca_coll_hier_module_destruct(mca_coll_hier_module_t *module)
+{
+    hier_free_topology(module);
+
+    HIER_RELEASE_PREVIOUS(module, allgather);
+    HIER_RELEASE_PREVIOUS(module, allgatherv);
+    HIER_RELEASE_PREVIOUS(module, allreduce);
+    HIER_RELEASE_PREVIOUS(module, barrier);
+    HIER_RELEASE_PREVIOUS(module, bcast);
+    HIER_RELEASE_PREVIOUS(module, gather);
+    HIER_RELEASE_PREVIOUS(module, reduce);
+    HIER_RELEASE_PREVIOUS(module, scatter);
+}
+
+OBJ_CLASS_INSTANCE(mca_coll_hier_module_t, mca_coll_base_module_t,
+                   mca_coll_hier_module_construct,
+                   mca_coll_hier_module_destruct);
+
+/*
+ * Initial query function that is invoked during MPI_INIT, allowing
+ * this component to disqualify itself if it doesn't support the
+ * required level of thread support.
+ */
+int mca_coll_hier_init_query(bool enable_progress_threads,
+                             bool enable_mpi_threads)
+{
+    /* Nothing to do */
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Count the processes of the communicator that share our node.
+ * Processes without a proc structure yet cannot be local, as local
+ * procs are always instantiated (see ompi_proc_complete_init).
+ */
+static void hier_count_local_peers(ompi_communicator_t *comm,
+                                   int *nlocal, int *nremote)
+{
+    ompi_group_t *group = comm->c_local_group;
+
+    *nlocal = *nremote = 0;
+    for (int i = 0 ; i < group->grp_proc_count ; ++i) {
+        ompi_proc_t *proc = ompi_group_get_proc_ptr(group, i, false);
+        if (NULL == proc || ompi_proc_is_sentinel(proc) ||
+            !OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
+            (*nremote)++;
+        } else {
+            (*nlocal)++;
+        }
+    }
+}
+
+/*
+ * Invoked when there's a new communicator that has been created.
+ * Look at the communicator and decide which set of functions and
+ * priority we want to return.
+ */
+mca_coll_base_module_t *
+mca_coll_hier_comm_query(struct ompi_communicator_t *comm, int *priority)
+{
+    mca_coll_hier_module_t *hier_module;
+
+    /* Only intra-communicators with at least two processes */
+    if (OMPI_COMM_IS_INTER(comm) || ompi_comm_size(comm) < 2) {
+        return NULL;
+    }
+
+    *priority = mca_coll_hier_component.hier_priority;
+    if (mca_coll_hier_component.hier_priority <= 0) {
+        return NULL;
+    }
+
+    /* Whether there is a hierarchy is decided in
+       mca_coll_hier_lazy_enable, where all processes agree on it: the
+       locality of our own peers alone would let the processes of the
+       same communicator select different components (e.g. nodes {0,1}
+       and {2}). */
+    hier_module = OBJ_NEW(mca_coll_hier_module_t);
+    if (NULL == hier_module) {
+        return NULL;
+    }
+
+    hier_module->super.coll_module_enable = hier_module_enable;
+    hier_module->super.coll_allgather  = mca_coll_hier_allgather_intra;
+    hier_module->super.coll_allgatherv = mca_coll_hier_allgatherv_intra;
+    hier_module->super.coll_allreduce  = mca_coll_hier_allreduce_intra;
+    hier_module->super.coll_alltoall   = NULL;
+    hier_module->super.coll_alltoallv  = NULL;
+    hier_module->super.coll_alltoallw  = NULL;
+    hier_module->super.coll_barrier    = mca_coll_hier_barrier_intra;
+    hier_module->super.coll_bcast      = mca_coll_hier_bcast_intra;
+    hier_module->super.coll_exscan     = NULL;
+    hier_module->super.coll_gather     = mca_coll_hier_gather_intra;
+    hier_module->super.coll_gatherv    = NULL;
+    hier_module->super.coll_reduce     = mca_coll_hier_reduce_intra;
+    hier_module->super.coll_reduce_scatter = NULL;
+    hier_module->super.coll_scan       = NULL;
+    hier_module->super.coll_scatter    = mca_coll_hier_scatter_intra;
+    hier_module->super.coll_scatterv   = NULL;
+
+    opal_output_verbose(10, mca_coll_hier_component.hier_output,
+                        "coll:hier:comm_query (%d/%s): pick me! pick me!",
+                        comm->c_contextid, comm->c_name);
+    return &(hier_module->super);
+}
+
+/*
+ * Init module on the communicator
+ */
+static int hier_module_enable(mca_coll_base_module_t *module,
+                              struct ompi_communicator_t *comm)
+{
+    bool good = true;
+    char *msg = NULL;
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+
+    /* Save the prior layer of coll functions; they are used as the
+       fallback, and while the sub-communicators are created */
+    hier_module->previous = *comm->c_coll;
+
+#define CHECK_PREVIOUS(name)                                            \
+    if (good && NULL == hier_module->previous.coll_ ## name ## _module) { \
+        good = false;                                                   \
+        msg = #name;                                                    \
+    }
+
+    CHECK_PREVIOUS(allgather);
+    CHECK_PREVIOUS(allgatherv);
+    CHECK_PREVIOUS(allreduce);
+    CHECK_PREVIOUS(barrier);
+    CHECK_PREVIOUS(bcast);
+    CHECK_PREVIOUS(gather);
+    CHECK_PREVIOUS(reduce);
+    CHECK_PREVIOUS(scatter);
+
+    if (!good) {
+        /* Nothing retained yet, so make sure the destructor does not
+           release anything */
+        memset(&hier_module->previous, 0, sizeof(hier_module->previous));
+        opal_output_verbose(10, mca_coll_hier_component.hier_output,
+                            "coll:hier:enable (%d/%s): no underlying %s; disqualifying myself",
+                            comm->c_contextid, comm->c_name, msg);
+        return OMPI_ERR_NOT_FOUND;
+    }
+
+    OBJ_RETAIN(hier_module->previous.coll_allgather_module);
+    OBJ_RETAIN(hier_module->previous.coll_allgatherv_module);
+    OBJ_RETAIN(hier_module->previous.coll_allreduce_module);
+    OBJ_RETAIN(hier_module->previous.coll_barrier_module);
+    OBJ_RETAIN(hier_module->previous.coll_bcast_module);
+    OBJ_RETAIN(hier_module->previous.coll_gather_module);
+    OBJ_RETAIN(hier_module->previous.coll_reduce_module);
+    OBJ_RETAIN(hier_module->previous.coll_scatter_module);
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Create the intra-node and leader communicators, and the tables
+ * mapping global ranks onto the node-major ordering.  This is
+ * collective over comm, and is called on the first hierarchical
+ * collective.  Any failure permanently disables the hierarchical
+ * algorithms on this communicator; since every step is collective,
+ * all processes reach the same conclusion.
+ */
+int mca_coll_hier_lazy_enable(mca_coll_hier_module_t *module,
+                              struct ompi_communicator_t *comm)
+{
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    int low_rank, my_info[2], *all_info = NULL, i, ret;
+    int nlocal, nremote, found[2];
+    ompi_communicator_t *low_comm = NULL, *up_comm = NULL;
+
+    /* ompi_comm_split* run collectives on comm itself.  The SETUP
+       state routes those calls to the previous collectives. */
+    module->state = MCA_COLL_HIER_SETUP;
+
+    /* Without processes on other nodes (e.g. our own intra-node
+       communicator), or without any node hosting two processes (e.g.
+       our leader communicator), there is no hierarchy.  Agree on it
+       before creating any sub-communicator, so the sub-communicators
+       we create do not recursively create their own. */
+    hier_count_local_peers(comm, &nlocal, &nremote);
+    found[0] = (0 != nremote);
+    found[1] = (nlocal >= 2);
+    ret = module->previous.coll_allreduce(MPI_IN_PLACE, found, 2, MPI_INT, MPI_MAX, comm,
+                                          module->previous.coll_allreduce_module);
+    if (OMPI_SUCCESS != ret) {
+        goto disable;
+    }
+    if (0 == found[0] || 0 == found[1]) {
+        opal_output_verbose(10, mca_coll_hier_component.hier_output,
+                            "coll:hier:lazy_enable (%d/%s): no hierarchy (%s)",
+                            comm->c_contextid, comm->c_name,
+                            (0 == found[0]) ? "single node" : "one process per node");
+        module->state = MCA_COLL_HIER_DISABLED;
+        return OMPI_SUCCESS;
+    }
+
+    ret = ompi_comm_split_type(comm, OMPI_COMM_TYPE_NODE, rank, NULL, &low_comm);
+    if (OMPI_SUCCESS != ret) {
+        goto disable;
+    }
+    module->low_comm = low_comm;
+    low_rank = ompi_comm_rank(low_comm);
+
+    ret = ompi_comm_split(comm, (0 == low_rank) ? 0 : MPI_UNDEFINED, rank,
+                          &up_comm, false);
+    if (OMPI_SUCCESS != ret) {
+        goto disable;
+    }
+    module->up_comm = up_comm;
+
+    /* The node index is the rank of the node leader in up_comm */
+    my_info[0] = (0 == low_rank) ? ompi_comm_rank(up_comm) : -1;
+    ret = low_comm->c_coll->coll_bcast(&my_info[0], 1, MPI_INT, 0, low_comm,
+                                       low_comm->c_coll->coll_bcast_module);
+    if (OMPI_SUCCESS != ret) {
+        goto disable;
+    }
+    my_info[1] = low_rank;
+    module->my_node = my_info[0];
+
+    all_info = (int*)malloc(2 * size * sizeof(int));
+    module->node_sizes = (int*)calloc(size, sizeof(int));
+    module->node_offsets = (int*)malloc(size * sizeof(int));
+    module->topo_order = (int*)malloc(size * sizeof(int));
+    module->rank_to_node = (int*)malloc(size * sizeof(int));
+    if (NULL == all_info || NULL == module->node_sizes || NULL == module->node_offsets ||
+        NULL == module->topo_order || NULL == module->rank_to_node) {
+        ret = OMPI_ERR_OUT_OF_RESOURCE;
+        goto disable;
+    }
+
+    ret = module->previous.coll_allgather(my_info, 2, MPI_INT, all_info, 2, MPI_INT, comm,
+                                          module->previous.coll_allgather_module);
+    if (OMPI_SUCCESS != ret) {
+        goto disable;
+    }
+
+    module->nnodes = 0;
+    for (i = 0; i < size; i++) {
+        module->rank_to_node[i] = all_info[2 * i];
+        module->node_sizes[all_info[2 * i]]++;
+        if (all_info[2 * i] >= module->nnodes) {
+            module->nnodes = all_info[2 * i] + 1;
+        }
+    }
+    module->node_offsets[0] = 0;
+    for (i = 1; i < module->nnodes; i++) {
+        module->node_offsets[i] = module->node_offsets[i - 1] + module->node_sizes[i - 1];
+    }
+    module->ordered = true;
+    for (i = 0; i < size; i++) {
+        int pos = module->node_offsets[all_info[2 * i]] + all_info[2 * i + 1];
+        module->topo_order[pos] = i;
+        if (pos != i) {
+            module->ordered = false;
+        }
+    }
+    free(all_info);
+    all_info = NULL;
+
+    /* A flat communicator after all (e.g. sentinel procs that were
+       on-node in disguise).  nnodes is the same everywhere, so all
+       processes fall back together. */
+    if (1 == module->nnodes || size == module->nnodes) {
+        goto disable;
+    }
+
+    opal_output_verbose(10, mca_coll_hier_component.hier_output,
+                        "coll:hier:lazy_enable (%d/%s): %d nodes, node %d has %d procs%s",
+                        comm->c_contextid, comm->c_name, module->nnodes, module->my_node,
+                        module->node_sizes[module->my_node],
+                        module->ordered ? ", block ordered" : "");
+    module->state = MCA_COLL_HIER_ACTIVE;
+    return OMPI_SUCCESS;
+
+ disable:
+    opal_output_verbose(10, mca_coll_hier_component.hier_output,
+                        "coll:hier:lazy_enable (%d/%s): hierarchy not usable (%d), using previous collectives",
+                        comm->c_contextid, comm->c_name, ret);
+    if (NULL != all_info) {
+        free(all_info);
+    }
+    hier_free_topology(module);
+    module->state = MCA_COLL_HIER_DISABLED;
+    return ret;
+}
+
+/*
+ * Move count elements of dtype per process between a buffer in rank
+ * order and a buffer in node-major order, in either direction.
+ */
+int mca_coll_hier_reorder(mca_coll_hier_module_t *module,
+                          struct ompi_datatype_t *dtype, int count,
+                          char *rank_buf, char *node_buf, bool to_rank_order)
+{
+    int i, size = 0, err = OMPI_SUCCESS;
+    ptrdiff_t lb, extent;
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    for (i = 0; i < module->nnodes; i++) {
+        size += module->node_sizes[i];
+    }
+    for (i = 0; i < size && OMPI_SUCCESS == err; i++) {
+        char *rblock = rank_buf + (ptrdiff_t)module->topo_order[i] * count * extent;
+        char *nblock = node_buf + (ptrdiff_t)i * count * extent;
+        err = ompi_datatype_copy_content_same_ddt(dtype, count,
+                                                  to_rank_order ? rblock : nblock,
+                                                  to_rank_order ? nblock : rblock);
+    }
+    return err;
+}
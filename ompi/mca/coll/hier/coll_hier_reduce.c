@@ -0,0 +1,151 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "coll_hier.h"
+
+/*
+ *	reduce
+ *
+ *	Function:	- hierarchical reduce
+ *	Accepts:	- same arguments as MPI_Reduce()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Segments are reduced on the node leaders, and then reduced
+ *	among the leaders onto the leader of the root's node, with the
+ *	inter-node reduction of segment i overlapping the intra-node
+ *	reduction of segment i+1.  If the root is not a leader, the
+ *	result is forwarded to it at the end.
+ */
+int mca_coll_hier_reduce_intra(const void *sbuf, void *rbuf, int count,
+                               struct ompi_datatype_t *dtype,
+                               struct ompi_op_t *op,
+                               int root,
+                               struct ompi_communicator_t *comm,
+                               mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    ompi_request_t *req = MPI_REQUEST_NULL;
+    int rank, root_node, root_leader, segcount, num_segments, step, err = OMPI_SUCCESS;
+    ptrdiff_t extent, lb, gap = 0;
+    char *free_buf = NULL, *accbuf = NULL;
+    bool leader;
+
+    if (!ompi_op_is_commute(op) || mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_reduce(sbuf, rbuf, count, dtype, op, root, comm,
+                                                 hier_module->previous.coll_reduce_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    leader = (0 == ompi_comm_rank(low_comm));
+    root_node = MCA_COLL_HIER_NODE_OF(hier_module, root);
+    root_leader = hier_module->topo_order[hier_module->node_offsets[root_node]];
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    segcount = mca_coll_hier_segcount(dtype, count);
+    num_segments = (0 == segcount) ? 1 : (count + segcount - 1) / segcount;
+
+    /* The leaders accumulate in rbuf if they are the root, in a
+       temporary buffer otherwise */
+    if (leader) {
+        if (rank == root) {
+            accbuf = (char*)rbuf;
+        } else {
+            ptrdiff_t dsize = opal_datatype_span(&dtype->super, count, &gap);
+            free_buf = (char*)malloc(dsize);
+            if (NULL == free_buf && 0 != dsize) {
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+            accbuf = free_buf - gap;
+        }
+    }
+
+#define HIER_SEG_COUNT(s) (((s) == num_segments - 1) ? count - (s) * segcount : segcount)
+#define HIER_SEG_OFFSET(s) ((ptrdiff_t)(s) * segcount * extent)
+
+    for (step = 0; step <= num_segments; step++) {
+        if (step < num_segments) {
+            const void *sseg = (MPI_IN_PLACE == sbuf) ? (const void*)((char*)rbuf + HIER_SEG_OFFSET(step)) :
+                (const void*)((char*)sbuf + HIER_SEG_OFFSET(step));
+            if (leader && MPI_IN_PLACE == sbuf && rank == root) {
+                sseg = MPI_IN_PLACE;
+            }
+            err = low_comm->c_coll->coll_reduce(sseg, leader ? accbuf + HIER_SEG_OFFSET(step) : NULL,
+                                                HIER_SEG_COUNT(step), dtype, op, 0, low_comm,
+                                                low_comm->c_coll->coll_reduce_module);
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+
+        if (!leader) {
+            continue;
+        }
+        if (MPI_REQUEST_NULL != req) {
+            err = ompi_request_wait(&req, MPI_STATUS_IGNORE);
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+        if (step < num_segments) {
+            char *aseg = accbuf + HIER_SEG_OFFSET(step);
+            if (hier_module->my_node == root_node) {
+                err = up_comm->c_coll->coll_ireduce(MPI_IN_PLACE, aseg, HIER_SEG_COUNT(step),
+                                                    dtype, op, root_node, up_comm, &req,
+                                                    up_comm->c_coll->coll_ireduce_module);
+            } else {
+                err = up_comm->c_coll->coll_ireduce(aseg, NULL, HIER_SEG_COUNT(step),
+                                                    dtype, op, root_node, up_comm, &req,
+                                                    up_comm->c_coll->coll_ireduce_module);
+            }
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+    }
+
+#undef HIER_SEG_COUNT
+#undef HIER_SEG_OFFSET
+
+    /* Forward the result to a root that is not a leader */
+    if (root != root_leader) {
+        if (rank == root_leader) {
+            err = MCA_PML_CALL(send(accbuf, count, dtype, root, MCA_COLL_BASE_TAG_REDUCE,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+        } else if (rank == root) {
+            err = MCA_PML_CALL(recv(rbuf, count, dtype, root_leader, MCA_COLL_BASE_TAG_REDUCE,
+                                    comm, MPI_STATUS_IGNORE));
+        }
+    }
+
+ cleanup:
+    if (MPI_REQUEST_NULL != req) {
+        (void) ompi_request_wait(&req, MPI_STATUS_IGNORE);
+    }
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    return err;
+}
@@ -0,0 +1,177 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "coll_hier.h"
+
+/*
+ *	scatter
+ *
+ *	Function:	- hierarchical scatter
+ *	Accepts:	- same arguments as MPI_Scatter()
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	The root arranges its blocks in node-major order (unless the
+ *	communicator is block ordered) and hands them to its leader if
+ *	it is not one.  The leader of the root's node scatterv's the
+ *	node blocks to the other leaders, and each leader scatters
+ *	inside its node.  Leaders other than the root stage the data as
+ *	rcount elements of rdtype per process.
+ */
+int mca_coll_hier_scatter_intra(const void *sbuf, int scount,
+                                struct ompi_datatype_t *sdtype,
+                                void *rbuf, int rcount,
+                                struct ompi_datatype_t *rdtype,
+                                int root,
+                                struct ompi_communicator_t *comm,
+                                mca_coll_base_module_t *module)
+{
+    mca_coll_hier_module_t *hier_module = (mca_coll_hier_module_t*) module;
+    ompi_communicator_t *low_comm, *up_comm;
+    int rank, size, root_node, root_leader, node, nblocks, pos0, blk_count, i;
+    int *counts = NULL, *displs = NULL, err = OMPI_SUCCESS;
+    struct ompi_datatype_t *blk_type, *my_rdtype = rdtype;
+    void *my_rbuf = rbuf;
+    int my_rcount = rcount;
+    ptrdiff_t blk_extent, sextent, lb, gap = 0, dsize;
+    char *free_buf = NULL, *lbuf = NULL;
+
+    if (mca_coll_hier_use_fallback(hier_module, comm)) {
+        return hier_module->previous.coll_scatter(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                                  root, comm,
+                                                  hier_module->previous.coll_scatter_module);
+    }
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    low_comm = hier_module->low_comm;
+    up_comm = hier_module->up_comm;
+    node = hier_module->my_node;
+    root_node = MCA_COLL_HIER_NODE_OF(hier_module, root);
+    root_leader = hier_module->topo_order[hier_module->node_offsets[root_node]];
+
+    if (rank == root) {
+        ompi_datatype_get_extent(sdtype, &lb, &sextent);
+        if (MPI_IN_PLACE == rbuf) {
+            my_rbuf = (char*)sbuf + (ptrdiff_t)rank * scount * sextent;
+            my_rcount = scount;
+            my_rdtype = sdtype;
+        }
+        /* Arrange the blocks in node-major order */
+        if (hier_module->ordered) {
+            lbuf = (char*)sbuf;
+        } else {
+            dsize = opal_datatype_span(&sdtype->super, (int64_t)size * scount, &gap);
+            free_buf = (char*)malloc(dsize);
+            if (NULL == free_buf && 0 != dsize) {
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+            lbuf = free_buf - gap;
+            err = mca_coll_hier_reorder(hier_module, sdtype, scount, (char*)sbuf, lbuf, false);
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+    }
+
+    if (0 != ompi_comm_rank(low_comm)) {
+        if (rank == root) {
+            err = MCA_PML_CALL(send(lbuf, size * scount, sdtype, root_leader,
+                                    MCA_COLL_BASE_TAG_SCATTER, MCA_PML_BASE_SEND_STANDARD, comm));
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+        err = low_comm->c_coll->coll_scatter(NULL, my_rcount, my_rdtype,
+                                             my_rbuf, my_rcount, my_rdtype, 0, low_comm,
+                                             low_comm->c_coll->coll_scatter_module);
+        goto cleanup;
+    }
+
+    /* Layout of the leader buffer: the root node holds all the
+       blocks, the others only their own node */
+    if (rank == root) {
+        blk_type = sdtype;
+        blk_count = scount;
+    } else {
+        blk_type = rdtype;
+        blk_count = rcount;
+    }
+    nblocks = (node == root_node) ? size : hier_module->node_sizes[node];
+    pos0 = (node == root_node) ? hier_module->node_offsets[node] : 0;
+    ompi_datatype_get_extent(blk_type, &lb, &blk_extent);
+
+    if (rank != root) {
+        dsize = opal_datatype_span(&blk_type->super, (int64_t)nblocks * blk_count, &gap);
+        free_buf = (char*)malloc(dsize);
+        if (NULL == free_buf && 0 != dsize) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        lbuf = free_buf - gap;
+        if (node == root_node) {
+            err = MCA_PML_CALL(recv(lbuf, size * blk_count, blk_type, root,
+                                    MCA_COLL_BASE_TAG_SCATTER, comm, MPI_STATUS_IGNORE));
+            if (OMPI_SUCCESS != err) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* Inter-node step */
+    if (node == root_node) {
+        counts = (int*)malloc(2 * hier_module->nnodes * sizeof(int));
+        if (NULL == counts) {
+            err = OMPI_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        displs = counts + hier_module->nnodes;
+        for (i = 0; i < hier_module->nnodes; i++) {
+            counts[i] = hier_module->node_sizes[i] * blk_count;
+            displs[i] = hier_module->node_offsets[i] * blk_count;
+        }
+        err = up_comm->c_coll->coll_scatterv(lbuf, counts, displs, blk_type,
+                                             MPI_IN_PLACE, 0, blk_type, root_node,
+                                             up_comm, up_comm->c_coll->coll_scatterv_module);
+    } else {
+        err = up_comm->c_coll->coll_scatterv(NULL, NULL, NULL, blk_type,
+                                             lbuf, nblocks * blk_count, blk_type, root_node,
+                                             up_comm, up_comm->c_coll->coll_scatterv_module);
+    }
+    if (OMPI_SUCCESS != err) {
+        goto cleanup;
+    }
+
+    /* Intra-node step */
+    err = low_comm->c_coll->coll_scatter(lbuf + (ptrdiff_t)pos0 * blk_count * blk_extent,
+                                         blk_count, blk_type,
+                                         (rank == root && MPI_IN_PLACE == rbuf) ? MPI_IN_PLACE : rbuf,
+                                         rcount, rdtype, 0, low_comm,
+                                         low_comm->c_coll->coll_scatter_module);
+
+ cleanup:
+    if (NULL != counts) {
+        free(counts);
+    }
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    return err;
+}
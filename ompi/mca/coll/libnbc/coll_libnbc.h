@@ -38,20 +38,6 @@ BEGIN_C_DECLS
 /* the debug level */
 #define NBC_DLEVEL 0
 
-/* enable schedule caching - undef NBC_CACHE_SCHEDULE to deactivate it */
-/* TODO: this whole schedule cache stuff does not work with the tmbuf
- * :-( - first, the tmpbuf must not be freed if a schedule using it is
- * still in the cache and second, the tmpbuf used by the schedule must
- * be attached to the handle that uses this schedule !!!!
- * I.E., THIS IS EXPERIMENTAL AND MIGHT NOT WORK */
-/* It also leaks memory because the schedule is never cleaned up when
-   the communicator is destroyed, so don't use it for now */
-#ifdef NBC_CACHE_SCHEDULE
-#undef NBC_CACHE_SCHEDULE
-#endif
-#define NBC_SCHED_DICT_UPPER 1024 /* max. number of dict entries */
-#define NBC_SCHED_DICT_LOWER 512  /* nuber of dict entries after wipe, if SCHED_DICT_UPPER is reached */
-
 /********************* end of LibNBC tuning parameters ************************/
 
 /* Function return codes  */
@@ -67,23 +53,29 @@ BEGIN_C_DECLS
 #define NBC_INVALID_TOPOLOGY_COMM 8 /* invalid topology attached to communicator */
 
 /* number of implemented collective functions */
-#define NBC_NUM_COLL 17
+#define NBC_NUM_COLL 22
 
 extern bool libnbc_ibcast_skip_dt_decision;
 extern int libnbc_iallgather_algorithm;
 extern int libnbc_iallreduce_algorithm;
+extern size_t libnbc_iallreduce_fusion_msg_size;
+extern size_t libnbc_iallreduce_fusion_size;
+extern int libnbc_iallreduce_fusion_window;
 extern int libnbc_ibcast_algorithm;
 extern int libnbc_ibcast_knomial_radix;
 extern int libnbc_iexscan_algorithm;
 extern int libnbc_ireduce_algorithm;
 extern int libnbc_iscan_algorithm;
+extern size_t libnbc_neighbor_combine_size;
+extern int libnbc_schedule_cache_size;
 
 struct ompi_coll_libnbc_component_t {
     mca_coll_base_component_2_0_0_t super;
     opal_free_list_t requests;
     opal_list_t active_requests;
     opal_atomic_int32_t active_comms;
-    opal_mutex_t lock;                /* protect access to the active_requests list */
+    opal_list_t fusions;              /* communicators with fused iallreduces in flight */
+    opal_mutex_t lock;                /* protect access to the active_requests and fusions lists */
 };
 typedef struct ompi_coll_libnbc_component_t ompi_coll_libnbc_component_t;
 
@@ -95,25 +87,42 @@ struct ompi_coll_libnbc_module_t {
     opal_mutex_t mutex;
     bool comm_registered;
     int tag;
-#ifdef NBC_CACHE_SCHEDULE
-  void *NBC_Dict[NBC_NUM_COLL]; /* this should point to a struct
-                                      hb_tree, but since this is a
-                                      public header-file, this would be
-                                      an include mess :-(. So let's void
-                                      it ...*/
-  int NBC_Dict_size[NBC_NUM_COLL];
-#endif
+    struct ompi_coll_libnbc_fusion_t *fusion; /* fused iallreduces, NULL until used */
+    struct ompi_coll_libnbc_cache_t *cache;   /* schedule cache, NULL until used */
+    struct ompi_coll_libnbc_combine_t *combine; /* neighbor combining plan, NULL without a graph topology */
 };
 typedef struct ompi_coll_libnbc_module_t ompi_coll_libnbc_module_t;
 OBJ_CLASS_DECLARATION(ompi_coll_libnbc_module_t);
 
 typedef ompi_coll_libnbc_module_t NBC_Comminfo;
 
+/* a schedule is a sequence of rounds of operations, stored as a structure
+ * of arrays (see nbc_internal.h) */
 struct NBC_Schedule {
     opal_object_t super;
-    volatile int size;
-    volatile int current_round_offset;
-    char *data;
+    int num_ops;              /* number of operations */
+    int max_ops;              /* size of the arrays of the operations */
+    int num_local;            /* number of local operations (OP, COPY, UNPACK) */
+    int max_local;            /* size of the arrays of the local operations */
+    int num_rounds;           /* number of rounds */
+    int max_rounds;           /* size of round_start - 1 */
+    int round_reqs;           /* number of requests of the last round */
+    int max_round_reqs;       /* largest number of requests of a round */
+    int *round_start;         /* round r is made of the operations round_start[r]
+                               * to round_start[r + 1] - 1 */
+    /* arguments of the operations */
+    void **buf;               /* buffer, or offset into the temporary buffer */
+    MPI_Datatype *datatype;
+    int *count;
+    int *peer;                /* peer of a SEND/RECV, index of the local
+                               * arguments of an OP/COPY/UNPACK */
+    char *type;               /* NBC_Fn_type */
+    char *flags;              /* NBC_SCHED_* flags */
+    /* arguments of the local operations */
+    void **buf2;              /* second buffer (or offset) */
+    MPI_Datatype *datatype2;
+    MPI_Op *op;
+    int *count2;
 };
 
 typedef struct NBC_Schedule NBC_Schedule;
@@ -123,11 +132,12 @@ OBJ_CLASS_DECLARATION(NBC_Schedule);
 struct ompi_coll_libnbc_request_t {
     ompi_coll_base_nbc_request_t super;
     MPI_Comm comm;
-    long row_offset;
+    int round; /* current round of the schedule */
     bool nbc_complete; /* status in libnbc level */
     int tag;
     volatile int req_count;
-    ompi_request_t **req_array;
+    int req_array_size;
+    ompi_request_t **req_array; /* kept with the handle when it is returned */
     NBC_Comminfo *comminfo;
     NBC_Schedule *schedule;
     void *tmpbuf; /* temporary buffer e.g. used for Reduce */
@@ -157,6 +167,8 @@ typedef ompi_coll_libnbc_request_t NBC_Handle;
     } while (0)
 
 int ompi_coll_libnbc_progress(void);
+int ompi_coll_libnbc_progress_thread_start(void);
+void ompi_coll_libnbc_progress_thread_stop(void);
 
 int NBC_Init_comm(MPI_Comm comm, ompi_coll_libnbc_module_t *module);
 int NBC_Progress(NBC_Handle *handle);
@@ -33,7 +33,13 @@
 
 #include "mpi.h"
 #include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
 #include "ompi/communicator/communicator.h"
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/threads/threads.h"
+
+#include <time.h>
 
 /*
  * Public string showing the coll ompi_libnbc component version number
@@ -44,7 +50,15 @@ const char *mca_coll_libnbc_component_version_string =
 
 static int libnbc_priority = 10;
 static bool libnbc_in_progress = false;     /* protect from recursive calls */
+
+static bool libnbc_progress_thread = false;         /* progress the schedules from a thread */
+static int libnbc_progress_thread_core = -1;        /* core the thread is bound to, -1 for none */
+static int libnbc_progress_thread_idle_usec = 50;   /* sleep time of the thread without requests */
+static opal_thread_t libnbc_progress_thread_obj;
+static opal_mutex_t libnbc_progress_thread_lock;    /* serialize the start and stop of the thread */
+static volatile bool libnbc_progress_thread_running = false;
 bool libnbc_ibcast_skip_dt_decision = true;
+int libnbc_schedule_cache_size = 64;           /* schedules cached per communicator, 0 disables the cache */
 
 int libnbc_iallgather_algorithm = 0;             /* iallgather user forced algorithm */
 static mca_base_var_enum_value_t iallgather_algorithms[] = {
@@ -64,6 +78,10 @@ static mca_base_var_enum_value_t iallreduce_algorithms[] = {
     {0, NULL}
 };
 
+size_t libnbc_iallreduce_fusion_msg_size = 0;   /* largest fused iallreduce, 0 disables the fusion */
+size_t libnbc_iallreduce_fusion_size = 65536;   /* largest fused buffer */
+int libnbc_iallreduce_fusion_window = 100;      /* usec a fused iallreduce waits for the next ones */
+
 int libnbc_ibcast_algorithm = 0;             /* ibcast user forced algorithm */
 int libnbc_ibcast_knomial_radix = 4;
 static mca_base_var_enum_value_t ibcast_algorithms[] = {
@@ -100,12 +118,15 @@ static mca_base_var_enum_value_t iscan_algorithms[] = {
     {0, NULL}
 };
 
+size_t libnbc_neighbor_combine_size = 4096;  /* largest combined neighbor message, 0 disables the combining */
+
 static int libnbc_open(void);
 static int libnbc_close(void);
 static int libnbc_register(void);
 static int libnbc_init_query(bool, bool);
 static mca_coll_base_module_t *libnbc_comm_query(struct ompi_communicator_t *, int *);
 static int libnbc_module_enable(mca_coll_base_module_t *, struct ompi_communicator_t *);
+static int libnbc_module_topo(mca_coll_base_module_t *, struct ompi_communicator_t *);
 
 /*
  * Instantiate the public struct with all of our public information
@@ -146,8 +167,10 @@ libnbc_open(void)
 {
     int ret;
 
+    OBJ_CONSTRUCT(&libnbc_progress_thread_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&mca_coll_libnbc_component.requests, opal_free_list_t);
     OBJ_CONSTRUCT(&mca_coll_libnbc_component.active_requests, opal_list_t);
+    OBJ_CONSTRUCT(&mca_coll_libnbc_component.fusions, opal_list_t);
     OBJ_CONSTRUCT(&mca_coll_libnbc_component.lock, opal_mutex_t);
     ret = opal_free_list_init (&mca_coll_libnbc_component.requests,
                                sizeof(ompi_coll_libnbc_request_t), 8,
@@ -166,11 +189,14 @@ static int
 libnbc_close(void)
 {
     if (0 != mca_coll_libnbc_component.active_comms) {
+        ompi_coll_libnbc_progress_thread_stop();
         opal_progress_unregister(ompi_coll_libnbc_progress);
     }
+    OBJ_DESTRUCT(&libnbc_progress_thread_lock);
 
     OBJ_DESTRUCT(&mca_coll_libnbc_component.requests);
     OBJ_DESTRUCT(&mca_coll_libnbc_component.active_requests);
+    OBJ_DESTRUCT(&mca_coll_libnbc_component.fusions);
     OBJ_DESTRUCT(&mca_coll_libnbc_component.lock);
 
     return OMPI_SUCCESS;
@@ -212,6 +238,42 @@ libnbc_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &libnbc_ibcast_skip_dt_decision);
 
+    libnbc_schedule_cache_size = 64;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "schedule_cache_size",
+                                           "Number of schedules cached per communicator, so that a non-blocking collective called again with the same arguments (the buffers excepted) does not build its schedule again, 0 disables the cache",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_schedule_cache_size);
+
+    libnbc_progress_thread = false;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "progress_thread",
+                                           "Progress the non-blocking collectives from a dedicated thread, so they advance while the application computes (requires MPI_THREAD_MULTIPLE, ignored otherwise)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_progress_thread);
+
+    libnbc_progress_thread_core = -1;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "progress_thread_core",
+                                           "Logical index of the core the progress thread is bound to, -1 to leave it unbound",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_progress_thread_core);
+
+    libnbc_progress_thread_idle_usec = 50;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "progress_thread_idle_usec",
+                                           "Time (in microseconds) the progress thread sleeps when there is no active non-blocking collective",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_progress_thread_idle_usec);
+
     libnbc_iallgather_algorithm = 0;
     (void) mca_base_var_enum_create("coll_libnbc_iallgather_algorithms", iallgather_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
@@ -232,6 +294,33 @@ libnbc_register(void)
                                     &libnbc_iallreduce_algorithm);
     OBJ_RELEASE(new_enum);
 
+    libnbc_iallreduce_fusion_msg_size = 0;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "iallreduce_fusion_msg_size",
+                                           "Non-blocking allreduces of a predefined datatype up to this size (in bytes) are fused together before being started, 0 disables the fusion",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_iallreduce_fusion_msg_size);
+
+    libnbc_iallreduce_fusion_size = 65536;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "iallreduce_fusion_size",
+                                           "Size (in bytes) of the data of the fused non-blocking allreduces after which they are started",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_iallreduce_fusion_size);
+
+    libnbc_iallreduce_fusion_window = 100;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "iallreduce_fusion_window",
+                                           "Time (in microseconds) after which the fused non-blocking allreduces are started even if they are smaller than iallreduce_fusion_size",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_iallreduce_fusion_window);
+
     libnbc_ibcast_algorithm = 0;
     (void) mca_base_var_enum_create("coll_libnbc_ibcast_algorithms", ibcast_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
@@ -280,6 +369,15 @@ libnbc_register(void)
                                     &libnbc_iscan_algorithm);
     OBJ_RELEASE(new_enum);
 
+    libnbc_neighbor_combine_size = 4096;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "neighbor_combine_size",
+                                           "Non-blocking neighbor allgathers and alltoalls on graph and distributed graph topologies sending up to this size (in bytes) to each neighbor send a single message to each remote node, forwarded there to the other neighbors, 0 disables the combining (Cartesian topologies and the v and w variants are not combined)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_neighbor_combine_size);
+
     return OMPI_SUCCESS;
 }
 
@@ -292,10 +390,103 @@ static int
 libnbc_init_query(bool enable_progress_threads,
                   bool enable_mpi_threads)
 {
-    /* Nothing to do */
+    if (libnbc_progress_thread && !enable_mpi_threads) {
+        /* the progress thread calls into the PML concurrently with the
+         * application, which is only safe if the library already protects
+         * itself, i.e. with MPI_THREAD_MULTIPLE */
+        opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                            "coll:libnbc: the progress thread requires MPI_THREAD_MULTIPLE, disabling it");
+        libnbc_progress_thread = false;
+    }
+
     return OMPI_SUCCESS;
 }
 
+static void *
+libnbc_progress_thread_engine(opal_object_t *obj)
+{
+    struct timespec idle = { .tv_sec = libnbc_progress_thread_idle_usec / 1000000,
+                             .tv_nsec = (libnbc_progress_thread_idle_usec % 1000000) * 1000 };
+
+    if (0 <= libnbc_progress_thread_core) {
+        hwloc_obj_t core = NULL;
+
+        if (OPAL_SUCCESS == opal_hwloc_base_get_topology()) {
+            core = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_CORE,
+                                         libnbc_progress_thread_core);
+        }
+        if (NULL == core ||
+            0 != hwloc_set_cpubind(opal_hwloc_topology, core->cpuset, HWLOC_CPUBIND_THREAD)) {
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "coll:libnbc: cannot bind the progress thread to core %d",
+                                libnbc_progress_thread_core);
+        }
+    }
+
+    while (libnbc_progress_thread_running) {
+        if (0 != opal_list_get_size (&mca_coll_libnbc_component.active_requests) ||
+            0 != opal_list_get_size (&mca_coll_libnbc_component.fusions)) {
+            /* drive the schedules and the underlying PML */
+            opal_progress();
+        } else {
+            nanosleep(&idle, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Start the progress thread, if requested, when the first communicator
+ * starts a non-blocking collective.
+ */
+int
+ompi_coll_libnbc_progress_thread_start(void)
+{
+    int ret = OMPI_SUCCESS;
+
+    if (!libnbc_progress_thread) {
+        return OMPI_SUCCESS;
+    }
+
+    OPAL_THREAD_LOCK(&libnbc_progress_thread_lock);
+    if (!libnbc_progress_thread_running) {
+        OBJ_CONSTRUCT(&libnbc_progress_thread_obj, opal_thread_t);
+        libnbc_progress_thread_obj.t_run = libnbc_progress_thread_engine;
+        libnbc_progress_thread_obj.t_arg = NULL;
+        libnbc_progress_thread_running = true;
+        ret = opal_thread_start(&libnbc_progress_thread_obj);
+        if (OPAL_SUCCESS != ret) {
+            /* fall back to the progress from the application calls */
+            libnbc_progress_thread_running = false;
+            OBJ_DESTRUCT(&libnbc_progress_thread_obj);
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "coll:libnbc: cannot start the progress thread (%d)", ret);
+        }
+    }
+    OPAL_THREAD_UNLOCK(&libnbc_progress_thread_lock);
+
+    return ret;
+}
+
+/*
+ * Stop the progress thread once no communicator uses libnbc anymore, which
+ * happens before the PML is finalized.
+ */
+void
+ompi_coll_libnbc_progress_thread_stop(void)
+{
+    void *ret;
+
+    OPAL_THREAD_LOCK(&libnbc_progress_thread_lock);
+    if (libnbc_progress_thread_running) {
+        libnbc_progress_thread_running = false;
+        opal_thread_join(&libnbc_progress_thread_obj, &ret);
+        OBJ_DESTRUCT(&libnbc_progress_thread_obj);
+    }
+    OPAL_THREAD_UNLOCK(&libnbc_progress_thread_lock);
+}
+
 /*
  * Invoked when there's a new communicator that has been created.
  * Look at the communicator and decide which set of functions and
@@ -313,6 +504,7 @@ libnbc_comm_query(struct ompi_communicator_t *comm,
     *priority = libnbc_priority;
 
     module->super.coll_module_enable = libnbc_module_enable;
+    module->super.coll_module_topo = libnbc_module_topo;
     if (OMPI_COMM_IS_INTER(comm)) {
         module->super.coll_iallgather = ompi_coll_libnbc_iallgather_inter;
         module->super.coll_iallgatherv = ompi_coll_libnbc_iallgatherv_inter;
@@ -422,13 +614,25 @@ libnbc_module_enable(mca_coll_base_module_t *module,
 }
 
 
+/*
+ * Prepare the neighbor collectives of a new graph topology
+ */
+static int
+libnbc_module_topo(mca_coll_base_module_t *module,
+                   struct ompi_communicator_t *comm)
+{
+    return NBC_Combine_setup(comm, (ompi_coll_libnbc_module_t *) module);
+}
+
+
 int
 ompi_coll_libnbc_progress(void)
 {
     ompi_coll_libnbc_request_t* request, *next;
     int res;
 
-    if (0 == opal_list_get_size (&mca_coll_libnbc_component.active_requests)) {
+    if (0 == opal_list_get_size (&mca_coll_libnbc_component.active_requests) &&
+        0 == opal_list_get_size (&mca_coll_libnbc_component.fusions)) {
         /* no requests -- nothing to do. do not grab a lock */
         return 0;
     }
@@ -459,7 +663,7 @@ ompi_coll_libnbc_progress(void)
                 }
                 if(request->super.super.req_persistent) {
                     /* reset for the next communication */
-                    request->row_offset = 0;
+                    request->round = 0;
                 }
                 if(!request->super.super.req_persistent || !REQUEST_COMPLETE(&request->super.super)) {
             	    ompi_request_complete(&request->super.super, true);
@@ -467,6 +671,12 @@ ompi_coll_libnbc_progress(void)
             }
             OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
         }
+
+        if (0 != opal_list_get_size (&mca_coll_libnbc_component.fusions)) {
+            OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+            NBC_Fusion_progress();
+            OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+        }
         libnbc_in_progress = false;
     }
     OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
@@ -480,12 +690,18 @@ libnbc_module_construct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_CONSTRUCT(&module->mutex, opal_mutex_t);
     module->comm_registered = false;
+    module->fusion = NULL;
+    module->cache = NULL;
+    module->combine = NULL;
 }
 
 
 static void
 libnbc_module_destruct(ompi_coll_libnbc_module_t *module)
 {
+    NBC_Fusion_release(module);
+    NBC_Cache_release(module);
+    NBC_Combine_release(module);
     OBJ_DESTRUCT(&module->mutex);
 
     /* if we ever were used for a collective op, do the progress cleanup. */
@@ -493,6 +709,7 @@ libnbc_module_destruct(ompi_coll_libnbc_module_t *module)
         int32_t tmp =
             OPAL_THREAD_ADD_FETCH32(&mca_coll_libnbc_component.active_comms, -1);
         if (0 == tmp) {
+            ompi_coll_libnbc_progress_thread_stop();
             opal_progress_unregister(ompi_coll_libnbc_progress);
         }
     }
@@ -520,9 +737,9 @@ request_start(size_t count, ompi_request_t ** requests)
         NBC_DEBUG(5, "--------------------------------\n");
         NBC_DEBUG(5, "schedule %p size %u\n", &schedule, sizeof(schedule));
         NBC_DEBUG(5, "handle %p size %u\n", &handle, sizeof(handle));
-        NBC_DEBUG(5, "data %p size %u\n", &schedule->data, sizeof(schedule->data));
-        NBC_DEBUG(5, "req_array %p size %u\n", &handle->req_array, sizeof(handle->req_array));
-        NBC_DEBUG(5, "row_offset=%u address=%p size=%u\n", handle->row_offset, &handle->row_offset, sizeof(handle->row_offset));
+        NBC_DEBUG(5, "num_ops=%i num_rounds=%i\n", schedule->num_ops, schedule->num_rounds);
+        NBC_DEBUG(5, "req_array %p size %i\n", handle->req_array, handle->req_array_size);
+        NBC_DEBUG(5, "round=%i address=%p size=%u\n", handle->round, &handle->round, sizeof(handle->round));
         NBC_DEBUG(5, "req_count=%u address=%p size=%u\n", handle->req_count, &handle->req_count, sizeof(handle->req_count));
         NBC_DEBUG(5, "tmpbuf address=%p size=%u\n", handle->tmpbuf, sizeof(handle->tmpbuf));
         NBC_DEBUG(5, "--------------------------------\n");
@@ -576,10 +793,20 @@ request_construct(ompi_coll_libnbc_request_t *request)
     request->super.super.req_start = request_start;
     request->super.super.req_free = request_free;
     request->super.super.req_cancel = request_cancel;
+    request->req_array = NULL;
+    request->req_array_size = 0;
+}
+
+
+static void
+request_destruct(ompi_coll_libnbc_request_t *request)
+{
+    free(request->req_array);
+    request->req_array = NULL;
 }
 
 
 OBJ_CLASS_INSTANCE(ompi_coll_libnbc_request_t,
                    ompi_coll_base_nbc_request_t,
                    request_construct,
-                   NULL);
+                   request_destruct);
@@ -44,101 +44,182 @@ void NBC_Print_times(double div) {
 }
 #endif
 
+/* the arrays of the operations of a schedule are allocated in a single
+ * block, and so are those of the local operations, both in decreasing
+ * order of alignment */
+#define NBC_SCHED_OP_SIZE (sizeof (void *) + sizeof (MPI_Datatype) + 2 * sizeof (int) + 2 * sizeof (char))
+#define NBC_SCHED_LOCAL_SIZE (sizeof (void *) + sizeof (MPI_Datatype) + sizeof (MPI_Op) + sizeof (int))
+
+static void nbc_schedule_set_ops (NBC_Schedule *schedule, char *block, int size) {
+  schedule->buf = (void **) block;
+  schedule->datatype = (MPI_Datatype *) (schedule->buf + size);
+  schedule->count = (int *) (schedule->datatype + size);
+  schedule->peer = schedule->count + size;
+  schedule->type = (char *) (schedule->peer + size);
+  schedule->flags = schedule->type + size;
+  schedule->max_ops = size;
+}
+
+static void nbc_schedule_set_local (NBC_Schedule *schedule, char *block, int size) {
+  schedule->buf2 = (void **) block;
+  schedule->datatype2 = (MPI_Datatype *) (schedule->buf2 + size);
+  schedule->op = (MPI_Op *) (schedule->datatype2 + size);
+  schedule->count2 = (int *) (schedule->op + size);
+  schedule->max_local = size;
+}
+
+/* copies the first num operations of src into dst */
+static void nbc_schedule_copy_ops (NBC_Schedule *dst, const NBC_Schedule *src, int num) {
+  memcpy (dst->buf, src->buf, num * sizeof (*src->buf));
+  memcpy (dst->datatype, src->datatype, num * sizeof (*src->datatype));
+  memcpy (dst->count, src->count, num * sizeof (*src->count));
+  memcpy (dst->peer, src->peer, num * sizeof (*src->peer));
+  memcpy (dst->type, src->type, num * sizeof (*src->type));
+  memcpy (dst->flags, src->flags, num * sizeof (*src->flags));
+}
+
+static void nbc_schedule_copy_local (NBC_Schedule *dst, const NBC_Schedule *src, int num) {
+  memcpy (dst->buf2, src->buf2, num * sizeof (*src->buf2));
+  memcpy (dst->datatype2, src->datatype2, num * sizeof (*src->datatype2));
+  memcpy (dst->op, src->op, num * sizeof (*src->op));
+  memcpy (dst->count2, src->count2, num * sizeof (*src->count2));
+}
+
 static void nbc_schedule_constructor (NBC_Schedule *schedule) {
-  /* initial total size of the schedule */
-  schedule->size = sizeof (int);
-  schedule->current_round_offset = 0;
-  schedule->data = calloc (1, schedule->size);
+  schedule->num_ops = schedule->max_ops = 0;
+  schedule->num_local = schedule->max_local = 0;
+  schedule->round_reqs = schedule->max_round_reqs = 0;
+  schedule->buf = NULL;
+  schedule->buf2 = NULL;
+
+  /* a schedule starts with an empty round */
+  schedule->num_rounds = 1;
+  schedule->max_rounds = 3;
+  schedule->round_start = calloc (schedule->max_rounds + 1, sizeof (int));
 }
 
 static void nbc_schedule_destructor (NBC_Schedule *schedule) {
-  free (schedule->data);
-  schedule->data = NULL;
+  free (schedule->round_start);
+  schedule->round_start = NULL;
+  /* the blocks of the arrays */
+  free (schedule->buf);
+  schedule->buf = NULL;
+  free (schedule->buf2);
+  schedule->buf2 = NULL;
 }
 
 OBJ_CLASS_INSTANCE(NBC_Schedule, opal_object_t, nbc_schedule_constructor,
                    nbc_schedule_destructor);
 
-static int nbc_schedule_grow (NBC_Schedule *schedule, int additional) {
-  void *tmp;
-  int size;
+/* makes room for one more operation, and one more local operation if
+ * local is true */
+static int nbc_schedule_grow (NBC_Schedule *schedule, bool local) {
+  if (OPAL_UNLIKELY(NULL == schedule->round_start)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+
+  if (schedule->num_ops == schedule->max_ops) {
+    NBC_Schedule old = *schedule;
+    int size = old.max_ops ? 2 * old.max_ops : 16;
+    char *block = malloc (size * NBC_SCHED_OP_SIZE);
 
-  /* get current size of schedule */
-  size = nbc_schedule_get_size (schedule);
+    if (NULL == block) {
+      NBC_Error ("Could not increase the size of NBC schedule");
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    nbc_schedule_set_ops (schedule, block, size);
+    nbc_schedule_copy_ops (schedule, &old, old.num_ops);
+    free (old.buf);
+  }
 
-  tmp = realloc (schedule->data, size + additional);
-  if (NULL == tmp) {
-    NBC_Error ("Could not increase the size of NBC schedule");
-    return OMPI_ERR_OUT_OF_RESOURCE;
+  if (local && schedule->num_local == schedule->max_local) {
+    NBC_Schedule old = *schedule;
+    int size = old.max_local ? 2 * old.max_local : 4;
+    char *block = malloc (size * NBC_SCHED_LOCAL_SIZE);
+
+    if (NULL == block) {
+      NBC_Error ("Could not increase the size of NBC schedule");
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    nbc_schedule_set_local (schedule, block, size);
+    nbc_schedule_copy_local (schedule, &old, old.num_local);
+    free (old.buf2);
   }
 
-  schedule->data = tmp;
   return OMPI_SUCCESS;
 }
 
-static int nbc_schedule_round_append (NBC_Schedule *schedule, void *data, int data_size, bool barrier) {
-  int ret, size = nbc_schedule_get_size (schedule);
+/* appends an operation to the last round of the schedule, and returns its
+ * index, or -1 if out of memory. The arguments of a local operation
+ * are at peer[index] in the arrays of the local operations. */
+static int nbc_schedule_append (NBC_Schedule *schedule, NBC_Fn_type type, const void *buf,
+                                int count, MPI_Datatype datatype, int peer, char flags) {
+  bool local = SEND != type && RECV != type;
+  int i = schedule->num_ops;
 
-  if (barrier) {
-    ret = nbc_schedule_grow (schedule, data_size + 1 + sizeof (int));
-  } else {
-    ret = nbc_schedule_grow (schedule, data_size);
+  if (OMPI_SUCCESS != nbc_schedule_grow (schedule, local)) {
+    return -1;
   }
-  if (OMPI_SUCCESS != ret) {
-    return ret;
+
+  schedule->buf[i] = (void *) buf;
+  schedule->datatype[i] = datatype;
+  schedule->count[i] = count;
+  schedule->peer[i] = local ? schedule->num_local++ : peer;
+  schedule->type[i] = (char) type;
+  schedule->flags[i] = flags;
+
+  schedule->round_start[schedule->num_rounds] = ++schedule->num_ops;
+  if (!local && ++schedule->round_reqs > schedule->max_round_reqs) {
+    schedule->max_round_reqs = schedule->round_reqs;
   }
 
-  /* append to the round-schedule */
-  if (data_size) {
-    memcpy (schedule->data + size, data, data_size);
+  return i;
+}
 
-    /* increase number of elements in round-schedule */
-    nbc_schedule_inc_round (schedule);
+/* this function ends a round of a schedule */
+int NBC_Sched_barrier (NBC_Schedule *schedule) {
+  if (OPAL_UNLIKELY(NULL == schedule->round_start)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    /* increase size of schedule */
-    nbc_schedule_inc_size (schedule, data_size);
+  if (schedule->num_rounds == schedule->max_rounds) {
+    int *tmp = realloc (schedule->round_start, (2 * schedule->max_rounds + 1) * sizeof (int));
+
+    if (NULL == tmp) {
+      NBC_Error ("Could not increase the size of NBC schedule");
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    schedule->round_start = tmp;
+    schedule->max_rounds *= 2;
   }
 
-  if (barrier) {
-    /* add the barrier */
-    schedule->data[size + data_size] = 1;
-    /* set next round counter to 0 */
-    memset (schedule->data + size + data_size + 1, 0, sizeof (int));
+  /* the new round is empty */
+  schedule->round_start[++schedule->num_rounds] = schedule->num_ops;
+  schedule->round_reqs = 0;
 
-    NBC_DEBUG(10, "ended round at byte %i\n", size + data_size + 1);
+  NBC_DEBUG(10, "ended round %i at operation %i\n", schedule->num_rounds - 2, schedule->num_ops);
 
-    schedule->current_round_offset = size + data_size + 1;
+  return OMPI_SUCCESS;
+}
 
-    /* increase size of schedule */
-    nbc_schedule_inc_size (schedule, sizeof (int) + 1);
+static inline int nbc_schedule_end_op (NBC_Schedule *schedule, int i, bool barrier) {
+  if (i < 0) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-  return OMPI_SUCCESS;
+  return barrier ? NBC_Sched_barrier (schedule) : OMPI_SUCCESS;
 }
 
 /* this function puts a send into the schedule */
 static int NBC_Sched_send_internal (const void* buf, char tmpbuf, int count, MPI_Datatype datatype, int dest, bool local, NBC_Schedule *schedule, bool barrier) {
-  NBC_Args_send send_args;
-  int ret;
-
-  /* store the passed arguments */
-  send_args.type = SEND;
-  send_args.buf = buf;
-  send_args.tmpbuf = tmpbuf;
-  send_args.count = count;
-  send_args.datatype = datatype;
-  send_args.dest = dest;
-  send_args.local = local;
+  int i;
 
-  /* append to the round-schedule */
-  ret = nbc_schedule_round_append (schedule, &send_args, sizeof (send_args), barrier);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
-  }
+  i = nbc_schedule_append (schedule, SEND, buf, count, datatype, dest,
+                           (tmpbuf ? NBC_SCHED_TMPBUF1 : 0) | (local ? NBC_SCHED_LOCAL : 0));
 
-  NBC_DEBUG(10, "added send - ends at byte %i\n", nbc_schedule_get_size (schedule));
+  NBC_DEBUG(10, "added send - operation %i\n", i);
 
-  return OMPI_SUCCESS;
+  return nbc_schedule_end_op (schedule, i, barrier);
 }
 
 int NBC_Sched_send (const void* buf, char tmpbuf, int count, MPI_Datatype datatype, int dest, NBC_Schedule *schedule, bool barrier) {
@@ -151,27 +232,14 @@ int NBC_Sched_local_send (const void* buf, char tmpbuf, int count, MPI_Datatype
 
 /* this function puts a receive into the schedule */
 static int NBC_Sched_recv_internal (void* buf, char tmpbuf, int count, MPI_Datatype datatype, int source, bool local, NBC_Schedule *schedule, bool barrier) {
-  NBC_Args_recv recv_args;
-  int ret;
+  int i;
 
-  /* store the passed arguments */
-  recv_args.type = RECV;
-  recv_args.buf = buf;
-  recv_args.tmpbuf = tmpbuf;
-  recv_args.count = count;
-  recv_args.datatype = datatype;
-  recv_args.source = source;
-  recv_args.local = local;
+  i = nbc_schedule_append (schedule, RECV, buf, count, datatype, source,
+                           (tmpbuf ? NBC_SCHED_TMPBUF1 : 0) | (local ? NBC_SCHED_LOCAL : 0));
 
-  /* append to the round-schedule */
-  ret = nbc_schedule_round_append (schedule, &recv_args, sizeof (recv_args), barrier);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
-  }
-
-  NBC_DEBUG(10, "added receive - ends at byte %d\n", nbc_schedule_get_size (schedule));
+  NBC_DEBUG(10, "added receive - operation %i\n", i);
 
-  return OMPI_SUCCESS;
+  return nbc_schedule_end_op (schedule, i, barrier);
 }
 
 int NBC_Sched_recv (void* buf, char tmpbuf, int count, MPI_Datatype datatype, int source, NBC_Schedule *schedule, bool barrier) {
@@ -185,110 +253,120 @@ int NBC_Sched_local_recv (void* buf, char tmpbuf, int count, MPI_Datatype dataty
 /* this function puts an operation into the schedule */
 int NBC_Sched_op (const void* buf1, char tmpbuf1, void* buf2, char tmpbuf2, int count, MPI_Datatype datatype,
                   MPI_Op op, NBC_Schedule *schedule, bool barrier) {
-  NBC_Args_op op_args;
-  int ret;
-
-  /* store the passed arguments */
-  op_args.type = OP;
-  op_args.buf1 = buf1;
-  op_args.buf2 = buf2;
-  op_args.tmpbuf1 = tmpbuf1;
-  op_args.tmpbuf2 = tmpbuf2;
-  op_args.count = count;
-  op_args.op = op;
-  op_args.datatype = datatype;
-
-  /* append to the round-schedule */
-  ret = nbc_schedule_round_append (schedule, &op_args, sizeof (op_args), barrier);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
+  int i, l;
+
+  i = nbc_schedule_append (schedule, OP, buf1, count, datatype, 0,
+                           (tmpbuf1 ? NBC_SCHED_TMPBUF1 : 0) | (tmpbuf2 ? NBC_SCHED_TMPBUF2 : 0));
+  if (i >= 0) {
+    l = schedule->peer[i];
+    schedule->buf2[l] = buf2;
+    schedule->datatype2[l] = datatype;
+    schedule->op[l] = op;
+    schedule->count2[l] = count;
   }
 
-  NBC_DEBUG(10, "added op2 - ends at byte %i\n", nbc_schedule_get_size (schedule));
+  NBC_DEBUG(10, "added op2 - operation %i\n", i);
 
-  return OMPI_SUCCESS;
+  return nbc_schedule_end_op (schedule, i, barrier);
 }
 
 /* this function puts a copy into the schedule */
 int NBC_Sched_copy (void *src, char tmpsrc, int srccount, MPI_Datatype srctype, void *tgt, char tmptgt, int tgtcount,
                     MPI_Datatype tgttype, NBC_Schedule *schedule, bool barrier) {
-  NBC_Args_copy copy_args;
-  int ret;
-
-  /* store the passed arguments */
-  copy_args.type = COPY;
-  copy_args.src = src;
-  copy_args.tmpsrc = tmpsrc;
-  copy_args.srccount = srccount;
-  copy_args.srctype = srctype;
-  copy_args.tgt = tgt;
-  copy_args.tmptgt = tmptgt;
-  copy_args.tgtcount = tgtcount;
-  copy_args.tgttype = tgttype;
-
-  /* append to the round-schedule */
-  ret = nbc_schedule_round_append (schedule, &copy_args, sizeof (copy_args), barrier);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
+  int i, l;
+
+  i = nbc_schedule_append (schedule, COPY, src, srccount, srctype, 0,
+                           (tmpsrc ? NBC_SCHED_TMPBUF1 : 0) | (tmptgt ? NBC_SCHED_TMPBUF2 : 0));
+  if (i >= 0) {
+    l = schedule->peer[i];
+    schedule->buf2[l] = tgt;
+    schedule->datatype2[l] = tgttype;
+    schedule->op[l] = NULL;
+    schedule->count2[l] = tgtcount;
   }
 
-  NBC_DEBUG(10, "added copy - ends at byte %i\n", nbc_schedule_get_size (schedule));
+  NBC_DEBUG(10, "added copy - operation %i\n", i);
 
-  return OMPI_SUCCESS;
+  return nbc_schedule_end_op (schedule, i, barrier);
 }
 
 /* this function puts a unpack into the schedule */
 int NBC_Sched_unpack (void *inbuf, char tmpinbuf, int count, MPI_Datatype datatype, void *outbuf, char tmpoutbuf,
                       NBC_Schedule *schedule, bool barrier) {
-  NBC_Args_unpack unpack_args;
-  int ret;
+  int i, l;
+
+  i = nbc_schedule_append (schedule, UNPACK, inbuf, count, datatype, 0,
+                           (tmpinbuf ? NBC_SCHED_TMPBUF1 : 0) | (tmpoutbuf ? NBC_SCHED_TMPBUF2 : 0));
+  if (i >= 0) {
+    l = schedule->peer[i];
+    schedule->buf2[l] = outbuf;
+    schedule->datatype2[l] = datatype;
+    schedule->op[l] = NULL;
+    schedule->count2[l] = count;
+  }
+
+  NBC_DEBUG(10, "added unpack - operation %i\n", i);
 
-  /* store the passed arguments */
-  unpack_args.type = UNPACK;
-  unpack_args.inbuf = inbuf;
-  unpack_args.tmpinbuf = tmpinbuf;
-  unpack_args.count = count;
-  unpack_args.datatype = datatype;
-  unpack_args.outbuf = outbuf;
-  unpack_args.tmpoutbuf = tmpoutbuf;
+  return nbc_schedule_end_op (schedule, i, barrier);
+}
 
-  /* append to the round-schedule */
-  ret = nbc_schedule_round_append (schedule, &unpack_args, sizeof (unpack_args), barrier);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
+/* this function ends a schedule */
+int NBC_Sched_commit(NBC_Schedule *schedule) {
+  if (OPAL_UNLIKELY(NULL == schedule->round_start)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-  NBC_DEBUG(10, "added unpack - ends at byte %i\n", nbc_schedule_get_size (schedule));
+  NBC_DEBUG(10, "closed schedule %p with %i operations in %i rounds\n", schedule,
+            schedule->num_ops, schedule->num_rounds);
 
   return OMPI_SUCCESS;
 }
 
-/* this function ends a round of a schedule */
-int NBC_Sched_barrier (NBC_Schedule *schedule) {
-  return nbc_schedule_round_append (schedule, NULL, 0, true);
-}
+/* returns a copy of a committed schedule, e.g. to re-bind its buffers */
+NBC_Schedule *NBC_Sched_dup (const NBC_Schedule *schedule) {
+  NBC_Schedule *dup = OBJ_NEW(NBC_Schedule);
+  char *ops = NULL, *local = NULL;
+  int *round_start;
 
-/* this function ends a schedule */
-int NBC_Sched_commit(NBC_Schedule *schedule) {
-  int size = nbc_schedule_get_size (schedule);
-  char *ptr;
-  int ret;
-
-  ret = nbc_schedule_grow (schedule, 1);
-  if (OMPI_SUCCESS != ret) {
-    return ret;
+  if (OPAL_UNLIKELY(NULL == dup)) {
+    return NULL;
   }
 
-  /* add the barrier char (0) because this is the last round */
-  ptr = schedule->data + size;
-  *((char *) ptr) = 0;
-
-  /* increase size of schedule */
-  nbc_schedule_inc_size (schedule, 1);
+  round_start = malloc ((schedule->num_rounds + 1) * sizeof (int));
+  if (schedule->num_ops > 0) {
+    ops = malloc (schedule->num_ops * NBC_SCHED_OP_SIZE);
+  }
+  if (schedule->num_local > 0) {
+    local = malloc (schedule->num_local * NBC_SCHED_LOCAL_SIZE);
+  }
+  if (OPAL_UNLIKELY(NULL == round_start || (schedule->num_ops > 0 && NULL == ops) ||
+                    (schedule->num_local > 0 && NULL == local))) {
+    free (round_start);
+    free (ops);
+    free (local);
+    OBJ_RELEASE(dup);
+    return NULL;
+  }
 
-  NBC_DEBUG(10, "closed schedule %p at byte %i\n", schedule, (int)(size + 1));
+  free (dup->round_start);
+  dup->round_start = round_start;
+  memcpy (round_start, schedule->round_start, (schedule->num_rounds + 1) * sizeof (int));
+  dup->num_rounds = dup->max_rounds = schedule->num_rounds;
+  dup->round_reqs = schedule->round_reqs;
+  dup->max_round_reqs = schedule->max_round_reqs;
+
+  if (NULL != ops) {
+    nbc_schedule_set_ops (dup, ops, schedule->num_ops);
+    nbc_schedule_copy_ops (dup, schedule, schedule->num_ops);
+    dup->num_ops = schedule->num_ops;
+  }
+  if (NULL != local) {
+    nbc_schedule_set_local (dup, local, schedule->num_local);
+    nbc_schedule_copy_local (dup, schedule, schedule->num_local);
+    dup->num_local = schedule->num_local;
+  }
 
-  return OMPI_SUCCESS;
+  return dup;
 }
 
 /* finishes a request
@@ -317,8 +395,6 @@ static inline void NBC_Free (NBC_Handle* handle) {
 int NBC_Progress(NBC_Handle *handle) {
   int res, ret=NBC_CONTINUE;
   bool flag;
-  unsigned long size = 0;
-  char *delim;
 
   if (handle->nbc_complete) {
     return NBC_OK;
@@ -355,19 +431,13 @@ int NBC_Progress(NBC_Handle *handle) {
 
   /* a round is finished */
   if (flag) {
-    /* reset handle for next round */
-    if (NULL != handle->req_array) {
-      /* free request array */
-      free (handle->req_array);
-      handle->req_array = NULL;
-    }
-
+    /* reset handle for next round, the request array is kept for it */
     handle->req_count = 0;
 
     /* previous round had an error */
     if (OPAL_UNLIKELY(OMPI_SUCCESS != handle->super.super.req_status.MPI_ERROR)) {
       res = handle->super.super.req_status.MPI_ERROR;
-      NBC_Error("NBC_Progress: an error %d was found during schedule %p at row-offset %li - aborting the schedule\n", res, handle->schedule, handle->row_offset);
+      NBC_Error("NBC_Progress: an error %d was found during schedule %p at round %i - aborting the schedule\n", res, handle->schedule, handle->round);
       handle->nbc_complete = true;
       if (!handle->super.super.req_persistent) {
         NBC_Free(handle);
@@ -375,16 +445,9 @@ int NBC_Progress(NBC_Handle *handle) {
       return res;
     }
 
-    /* adjust delim to start of current round */
-    NBC_DEBUG(5, "NBC_Progress: going in schedule %p to row-offset: %li\n", handle->schedule, handle->row_offset);
-    delim = handle->schedule->data + handle->row_offset;
-    NBC_DEBUG(10, "delim: %p\n", delim);
-    nbc_get_round_size(delim, &size);
-    NBC_DEBUG(10, "size: %li\n", size);
-    /* adjust delim to end of current round -> delimiter */
-    delim = delim + size;
+    NBC_DEBUG(5, "NBC_Progress: round %i of schedule %p finished\n", handle->round, handle->schedule);
 
-    if (*delim == 0) {
+    if (handle->round + 1 >= handle->schedule->num_rounds) {
       /* this was the last round - we're done */
       NBC_DEBUG(5, "NBC_Progress last round finished - we're done\n");
 
@@ -397,9 +460,8 @@ int NBC_Progress(NBC_Handle *handle) {
     }
 
     NBC_DEBUG(5, "NBC_Progress round finished - goto next round\n");
-    /* move delim to start of next round */
     /* initializing handle for new virgin round */
-    handle->row_offset = (intptr_t) (delim + 1) - (intptr_t) handle->schedule->data;
+    handle->round++;
     /* kick it off */
     res = NBC_Start_round(handle);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -412,164 +474,98 @@ int NBC_Progress(NBC_Handle *handle) {
 }
 
 static inline int NBC_Start_round(NBC_Handle *handle) {
-  int num; /* number of operations */
-  int res;
-  char* ptr;
-  MPI_Request *tmp;
-  NBC_Fn_type type;
-  NBC_Args_send     sendargs;
-  NBC_Args_recv     recvargs;
-  NBC_Args_op         opargs;
-  NBC_Args_copy     copyargs;
-  NBC_Args_unpack unpackargs;
-  void *buf1,  *buf2;
-
-  /* get round-schedule address */
-  ptr = handle->schedule->data + handle->row_offset;
-
-  NBC_GET_BYTES(ptr,num);
-  NBC_DEBUG(10, "start_round round at offset %d : posting %i operations\n", handle->row_offset, num);
-
-  for (int i = 0 ; i < num ; ++i) {
-    int offset = (intptr_t)(ptr - handle->schedule->data);
-
-    memcpy (&type, ptr, sizeof (type));
-    switch(type) {
+  const NBC_Schedule *schedule = handle->schedule;
+  int first = schedule->round_start[handle->round];
+  int last = schedule->round_start[handle->round + 1];
+  int res, l;
+  void *buf1, *buf2;
+  ompi_communicator_t *comm;
+
+  NBC_DEBUG(10, "start_round round %i : posting %i operations\n", handle->round, last - first);
+
+  for (int i = first ; i < last ; ++i) {
+    /* get buffers */
+    if (schedule->flags[i] & NBC_SCHED_TMPBUF1) {
+      buf1 = (char *) handle->tmpbuf + (intptr_t) schedule->buf[i];
+    } else {
+      buf1 = schedule->buf[i];
+    }
+
+    switch(schedule->type[i]) {
       case SEND:
-        NBC_DEBUG(5,"  SEND (offset %li) ", offset);
-        NBC_GET_BYTES(ptr,sendargs);
-        NBC_DEBUG(5,"*buf: %p, count: %i, type: %p, dest: %i, tag: %i)\n", sendargs.buf,
-                  sendargs.count, sendargs.datatype, sendargs.dest, handle->tag);
-        /* get an additional request */
-        handle->req_count++;
-        /* get buffer */
-        if(sendargs.tmpbuf) {
-          buf1=(char*)handle->tmpbuf+(long)sendargs.buf;
-        } else {
-          buf1=(void *)sendargs.buf;
-        }
+        NBC_DEBUG(5,"  SEND (operation %i) *buf: %p, count: %i, type: %p, dest: %i, tag: %i)\n", i,
+                  buf1, schedule->count[i], schedule->datatype[i], schedule->peer[i], handle->tag);
+        comm = (schedule->flags[i] & NBC_SCHED_LOCAL) ? handle->comm->c_local_comm : handle->comm;
 #ifdef NBC_TIMING
         Isend_time -= MPI_Wtime();
 #endif
-        tmp = (MPI_Request *) realloc ((void *) handle->req_array, handle->req_count * sizeof (MPI_Request));
-        if (NULL == tmp) {
-          return OMPI_ERR_OUT_OF_RESOURCE;
-        }
-
-        handle->req_array = tmp;
-
-        res = MCA_PML_CALL(isend(buf1, sendargs.count, sendargs.datatype, sendargs.dest, handle->tag,
-                                 MCA_PML_BASE_SEND_STANDARD, sendargs.local?handle->comm->c_local_comm:handle->comm,
-                                 handle->req_array+handle->req_count - 1));
+        /* the request array was sized for the largest round of the schedule */
+        res = MCA_PML_CALL(isend(buf1, schedule->count[i], schedule->datatype[i], schedule->peer[i], handle->tag,
+                                 MCA_PML_BASE_SEND_STANDARD, comm, handle->req_array + handle->req_count));
         if (OMPI_SUCCESS != res) {
-          NBC_Error ("Error in MPI_Isend(%lu, %i, %p, %i, %i, %lu) (%i)", (unsigned long)buf1, sendargs.count,
-                     sendargs.datatype, sendargs.dest, handle->tag, (unsigned long)handle->comm, res);
+          NBC_Error ("Error in MPI_Isend(%lu, %i, %p, %i, %i, %lu) (%i)", (unsigned long)buf1, schedule->count[i],
+                     schedule->datatype[i], schedule->peer[i], handle->tag, (unsigned long)handle->comm, res);
           return res;
         }
+        handle->req_count++;
 #ifdef NBC_TIMING
         Isend_time += MPI_Wtime();
 #endif
         break;
       case RECV:
-        NBC_DEBUG(5, "  RECV (offset %li) ", offset);
-        NBC_GET_BYTES(ptr,recvargs);
-        NBC_DEBUG(5, "*buf: %p, count: %i, type: %p, source: %i, tag: %i)\n", recvargs.buf, recvargs.count,
-                  recvargs.datatype, recvargs.source, handle->tag);
-        /* get an additional request - TODO: req_count NOT thread safe */
-        handle->req_count++;
-        /* get buffer */
-        if(recvargs.tmpbuf) {
-          buf1=(char*)handle->tmpbuf+(long)recvargs.buf;
-        } else {
-          buf1=recvargs.buf;
-        }
+        NBC_DEBUG(5, "  RECV (operation %i) *buf: %p, count: %i, type: %p, source: %i, tag: %i)\n", i,
+                  buf1, schedule->count[i], schedule->datatype[i], schedule->peer[i], handle->tag);
+        comm = (schedule->flags[i] & NBC_SCHED_LOCAL) ? handle->comm->c_local_comm : handle->comm;
 #ifdef NBC_TIMING
         Irecv_time -= MPI_Wtime();
 #endif
-        tmp = (MPI_Request *) realloc ((void *) handle->req_array, handle->req_count * sizeof (MPI_Request));
-        if (NULL == tmp) {
-          return OMPI_ERR_OUT_OF_RESOURCE;
-        }
-
-        handle->req_array = tmp;
-
-        res = MCA_PML_CALL(irecv(buf1, recvargs.count, recvargs.datatype, recvargs.source, handle->tag, recvargs.local?handle->comm->c_local_comm:handle->comm,
-                                 handle->req_array+handle->req_count-1));
+        res = MCA_PML_CALL(irecv(buf1, schedule->count[i], schedule->datatype[i], schedule->peer[i], handle->tag,
+                                 comm, handle->req_array + handle->req_count));
         if (OMPI_SUCCESS != res) {
-          NBC_Error("Error in MPI_Irecv(%lu, %i, %p, %i, %i, %lu) (%i)", (unsigned long)buf1, recvargs.count,
-                    recvargs.datatype, recvargs.source, handle->tag, (unsigned long)handle->comm, res);
+          NBC_Error("Error in MPI_Irecv(%lu, %i, %p, %i, %i, %lu) (%i)", (unsigned long)buf1, schedule->count[i],
+                    schedule->datatype[i], schedule->peer[i], handle->tag, (unsigned long)handle->comm, res);
           return res;
         }
+        handle->req_count++;
 #ifdef NBC_TIMING
         Irecv_time += MPI_Wtime();
 #endif
         break;
       case OP:
-        NBC_DEBUG(5, "  OP2  (offset %li) ", offset);
-        NBC_GET_BYTES(ptr,opargs);
-        NBC_DEBUG(5, "*buf1: %p, buf2: %p, count: %i, type: %p)\n", opargs.buf1, opargs.buf2,
-                  opargs.count, opargs.datatype);
-        /* get buffers */
-        if(opargs.tmpbuf1) {
-          buf1=(char*)handle->tmpbuf+(long)opargs.buf1;
-        } else {
-          buf1=(void *)opargs.buf1;
-        }
-        if(opargs.tmpbuf2) {
-          buf2=(char*)handle->tmpbuf+(long)opargs.buf2;
-        } else {
-          buf2=opargs.buf2;
-        }
-        ompi_op_reduce(opargs.op, buf1, buf2, opargs.count, opargs.datatype);
-        break;
       case COPY:
-        NBC_DEBUG(5, "  COPY   (offset %li) ", offset);
-        NBC_GET_BYTES(ptr,copyargs);
-        NBC_DEBUG(5, "*src: %lu, srccount: %i, srctype: %p, *tgt: %lu, tgtcount: %i, tgttype: %p)\n",
-                  (unsigned long) copyargs.src, copyargs.srccount, copyargs.srctype,
-                  (unsigned long) copyargs.tgt, copyargs.tgtcount, copyargs.tgttype);
-        /* get buffers */
-        if(copyargs.tmpsrc) {
-          buf1=(char*)handle->tmpbuf+(long)copyargs.src;
-        } else {
-          buf1=copyargs.src;
-        }
-        if(copyargs.tmptgt) {
-          buf2=(char*)handle->tmpbuf+(long)copyargs.tgt;
-        } else {
-          buf2=copyargs.tgt;
-        }
-        res = NBC_Copy (buf1, copyargs.srccount, copyargs.srctype, buf2, copyargs.tgtcount, copyargs.tgttype,
-                        handle->comm);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-          return res;
-        }
-        break;
       case UNPACK:
-        NBC_DEBUG(5, "  UNPACK   (offset %li) ", offset);
-        NBC_GET_BYTES(ptr,unpackargs);
-        NBC_DEBUG(5, "*src: %lu, srccount: %i, srctype: %p, *tgt: %lu\n", (unsigned long) unpackargs.inbuf,
-                  unpackargs.count, unpackargs.datatype, (unsigned long) unpackargs.outbuf);
-        /* get buffers */
-        if(unpackargs.tmpinbuf) {
-          buf1=(char*)handle->tmpbuf+(long)unpackargs.inbuf;
+        l = schedule->peer[i];
+        if (schedule->flags[i] & NBC_SCHED_TMPBUF2) {
+          buf2 = (char *) handle->tmpbuf + (intptr_t) schedule->buf2[l];
         } else {
-          buf1=unpackargs.inbuf;
+          buf2 = schedule->buf2[l];
         }
-        if(unpackargs.tmpoutbuf) {
-          buf2=(char*)handle->tmpbuf+(long)unpackargs.outbuf;
+
+        if (OP == schedule->type[i]) {
+          NBC_DEBUG(5, "  OP2  (operation %i) *buf1: %p, buf2: %p, count: %i, type: %p)\n", i, buf1, buf2,
+                    schedule->count[i], schedule->datatype[i]);
+          ompi_op_reduce(schedule->op[l], buf1, buf2, schedule->count[i], schedule->datatype[i]);
+        } else if (COPY == schedule->type[i]) {
+          NBC_DEBUG(5, "  COPY   (operation %i) *src: %p, srccount: %i, srctype: %p, *tgt: %p, tgtcount: %i, tgttype: %p)\n",
+                    i, buf1, schedule->count[i], schedule->datatype[i], buf2, schedule->count2[l],
+                    schedule->datatype2[l]);
+          res = NBC_Copy (buf1, schedule->count[i], schedule->datatype[i], buf2, schedule->count2[l],
+                          schedule->datatype2[l], handle->comm);
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            return res;
+          }
         } else {
-          buf2=unpackargs.outbuf;
+          NBC_DEBUG(5, "  UNPACK   (operation %i) *src: %p, srccount: %i, srctype: %p, *tgt: %p\n", i, buf1,
+                    schedule->count[i], schedule->datatype[i], buf2);
+          res = NBC_Unpack (buf1, schedule->count[i], schedule->datatype[i], buf2, handle->comm);
+          if (OMPI_SUCCESS != res) {
+            NBC_Error ("NBC_Unpack() failed (code: %i)", res);
+            return res;
+          }
         }
-        res = NBC_Unpack (buf1, unpackargs.count, unpackargs.datatype, buf2, handle->comm);
-        if (OMPI_SUCCESS != res) {
-          NBC_Error ("NBC_Unpack() failed (code: %i)", res);
-          return res;
-        }
-
         break;
       default:
-        NBC_Error ("NBC_Start_round: bad type %li at offset %li", (long)type, offset);
+        NBC_Error ("NBC_Start_round: bad type %li at operation %i", (long)schedule->type[i], i);
         return OMPI_ERROR;
     }
   }
@@ -579,7 +575,7 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
    *
    * threaded case: calling progress in the first round can lead to a
    * deadlock if NBC_Free is called in this round :-( */
-  if (handle->row_offset) {
+  if (handle->round) {
     res = NBC_Progress(handle);
     if ((NBC_OK != res) && (NBC_CONTINUE != res)) {
       return OMPI_ERROR;
@@ -597,52 +593,6 @@ void NBC_Return_handle(ompi_coll_libnbc_request_t *request) {
 int  NBC_Init_comm(MPI_Comm comm, NBC_Comminfo *comminfo) {
   comminfo->tag= MCA_COLL_BASE_TAG_NONBLOCKING_BASE;
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* initialize the NBC_ALLTOALL SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLTOALL] = hb_tree_new((dict_cmp_func)NBC_Alltoall_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLTOALL] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLTOALL]);
-  comminfo->NBC_Dict_size[NBC_ALLTOALL] = 0;
-  /* initialize the NBC_ALLGATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLGATHER] = hb_tree_new((dict_cmp_func)NBC_Allgather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLGATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLGATHER]);
-  comminfo->NBC_Dict_size[NBC_ALLGATHER] = 0;
-  /* initialize the NBC_ALLREDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLREDUCE] = hb_tree_new((dict_cmp_func)NBC_Allreduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLREDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLREDUCE]);
-  comminfo->NBC_Dict_size[NBC_ALLREDUCE] = 0;
-  /* initialize the NBC_BARRIER SchedCache tree - is not needed -
-   * schedule is hung off directly */
-  comminfo->NBC_Dict_size[NBC_BARRIER] = 0;
-  /* initialize the NBC_BCAST SchedCache tree */
-  comminfo->NBC_Dict[NBC_BCAST] = hb_tree_new((dict_cmp_func)NBC_Bcast_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_BCAST] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_BCAST]);
-  comminfo->NBC_Dict_size[NBC_BCAST] = 0;
-  /* initialize the NBC_GATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_GATHER] = hb_tree_new((dict_cmp_func)NBC_Gather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_GATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_GATHER]);
-  comminfo->NBC_Dict_size[NBC_GATHER] = 0;
-  /* initialize the NBC_REDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_REDUCE] = hb_tree_new((dict_cmp_func)NBC_Reduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_REDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_REDUCE]);
-  comminfo->NBC_Dict_size[NBC_REDUCE] = 0;
-  /* initialize the NBC_SCAN SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCAN] = hb_tree_new((dict_cmp_func)NBC_Scan_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCAN] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCAN]);
-  comminfo->NBC_Dict_size[NBC_SCAN] = 0;
-  /* initialize the NBC_SCATTER SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCATTER] = hb_tree_new((dict_cmp_func)NBC_Scatter_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCATTER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCATTER]);
-  comminfo->NBC_Dict_size[NBC_SCATTER] = 0;
-#endif
-
   return OMPI_SUCCESS;
 }
 
@@ -673,11 +623,9 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
                          ompi_coll_libnbc_module_t *module, bool persistent,
                          ompi_request_t **request, void *tmpbuf) {
   int ret, tmp_tag;
-  bool need_register = false;
-  ompi_coll_libnbc_request_t *handle;
 
   /* no operation (e.g. one process barrier)? */
-  if (((int *)schedule->data)[0] == 0 && schedule->data[sizeof(int)] == 0) {
+  if (0 == schedule->num_ops && 1 == schedule->num_rounds) {
     ret = nbc_get_noop_request(persistent, request);
     if (OMPI_SUCCESS != ret) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -699,16 +647,14 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
     return OMPI_SUCCESS;
   }
 
-  OMPI_COLL_LIBNBC_REQUEST_ALLOC(comm, persistent, handle);
-  if (NULL == handle) return OMPI_ERR_OUT_OF_RESOURCE;
+  tmp_tag = NBC_Reserve_tag(module);
 
-  handle->tmpbuf = NULL;
-  handle->req_count = 0;
-  handle->req_array = NULL;
-  handle->comm = comm;
-  handle->schedule = NULL;
-  handle->row_offset = 0;
-  handle->nbc_complete = persistent ? true : false;
+  return NBC_Schedule_request_tag(schedule, comm, module, persistent, tmp_tag, request, tmpbuf);
+}
+
+int NBC_Reserve_tag(ompi_coll_libnbc_module_t *module) {
+  int tmp_tag;
+  bool need_register = false;
 
   /******************** Do the tag and shadow comm administration ...  ***************/
 
@@ -725,21 +671,49 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
   }
   OPAL_THREAD_UNLOCK(&module->mutex);
 
-  handle->tag = tmp_tag;
-
   /* register progress */
   if (need_register) {
       int32_t tmp =
           OPAL_THREAD_ADD_FETCH32(&mca_coll_libnbc_component.active_comms, 1);
       if (tmp == 1) {
           opal_progress_register(ompi_coll_libnbc_progress);
+          (void) ompi_coll_libnbc_progress_thread_start();
       }
   }
 
-  handle->comm=comm;
-  /*printf("got module: %lu tag: %i\n", module, module->tag);*/
-
   /******************** end of tag and shadow comm administration ...  ***************/
+
+  return tmp_tag;
+}
+
+int NBC_Schedule_request_tag(NBC_Schedule *schedule, ompi_communicator_t *comm,
+                             ompi_coll_libnbc_module_t *module, bool persistent,
+                             int tag, ompi_request_t **request, void *tmpbuf) {
+  ompi_coll_libnbc_request_t *handle;
+
+  OMPI_COLL_LIBNBC_REQUEST_ALLOC(comm, persistent, handle);
+  if (NULL == handle) return OMPI_ERR_OUT_OF_RESOURCE;
+
+  /* a returned handle keeps its request array, grow it if it cannot hold
+   * the requests of the largest round of this schedule */
+  if (handle->req_array_size < schedule->max_round_reqs) {
+    ompi_request_t **tmp = realloc (handle->req_array, schedule->max_round_reqs * sizeof (*tmp));
+    if (NULL == tmp) {
+      OMPI_COLL_LIBNBC_REQUEST_RETURN(handle);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    handle->req_array = tmp;
+    handle->req_array_size = schedule->max_round_reqs;
+  }
+
+  handle->tmpbuf = NULL;
+  handle->req_count = 0;
+  handle->comm = comm;
+  handle->schedule = NULL;
+  handle->round = 0;
+  handle->nbc_complete = persistent ? true : false;
+  handle->tag = tag;
+  /*printf("got module: %lu tag: %i\n", module, module->tag);*/
   handle->comminfo = module;
 
   NBC_DEBUG(3, "got tag %i\n", handle->tag);
@@ -750,16 +724,3 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
 
   return OMPI_SUCCESS;
 }
-
-#ifdef NBC_CACHE_SCHEDULE
-void NBC_SchedCache_args_delete_key_dummy(void *k) {
-    /* do nothing because the key and the data element are identical :-)
-     * both (the single one :) is freed in NBC_<COLLOP>_args_delete() */
-}
-
-void NBC_SchedCache_args_delete(void *entry) {
-  struct NBC_dummyarg *tmp = (struct NBC_dummyarg*)entry;
-  OBJ_RELEASE(tmp->schedule);
-  free(entry);
-}
-#endif
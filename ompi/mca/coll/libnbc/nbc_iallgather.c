@@ -29,26 +29,6 @@ static inline int allgather_sched_recursivedoubling(
     int scount, struct ompi_datatype_t *sdtype, void *rbuf, int rcount,
     struct ompi_datatype_t *rdtype);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) ) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_allgather_init(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount,
                               MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
                               struct mca_coll_base_module_2_3_0_t *module, bool persistent)
@@ -57,9 +37,8 @@ static int nbc_allgather_init(const void* sendbuf, int sendcount, MPI_Datatype s
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
   char *rbuf, inplace;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allgather_args *args, *found, search;
-#endif
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   enum { NBC_ALLGATHER_LINEAR, NBC_ALLGATHER_RDBL} alg;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -102,17 +81,15 @@ static int nbc_allgather_init(const void* sendbuf, int sendcount, MPI_Datatype s
     return nbc_get_noop_request(persistent, request);
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  found = (NBC_Allgather_args *) hb_tree_search ((hb_tree*)libnbc_module->NBC_Dict[NBC_ALLGATHER], &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLGATHER, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &alg, sizeof(alg));
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -152,34 +129,8 @@ static int nbc_allgather_init(const void* sendbuf, int sendcount, MPI_Datatype s
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allgather_args *) malloc (sizeof (args));
-    args->sendbuf = sendbuf;
-    args->sendcount = sendcount;
-    args->sendtype = sendtype;
-    args->recvbuf = recvbuf;
-    args->recvcount = recvcount;
-    args->recvtype = recvtype;
-    args->schedule = schedule;
-
-    res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], args, args, 0);
-    if (res != 0) {
-      free (args);
-    } else {
-      OBJ_RETAIN(schedule);
-    }
-
-    /* increase number of elements for A2A */
-    if (++libnbc_module->NBC_Dict_size[NBC_ALLGATHER] > NBC_SCHED_DICT_UPPER) {
-      NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], &libnbc_module->NBC_Dict_size[NBC_ALLGATHER]);
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -217,6 +168,8 @@ static int nbc_allgather_inter_init(const void* sendbuf, int sendcount, MPI_Data
   int res, rsize;
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -228,34 +181,45 @@ static int nbc_allgather_inter_init(const void* sendbuf, int sendcount, MPI_Data
 
   rsize = ompi_comm_remote_size (comm);
 
-  /* set up schedule */
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLGATHER, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    /* set up schedule */
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  /* do rsize - 1 rounds */
-  for (int r = 0 ; r < rsize ; ++r) {
-    /* recv from rank r */
-    rbuf = (char *) recvbuf + r * recvcount * rcvext;
-    res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, r, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+    /* do rsize - 1 rounds */
+    for (int r = 0 ; r < rsize ; ++r) {
+      /* recv from rank r */
+      rbuf = (char *) recvbuf + r * recvcount * rcvext;
+      res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, r, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+
+      /* send to rank r */
+      res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, r, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
     }
 
-    /* send to rank r */
-    res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, r, schedule, false);
+    res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -41,6 +41,8 @@ static int nbc_allgatherv_init(const void* sendbuf, int sendcount, MPI_Datatype
   int rank, p, res, speer, rpeer;
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf, inplace;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -67,47 +69,59 @@ static int nbc_allgatherv_init(const void* sendbuf, int sendcount, MPI_Datatype
     }
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLGATHERV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, recvcounts, p * sizeof(int));
+  NBC_Cache_key_add(&key, displs, p * sizeof(int));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
   if (NULL == schedule) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (NULL == schedule) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  sbuf = (char *) recvbuf + displs[rank] * rcvext;
+    sbuf = (char *) recvbuf + displs[rank] * rcvext;
 
-  if (persistent && !inplace) { /* for nonblocking, data has been copied already */
-    /* copy my data to receive buffer (= send buffer of NBC_Sched_send) */
-    res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
-                          sbuf, false, recvcounts[rank], recvtype, schedule, true);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+    if (persistent && !inplace) { /* for nonblocking, data has been copied already */
+      /* copy my data to receive buffer (= send buffer of NBC_Sched_send) */
+      res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
+                            sbuf, false, recvcounts[rank], recvtype, schedule, true);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
     }
-  }
 
-  /* do p-1 rounds */
-  for (int r = 1 ; r < p ; ++r) {
-    speer = (rank + r) % p;
-    rpeer = (rank - r + p) % p;
-    rbuf = (char *)recvbuf + displs[rpeer] * rcvext;
+    /* do p-1 rounds */
+    for (int r = 1 ; r < p ; ++r) {
+      speer = (rank + r) % p;
+      rpeer = (rank - r + p) % p;
+      rbuf = (char *)recvbuf + displs[rpeer] * rcvext;
 
-    res = NBC_Sched_recv (rbuf, false, recvcounts[rpeer], recvtype, rpeer, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+      res = NBC_Sched_recv (rbuf, false, recvcounts[rpeer], recvtype, rpeer, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+
+      /* send to rank r - not from the sendbuf to optimize MPI_IN_PLACE */
+      res = NBC_Sched_send (sbuf, false, recvcounts[rank], recvtype, speer, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
     }
 
-    /* send to rank r - not from the sendbuf to optimize MPI_IN_PLACE */
-    res = NBC_Sched_send (sbuf, false, recvcounts[rank], recvtype, speer, schedule, false);
+    res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, NULL);
@@ -145,6 +159,8 @@ static int nbc_allgatherv_inter_init(const void* sendbuf, int sendcount, MPI_Dat
   int res, rsize;
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
   rsize = ompi_comm_remote_size (comm);
@@ -155,38 +171,50 @@ static int nbc_allgatherv_inter_init(const void* sendbuf, int sendcount, MPI_Dat
     return res;
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLGATHERV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, recvcounts, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, displs, rsize * sizeof(int));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
   if (NULL == schedule) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
-
-  /* do rsize  rounds */
-  for (int r = 0 ; r < rsize ; ++r) {
-    char *rbuf = (char *) recvbuf + displs[r] * rcvext;
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (NULL == schedule) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-    if (recvcounts[r]) {
-      res = NBC_Sched_recv (rbuf, false, recvcounts[r], recvtype, r, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+    /* do rsize  rounds */
+    for (int r = 0 ; r < rsize ; ++r) {
+      char *rbuf = (char *) recvbuf + displs[r] * rcvext;
+
+      if (recvcounts[r]) {
+        res = NBC_Sched_recv (rbuf, false, recvcounts[r], recvtype, r, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  }
 
-  if (sendcount) {
-    for (int r = 0 ; r < rsize ; ++r) {
-      res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, r, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+    if (sendcount) {
+      for (int r = 0 ; r < rsize ; ++r) {
+        res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, r, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -42,36 +42,19 @@ static inline int allred_sched_redscat_allgather(
     const void *sbuf, void *rbuf, MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmpbuf, struct ompi_communicator_t *comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
+/* a non-zero tag is used by the fused iallreduces, whose requests reuse
+ * the tag reserved by the first fused call instead of a new one */
 static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
                               struct ompi_communicator_t *comm, ompi_request_t ** request,
-                              struct mca_coll_base_module_2_3_0_t *module, bool persistent)
+                              struct mca_coll_base_module_2_3_0_t *module, bool persistent,
+                              int tag)
 {
   int rank, p, res;
   ptrdiff_t ext, lb;
   NBC_Schedule *schedule;
   size_t size;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allreduce_args *args, *found, search;
-#endif
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry = NULL;
   enum { NBC_ARED_BINOMIAL, NBC_ARED_RING, NBC_ARED_REDSCAT_ALLGATHER, NBC_ARED_RDBL } alg;
   char inplace;
   void *tmpbuf = NULL;
@@ -134,16 +117,19 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, int count, MPI
     else
       alg = NBC_ARED_RING;
   }
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  found = (NBC_Allreduce_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], &search);
-  if (NULL == found) {
-#endif
+
+  /* search schedule in the communicator specific cache, which the fused
+   * iallreduces bypass */
+  schedule = NULL;
+  if (0 == tag) {
+    NBC_Cache_key_init(&key, NBC_ALLREDUCE, persistent, sendbuf, recvbuf, tmpbuf);
+    NBC_Cache_key_add(&key, &alg, sizeof(alg));
+    NBC_Cache_key_add(&key, &count, sizeof(count));
+    NBC_Cache_key_add_type(&key, datatype);
+    NBC_Cache_key_add_op(&key, op);
+    schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  }
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (NULL == schedule) {
       free(tmpbuf);
@@ -183,38 +169,14 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, int count, MPI
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allreduce_args *) malloc (sizeof(args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_ALLREDUCE] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE],
-                                   &libnbc_module->NBC_Dict_size[NBC_ALLREDUCE]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
-  res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  if (0 != tag) {
+    res = NBC_Schedule_request_tag (schedule, comm, libnbc_module, persistent, tag, request, tmpbuf);
+  } else {
+    res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  }
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -224,11 +186,38 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, int count, MPI
   return OMPI_SUCCESS;
 }
 
+int NBC_Iallreduce_tag(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype,
+                       MPI_Op op, ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module,
+                       int tag, ompi_request_t **request) {
+    int res = nbc_allreduce_init(sendbuf, recvbuf, count, datatype, op,
+                                 comm, request, &module->super, false, tag);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        return res;
+    }
+
+    res = NBC_Start(*(ompi_coll_libnbc_request_t **)request);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        NBC_Return_handle (*(ompi_coll_libnbc_request_t **)request);
+        *request = &ompi_request_null.request;
+        return res;
+    }
+
+    return OMPI_SUCCESS;
+}
+
 int ompi_coll_libnbc_iallreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
                                 struct ompi_communicator_t *comm, ompi_request_t ** request,
                                 struct mca_coll_base_module_2_3_0_t *module) {
-    int res = nbc_allreduce_init(sendbuf, recvbuf, count, datatype, op,
-                                 comm, request, module, false);
+    int res;
+
+    if (0 < libnbc_iallreduce_fusion_msg_size &&
+        NBC_Fusion_eligible(count, datatype, comm)) {
+        return NBC_Fusion_iallreduce(sendbuf, recvbuf, count, datatype, op, comm, request,
+                                     (ompi_coll_libnbc_module_t *) module);
+    }
+
+    res = nbc_allreduce_init(sendbuf, recvbuf, count, datatype, op,
+                             comm, request, module, false, 0);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         return res;
     }
@@ -251,6 +240,8 @@ static int nbc_allreduce_inter_init(const void* sendbuf, void* recvbuf, int coun
   size_t size;
   MPI_Aint ext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   void *tmpbuf = NULL;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
   ptrdiff_t span, gap;
@@ -276,25 +267,35 @@ static int nbc_allreduce_inter_init(const void* sendbuf, void* recvbuf, int coun
     return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLREDUCE, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, &count, sizeof(count));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add_op(&key, op);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  res = allred_sched_linear (rank, rsize, sendbuf, recvbuf, count, datatype, gap, op,
-                             ext, size, schedule, tmpbuf);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
+    res = allred_sched_linear (rank, rsize, sendbuf, recvbuf, count, datatype, gap, op,
+                               ext, size, schedule, tmpbuf);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
 
-  res = NBC_Sched_commit(schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    res = NBC_Sched_commit(schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
@@ -1188,7 +1189,7 @@ int ompi_coll_libnbc_allreduce_init(const void* sendbuf, void* recvbuf, int coun
                                     struct ompi_communicator_t *comm, MPI_Info info, ompi_request_t ** request,
                                     struct mca_coll_base_module_2_3_0_t *module) {
     int res = nbc_allreduce_init(sendbuf, recvbuf, count, datatype, op,
-                                 comm, request, module, true);
+                                 comm, request, module, true, 0);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         return res;
     }
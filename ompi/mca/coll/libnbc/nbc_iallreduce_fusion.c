@@ -0,0 +1,400 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/*
+ * Fusion of small non-blocking allreduces.
+ *
+ * The eligible MPI_Iallreduce calls are not started right away, they are
+ * queued on the communicator, and the queue is reduced in rounds. A round
+ * packs consecutive requests with the same datatype and operation into one
+ * buffer, reduces it with a single allreduce, and copies the results back
+ * into the receive buffers of the requests before completing them.
+ *
+ * A round is started once the queue holds enough data, or once its oldest
+ * request has waited for longer than the fusion window (the latter is
+ * checked by the progress function, so waiting on a fused request always
+ * eventually starts its round). These conditions are local, and the
+ * processes can start a round with a different number of requests: a round
+ * thus first agrees on the smallest of these numbers, then reduces only this
+ * many requests, leaving the others in the queue. All processes see the
+ * same sequence of calls, so they run the same sequence of rounds, and a
+ * round uses the tag reserved by its first request.
+ *
+ * The queued requests hold a reference on their operation, which the user
+ * may free before they complete.
+ */
+#include "nbc_internal.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+
+static void fusion_construct(ompi_coll_libnbc_fusion_t *fusion)
+{
+  OBJ_CONSTRUCT(&fusion->lock, opal_mutex_t);
+  OBJ_CONSTRUCT(&fusion->pending, opal_list_t);
+  fusion->comm = NULL;
+  fusion->module = NULL;
+  fusion->pending_bytes = 0;
+  fusion->first_usec = 0;
+  fusion->queued = false;
+  fusion->visit = 0;
+  fusion->stage = NULL;
+  fusion->nreqs = 0;
+  fusion->agreed = 0;
+  fusion->buffer = NULL;
+}
+
+static void fusion_destruct(ompi_coll_libnbc_fusion_t *fusion)
+{
+  OBJ_DESTRUCT(&fusion->pending);
+  OBJ_DESTRUCT(&fusion->lock);
+  if (NULL != fusion->buffer) {
+    free(fusion->buffer);
+  }
+}
+
+OBJ_CLASS_INSTANCE(ompi_coll_libnbc_fusion_t, opal_list_item_t,
+                   fusion_construct, fusion_destruct);
+
+/* the decision only depends on arguments which are the same on all
+ * processes, so they all fuse the same calls */
+bool NBC_Fusion_eligible(int count, MPI_Datatype datatype, ompi_communicator_t *comm) {
+  size_t size;
+
+  if (ompi_comm_size(comm) < 2 || count <= 0 || !ompi_datatype_is_predefined(datatype)) {
+    return false;
+  }
+  ompi_datatype_type_size(datatype, &size);
+
+  return size * (size_t)count <= libnbc_iallreduce_fusion_msg_size;
+}
+
+/* completes the first n pending requests with the given error code */
+static void fusion_complete(ompi_coll_libnbc_fusion_t *fusion, int n, int err) {
+  ompi_coll_libnbc_request_t *handle;
+  NBC_Fused_args *args;
+  size_t size;
+
+  while (n-- > 0) {
+    handle = (ompi_coll_libnbc_request_t *) opal_list_remove_first(&fusion->pending);
+    args = (NBC_Fused_args *) handle->tmpbuf;
+    ompi_datatype_type_size(args->datatype, &size);
+    fusion->pending_bytes -= size * (size_t)args->count;
+
+    OBJ_RELEASE(args->op);
+    free(args);
+    handle->tmpbuf = NULL;
+    handle->nbc_complete = true;
+    handle->super.super.req_status.MPI_ERROR = err;
+    ompi_request_complete(&handle->super.super, true);
+  }
+}
+
+/* starts a round with the longest sequence of pending requests with the
+ * same datatype and operation fitting in the fusion buffer, by agreeing on
+ * the number of requests to reduce */
+static int fusion_start_round(ompi_coll_libnbc_fusion_t *fusion) {
+  ompi_coll_libnbc_request_t *first, *handle;
+  NBC_Fused_args *first_args, *args;
+  size_t size, bytes = 0;
+  int res;
+
+  first = (ompi_coll_libnbc_request_t *) opal_list_get_first(&fusion->pending);
+  first_args = (NBC_Fused_args *) first->tmpbuf;
+  ompi_datatype_type_size(first_args->datatype, &size);
+
+  fusion->nreqs = 0;
+  OPAL_LIST_FOREACH(handle, &fusion->pending, ompi_coll_libnbc_request_t) {
+    args = (NBC_Fused_args *) handle->tmpbuf;
+    if (args->datatype != first_args->datatype || args->op != first_args->op) {
+      break;
+    }
+    if (fusion->nreqs > 0 && bytes + size * (size_t)args->count > libnbc_iallreduce_fusion_size) {
+      break;
+    }
+    bytes += size * (size_t)args->count;
+    fusion->nreqs++;
+  }
+
+  res = NBC_Iallreduce_tag(&fusion->nreqs, &fusion->agreed, 1, MPI_INT, MPI_MIN,
+                           fusion->comm, fusion->module, first->tag, &fusion->stage);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    fusion->stage = NULL;
+    fusion_complete(fusion, fusion->nreqs, res);
+  }
+
+  return res;
+}
+
+/* once the processes agreed on the number of requests, packs their data
+ * and starts the reduction */
+static int fusion_start_reduction(ompi_coll_libnbc_fusion_t *fusion) {
+  ompi_coll_libnbc_request_t *first, *handle;
+  NBC_Fused_args *args;
+  ptrdiff_t lb, extent;
+  size_t total = 0;
+  char *ptr;
+  int i, res;
+
+  first = (ompi_coll_libnbc_request_t *) opal_list_get_first(&fusion->pending);
+  args = (NBC_Fused_args *) first->tmpbuf;
+  ompi_datatype_get_extent(args->datatype, &lb, &extent);
+
+  i = 0;
+  OPAL_LIST_FOREACH(handle, &fusion->pending, ompi_coll_libnbc_request_t) {
+    if (i++ == fusion->agreed) break;
+    total += ((NBC_Fused_args *) handle->tmpbuf)->count;
+  }
+
+  /* the data followed by the result */
+  fusion->buffer = malloc(2 * total * extent);
+  if (OPAL_UNLIKELY(NULL == fusion->buffer)) {
+    fusion_complete(fusion, fusion->agreed, OMPI_ERR_OUT_OF_RESOURCE);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+
+  i = 0;
+  ptr = (char *) fusion->buffer;
+  OPAL_LIST_FOREACH(handle, &fusion->pending, ompi_coll_libnbc_request_t) {
+    NBC_Fused_args *hargs = (NBC_Fused_args *) handle->tmpbuf;
+    if (i++ == fusion->agreed) break;
+    res = ompi_datatype_copy_content_same_ddt(hargs->datatype, hargs->count, ptr,
+                                              (char *) (MPI_IN_PLACE == hargs->sendbuf ?
+                                                        hargs->recvbuf : hargs->sendbuf));
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      fusion_complete(fusion, fusion->agreed, res);
+      return res;
+    }
+    ptr += hargs->count * extent;
+  }
+
+  res = NBC_Iallreduce_tag(fusion->buffer, (char *) fusion->buffer + total * extent, (int) total,
+                           args->datatype, args->op, fusion->comm, fusion->module,
+                           first->tag, &fusion->stage);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    fusion->stage = NULL;
+    fusion_complete(fusion, fusion->agreed, res);
+  }
+
+  return res;
+}
+
+/* copies the results back to the requests, and completes them */
+static void fusion_finish_reduction(ompi_coll_libnbc_fusion_t *fusion) {
+  ompi_coll_libnbc_request_t *handle;
+  ptrdiff_t lb, extent;
+  size_t total = 0;
+  char *ptr;
+  int i, res = OMPI_SUCCESS;
+
+  handle = (ompi_coll_libnbc_request_t *) opal_list_get_first(&fusion->pending);
+  ompi_datatype_get_extent(((NBC_Fused_args *) handle->tmpbuf)->datatype, &lb, &extent);
+
+  i = 0;
+  OPAL_LIST_FOREACH(handle, &fusion->pending, ompi_coll_libnbc_request_t) {
+    if (i++ == fusion->agreed) break;
+    total += ((NBC_Fused_args *) handle->tmpbuf)->count;
+  }
+
+  i = 0;
+  ptr = (char *) fusion->buffer + total * extent;
+  OPAL_LIST_FOREACH(handle, &fusion->pending, ompi_coll_libnbc_request_t) {
+    NBC_Fused_args *args = (NBC_Fused_args *) handle->tmpbuf;
+    if (i++ == fusion->agreed) break;
+    if (OMPI_SUCCESS == res) {
+      res = ompi_datatype_copy_content_same_ddt(args->datatype, args->count,
+                                                (char *) args->recvbuf, ptr);
+    }
+    ptr += args->count * extent;
+  }
+
+  free(fusion->buffer);
+  fusion->buffer = NULL;
+  fusion_complete(fusion, fusion->agreed, res);
+}
+
+/* moves the round of the communicator to its next stage */
+static void fusion_next_stage(ompi_coll_libnbc_fusion_t *fusion) {
+  int res = fusion->stage->req_status.MPI_ERROR;
+
+  ompi_request_free(&fusion->stage);
+  fusion->stage = NULL;
+
+  if (NULL == fusion->buffer) {
+    /* the agreement is done */
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      fusion_complete(fusion, fusion->nreqs, res);
+      return;
+    }
+    NBC_DEBUG(5, "fusing %i of %i iallreduces\n", fusion->agreed, fusion->nreqs);
+    (void) fusion_start_reduction(fusion);
+  } else if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    free(fusion->buffer);
+    fusion->buffer = NULL;
+    fusion_complete(fusion, fusion->agreed, res);
+  } else {
+    fusion_finish_reduction(fusion);
+  }
+}
+
+int NBC_Fusion_iallreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype,
+                          MPI_Op op, ompi_communicator_t *comm, ompi_request_t **request,
+                          ompi_coll_libnbc_module_t *module) {
+  ompi_coll_libnbc_fusion_t *fusion = module->fusion;
+  ompi_coll_libnbc_request_t *handle;
+  NBC_Fused_args *args;
+  size_t size;
+  int tag, res = OMPI_SUCCESS;
+
+  if (NULL == fusion) {
+    fusion = OBJ_NEW(ompi_coll_libnbc_fusion_t);
+    if (OPAL_UNLIKELY(NULL == fusion)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    fusion->comm = comm;
+    fusion->module = module;
+    module->fusion = fusion;
+  }
+
+  args = (NBC_Fused_args *) malloc(sizeof(*args));
+  if (OPAL_UNLIKELY(NULL == args)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+  args->sendbuf = sendbuf;
+  args->recvbuf = recvbuf;
+  args->count = count;
+  args->datatype = datatype;
+  args->op = op;
+
+  /* reserve a tag as any other collective, the first request of a round
+   * gives it its tag */
+  tag = NBC_Reserve_tag(module);
+
+  OMPI_COLL_LIBNBC_REQUEST_ALLOC(comm, false, handle);
+  if (OPAL_UNLIKELY(NULL == handle)) {
+    free(args);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+  handle->tmpbuf = args;
+  handle->req_count = 0;
+  handle->comm = comm;
+  handle->schedule = NULL;
+  handle->round = 0;
+  handle->nbc_complete = false;
+  handle->tag = tag;
+  handle->comminfo = module;
+  handle->super.super.req_state = OMPI_REQUEST_ACTIVE;
+  handle->super.super.req_status.MPI_ERROR = OMPI_SUCCESS;
+  *request = (ompi_request_t *) handle;
+  OBJ_RETAIN(op);
+
+  ompi_datatype_type_size(datatype, &size);
+
+  OPAL_THREAD_LOCK(&fusion->lock);
+  if (opal_list_is_empty(&fusion->pending)) {
+    fusion->first_usec = opal_timer_base_get_usec();
+  }
+  opal_list_append(&fusion->pending, (opal_list_item_t *) handle);
+  fusion->pending_bytes += size * (size_t)count;
+
+  OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+  if (!fusion->queued) {
+    fusion->queued = true;
+    opal_list_append(&mca_coll_libnbc_component.fusions, &fusion->super);
+  }
+  OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+
+  if (NULL == fusion->stage && fusion->pending_bytes >= libnbc_iallreduce_fusion_size) {
+    res = fusion_start_round(fusion);
+  }
+  OPAL_THREAD_UNLOCK(&fusion->lock);
+
+  /* a failure completed the request with the error */
+  (void) res;
+
+  return OMPI_SUCCESS;
+}
+
+/* progresses the rounds of all the communicators with fused iallreduces,
+ * called from the libnbc progress function (never concurrently with
+ * itself). The lock of the component is dropped while a communicator is
+ * progressed, and NBC_Fusion_release may then remove any of them from the
+ * list: the one progressed is kept alive by a reference, and the walk
+ * restarts from the head of the list, skipping the communicators already
+ * visited by this call. */
+int NBC_Fusion_progress(void) {
+  static unsigned int visit = 0;
+  ompi_coll_libnbc_fusion_t *fusion;
+  opal_timer_t now = 0;
+  bool found;
+
+  OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+  visit++;
+  do {
+    found = false;
+    OPAL_LIST_FOREACH(fusion, &mca_coll_libnbc_component.fusions, ompi_coll_libnbc_fusion_t) {
+      if (visit != fusion->visit) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      break;
+    }
+    fusion->visit = visit;
+    OBJ_RETAIN(fusion);
+    OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+    OPAL_THREAD_LOCK(&fusion->lock);
+
+    if (NULL != fusion->stage && REQUEST_COMPLETE(fusion->stage)) {
+      fusion_next_stage(fusion);
+    }
+
+    if (NULL == fusion->stage && !opal_list_is_empty(&fusion->pending)) {
+      if (0 == now) {
+        now = opal_timer_base_get_usec();
+      }
+      if (fusion->pending_bytes >= libnbc_iallreduce_fusion_size ||
+          now - fusion->first_usec >= (opal_timer_t) libnbc_iallreduce_fusion_window) {
+        (void) fusion_start_round(fusion);
+      }
+    }
+
+    OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+    if (fusion->queued && NULL == fusion->stage && opal_list_is_empty(&fusion->pending)) {
+      opal_list_remove_item(&mca_coll_libnbc_component.fusions, &fusion->super);
+      fusion->queued = false;
+    }
+    OPAL_THREAD_UNLOCK(&fusion->lock);
+    OBJ_RELEASE(fusion);
+  } while (1);
+  OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+
+  return 0;
+}
+
+void NBC_Fusion_release(ompi_coll_libnbc_module_t *module) {
+  ompi_coll_libnbc_fusion_t *fusion = module->fusion;
+
+  if (NULL == fusion) {
+    return;
+  }
+
+  OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+  if (fusion->queued) {
+    opal_list_remove_item(&mca_coll_libnbc_component.fusions, &fusion->super);
+    fusion->queued = false;
+  }
+  OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+
+  OBJ_RELEASE(fusion);
+  module->fusion = NULL;
+}
@@ -33,26 +33,6 @@ static inline int a2a_sched_diss(int rank, int p, MPI_Aint sndext, MPI_Aint rcve
 static inline int a2a_sched_inplace(int rank, int p, NBC_Schedule* schedule, void* buf, int count,
                                    MPI_Datatype type, MPI_Aint ext, ptrdiff_t gap, MPI_Comm comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Alltoall_args_compare(NBC_Alltoall_args *a, NBC_Alltoall_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 /* simple linear MPI_Ialltoall the (simple) algorithm just sends to all nodes */
 static int nbc_alltoall_init(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount,
                              MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -63,9 +43,8 @@ static int nbc_alltoall_init(const void* sendbuf, int sendcount, MPI_Datatype se
   size_t a2asize, sndsize;
   NBC_Schedule *schedule;
   MPI_Aint rcvext, sndext;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Alltoall_args *args, *found, search;
-#endif
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf, inplace;
   enum {NBC_A2A_LINEAR, NBC_A2A_PAIRWISE, NBC_A2A_DISS, NBC_A2A_INPLACE} alg;
   void *tmpbuf = NULL;
@@ -180,17 +159,15 @@ static int nbc_alltoall_init(const void* sendbuf, int sendcount, MPI_Datatype se
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  found = (NBC_Alltoall_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL], &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALL, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, &alg, sizeof(alg));
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     /* not found - generate new schedule */
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
@@ -239,37 +216,8 @@ static int nbc_alltoall_init(const void* sendbuf, int sendcount, MPI_Datatype se
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Alltoall_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_ALLTOALL] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLTOALL],
-                                   &libnbc_module->NBC_Dict_size[NBC_ALLTOALL]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -307,6 +255,8 @@ static int nbc_alltoall_inter_init (const void* sendbuf, int sendcount, MPI_Data
   int res, rsize;
   MPI_Aint sndext, rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -324,36 +274,47 @@ static int nbc_alltoall_inter_init (const void* sendbuf, int sendcount, MPI_Data
     return res;
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALL, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  for (int i = 0; i < rsize; i++) {
-    /* post all sends */
-    sbuf = (char *) sendbuf + i * sendcount * sndext;
-    res = NBC_Sched_send (sbuf, false, sendcount, sendtype, i, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      break;
+    for (int i = 0; i < rsize; i++) {
+      /* post all sends */
+      sbuf = (char *) sendbuf + i * sendcount * sndext;
+      res = NBC_Sched_send (sbuf, false, sendcount, sendtype, i, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        break;
+      }
+
+      /* post all receives */
+      rbuf = (char *) recvbuf + i * recvcount * rcvext;
+      res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        break;
+      }
     }
 
-    /* post all receives */
-    rbuf = (char *) recvbuf + i * recvcount * rcvext;
-    res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      break;
+      OBJ_RELEASE(schedule);
+      return res;
     }
-  }
 
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
-  }
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
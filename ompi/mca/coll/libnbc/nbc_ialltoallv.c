@@ -36,9 +36,9 @@ static inline int a2av_sched_inplace(int rank, int p, NBC_Schedule *schedule,
                                     void *buf, const int *counts, const int *displs,
                                     MPI_Aint ext, MPI_Datatype type, ptrdiff_t gap);
 
-/* an alltoallv schedule can not be cached easily because the contents
- * ot the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
+/* the contents of the count and displacement arrays may change between two
+ * calls with the same arrays, so they are copied into the key of the
+ * schedule cache */
 
 /* simple linear Alltoallv */
 static int nbc_alltoallv_init(const void* sendbuf, const int *sendcounts, const int *sdispls,
@@ -49,6 +49,8 @@ static int nbc_alltoallv_init(const void* sendbuf, const int *sendcounts, const
   int rank, p, res;
   MPI_Aint sndext, rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf, inplace;
   ptrdiff_t gap = 0, span;
   void * tmpbuf = NULL;
@@ -91,43 +93,56 @@ static int nbc_alltoallv_init(const void* sendbuf, const int *sendcounts, const
     }
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALLV, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, sendcounts, p * sizeof(int));
+  NBC_Cache_key_add(&key, sdispls, p * sizeof(int));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, recvcounts, p * sizeof(int));
+  NBC_Cache_key_add(&key, rdispls, p * sizeof(int));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
 
-  if (!inplace && sendcounts[rank] != 0) {
-    rbuf = (char *) recvbuf + rdispls[rank] * rcvext;
-    sbuf = (char *) sendbuf + sdispls[rank] * sndext;
-    res = NBC_Sched_copy (sbuf, false, sendcounts[rank], sendtype,
-                          rbuf, false, recvcounts[rank], recvtype, schedule, false);
+    if (!inplace && sendcounts[rank] != 0) {
+      rbuf = (char *) recvbuf + rdispls[rank] * rcvext;
+      sbuf = (char *) sendbuf + sdispls[rank] * sndext;
+      res = NBC_Sched_copy (sbuf, false, sendcounts[rank], sendtype,
+                            rbuf, false, recvcounts[rank], recvtype, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+    }
+
+    if (inplace) {
+      res = a2av_sched_inplace(rank, p, schedule, recvbuf, recvcounts,
+                                   rdispls, rcvext, recvtype, gap);
+    } else {
+      res = a2av_sched_linear(rank, p, schedule,
+                              sendbuf, sendcounts, sdispls, sndext, sendtype,
+                              recvbuf, recvcounts, rdispls, rcvext, recvtype);
+    }
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
+      free(tmpbuf);
       return res;
     }
-  }
 
-  if (inplace) {
-    res = a2av_sched_inplace(rank, p, schedule, recvbuf, recvcounts,
-                                 rdispls, rcvext, recvtype, gap);
-  } else {
-    res = a2av_sched_linear(rank, p, schedule,
-                            sendbuf, sendcounts, sdispls, sndext, sendtype,
-                            recvbuf, recvcounts, rdispls, rcvext, recvtype);
-  }
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
@@ -170,6 +185,8 @@ static int nbc_alltoallv_inter_init (const void* sendbuf, const int *sendcounts,
   int res, rsize;
   MPI_Aint sndext, rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
 
@@ -187,36 +204,49 @@ static int nbc_alltoallv_inter_init (const void* sendbuf, const int *sendcounts,
 
   rsize = ompi_comm_remote_size (comm);
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALLV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, sendcounts, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, sdispls, rsize * sizeof(int));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, recvcounts, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, rdispls, rsize * sizeof(int));
+  NBC_Cache_key_add_type(&key, recvtype);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  for (int i = 0; i < rsize; i++) {
-    /* post all sends */
-    if (sendcounts[i] != 0) {
-      char *sbuf = (char *) sendbuf + sdispls[i] * sndext;
-      res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+    for (int i = 0; i < rsize; i++) {
+      /* post all sends */
+      if (sendcounts[i] != 0) {
+        char *sbuf = (char *) sendbuf + sdispls[i] * sndext;
+        res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
-    }
-    /* post all receives */
-    if (recvcounts[i] != 0) {
-      char *rbuf = (char *) recvbuf + rdispls[i] * rcvext;
-      res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+      /* post all receives */
+      if (recvcounts[i] != 0) {
+        char *rbuf = (char *) recvbuf + rdispls[i] * rcvext;
+        res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  }
 
-  res = NBC_Sched_commit(schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit(schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -36,9 +36,9 @@ static inline int a2aw_sched_inplace(int rank, int p, NBC_Schedule *schedule,
                                     void *buf, const int *counts, const int *displs,
                                     struct ompi_datatype_t * const * types);
 
-/* an alltoallw schedule can not be cached easily because the contents
- * ot the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
+/* the contents of the count and displacement arrays may change between two
+ * calls with the same arrays, so they are copied into the key of the
+ * schedule cache */
 
 /* simple linear Alltoallw */
 static int nbc_alltoallw_init(const void* sendbuf, const int *sendcounts, const int *sdispls,
@@ -48,6 +48,8 @@ static int nbc_alltoallw_init(const void* sendbuf, const int *sendcounts, const
 {
   int rank, p, res;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf, inplace;
   ptrdiff_t span=0;
   void *tmpbuf = NULL;
@@ -79,41 +81,56 @@ static int nbc_alltoallw_init(const void* sendbuf, const int *sendcounts, const
     sendtypes = recvtypes;
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALLW, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, sendcounts, p * sizeof(int));
+  NBC_Cache_key_add(&key, sdispls, p * sizeof(int));
+  NBC_Cache_key_add(&key, recvcounts, p * sizeof(int));
+  NBC_Cache_key_add(&key, rdispls, p * sizeof(int));
+  for (int i = 0 ; i < p ; ++i) {
+    NBC_Cache_key_add_type(&key, sendtypes[i]);
+    NBC_Cache_key_add_type(&key, recvtypes[i]);
   }
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  if (!inplace && sendcounts[rank] != 0) {
-    rbuf = (char *) recvbuf + rdispls[rank];
-    sbuf = (char *) sendbuf + sdispls[rank];
-    res = NBC_Sched_copy(sbuf, false, sendcounts[rank], sendtypes[rank],
-                         rbuf, false, recvcounts[rank], recvtypes[rank], schedule, false);
+    if (!inplace && sendcounts[rank] != 0) {
+      rbuf = (char *) recvbuf + rdispls[rank];
+      sbuf = (char *) sendbuf + sdispls[rank];
+      res = NBC_Sched_copy(sbuf, false, sendcounts[rank], sendtypes[rank],
+                           rbuf, false, recvcounts[rank], recvtypes[rank], schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        return res;
+      }
+    }
+
+    if (inplace) {
+      res = a2aw_sched_inplace(rank, p, schedule, recvbuf,
+                                   recvcounts, rdispls, recvtypes);
+    } else {
+      res = a2aw_sched_linear(rank, p, schedule,
+                              sendbuf, sendcounts, sdispls, sendtypes,
+                              recvbuf, recvcounts, rdispls, recvtypes);
+    }
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
       return res;
     }
-  }
 
-  if (inplace) {
-    res = a2aw_sched_inplace(rank, p, schedule, recvbuf,
-                                 recvcounts, rdispls, recvtypes);
-  } else {
-    res = a2aw_sched_linear(rank, p, schedule,
-                            sendbuf, sendcounts, sdispls, sendtypes,
-                            recvbuf, recvcounts, rdispls, recvtypes);
-  }
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
@@ -155,41 +172,58 @@ static int nbc_alltoallw_inter_init (const void* sendbuf, const int *sendcounts,
 {
   int res, rsize;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, *sbuf;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
   rsize = ompi_comm_remote_size (comm);
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_ALLTOALLW, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, sendcounts, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, sdispls, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, recvcounts, rsize * sizeof(int));
+  NBC_Cache_key_add(&key, rdispls, rsize * sizeof(int));
+  for (int i = 0 ; i < rsize ; ++i) {
+    NBC_Cache_key_add_type(&key, sendtypes[i]);
+    NBC_Cache_key_add_type(&key, recvtypes[i]);
   }
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  for (int i = 0 ; i < rsize ; ++i) {
-    /* post all sends */
-    if (sendcounts[i] != 0) {
-      sbuf = (char *) sendbuf + sdispls[i];
-      res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtypes[i], i, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+    for (int i = 0 ; i < rsize ; ++i) {
+      /* post all sends */
+      if (sendcounts[i] != 0) {
+        sbuf = (char *) sendbuf + sdispls[i];
+        res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtypes[i], i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
-    }
-    /* post all receives */
-    if (recvcounts[i] != 0) {
-      rbuf = (char *) recvbuf + rdispls[i];
-      res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtypes[i], i, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+      /* post all receives */
+      if (recvcounts[i] != 0) {
+        rbuf = (char *) recvbuf + rdispls[i];
+        res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtypes[i], i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
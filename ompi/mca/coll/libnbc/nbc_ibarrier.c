@@ -27,19 +27,17 @@ static int nbc_barrier_init(struct ompi_communicator_t *comm, ompi_request_t **
 {
   int rank, p, maxround, res, recvpeer, sendpeer;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
   rank = ompi_comm_rank (comm);
   p = ompi_comm_size (comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* there only one argument set per communicator -> hang it directly at
-   * the tree-position, NBC_Dict_size[...] is 0 for not initialized and
-   * 1 for initialized. NBC_Dict[...] is a pointer to the schedule in
-   * this case */
-  if (libnbc_module->NBC_Dict_size[NBC_BARRIER] == 0) {
-    /* we did not init it yet */
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_BARRIER, persistent, NULL, NULL, NULL);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -82,13 +80,8 @@ static int nbc_barrier_init(struct ompi_communicator_t *comm, ompi_request_t **
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* add it */
-    libnbc_module->NBC_Dict[NBC_BARRIER] = (hb_tree *) schedule;
-    libnbc_module->NBC_Dict_size[NBC_BARRIER] = 1;
+    NBC_Cache_insert(entry, schedule);
   }
-  OBJ_RETAIN(schedule);
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -121,61 +114,70 @@ static int nbc_barrier_inter_init(struct ompi_communicator_t *comm, ompi_request
 {
   int rank, res, rsize;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
   rank = ompi_comm_rank (comm);
   rsize = ompi_comm_remote_size (comm);
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_BARRIER, persistent, NULL, NULL, NULL);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  if (0 == rank) {
-    for (int peer = 1 ; peer < rsize ; ++peer) {
-      res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, peer, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+    if (0 == rank) {
+      for (int peer = 1 ; peer < rsize ; ++peer) {
+        res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, peer, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  }
-
-  /* synchronize with the remote root */
-  res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, 0, schedule, false);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
-  }
 
-  res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, 0, schedule, false);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
-  }
+    /* synchronize with the remote root */
+    res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, 0, schedule, false);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
 
-  if (0 == rank) {
-    /* wait for the remote root */
-    res = NBC_Sched_barrier (schedule);
+    res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, 0, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
 
-    /* inform remote peers that all local peers have entered the barrier */
-    for (int peer = 1; peer < rsize ; ++peer) {
-      res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, peer, schedule, false);
+    if (0 == rank) {
+      /* wait for the remote root */
+      res = NBC_Sched_barrier (schedule);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
       }
+
+      /* inform remote peers that all local peers have entered the barrier */
+      for (int peer = 1; peer < rsize ; ++peer) {
+        res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, peer, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
+      }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -29,24 +29,6 @@ static inline int bcast_sched_chain(int rank, int p, int root, NBC_Schedule *sch
 static inline int bcast_sched_knomial(int rank, int comm_size, int root, NBC_Schedule *schedule, void *buf,
                                       int count, MPI_Datatype datatype, int knomial_radix);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param) {
-  if ((a->buffer == b->buffer) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->root == b->root) ) {
-    return 0;
-  }
-
-  if( a->buffer < b->buffer ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int root,
                           struct ompi_communicator_t *comm, ompi_request_t ** request,
                           struct mca_coll_base_module_2_3_0_t *module, bool persistent)
@@ -54,9 +36,8 @@ static int nbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int ro
   int rank, p, res, segsize;
   size_t size;
   NBC_Schedule *schedule;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Bcast_args *args, *found, search;
-#endif
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   enum { NBC_BCAST_LINEAR, NBC_BCAST_BINOMIAL, NBC_BCAST_CHAIN, NBC_BCAST_KNOMIAL } alg;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -112,15 +93,16 @@ static int nbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int ro
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.buffer = buffer;
-  search.count = count;
-  search.datatype = datatype;
-  search.root = root;
-  found = (NBC_Bcast_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST], &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_BCAST, persistent, NULL, buffer, NULL);
+  NBC_Cache_key_add(&key, &count, sizeof(count));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  NBC_Cache_key_add(&key, &alg, sizeof(alg));
+  NBC_Cache_key_add(&key, &segsize, sizeof(segsize));
+  NBC_Cache_key_add(&key, &libnbc_ibcast_knomial_radix, sizeof(libnbc_ibcast_knomial_radix));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -152,35 +134,8 @@ static int nbc_bcast_init(void *buffer, int count, MPI_Datatype datatype, int ro
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Bcast_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->buffer = buffer;
-      args->count = count;
-      args->datatype = datatype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN (schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_BCAST] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST],
-                                   &libnbc_module->NBC_Dict_size[NBC_BCAST]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -413,42 +368,54 @@ static int nbc_bcast_inter_init(void *buffer, int count, MPI_Datatype datatype,
                                 struct mca_coll_base_module_2_3_0_t *module, bool persistent) {
   int res;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_BCAST, persistent, NULL, buffer, NULL);
+  NBC_Cache_key_add(&key, &count, sizeof(count));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  if (root != MPI_PROC_NULL) {
-    /* send to all others */
-    if (root == MPI_ROOT) {
-      int remsize;
+    if (root != MPI_PROC_NULL) {
+      /* send to all others */
+      if (root == MPI_ROOT) {
+        int remsize;
 
-      remsize = ompi_comm_remote_size (comm);
+        remsize = ompi_comm_remote_size (comm);
 
-      for (int peer = 0 ; peer < remsize ; ++peer) {
-        /* send msg to peer */
-        res = NBC_Sched_send (buffer, false, count, datatype, peer, schedule, false);
+        for (int peer = 0 ; peer < remsize ; ++peer) {
+          /* send msg to peer */
+          res = NBC_Sched_send (buffer, false, count, datatype, peer, schedule, false);
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            return res;
+          }
+        }
+      } else {
+        /* recv msg from root */
+        res = NBC_Sched_recv (buffer, false, count, datatype, root, schedule, false);
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
           OBJ_RELEASE(schedule);
           return res;
         }
       }
-    } else {
-      /* recv msg from root */
-      res = NBC_Sched_recv (buffer, false, count, datatype, root, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -23,27 +23,6 @@
  */
 #include "nbc_internal.h"
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) &&
-      (a->root == b->root)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_gather_init(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf,
                            int recvcount, MPI_Datatype recvtype, int root,
                            struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -51,6 +30,8 @@ static int nbc_gather_init(const void* sendbuf, int sendcount, MPI_Datatype send
   int rank, p, res;
   MPI_Aint rcvext = 0;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -73,21 +54,18 @@ static int nbc_gather_init(const void* sendbuf, int sendcount, MPI_Datatype send
     sendtype = recvtype;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Gather_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  search.root = root;
-  found = (NBC_Gather_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                              &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_GATHER, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+  NBC_Cache_key_add_type(&key, sendtype);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  /* the receive arguments are only significant at the root */
+  if (rank == root) {
+    NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+    NBC_Cache_key_add_type(&key, recvtype);
+  }
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -131,38 +109,8 @@ static int nbc_gather_init(const void* sendbuf, int sendcount, MPI_Datatype send
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Gather_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_GATHER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                   &libnbc_module->NBC_Dict_size[NBC_GATHER]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -200,6 +148,8 @@ static int nbc_gather_inter_init (const void* sendbuf, int sendcount, MPI_Dataty
     int res, rsize;
     MPI_Aint rcvext = 0;
     NBC_Schedule *schedule;
+    NBC_Cache_key key;
+    NBC_Cache_entry *entry;
     char *rbuf;
     ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -213,35 +163,50 @@ static int nbc_gather_inter_init (const void* sendbuf, int sendcount, MPI_Dataty
         }
     }
 
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
+    /* search schedule in the communicator specific cache */
+    NBC_Cache_key_init(&key, NBC_GATHER, persistent, sendbuf, recvbuf, NULL);
+    NBC_Cache_key_add(&key, &root, sizeof(root));
+    if (MPI_ROOT == root) {
+        NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+        NBC_Cache_key_add_type(&key, recvtype);
+    } else if (MPI_PROC_NULL != root) {
+        NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+        NBC_Cache_key_add_type(&key, sendtype);
     }
-
-    /* send to root */
-    if (root != MPI_ROOT && root != MPI_PROC_NULL) {
-        /* send msg to root */
-        res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-          OBJ_RELEASE(schedule);
-          return res;
+    schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+    if (NULL == schedule) {
+        schedule = OBJ_NEW(NBC_Schedule);
+        if (OPAL_UNLIKELY(NULL == schedule)) {
+          return OMPI_ERR_OUT_OF_RESOURCE;
         }
-    } else if (MPI_ROOT == root) {
-        for (int i = 0 ; i < rsize ; ++i) {
-            rbuf = ((char *)recvbuf) + (i * recvcount * rcvext);
-            /* root receives message to the right buffer */
-            res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
+
+        /* send to root */
+        if (root != MPI_ROOT && root != MPI_PROC_NULL) {
+            /* send msg to root */
+            res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
             if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
               OBJ_RELEASE(schedule);
               return res;
             }
+        } else if (MPI_ROOT == root) {
+            for (int i = 0 ; i < rsize ; ++i) {
+                rbuf = ((char *)recvbuf) + (i * recvcount * rcvext);
+                /* root receives message to the right buffer */
+                res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
+                if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+                  OBJ_RELEASE(schedule);
+                  return res;
+                }
+            }
         }
-    }
 
-    res = NBC_Sched_commit (schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+        res = NBC_Sched_commit (schedule);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
+
+        NBC_Cache_insert(entry, schedule);
     }
 
     res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
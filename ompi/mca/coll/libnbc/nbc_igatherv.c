@@ -24,9 +24,9 @@
  */
 #include "nbc_internal.h"
 
-/* an gatherv schedule can not be cached easily because the contents
- * ot the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
+/* the contents of the count and displacement arrays may change between two
+ * calls with the same arrays, so they are copied into the key of the
+ * schedule cache */
 
 
 static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
@@ -36,6 +36,8 @@ static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sen
   int rank, p, res;
   MPI_Aint rcvext = 0;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -53,47 +55,68 @@ static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sen
     }
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
-
-  /* send to root */
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_GATHERV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  /* the receive arguments are only significant at the root */
   if (rank != root) {
-    /* send msg to root */
-    res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
-    }
+    NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+    NBC_Cache_key_add_type(&key, sendtype);
   } else {
-    for (int i = 0 ; i < p ; ++i) {
-      rbuf = (char *) recvbuf + displs[i] * rcvext;
-      if (i == root) {
-        if (!inplace) {
-          /* if I am the root - just copy the message */
-          res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
-                                rbuf, false, recvcounts[i], recvtype, schedule, false);
+    NBC_Cache_key_add(&key, recvcounts, p * sizeof(int));
+    NBC_Cache_key_add(&key, displs, p * sizeof(int));
+    NBC_Cache_key_add_type(&key, recvtype);
+    if (!inplace) {
+      NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+      NBC_Cache_key_add_type(&key, sendtype);
+    }
+  }
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* send to root */
+    if (rank != root) {
+      /* send msg to root */
+      res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+    } else {
+      for (int i = 0 ; i < p ; ++i) {
+        rbuf = (char *) recvbuf + displs[i] * rcvext;
+        if (i == root) {
+          if (!inplace) {
+            /* if I am the root - just copy the message */
+            res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
+                                  rbuf, false, recvcounts[i], recvtype, schedule, false);
+            if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+              OBJ_RELEASE(schedule);
+              return res;
+            }
+          }
+        } else {
+          /* root receives message to the right buffer */
+          res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
           if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
             OBJ_RELEASE(schedule);
             return res;
           }
         }
-      } else {
-        /* root receives message to the right buffer */
-        res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-          OBJ_RELEASE(schedule);
-          return res;
-        }
       }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -132,6 +155,8 @@ static int nbc_gatherv_inter_init (const void* sendbuf, int sendcount, MPI_Datat
   int res, rsize;
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *rbuf;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -145,35 +170,51 @@ static int nbc_gatherv_inter_init (const void* sendbuf, int sendcount, MPI_Datat
     }
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_GATHERV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  if (MPI_ROOT == root) {
+    NBC_Cache_key_add(&key, recvcounts, rsize * sizeof(int));
+    NBC_Cache_key_add(&key, displs, rsize * sizeof(int));
+    NBC_Cache_key_add_type(&key, recvtype);
+  } else if (MPI_PROC_NULL != root) {
+    NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+    NBC_Cache_key_add_type(&key, sendtype);
   }
-
-  /* send to root */
-  if (MPI_ROOT != root && MPI_PROC_NULL != root) {
-    /* send msg to root */
-    res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
     }
-  } else if (MPI_ROOT == root) {
-    for (int i = 0 ; i < rsize ; ++i) {
-      rbuf = (char *) recvbuf + displs[i] * rcvext;
-      /* root receives message to the right buffer */
-      res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
+
+    /* send to root */
+    if (MPI_ROOT != root && MPI_PROC_NULL != root) {
+      /* send msg to root */
+      res = NBC_Sched_send (sendbuf, false, sendcount, sendtype, root, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
       }
+    } else if (MPI_ROOT == root) {
+      for (int i = 0 ; i < rsize ; ++i) {
+        rbuf = (char *) recvbuf + displs[i] * rcvext;
+        /* root receives message to the right buffer */
+        res = NBC_Sched_recv (rbuf, false, recvcounts[i], recvtype, i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
+      }
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
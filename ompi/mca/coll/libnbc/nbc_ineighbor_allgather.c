@@ -20,29 +20,6 @@
  */
 #include "nbc_internal.h"
 
-/* cannot cache schedules because one cannot check locally if the pattern is the same!! */
-#undef NBC_CACHE_SCHEDULE
-
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Ineighbor_allgather_args_compare(NBC_Ineighbor_allgather_args *a, NBC_Ineighbor_allgather_args *b, void *param) {
-  if ((a->sbuf == b->sbuf) &&
-      (a->scount == b->scount) &&
-      (a->stype == b->stype) &&
-      (a->rbuf == b->rbuf) &&
-      (a->rcount == b->rcount) &&
-      (a->rtype == b->rtype) ) {
-    return  0;
-  }
-
-  if( a->sbuf < b->sbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 
 static int nbc_neighbor_allgather_init(const void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
                                        int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
@@ -50,8 +27,13 @@ static int nbc_neighbor_allgather_init(const void *sbuf, int scount, MPI_Datatyp
                                        struct mca_coll_base_module_2_3_0_t *module, bool persistent) {
   int res, indegree, outdegree, *srcs, *dsts;
   MPI_Aint rcvext;
+  size_t ssize, rsize;
+  bool combine[2] = {false, false};
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+  ompi_coll_libnbc_combine_t *plan;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
 
   res = ompi_datatype_type_extent (rtype, &rcvext);
   if (MPI_SUCCESS != res) {
@@ -59,25 +41,39 @@ static int nbc_neighbor_allgather_init(const void *sbuf, int scount, MPI_Datatyp
     return res;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Ineighbor_allgather_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sbuf = sbuf;
-  search.scount = scount;
-  search.stype = stype;
-  search.rbuf = rbuf;
-  search.rcount = rcount;
-  search.rtype = rtype;
-  found = (NBC_Ineighbor_allgather_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLGATHER],
-                                                           &search);
-  if (NULL == found) {
-#endif
+  /* combine the messages to each remote node (see nbc_neighbor_combine.c) */
+  plan = NBC_Combine_get(libnbc_module);
+  if (NULL != plan) {
+    ompi_datatype_type_size(stype, &ssize);
+    ompi_datatype_type_size(rtype, &rsize);
+    combine[0] = ssize * scount <= libnbc_neighbor_combine_size;
+    combine[1] = rsize * rcount <= libnbc_neighbor_combine_size;
+  }
+
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_NEIGHBOR_ALLGATHER, persistent, sbuf, rbuf, NULL);
+  NBC_Cache_key_add(&key, &scount, sizeof(scount));
+  NBC_Cache_key_add_type(&key, stype);
+  NBC_Cache_key_add(&key, &rcount, sizeof(rcount));
+  NBC_Cache_key_add_type(&key, rtype);
+  NBC_Cache_key_add(&key, combine, sizeof(combine));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
+    if (combine[0] || combine[1]) {
+      res = NBC_Combine_sched_allgather(plan, combine[0], combine[1], sbuf, scount, stype, rbuf, rcount,
+                                        rtype, rcvext, schedule);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+      goto commit;
+    }
+
     res = NBC_Comm_neighbors (comm, &srcs, &indegree, &dsts, &outdegree);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
@@ -86,7 +82,7 @@ static int nbc_neighbor_allgather_init(const void *sbuf, int scount, MPI_Datatyp
 
     for (int i = 0 ; i < indegree ; ++i) {
       if (MPI_PROC_NULL != srcs[i]) {
-        res = NBC_Sched_recv ((char *) rbuf + i * rcount * rcvext, true, rcount, rtype, srcs[i], schedule, false);
+        res = NBC_Sched_recv ((char *) rbuf + i * rcount * rcvext, false, rcount, rtype, srcs[i], schedule, false);
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
           break;
         }
@@ -117,42 +113,15 @@ static int nbc_neighbor_allgather_init(const void *sbuf, int scount, MPI_Datatyp
       return res;
     }
 
+  commit:
     res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Ineighbor_allgather_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sbuf = sbuf;
-      args->scount = scount;
-      args->stype = stype;
-      args->rbuf = rbuf;
-      args->rcount = rcount;
-      args->rtype = rtype;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLGATHER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_NEIGHBOR_ALLGATHER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLGATHER],
-                                   &libnbc_module->NBC_Dict_size[NBC_NEIGHBOR_ALLGATHER]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
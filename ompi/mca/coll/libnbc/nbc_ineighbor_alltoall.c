@@ -20,35 +20,20 @@
  */
 #include "nbc_internal.h"
 
-/* cannot cache schedules because one cannot check locally if the pattern is the same!! */
-#undef NBC_CACHE_SCHEDULE
-
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Ineighbor_alltoall_args_compare(NBC_Ineighbor_alltoall_args *a, NBC_Ineighbor_alltoall_args *b, void *param) {
-  if( (a->sbuf == b->sbuf) &&
-      (a->scount == b->scount) &&
-      (a->stype == b->stype) &&
-      (a->rbuf == b->rbuf) &&
-      (a->rcount == b->rcount) &&
-      (a->rtype == b->rtype) ) {
-    return  0;
-  }
-  if( a->sbuf < b->sbuf ) {
-    return -1;
-  }
-  return +1;
-}
-#endif
-
 static int nbc_neighbor_alltoall_init(const void *sbuf, int scount, MPI_Datatype stype, void *rbuf,
                                       int rcount, MPI_Datatype rtype, struct ompi_communicator_t *comm,
                                       ompi_request_t ** request,
                                       struct mca_coll_base_module_2_3_0_t *module, bool persistent) {
   int res, indegree, outdegree, *srcs, *dsts;
   MPI_Aint sndext, rcvext;
+  size_t ssize, rsize;
+  bool combine[2] = {false, false};
+  void *tmpbuf = NULL;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+  ompi_coll_libnbc_combine_t *plan;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
 
   res = ompi_datatype_type_extent(stype, &sndext);
   if (MPI_SUCCESS != res) {
@@ -62,25 +47,53 @@ static int nbc_neighbor_alltoall_init(const void *sbuf, int scount, MPI_Datatype
     return res;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Ineighbor_alltoall_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sbuf = sbuf;
-  search.scount = scount;
-  search.stype = stype;
-  search.rbuf = rbuf;
-  search.rcount = rcount;
-  search.rtype = rtype;
-  found = (NBC_Ineighbor_alltoall_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLTOALL],
-                                                          &search);
-  if (NULL == found) {
-#endif
+  /* combine the messages to each remote node (see nbc_neighbor_combine.c) */
+  plan = NBC_Combine_get(libnbc_module);
+  if (NULL != plan) {
+    ompi_datatype_type_size(stype, &ssize);
+    ompi_datatype_type_size(rtype, &rsize);
+    combine[0] = ssize * scount <= libnbc_neighbor_combine_size;
+    combine[1] = rsize * rcount <= libnbc_neighbor_combine_size;
+    if (combine[0] || combine[1]) {
+      size_t size = NBC_Combine_alltoall_tmpbuf_size(plan, combine[0], combine[1], scount, stype,
+                                                     rcount, rtype);
+
+      /* nothing to pack with empty messages */
+      if (0 != size) {
+        tmpbuf = malloc(size);
+        if (OPAL_UNLIKELY(NULL == tmpbuf)) {
+          return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+      }
+    }
+  }
+
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_NEIGHBOR_ALLTOALL, persistent, sbuf, rbuf, tmpbuf);
+  NBC_Cache_key_add(&key, &scount, sizeof(scount));
+  NBC_Cache_key_add_type(&key, stype);
+  NBC_Cache_key_add(&key, &rcount, sizeof(rcount));
+  NBC_Cache_key_add_type(&key, rtype);
+  NBC_Cache_key_add(&key, combine, sizeof(combine));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
       return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
+    if (combine[0] || combine[1]) {
+      res = NBC_Combine_sched_alltoall(plan, combine[0], combine[1], sbuf, scount, stype, sndext, rbuf,
+                                       rcount, rtype, rcvext, schedule);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        free(tmpbuf);
+        return res;
+      }
+      goto commit;
+    }
+
     res = NBC_Comm_neighbors(comm, &srcs, &indegree, &dsts, &outdegree);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
@@ -89,7 +102,7 @@ static int nbc_neighbor_alltoall_init(const void *sbuf, int scount, MPI_Datatype
 
     for (int i = 0 ; i < indegree ; ++i) {
       if (MPI_PROC_NULL != srcs[i]) {
-        res = NBC_Sched_recv ((char *) rbuf + i * rcount * rcvext, true, rcount, rtype, srcs[i], schedule, false);
+        res = NBC_Sched_recv ((char *) rbuf + i * rcount * rcvext, false, rcount, rtype, srcs[i], schedule, false);
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
           break;
         }
@@ -120,47 +133,21 @@ static int nbc_neighbor_alltoall_init(const void *sbuf, int scount, MPI_Datatype
       return res;
     }
 
+  commit:
     res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
+      free(tmpbuf);
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Ineighbor_alltoall_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sbuf = sbuf;
-      args->scount = scount;
-      args->stype = stype;
-      args->rbuf = rbuf;
-      args->rcount = rcount;
-      args->rtype = rtype;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLTOALL], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_NEIGHBOR_ALLTOALL] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_NEIGHBOR_ALLTOALL],
-                                   &libnbc_module->NBC_Dict_size[NBC_NEIGHBOR_ALLTOALL]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
+    free(tmpbuf);
     return res;
   }
 
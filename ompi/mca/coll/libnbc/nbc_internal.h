@@ -37,6 +37,7 @@
 #include "ompi/request/request.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/communicator/communicator.h"
+#include "opal/mca/timer/base/base.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -44,7 +45,6 @@
 #include <assert.h>
 #include <math.h>
 #include <string.h>
-#include "libdict/dict.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -74,6 +74,12 @@ extern "C" {
 #define NBC_SCAN 13
 #define NBC_SCATTER 14
 #define NBC_SCATTERV 15
+#define NBC_REDUCESCAT_BLOCK 16
+#define NBC_NEIGHBOR_ALLGATHER 17
+#define NBC_NEIGHBOR_ALLGATHERV 18
+#define NBC_NEIGHBOR_ALLTOALL 19
+#define NBC_NEIGHBOR_ALLTOALLV 20
+#define NBC_NEIGHBOR_ALLTOALLW 21
 /* set the number of collectives in nbc.h !!!! */
 
 /* several typedefs for NBC */
@@ -87,63 +93,10 @@ typedef enum {
   UNPACK
 } NBC_Fn_type;
 
-/* the send argument struct */
-typedef struct {
-  NBC_Fn_type type;
-  int count;
-  const void *buf;
-  MPI_Datatype datatype;
-  int dest;
-  char tmpbuf;
-  bool local;
-} NBC_Args_send;
-
-/* the receive argument struct */
-typedef struct {
-  NBC_Fn_type type;
-  int count;
-  void *buf;
-  MPI_Datatype datatype;
-  char tmpbuf;
-  int source;
-  bool local;
-} NBC_Args_recv;
-
-/* the operation argument struct */
-typedef struct {
-  NBC_Fn_type type;
-  char tmpbuf1;
-  char tmpbuf2;
-  const void *buf1;
-  void *buf2;
-  MPI_Op op;
-  MPI_Datatype datatype;
-  int count;
-} NBC_Args_op;
-
-/* the copy argument struct */
-typedef struct {
-  NBC_Fn_type type;
-  int srccount;
-  void *src;
-  void *tgt;
-  MPI_Datatype srctype;
-  MPI_Datatype tgttype;
-  int tgtcount;
-  char tmpsrc;
-  char tmptgt;
-} NBC_Args_copy;
-
-/* unpack operation arguments */
-typedef struct {
-  NBC_Fn_type type;
-  int count;
-  void *inbuf;
-  void *outbuf;
-  MPI_Datatype datatype;
-  char tmpinbuf;
-  char tmpoutbuf;
-} NBC_Args_unpack;
+/* the flags of an operation */
+#define NBC_SCHED_TMPBUF1 0x1 /* buf is an offset into the temporary buffer */
+#define NBC_SCHED_TMPBUF2 0x2 /* buf2 is an offset into the temporary buffer */
+#define NBC_SCHED_LOCAL   0x4 /* SEND/RECV on the local communicator of an intercommunicator */
 
 /* internal function prototypes */
 int NBC_Sched_send (const void* buf, char tmpbuf, int count, MPI_Datatype datatype, int dest, NBC_Schedule *schedule, bool barrier);
@@ -159,117 +112,113 @@ int NBC_Sched_unpack (void *inbuf, char tmpinbuf, int count, MPI_Datatype dataty
 
 int NBC_Sched_barrier (NBC_Schedule *schedule);
 int NBC_Sched_commit (NBC_Schedule *schedule);
+NBC_Schedule *NBC_Sched_dup (const NBC_Schedule *schedule);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* this is a dummy structure which is used to get the schedule out of
- * the collop specific structure. The schedule pointer HAS to be at the
- * first position and should NOT BE REORDERED by the compiler (C
- * guarantees that */
-struct NBC_dummyarg {
-  NBC_Schedule *schedule;
-};
+/* schedule cache (nbc_schedule_cache.c) */
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  int sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  int recvcount;
-  MPI_Datatype recvtype;
-} NBC_Alltoall_args;
-int NBC_Alltoall_args_compare(NBC_Alltoall_args *a, NBC_Alltoall_args *b, void *param);
+/* the buffers a cached schedule is re-bound to */
+#define NBC_CACHE_SENDBUF 0
+#define NBC_CACHE_RECVBUF 1
+#define NBC_CACHE_TMPBUF 2
+#define NBC_CACHE_NBUFS 3
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  int sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  int recvcount;
-  MPI_Datatype recvtype;
-} NBC_Allgather_args;
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  int count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-} NBC_Allreduce_args;
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *buffer;
-  int count;
-  MPI_Datatype datatype;
-  int root;
-} NBC_Bcast_args;
-int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param);
+#define NBC_CACHE_KEY_INLINE 256
+#define NBC_CACHE_KEY_INLINE_OBJS 8
 
+/* the arguments of a collective call which determine its schedule, the
+ * buffers excepted. Keys larger than the inline storage are allocated, and
+ * are released by NBC_Cache_lookup(). */
 typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  int sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  int recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Gather_args;
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  int count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-  int root;
-} NBC_Reduce_args;
-int NBC_Reduce_args_compare(NBC_Reduce_args *a, NBC_Reduce_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  int count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-} NBC_Scan_args;
-int NBC_Scan_args_compare(NBC_Scan_args *a, NBC_Scan_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  int sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  int recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Scatter_args;
-int NBC_Scatter_args_compare(NBC_Scatter_args *a, NBC_Scatter_args *b, void *param);
-
-/* Schedule cache structures/functions */
-void NBC_SchedCache_args_delete(void *entry);
-void NBC_SchedCache_args_delete_key_dummy(void *k);
-
-#endif
+  bool enabled;
+  const void *bufs[NBC_CACHE_NBUFS];
+  char *data;
+  size_t len;
+  size_t size;
+  opal_object_t **objs;
+  int nobjs;
+  int objs_size;
+  char inline_data[NBC_CACHE_KEY_INLINE];
+  opal_object_t *inline_objs[NBC_CACHE_KEY_INLINE_OBJS];
+} NBC_Cache_key;
+
+typedef struct ompi_coll_libnbc_cache_entry_t NBC_Cache_entry;
+
+void NBC_Cache_key_init(NBC_Cache_key *key, int coll, bool persistent, const void *sendbuf,
+                        const void *recvbuf, const void *tmpbuf);
+void NBC_Cache_key_add(NBC_Cache_key *key, const void *data, size_t len);
+void NBC_Cache_key_add_type(NBC_Cache_key *key, MPI_Datatype type);
+void NBC_Cache_key_add_op(NBC_Cache_key *key, MPI_Op op);
+NBC_Schedule *NBC_Cache_lookup(ompi_coll_libnbc_module_t *module, NBC_Cache_key *key,
+                               NBC_Cache_entry **entry);
+void NBC_Cache_insert(NBC_Cache_entry *entry, NBC_Schedule *schedule);
+void NBC_Cache_release(ompi_coll_libnbc_module_t *module);
 
 
 int NBC_Start(NBC_Handle *handle);
 int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
                          ompi_coll_libnbc_module_t *module, bool persistent,
                          ompi_request_t **request, void *tmpbuf);
+int NBC_Reserve_tag(ompi_coll_libnbc_module_t *module);
+int NBC_Schedule_request_tag(NBC_Schedule *schedule, ompi_communicator_t *comm,
+                             ompi_coll_libnbc_module_t *module, bool persistent,
+                             int tag, ompi_request_t **request, void *tmpbuf);
 void NBC_Return_handle(ompi_coll_libnbc_request_t *request);
 static inline int NBC_Type_intrinsic(MPI_Datatype type);
 int NBC_Create_fortran_handle(int *fhandle, NBC_Handle **handle);
 
+/* fusion of small non-blocking allreduces (nbc_iallreduce_fusion.c) */
+typedef struct {
+  const void *sendbuf;
+  void *recvbuf;
+  int count;
+  MPI_Datatype datatype;
+  MPI_Op op;
+} NBC_Fused_args;
+
+struct ompi_coll_libnbc_fusion_t {
+  opal_list_item_t super;
+  opal_mutex_t lock;         /* protects the fields below */
+  ompi_communicator_t *comm;
+  ompi_coll_libnbc_module_t *module;
+  opal_list_t pending;       /* fused requests not reduced yet, in call order */
+  size_t pending_bytes;
+  opal_timer_t first_usec;   /* when the oldest pending request was posted */
+  bool queued;               /* in mca_coll_libnbc_component.fusions, also
+                              * protected by the lock of the component */
+  unsigned int visit;        /* last call to NBC_Fusion_progress visiting it */
+  ompi_request_t *stage;     /* agreement or reduction of the current round */
+  int nreqs;                 /* requests offered to the current round */
+  int agreed;                /* requests reduced by the current round */
+  void *buffer;              /* fused data of the current round */
+};
+typedef struct ompi_coll_libnbc_fusion_t ompi_coll_libnbc_fusion_t;
+OBJ_CLASS_DECLARATION(ompi_coll_libnbc_fusion_t);
+
+int NBC_Iallreduce_tag(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype,
+                       MPI_Op op, ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module,
+                       int tag, ompi_request_t **request);
+bool NBC_Fusion_eligible(int count, MPI_Datatype datatype, ompi_communicator_t *comm);
+int NBC_Fusion_iallreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype,
+                          MPI_Op op, ompi_communicator_t *comm, ompi_request_t **request,
+                          ompi_coll_libnbc_module_t *module);
+int NBC_Fusion_progress(void);
+void NBC_Fusion_release(ompi_coll_libnbc_module_t *module);
+
+/* node aware combining of the neighbor collectives (see nbc_neighbor_combine.c) */
+typedef struct ompi_coll_libnbc_combine_t ompi_coll_libnbc_combine_t;
+
+int NBC_Combine_setup(ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module);
+ompi_coll_libnbc_combine_t *NBC_Combine_get(ompi_coll_libnbc_module_t *module);
+void NBC_Combine_release(ompi_coll_libnbc_module_t *module);
+int NBC_Combine_sched_allgather(ompi_coll_libnbc_combine_t *plan, bool out, bool in, const void *sbuf,
+                                int scount, MPI_Datatype stype, void *rbuf, int rcount, MPI_Datatype rtype,
+                                MPI_Aint rcvext, NBC_Schedule *schedule);
+size_t NBC_Combine_alltoall_tmpbuf_size(ompi_coll_libnbc_combine_t *plan, bool out, bool in, int scount,
+                                        MPI_Datatype stype, int rcount, MPI_Datatype rtype);
+int NBC_Combine_sched_alltoall(ompi_coll_libnbc_combine_t *plan, bool out, bool in, const void *sbuf,
+                               int scount, MPI_Datatype stype, MPI_Aint sndext, void *rbuf, int rcount,
+                               MPI_Datatype rtype, MPI_Aint rcvext, NBC_Schedule *schedule);
+
 /* some macros */
 
 static inline void NBC_Error (char *format, ...) {
@@ -281,94 +230,20 @@ static inline void NBC_Error (char *format, ...) {
   va_end (args);
 }
 
-/* a schedule has the following format:
- * [schedule] ::= [size][round-schedule][delimiter][round-schedule][delimiter]...[end]
- * [size] ::= size of the schedule (int)
- * [round-schedule] ::= [num][type][type-args][type][type-args]...
- * [num] ::= number of elements in round (int)
- * [type] ::= function type (NBC_Fn_type)
- * [type-args] ::= type specific arguments (NBC_Args_send, NBC_Args_recv or, NBC_Args_op)
- * [delimiter] ::= 1 (char) - indicates that a round follows
- * [end] ::= 0 (char) - indicates that this is the last round
+/* a schedule is stored as a structure of arrays:
+ * - the arrays of the operations (buf, datatype, count, peer, type and
+ *   flags) hold the arguments common to all the operations, in the order
+ *   they are executed
+ * - the arrays of the local operations (buf2, datatype2, op and count2)
+ *   hold the second buffer of an OP (the target of the reduction), COPY
+ *   (the target, with its own count and datatype) or UNPACK (the output
+ *   buffer), at the index given by the peer of the operation
+ * - round_start gives the index of the first operation of each round, and
+ *   round_start[num_rounds] is the number of operations
+ * - max_round_reqs is the largest number of requests a round posts, so the
+ *   requests of a handle are allocated once, when the schedule is attached
  */
 
-/*
- * The addresses of components of a round-schedule may be poorly aligned.
- * E.g., single-char delimiters can push addresses to odd-byte boundaries.
- * Or even ints can push 8-byte pointers to 4-byte boundaries.
- * So, for greater portability, we access components of a round-schedule with memcpy.
- */
-#define NBC_GET_BYTES(ptr,x) {memcpy(&x,ptr,sizeof(x)); ptr += sizeof(x);}
-#define NBC_PUT_BYTES(ptr,x) {memcpy(ptr,&x,sizeof(x)); ptr += sizeof(x);}
-
-/* NBC_GET_ROUND_SIZE returns the size in bytes of a round of a NBC_Schedule
- * schedule. A round has the format:
- * [num]{[type][type-args]}
- * e.g. [(int)2][(NBC_Fn_type)SEND][(NBC_Args_send)SEND-ARGS][(NBC_Fn_type)RECV][(NBC_Args_recv)RECV-ARGS] */
-static inline void nbc_get_round_size (char *p, unsigned long *size) {
-  NBC_Fn_type type;
-  unsigned long offset = 0;
-  int num;
-
-  NBC_GET_BYTES(p,num);
-  /*NBC_DEBUG(10, "GET_ROUND_SIZE got %i elements\n", num); */
-  for (int i = 0 ; i < num ; ++i) {
-    memcpy (&type, p + offset, sizeof (type));
-    switch(type) {
-    case SEND:
-      /*printf("found a SEND at offset %li\n", (long)p-(long)schedule); */
-      offset += sizeof(NBC_Args_send);
-      break;
-    case RECV:
-      /*printf("found a RECV at offset %li\n", (long)p-(long)schedule); */
-      offset += sizeof(NBC_Args_recv);
-      break;
-    case OP:
-      /*printf("found a OP at offset %li\n", (long)p-(long)schedule); */
-      offset += sizeof(NBC_Args_op);            \
-      break;
-    case COPY:
-      /*printf("found a COPY at offset %li\n", (long)p-(long)schedule); */
-      offset += sizeof(NBC_Args_copy);
-      break;
-    case UNPACK:
-      /*printf("found a UNPACK at offset %li\n", (long)p-(long)schedule); */
-      offset += sizeof(NBC_Args_unpack);
-      break;
-    default:
-      NBC_Error("NBC_GET_ROUND_SIZE: bad type %i at offset %li", type, offset);
-      return;
-    }
-  }
-
-  *size = offset + sizeof (int);
-}
-
-
-/* returns the size of a schedule in bytes */
-static inline int nbc_schedule_get_size (NBC_Schedule *schedule) {
-  return schedule->size;
-}
-
-/* increase the size of a schedule by size bytes */
-static inline void nbc_schedule_inc_size (NBC_Schedule *schedule, int size) {
-  schedule->size += size;
-}
-
-/* increments the number of operations in the last round */
-static inline void nbc_schedule_inc_round (NBC_Schedule *schedule) {
-  int last_round_num;
-  char *lastround;
-
-  lastround = schedule->data + schedule->current_round_offset;
-
-  /* increment the count in the last round of the schedule (memcpy is used
-   * to protect against unaligned access) */
-  memcpy (&last_round_num, lastround, sizeof (last_round_num));
-  ++last_round_num;
-  memcpy (lastround, &last_round_num, sizeof (last_round_num));
-}
-
 /* returns a no-operation request (e.g. for one process barrier) */
 static inline int nbc_get_noop_request(bool persistent, ompi_request_t **request) {
   if (persistent) {
@@ -379,80 +254,6 @@ static inline int nbc_get_noop_request(bool persistent, ompi_request_t **request
   }
 }
 
-/* NBC_PRINT_ROUND prints a round in a schedule. A round has the format:
- * [num]{[type][type-args]} types: [int]{[enum][args-type]}
- * e.g. [2][SEND][SEND-ARGS][RECV][RECV-ARGS] */
-#define NBC_PRINT_ROUND(schedule) \
- {  \
-   int myrank, i, num; \
-   char *p = (char*) schedule; \
-   NBC_Fn_type type; \
-   NBC_Args_send     sendargs; \
-   NBC_Args_recv     recvargs; \
-   NBC_Args_op         opargs; \
-   NBC_Args_copy     copyargs; \
-   NBC_Args_unpack unpackargs; \
-     \
-   NBC_GET_BYTES(p,num); \
-   MPI_Comm_rank(MPI_COMM_WORLD, &myrank); \
-   printf("[%i] has %i actions: \n", myrank, num); \
-   for (i=0; i<num; i++) { \
-     NBC_GET_BYTES(p,type); \
-     switch(type) { \
-       case SEND: \
-         printf("[%i]  SEND (offset %li) ", myrank, (long)p-(long)schedule); \
-         NBC_GET_BYTES(p,sendargs); \
-         printf("*buf: %lu, count: %i, type: %lu, dest: %i)\n", (unsigned long)sendargs.buf, sendargs.count, (unsigned long)sendargs.datatype, sendargs.dest); \
-         break; \
-       case RECV: \
-         printf("[%i]  RECV (offset %li) ", myrank, (long)p-(long)schedule); \
-         NBC_GET_BYTES(p,recvargs); \
-         printf("*buf: %lu, count: %i, type: %lu, source: %i)\n", (unsigned long)recvargs.buf, recvargs.count, (unsigned long)recvargs.datatype, recvargs.source); \
-         break; \
-       case OP: \
-         printf("[%i]  OP   (offset %li) ", myrank, (long)p-(long)schedule); \
-         NBC_GET_BYTES(p,opargs); \
-         printf("*buf1: %lu, buf2: %lu, count: %i, type: %lu)\n", (unsigned long)opargs.buf1, (unsigned long)opargs.buf2, opargs.count, (unsigned long)opargs.datatype); \
-         break; \
-       case COPY: \
-         printf("[%i]  COPY   (offset %li) ", myrank, (long)p-(long)schedule); \
-         NBC_GET_BYTES(p,copyargs); \
-         printf("*src: %lu, srccount: %i, srctype: %lu, *tgt: %lu, tgtcount: %i, tgttype: %lu)\n", (unsigned long)copyargs.src, copyargs.srccount, (unsigned long)copyargs.srctype, (unsigned long)copyargs.tgt, copyargs.tgtcount, (unsigned long)copyargs.tgttype); \
-         break; \
-       case UNPACK: \
-         printf("[%i]  UNPACK   (offset %li) ", myrank, (long)p-(long)schedule); \
-         NBC_GET_BYTES(p,unpackargs); \
-         printf("*src: %lu, srccount: %i, srctype: %lu, *tgt: %lu\n",(unsigned long)unpackargs.inbuf, unpackargs.count, (unsigned long)unpackargs.datatype, (unsigned long)unpackargs.outbuf); \
-         break; \
-       default: \
-         printf("[%i] NBC_PRINT_ROUND: bad type %i at offset %li\n", myrank, type, (long)p-sizeof(type)-(long)schedule); \
-         return NBC_BAD_SCHED; \
-     } \
-   } \
-   printf("\n"); \
- }
-
-#define NBC_PRINT_SCHED(schedule) \
-{ \
-  int size, myrank; \
-  long round_size; \
-  char *ptr; \
- \
-  NBC_GET_SIZE(schedule, size); \
-  MPI_Comm_rank(MPI_COMM_WORLD, &myrank); \
-  printf("[%i] printing schedule of size %i\n", myrank, size); \
- \
-  /* ptr begins at first round (first int is overall size) */ \
-  ptr = (char*)schedule+sizeof(int); \
-  while ((long)ptr-(long)schedule < size) { \
-    NBC_GET_ROUND_SIZE(ptr, round_size); \
-    printf("[%i] Round at byte %li (size %li) ", myrank, (long)ptr-(long)schedule, round_size); \
-    NBC_PRINT_ROUND(ptr); \
-    ptr += round_size; \
-    ptr += sizeof(char); /* barrier delimiter */ \
-  } \
-}
-
 /*
 #define NBC_DEBUG(level, ...) {}
 */
@@ -549,18 +350,6 @@ static inline int NBC_Unpack(void *src, int srccount, MPI_Datatype srctype, void
   return OMPI_SUCCESS;
 }
 
-/* deletes elements from dict until low watermark is reached */
-static inline void NBC_SchedCache_dictwipe(hb_tree *dict, int *size) {
-  hb_itor *itor;
-
-  itor = hb_itor_new(dict);
-  for (; hb_itor_valid(itor) && (*size>NBC_SCHED_DICT_LOWER); hb_itor_next(itor)) {
-    hb_tree_remove(dict, hb_itor_key(itor), 0);
-    *size = *size-1;
-  }
-  hb_itor_destroy(itor);
-}
-
 #define NBC_IN_PLACE(sendbuf, recvbuf, inplace) \
 { \
   inplace = 0; \
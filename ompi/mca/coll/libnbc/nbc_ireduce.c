@@ -38,26 +38,6 @@ static inline int red_sched_redscat_gather(
     char tmpredbuf, int count, MPI_Datatype datatype, MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmp_buf, struct ompi_communicator_t *comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Reduce_args_compare(NBC_Reduce_args *a, NBC_Reduce_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op) &&
-      (a->root == b->root)) {
-    return 0;
-  }
-
-  if (a->sendbuf < b->sendbuf) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 /* the non-blocking reduce */
 static int nbc_reduce_init(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype,
                            MPI_Op op, int root, struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -66,6 +46,8 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, int count, MPI_Da
   size_t size;
   MPI_Aint ext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *redbuf=NULL, inplace;
   void *tmpbuf;
   char tmpredbuf = 0;
@@ -147,19 +129,15 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, int count, MPI_Da
     return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Reduce_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  search.root = root;
-  found = (NBC_Reduce_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE], &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_REDUCE, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, &count, sizeof(count));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add_op(&key, op);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  NBC_Cache_key_add(&key, &alg, sizeof(alg));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       free(tmpbuf);
@@ -195,37 +173,9 @@ static int nbc_reduce_init(const void* sendbuf, void* recvbuf, int count, MPI_Da
       free(tmpbuf);
       return res;
     }
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Reduce_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for Reduce */
-        if (++libnbc_module->NBC_Dict_size[NBC_REDUCE] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_REDUCE],
-                                   &libnbc_module->NBC_Dict_size[NBC_REDUCE]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -260,6 +210,8 @@ static int nbc_reduce_inter_init(const void* sendbuf, void* recvbuf, int count,
                                  struct mca_coll_base_module_2_3_0_t *module, bool persistent) {
   int rank, res, rsize;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
   ptrdiff_t span, gap;
   void *tmpbuf;
@@ -273,24 +225,35 @@ static int nbc_reduce_inter_init(const void* sendbuf, void* recvbuf, int count,
     return OMPI_ERR_OUT_OF_RESOURCE;
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_REDUCE, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, &count, sizeof(count));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add_op(&key, op);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  res = red_sched_linear (rank, rsize, root, sendbuf, recvbuf, (void *)(-gap), count, datatype, op, schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+    res = red_sched_linear (rank, rsize, root, sendbuf, recvbuf, (void *)(-gap), count, datatype, op, schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  res = NBC_Sched_commit(schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    res = NBC_Sched_commit(schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
+
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
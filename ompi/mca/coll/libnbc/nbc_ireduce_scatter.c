@@ -25,9 +25,8 @@
 
 #include "nbc_internal.h"
 
-/* an reduce_csttare schedule can not be cached easily because the contents
- * ot the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
+/* the contents of the count array may change between two calls with the
+ * same array, so it is copied into the key of the schedule cache */
 
 /* binomial reduce to rank 0 followed by a linear scatter ...
  *
@@ -50,6 +49,8 @@ static int nbc_reduce_scatter_init(const void* sendbuf, void* recvbuf, const int
   ptrdiff_t gap, span, span_align;
   char *sbuf, inplace;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   void *tmpbuf;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
   char *rbuf, *lbuf, *buf;
@@ -94,109 +95,119 @@ static int nbc_reduce_scatter_init(const void* sendbuf, void* recvbuf, const int
   rbuf = (char *)(-gap);
   lbuf = (char *)(span_align - gap);
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_REDUCESCAT, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, recvcounts, p * sizeof(int));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add_op(&key, op);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  for (int r = 1, firstred = 1 ; r <= maxr ; ++r) {
-    if ((rank % (1 << r)) == 0) {
-      /* we have to receive this round */
-      peer = rank + (1 << (r - 1));
-      if (peer < p) {
-        /* we have to wait until we have the data */
-        res = NBC_Sched_recv(rbuf, true, count, datatype, peer, schedule, true);
+    for (int r = 1, firstred = 1 ; r <= maxr ; ++r) {
+      if ((rank % (1 << r)) == 0) {
+        /* we have to receive this round */
+        peer = rank + (1 << (r - 1));
+        if (peer < p) {
+          /* we have to wait until we have the data */
+          res = NBC_Sched_recv(rbuf, true, count, datatype, peer, schedule, true);
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            free(tmpbuf);
+            return res;
+          }
+
+          /* this cannot be done until tmpbuf is unused :-( so barrier after the op */
+          if (firstred) {
+            /* take reduce data from the sendbuf in the first round -> save copy */
+            res = NBC_Sched_op (sendbuf, false, rbuf, true, count, datatype, op, schedule, true);
+            firstred = 0;
+          } else {
+            /* perform the reduce in my local buffer */
+            res = NBC_Sched_op (lbuf, true, rbuf, true, count, datatype, op, schedule, true);
+          }
+
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            free(tmpbuf);
+            return res;
+          }
+          /* swap left and right buffers */
+          buf = rbuf; rbuf = lbuf ; lbuf = buf;
+        }
+      } else {
+        /* we have to send this round */
+        peer = rank - (1 << (r - 1));
+        if (firstred) {
+          /* we have to send the senbuf */
+          res = NBC_Sched_send (sendbuf, false, count, datatype, peer, schedule, false);
+        } else {
+          /* we send an already reduced value from lbuf */
+          res = NBC_Sched_send (lbuf, true, count, datatype, peer, schedule, false);
+        }
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
           OBJ_RELEASE(schedule);
           free(tmpbuf);
           return res;
         }
 
-        /* this cannot be done until tmpbuf is unused :-( so barrier after the op */
-        if (firstred) {
-          /* take reduce data from the sendbuf in the first round -> save copy */
-          res = NBC_Sched_op (sendbuf, false, rbuf, true, count, datatype, op, schedule, true);
-          firstred = 0;
-        } else {
-          /* perform the reduce in my local buffer */
-          res = NBC_Sched_op (lbuf, true, rbuf, true, count, datatype, op, schedule, true);
-        }
+        /* leave the game */
+        break;
+      }
+    }
+
+    res = NBC_Sched_barrier(schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
+    }
 
+    /* rank 0 is root and sends - all others receive */
+    if (rank == 0) {
+      for (long int r = 1, offset = 0 ; r < p ; ++r) {
+        offset += recvcounts[r-1];
+        sbuf = lbuf + (offset*ext);
+        /* root sends the right buffer to the right receiver */
+        res = NBC_Sched_send (sbuf, true, recvcounts[r], datatype, r, schedule,
+                              false);
         if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
           OBJ_RELEASE(schedule);
           free(tmpbuf);
           return res;
         }
-        /* swap left and right buffers */
-        buf = rbuf; rbuf = lbuf ; lbuf = buf;
       }
-    } else {
-      /* we have to send this round */
-      peer = rank - (1 << (r - 1));
-      if (firstred) {
-        /* we have to send the senbuf */
-        res = NBC_Sched_send (sendbuf, false, count, datatype, peer, schedule, false);
+
+      if (p == 1) {
+        /* single node not in_place: copy data to recvbuf */
+        res = NBC_Sched_copy ((void *)sendbuf, false, recvcounts[0], datatype,
+                              recvbuf, false, recvcounts[0], datatype, schedule, false);
       } else {
-        /* we send an already reduced value from lbuf */
-        res = NBC_Sched_send (lbuf, true, count, datatype, peer, schedule, false);
-      }
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        free(tmpbuf);
-        return res;
+        res = NBC_Sched_copy (lbuf, true, recvcounts[0], datatype, recvbuf, false,
+                              recvcounts[0], datatype, schedule, false);
       }
-
-      /* leave the game */
-      break;
+    } else {
+      res = NBC_Sched_recv (recvbuf, false, recvcounts[rank], datatype, 0, schedule, false);
     }
-  }
-
-  res = NBC_Sched_barrier(schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
 
-  /* rank 0 is root and sends - all others receive */
-  if (rank == 0) {
-    for (long int r = 1, offset = 0 ; r < p ; ++r) {
-      offset += recvcounts[r-1];
-      sbuf = lbuf + (offset*ext);
-      /* root sends the right buffer to the right receiver */
-      res = NBC_Sched_send (sbuf, true, recvcounts[r], datatype, r, schedule,
-                            false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        free(tmpbuf);
-        return res;
-      }
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
     }
 
-    if (p == 1) {
-      /* single node not in_place: copy data to recvbuf */
-      res = NBC_Sched_copy ((void *)sendbuf, false, recvcounts[0], datatype,
-                            recvbuf, false, recvcounts[0], datatype, schedule, false);
-    } else {
-      res = NBC_Sched_copy (lbuf, true, recvcounts[0], datatype, recvbuf, false,
-                            recvcounts[0], datatype, schedule, false);
+    res = NBC_Sched_commit (schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      free(tmpbuf);
+      return res;
     }
-  } else {
-    res = NBC_Sched_recv (recvbuf, false, recvcounts[rank], datatype, 0, schedule, false);
-  }
 
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
-
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
@@ -233,6 +244,8 @@ static int nbc_reduce_scatter_inter_init (const void* sendbuf, void* recvbuf, co
   MPI_Aint ext;
   ptrdiff_t gap, span, span_align;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   void *tmpbuf = NULL;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -261,84 +274,94 @@ static int nbc_reduce_scatter_inter_init (const void* sendbuf, void* recvbuf, co
     }
   }
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    free(tmpbuf);
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
-
-  /* send my data to the remote root */
-  res = NBC_Sched_send(sendbuf, false, count, datatype, 0, schedule, false);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
-  }
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_REDUCESCAT, persistent, sendbuf, recvbuf, tmpbuf);
+  NBC_Cache_key_add(&key, recvcounts, lsize * sizeof(int));
+  NBC_Cache_key_add_type(&key, datatype);
+  NBC_Cache_key_add_op(&key, op);
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      free(tmpbuf);
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
 
-  if (0 == rank) {
-    char *lbuf, *rbuf;
-    lbuf = (char *)(-gap);
-    rbuf = (char *)(span_align-gap);
-    res = NBC_Sched_recv (lbuf, true, count, datatype, 0, schedule, true);
+    /* send my data to the remote root */
+    res = NBC_Sched_send(sendbuf, false, count, datatype, 0, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       free(tmpbuf);
       return res;
     }
 
-    for (int peer = 1 ; peer < rsize ; ++peer) {
-      char *tbuf;
-      res = NBC_Sched_recv (rbuf, true, count, datatype, peer, schedule, true);
+    if (0 == rank) {
+      char *lbuf, *rbuf;
+      lbuf = (char *)(-gap);
+      rbuf = (char *)(span_align-gap);
+      res = NBC_Sched_recv (lbuf, true, count, datatype, 0, schedule, true);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         free(tmpbuf);
         return res;
       }
 
-      res = NBC_Sched_op (lbuf, true, rbuf, true, count, datatype,
-                          op, schedule, true);
+      for (int peer = 1 ; peer < rsize ; ++peer) {
+        char *tbuf;
+        res = NBC_Sched_recv (rbuf, true, count, datatype, peer, schedule, true);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          free(tmpbuf);
+          return res;
+        }
+
+        res = NBC_Sched_op (lbuf, true, rbuf, true, count, datatype,
+                            op, schedule, true);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          free(tmpbuf);
+          return res;
+        }
+        tbuf = lbuf; lbuf = rbuf; rbuf = tbuf;
+      }
+
+      /* do the local scatterv with the local communicator */
+      res = NBC_Sched_copy (lbuf, true, recvcounts[0], datatype, recvbuf, false,
+                            recvcounts[0], datatype, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         free(tmpbuf);
         return res;
       }
-      tbuf = lbuf; lbuf = rbuf; rbuf = tbuf;
-    }
+      for (int peer = 1, offset = recvcounts[0] * ext; peer < lsize ; ++peer) {
+        res = NBC_Sched_local_send (lbuf + offset, true, recvcounts[peer], datatype, peer, schedule,
+                                    false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          free(tmpbuf);
+          return res;
+        }
 
-    /* do the local scatterv with the local communicator */
-    res = NBC_Sched_copy (lbuf, true, recvcounts[0], datatype, recvbuf, false,
-                          recvcounts[0], datatype, schedule, false);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      free(tmpbuf);
-      return res;
-    }
-    for (int peer = 1, offset = recvcounts[0] * ext; peer < lsize ; ++peer) {
-      res = NBC_Sched_local_send (lbuf + offset, true, recvcounts[peer], datatype, peer, schedule,
-                                  false);
+        offset += recvcounts[peer] * ext;
+      }
+    } else {
+      /* receive my block */
+      res = NBC_Sched_local_recv (recvbuf, false, recvcounts[rank], datatype, 0, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         free(tmpbuf);
         return res;
       }
-
-      offset += recvcounts[peer] * ext;
     }
-  } else {
-    /* receive my block */
-    res = NBC_Sched_local_recv (recvbuf, false, recvcounts[rank], datatype, 0, schedule, false);
+
+    res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       free(tmpbuf);
       return res;
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    free(tmpbuf);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
@@ -32,31 +32,14 @@ static inline int scan_sched_recursivedoubling(
     int count, MPI_Datatype datatype,  MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmpbuf1, void *tmpbuf2);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Scan_args_compare(NBC_Scan_args *a, NBC_Scan_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op) ) {
-    return 0;
-  }
-
-  if (a->sendbuf < b->sendbuf) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_scan_init(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op,
                          struct ompi_communicator_t *comm, ompi_request_t ** request,
                          struct mca_coll_base_module_2_3_0_t *module, bool persistent) {
     int rank, p, res;
     ptrdiff_t gap, span;
     NBC_Schedule *schedule;
+    NBC_Cache_key key;
+    NBC_Cache_entry *entry;
     void *tmpbuf = NULL, *tmpbuf1 = NULL, *tmpbuf2 = NULL;
     enum { NBC_SCAN_LINEAR, NBC_SCAN_RDBL } alg;
     char inplace;
@@ -87,74 +70,42 @@ static int nbc_scan_init(const void* sendbuf, void* recvbuf, int count, MPI_Data
         }
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Scan_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  found = (NBC_Scan_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCAN], &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-        free(tmpbuf);
-        return OMPI_ERR_OUT_OF_RESOURCE;
-    }
-
-    if (alg == NBC_SCAN_LINEAR) {
-        res = scan_sched_linear(rank, p, sendbuf, recvbuf, count, datatype,
-                                op, inplace, schedule, tmpbuf);
-    } else {
-        res = scan_sched_recursivedoubling(rank, p, sendbuf, recvbuf, count,
-                                           datatype, op, inplace, schedule, tmpbuf1, tmpbuf2);
-    }
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        free(tmpbuf);
-        return res;
-    }
-
-    res = NBC_Sched_commit(schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        free(tmpbuf);
-        return res;
-    }
+    /* search schedule in the communicator specific cache */
+    NBC_Cache_key_init(&key, NBC_SCAN, persistent, sendbuf, recvbuf, tmpbuf);
+    NBC_Cache_key_add(&key, &count, sizeof(count));
+    NBC_Cache_key_add_type(&key, datatype);
+    NBC_Cache_key_add_op(&key, op);
+    NBC_Cache_key_add(&key, &alg, sizeof(alg));
+    schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+    if (NULL == schedule) {
+        schedule = OBJ_NEW(NBC_Schedule);
+        if (OPAL_UNLIKELY(NULL == schedule)) {
+            free(tmpbuf);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Scan_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCAN], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
+        if (alg == NBC_SCAN_LINEAR) {
+            res = scan_sched_linear(rank, p, sendbuf, recvbuf, count, datatype,
+                                    op, inplace, schedule, tmpbuf);
+        } else {
+            res = scan_sched_recursivedoubling(rank, p, sendbuf, recvbuf, count,
+                                               datatype, op, inplace, schedule, tmpbuf1, tmpbuf2);
+        }
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            free(tmpbuf);
+            return res;
+        }
 
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_SCAN] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCAN],
-                                   &libnbc_module->NBC_Dict_size[NBC_SCAN]);
+        res = NBC_Sched_commit(schedule);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            free(tmpbuf);
+            return res;
         }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
+
+        NBC_Cache_insert(entry, schedule);
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
-  }
-#endif
 
     res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
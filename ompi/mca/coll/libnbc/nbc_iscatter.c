@@ -23,27 +23,6 @@
  */
 #include "nbc_internal.h"
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Scatter_args_compare(NBC_Scatter_args *a, NBC_Scatter_args *b, void *param) {
-    if ((a->sendbuf == b->sendbuf) &&
-        (a->sendcount == b->sendcount) &&
-        (a->sendtype == b->sendtype) &&
-        (a->recvbuf == b->recvbuf) &&
-        (a->recvcount == b->recvcount) &&
-        (a->recvtype == b->recvtype) &&
-        (a->root == b->root)) {
-        return 0;
-    }
-
-    if (a->sendbuf < b->sendbuf) {
-        return -1;
-    }
-
-    return 1;
-}
-#endif
-
 /* simple linear MPI_Iscatter */
 static int nbc_scatter_init (const void* sendbuf, int sendcount, MPI_Datatype sendtype,
                              void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
@@ -52,6 +31,8 @@ static int nbc_scatter_init (const void* sendbuf, int sendcount, MPI_Datatype se
   int rank, p, res;
   MPI_Aint sndext = 0;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *sbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -70,20 +51,21 @@ static int nbc_scatter_init (const void* sendbuf, int sendcount, MPI_Datatype se
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Scatter_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf=sendbuf;
-  search.sendcount=sendcount;
-  search.sendtype=sendtype;
-  search.recvbuf=recvbuf;
-  search.recvcount=recvcount;
-  search.recvtype=recvtype;
-  search.root=root;
-  found = (NBC_Scatter_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER], &search);
-  if (NULL == found) {
-#endif
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_SCATTER, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  /* the send arguments are only significant at the root, and the receive
+   * arguments are ignored by an in place root */
+  if (rank == root) {
+    NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+    NBC_Cache_key_add_type(&key, sendtype);
+  }
+  if (!inplace) {
+    NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+    NBC_Cache_key_add_type(&key, recvtype);
+  }
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -126,38 +108,9 @@ static int nbc_scatter_init (const void* sendbuf, int sendcount, MPI_Datatype se
       OBJ_RELEASE(schedule);
       return res;
     }
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Scatter_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
 
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_SCATTER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER],
-                                   &libnbc_module->NBC_Dict_size[NBC_SCATTER]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    NBC_Cache_insert(entry, schedule);
   }
-#endif
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
@@ -194,6 +147,8 @@ static int nbc_scatter_inter_init (const void* sendbuf, int sendcount, MPI_Datat
     int res, rsize;
     MPI_Aint sndext;
     NBC_Schedule *schedule;
+    NBC_Cache_key key;
+    NBC_Cache_entry *entry;
     char *sbuf;
     ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -207,35 +162,50 @@ static int nbc_scatter_inter_init (const void* sendbuf, int sendcount, MPI_Datat
         }
     }
 
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-        return OMPI_ERR_OUT_OF_RESOURCE;
+    /* search schedule in the communicator specific cache */
+    NBC_Cache_key_init(&key, NBC_SCATTER, persistent, sendbuf, recvbuf, NULL);
+    NBC_Cache_key_add(&key, &root, sizeof(root));
+    if (MPI_ROOT == root) {
+        NBC_Cache_key_add(&key, &sendcount, sizeof(sendcount));
+        NBC_Cache_key_add_type(&key, sendtype);
+    } else if (MPI_PROC_NULL != root) {
+        NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+        NBC_Cache_key_add_type(&key, recvtype);
     }
-
-    /* receive from root */
-    if (MPI_ROOT != root && MPI_PROC_NULL != root) {
-        /* recv msg from remote root */
-        res = NBC_Sched_recv(recvbuf, false, recvcount, recvtype, root, schedule, false);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-            OBJ_RELEASE(schedule);
-            return res;
+    schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+    if (NULL == schedule) {
+        schedule = OBJ_NEW(NBC_Schedule);
+        if (OPAL_UNLIKELY(NULL == schedule)) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
         }
-    } else if (MPI_ROOT == root) {
-        for (int i = 0 ; i < rsize ; ++i) {
-            sbuf = ((char *)sendbuf) + (i * sendcount * sndext);
-            /* root sends the right buffer to the right receiver */
-            res = NBC_Sched_send(sbuf, false, sendcount, sendtype, i, schedule, false);
+
+        /* receive from root */
+        if (MPI_ROOT != root && MPI_PROC_NULL != root) {
+            /* recv msg from remote root */
+            res = NBC_Sched_recv(recvbuf, false, recvcount, recvtype, root, schedule, false);
             if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
                 OBJ_RELEASE(schedule);
                 return res;
             }
+        } else if (MPI_ROOT == root) {
+            for (int i = 0 ; i < rsize ; ++i) {
+                sbuf = ((char *)sendbuf) + (i * sendcount * sndext);
+                /* root sends the right buffer to the right receiver */
+                res = NBC_Sched_send(sbuf, false, sendcount, sendtype, i, schedule, false);
+                if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+                    OBJ_RELEASE(schedule);
+                    return res;
+                }
+            }
         }
-    }
 
-    res = NBC_Sched_commit(schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+        res = NBC_Sched_commit(schedule);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            return res;
+        }
+
+        NBC_Cache_insert(entry, schedule);
     }
 
     res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -23,9 +23,9 @@
  */
 #include "nbc_internal.h"
 
-/* a scatterv schedule can not be cached easily because the contents
- * ot the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
+/* the contents of the count and displacement arrays may change between two
+ * calls with the same arrays, so they are copied into the key of the
+ * schedule cache */
 
 /* simple linear MPI_Iscatterv */
 static int nbc_scatterv_init(const void* sendbuf, const int *sendcounts, const int *displs, MPI_Datatype sendtype,
@@ -35,6 +35,8 @@ static int nbc_scatterv_init(const void* sendbuf, const int *sendcounts, const i
   int rank, p, res;
   MPI_Aint sndext;
   NBC_Schedule *schedule;
+  NBC_Cache_key key;
+  NBC_Cache_entry *entry;
   char *sbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -45,53 +47,74 @@ static int nbc_scatterv_init(const void* sendbuf, const int *sendcounts, const i
 
   p = ompi_comm_size (comm);
 
-  schedule = OBJ_NEW(NBC_Schedule);
-  if (OPAL_UNLIKELY(NULL == schedule)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
+  /* search schedule in the communicator specific cache */
+  NBC_Cache_key_init(&key, NBC_SCATTERV, persistent, sendbuf, recvbuf, NULL);
+  NBC_Cache_key_add(&key, &root, sizeof(root));
+  /* the send arguments are only significant at the root */
+  if (rank != root) {
+    NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+    NBC_Cache_key_add_type(&key, recvtype);
+  } else {
+    NBC_Cache_key_add(&key, sendcounts, p * sizeof(int));
+    NBC_Cache_key_add(&key, displs, p * sizeof(int));
+    NBC_Cache_key_add_type(&key, sendtype);
+    if (!inplace) {
+      NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+      NBC_Cache_key_add_type(&key, recvtype);
+    }
   }
-
-  /* receive from root */
-  if (rank == root) {
-    res = ompi_datatype_type_extent (sendtype, &sndext);
-    if (MPI_SUCCESS != res) {
-      NBC_Error("MPI Error in ompi_datatype_type_extent() (%i)", res);
-      OBJ_RELEASE(schedule);
-      return res;
+  schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+  if (NULL == schedule) {
+    schedule = OBJ_NEW(NBC_Schedule);
+    if (OPAL_UNLIKELY(NULL == schedule)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
     }
 
-    for (int i = 0 ; i < p ; ++i) {
-      sbuf = (char *) sendbuf + displs[i] * sndext;
-      if (i == root) {
-        if (!inplace) {
-          /* if I am the root - just copy the message */
-          res = NBC_Sched_copy (sbuf, false, sendcounts[i], sendtype,
-                                recvbuf, false, recvcount, recvtype, schedule, false);
+    /* receive from root */
+    if (rank == root) {
+      res = ompi_datatype_type_extent (sendtype, &sndext);
+      if (MPI_SUCCESS != res) {
+        NBC_Error("MPI Error in ompi_datatype_type_extent() (%i)", res);
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+
+      for (int i = 0 ; i < p ; ++i) {
+        sbuf = (char *) sendbuf + displs[i] * sndext;
+        if (i == root) {
+          if (!inplace) {
+            /* if I am the root - just copy the message */
+            res = NBC_Sched_copy (sbuf, false, sendcounts[i], sendtype,
+                                  recvbuf, false, recvcount, recvtype, schedule, false);
+          } else {
+            res = OMPI_SUCCESS;
+          }
         } else {
-          res = OMPI_SUCCESS;
+          /* root sends the right buffer to the right receiver */
+          res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
         }
-      } else {
-        /* root sends the right buffer to the right receiver */
-        res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
-      }
 
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
+      }
+    } else {
+      /* recv msg from root */
+      res = NBC_Sched_recv (recvbuf, false, recvcount, recvtype, root, schedule, false);
       if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
       }
     }
-  } else {
-    /* recv msg from root */
-    res = NBC_Sched_recv (recvbuf, false, recvcount, recvtype, root, schedule, false);
+
+    res = NBC_Sched_commit (schedule);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
-  }
 
-  res = NBC_Sched_commit (schedule);
-  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-    OBJ_RELEASE(schedule);
-    return res;
+    NBC_Cache_insert(entry, schedule);
   }
 
   res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
@@ -129,47 +152,65 @@ static int nbc_scatterv_inter_init (const void* sendbuf, const int *sendcounts,
     int res, rsize;
     MPI_Aint sndext;
     NBC_Schedule *schedule;
+    NBC_Cache_key key;
+    NBC_Cache_entry *entry;
     char *sbuf;
     ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
     rsize = ompi_comm_remote_size (comm);
 
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-        return OMPI_ERR_OUT_OF_RESOURCE;
+    /* search schedule in the communicator specific cache */
+    NBC_Cache_key_init(&key, NBC_SCATTERV, persistent, sendbuf, recvbuf, NULL);
+    NBC_Cache_key_add(&key, &root, sizeof(root));
+    if (MPI_ROOT == root) {
+        NBC_Cache_key_add(&key, sendcounts, rsize * sizeof(int));
+        NBC_Cache_key_add(&key, displs, rsize * sizeof(int));
+        NBC_Cache_key_add_type(&key, sendtype);
+    } else if (MPI_PROC_NULL != root) {
+        NBC_Cache_key_add(&key, &recvcount, sizeof(recvcount));
+        NBC_Cache_key_add_type(&key, recvtype);
     }
-
-    /* receive from root */
-    if (MPI_ROOT != root && MPI_PROC_NULL != root) {
-        /* recv msg from root */
-        res = NBC_Sched_recv(recvbuf, false, recvcount, recvtype, root, schedule, false);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-            OBJ_RELEASE(schedule);
-            return res;
-        }
-    } else if (MPI_ROOT == root) {
-        res = ompi_datatype_type_extent(sendtype, &sndext);
-        if (MPI_SUCCESS != res) {
-            NBC_Error("MPI Error in ompi_datatype_type_extent() (%i)", res);
-            OBJ_RELEASE(schedule);
-            return res;
+    schedule = NBC_Cache_lookup(libnbc_module, &key, &entry);
+    if (NULL == schedule) {
+        schedule = OBJ_NEW(NBC_Schedule);
+        if (OPAL_UNLIKELY(NULL == schedule)) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
         }
 
-        for (int i = 0 ; i < rsize ; ++i) {
-            sbuf = (char *)sendbuf + displs[i] * sndext;
-            /* root sends the right buffer to the right receiver */
-            res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
+        /* receive from root */
+        if (MPI_ROOT != root && MPI_PROC_NULL != root) {
+            /* recv msg from root */
+            res = NBC_Sched_recv(recvbuf, false, recvcount, recvtype, root, schedule, false);
             if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
                 OBJ_RELEASE(schedule);
                 return res;
             }
+        } else if (MPI_ROOT == root) {
+            res = ompi_datatype_type_extent(sendtype, &sndext);
+            if (MPI_SUCCESS != res) {
+                NBC_Error("MPI Error in ompi_datatype_type_extent() (%i)", res);
+                OBJ_RELEASE(schedule);
+                return res;
+            }
+
+            for (int i = 0 ; i < rsize ; ++i) {
+                sbuf = (char *)sendbuf + displs[i] * sndext;
+                /* root sends the right buffer to the right receiver */
+                res = NBC_Sched_send (sbuf, false, sendcounts[i], sendtype, i, schedule, false);
+                if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+                    OBJ_RELEASE(schedule);
+                    return res;
+                }
+            }
         }
-    }
 
-    res = NBC_Sched_commit(schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
+        res = NBC_Sched_commit(schedule);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            return res;
+        }
+
+        NBC_Cache_insert(entry, schedule);
     }
 
     res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
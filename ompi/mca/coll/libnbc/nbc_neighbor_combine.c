@@ -0,0 +1,518 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/*
+ * Node aware combining of the neighbor collectives.
+ *
+ * On graph and distributed graph topologies, a process whose destinations
+ * include several processes of the same remote node sends its data to
+ * that node once, to the destination of lowest rank there (the gateway),
+ * which forwards it to the others in a second round. For small messages,
+ * this trades latency bound messages between nodes for messages within a
+ * node. Neighbor allgathers send the same data to the whole group, neighbor
+ * alltoalls send the blocks of the group packed in a single message.
+ *
+ * The plan (which edges are combined, and who forwards what to whom) is
+ * computed when the topology is attached to the communicator, which is
+ * collective and blocking, so that the nonblocking and persistent
+ * collectives never wait on the other processes to start: each process
+ * tells its sources its node, the processes agree on whether combining is
+ * possible and useful, and each source tells its destinations who their
+ * gateway is, and its gateways whom they forward to. The processes agree
+ * after each of these exchanges, and all fall back to the direct messages
+ * if one of them failed. Within an exchange, a process posts all its
+ * messages even if one of them fails, so that no peer is left waiting.
+ * Topologies with repeated or MPI_PROC_NULL neighbors are not combined,
+ * nor are the duplicates of a topology communicator.
+ *
+ * Only neighbor allgather and alltoall are combined. Cartesian topologies
+ * (which would rather forward along each dimension) and the v and w
+ * variants always use the direct messages.
+ *
+ * The size of the messages of an edge is known at both ends (the send size
+ * of the source is the receive size of the destination), but may differ
+ * between processes. Whether a collective combines is thus decided for the
+ * out-edges of a process by its send size, and for its in-edges by its
+ * receive size.
+ */
+
+#include "nbc_internal.h"
+#include "ompi/mca/pml/pml.h"
+#include "opal/mca/hwloc/base/base.h"
+
+struct ompi_coll_libnbc_combine_t {
+  bool enabled;
+  int indegree, outdegree;
+  int *srcs, *dsts;
+  /* out-edges: the out-edge of the gateway of the node of each destination
+   * (the edge itself if it is not combined), and the groups of combined
+   * out-edges, in rank order starting with the gateway */
+  int *out_gateway;
+  int ngroups;
+  int *group_start;
+  int *group;
+  /* in-edges: the process the data of each source is received from (the
+   * source, or the gateway on this node), and for the sources this process
+   * is the gateway of, the processes it forwards to in rank order */
+  int *in_from;
+  int *in_fwd_start;
+  int *in_fwd;
+  int *in_order;             /* the in-edges by increasing source rank */
+};
+
+/* sort keys, only used while setting up a plan (which is collective) */
+static const int *combine_key1, *combine_key2;
+
+static int combine_compare(const void *a, const void *b) {
+  int ia = *(const int *) a, ib = *(const int *) b;
+
+  if (combine_key1[ia] != combine_key1[ib]) {
+    return combine_key1[ia] < combine_key1[ib] ? -1 : 1;
+  }
+  if (NULL != combine_key2 && combine_key2[ia] != combine_key2[ib]) {
+    return combine_key2[ia] < combine_key2[ib] ? -1 : 1;
+  }
+  return 0;
+}
+
+/* sorts the indices 0 to n - 1 by key1, then key2 */
+static void combine_sort(int *idx, int n, const int *key1, const int *key2) {
+  for (int i = 0 ; i < n ; ++i) {
+    idx[i] = i;
+  }
+  combine_key1 = key1;
+  combine_key2 = key2;
+  qsort(idx, n, sizeof(int), combine_compare);
+}
+
+static bool combine_has_duplicates(const int *ranks, int n, int *idx) {
+  combine_sort(idx, n, ranks, NULL);
+  for (int i = 0 ; i < n ; ++i) {
+    if (MPI_PROC_NULL == ranks[idx[i]] || (i > 0 && ranks[idx[i]] == ranks[idx[i - 1]])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void NBC_Combine_release(ompi_coll_libnbc_module_t *module) {
+  ompi_coll_libnbc_combine_t *plan = module->combine;
+
+  if (NULL != plan) {
+    free(plan->srcs);
+    free(plan->dsts);
+    free(plan->out_gateway);
+    free(plan->group_start);
+    free(plan->group);
+    free(plan->in_from);
+    free(plan->in_fwd_start);
+    free(plan->in_fwd);
+    free(plan->in_order);
+    free(plan);
+    module->combine = NULL;
+  }
+}
+
+/* posts a request of the plan messages. A failed post does not stop the
+ * others, so that the peers do not wait on messages that were never
+ * posted, and is reported by the agreement that follows the exchange */
+#define COMBINE_POST(res, nreqs, call)   \
+  do {                                   \
+    int _err = MCA_PML_CALL(call);       \
+    if (OMPI_SUCCESS == _err) {          \
+      ++(nreqs);                         \
+    } else {                             \
+      (res) = _err;                      \
+    }                                    \
+  } while (0)
+
+/* waits for the nreqs posted requests, keeps the first error in res */
+static int combine_wait(ompi_request_t **reqs, int *nreqs, int res) {
+  if (*nreqs > 0 && OMPI_SUCCESS != ompi_request_wait_all(*nreqs, reqs, MPI_STATUSES_IGNORE) &&
+      OMPI_SUCCESS == res) {
+    res = OMPI_ERROR;
+  }
+  *nreqs = 0;
+  return res;
+}
+
+/* the processes agree on flags, by their maximum */
+static int combine_agree(ompi_communicator_t *comm, int *flags, int n) {
+  return comm->c_coll->coll_allreduce(MPI_IN_PLACE, flags, n, MPI_INT, MPI_MAX, comm,
+                                      comm->c_coll->coll_allreduce_module);
+}
+
+/* computes the plan of the communicator. Collective: the processes agree at
+ * each step, so that they all enable the plan or all fall back together */
+static int combine_setup(ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module,
+                         ompi_coll_libnbc_combine_t *plan) {
+  int rank = ompi_comm_rank(comm), indeg, outdeg, res, tag = 0;
+  int *idx = NULL, *dst_nodes = NULL, *in_msg = NULL, *out_msg = NULL;
+  int node = rank, nreqs = 0, nfwd = 0, flags[2];
+  ompi_request_t **reqs = NULL;
+
+  res = NBC_Comm_neighbors(comm, &plan->srcs, &plan->indegree, &plan->dsts, &plan->outdegree);
+  indeg = plan->indegree;
+  outdeg = plan->outdegree;
+  if (OMPI_SUCCESS == res) {
+    idx = (int *) malloc((indeg + outdeg + 1) * sizeof(int));
+    dst_nodes = (int *) malloc((outdeg + 1) * sizeof(int));
+    plan->out_gateway = (int *) malloc((outdeg + 1) * sizeof(int));
+    plan->group_start = (int *) malloc((outdeg + 1) * sizeof(int));
+    plan->group = (int *) malloc((outdeg + 1) * sizeof(int));
+    plan->in_from = (int *) malloc((indeg + 1) * sizeof(int));
+    plan->in_fwd_start = (int *) malloc((indeg + 1) * sizeof(int));
+    plan->in_order = (int *) malloc((indeg + 1) * sizeof(int));
+    in_msg = (int *) malloc((2 * indeg + 1) * sizeof(int));
+    out_msg = (int *) malloc((2 * outdeg + 1) * sizeof(int));
+    reqs = (ompi_request_t **) malloc((indeg + outdeg + 1) * sizeof(ompi_request_t *));
+    if (NULL == idx || NULL == dst_nodes || NULL == plan->out_gateway || NULL == plan->group_start ||
+        NULL == plan->group || NULL == plan->in_from || NULL == plan->in_fwd_start ||
+        NULL == plan->in_order || NULL == in_msg || NULL == out_msg || NULL == reqs) {
+      res = OMPI_ERR_OUT_OF_RESOURCE;
+    }
+  }
+
+  /* flags[0]: some edges cannot be combined, flags[1]: some edges can. No
+   * process goes on with the messages below if one of them cannot */
+  flags[0] = OMPI_SUCCESS != res || combine_has_duplicates(plan->srcs, indeg, idx) ||
+             combine_has_duplicates(plan->dsts, outdeg, idx);
+  flags[1] = 0;
+  res = combine_agree(comm, flags, 1);
+  if (OMPI_SUCCESS != res || flags[0]) {
+    goto out;
+  }
+
+  /* a node is identified by the lowest rank of its processes, which each
+   * process tells its sources */
+  for (int i = 0 ; i < rank ; ++i) {
+    ompi_proc_t *proc = ompi_group_peer_lookup(comm->c_local_group, i);
+
+    if (OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
+      node = i;
+      break;
+    }
+  }
+  tag = NBC_Reserve_tag(module);
+  for (int i = 0 ; i < outdeg ; ++i) {
+    COMBINE_POST(res, nreqs, irecv(dst_nodes + i, 1, MPI_INT, plan->dsts[i], tag, comm, reqs + nreqs));
+  }
+  for (int j = 0 ; j < indeg ; ++j) {
+    COMBINE_POST(res, nreqs, isend(&node, 1, MPI_INT, plan->srcs[j], tag, MCA_PML_BASE_SEND_STANDARD,
+                                   comm, reqs + nreqs));
+  }
+  res = combine_wait(reqs, &nreqs, res);
+
+  flags[0] = OMPI_SUCCESS != res;
+  if (!flags[0]) {
+    /* the destinations by node, then by rank */
+    combine_sort(idx, outdeg, dst_nodes, plan->dsts);
+    for (int i = 1 ; i < outdeg ; ++i) {
+      if (dst_nodes[idx[i]] == dst_nodes[idx[i - 1]] && dst_nodes[idx[i]] != node) {
+        flags[1] = 1;
+      }
+    }
+  }
+  res = combine_agree(comm, flags, 2);
+  if (OMPI_SUCCESS != res || flags[0] || !flags[1]) {
+    goto out;
+  }
+
+  /* the runs of destinations on the same remote node are the groups */
+  plan->ngroups = 0;
+  plan->group_start[0] = 0;
+  for (int i = 0, first = 0, ngrouped = 0 ; i < outdeg ; ++i) {
+    int e = idx[i];
+
+    if (i > 0 && dst_nodes[e] != dst_nodes[idx[i - 1]]) {
+      first = i;
+    }
+    plan->out_gateway[e] = idx[first];
+    out_msg[2 * e + 1] = 0;
+    if (dst_nodes[e] == node || (i == first && (i == outdeg - 1 || dst_nodes[idx[i + 1]] != dst_nodes[e]))) {
+      /* the node of this process, or a single destination */
+      plan->out_gateway[e] = e;
+      continue;
+    }
+    if (i != first && (i == outdeg - 1 || dst_nodes[idx[i + 1]] != dst_nodes[e])) {
+      /* last destination of the group */
+      for (int k = first ; k <= i ; ++k) {
+        plan->group[ngrouped++] = idx[k];
+      }
+      out_msg[2 * idx[first] + 1] = i - first;
+      plan->group_start[++plan->ngroups] = ngrouped;
+    }
+  }
+
+  /* phase 1: tell each destination its gateway, and each gateway the number
+   * of processes it forwards to */
+  for (int j = 0 ; j < indeg ; ++j) {
+    COMBINE_POST(res, nreqs, irecv(in_msg + 2 * j, 2, MPI_INT, plan->srcs[j], tag, comm, reqs + nreqs));
+  }
+  for (int i = 0 ; i < outdeg ; ++i) {
+    out_msg[2 * i] = plan->dsts[plan->out_gateway[i]];
+    COMBINE_POST(res, nreqs, isend(out_msg + 2 * i, 2, MPI_INT, plan->dsts[i], tag,
+                                   MCA_PML_BASE_SEND_STANDARD, comm, reqs + nreqs));
+  }
+  res = combine_wait(reqs, &nreqs, res);
+  /* phase 2 only takes place if phase 1 went through everywhere */
+  flags[0] = OMPI_SUCCESS != res;
+  res = combine_agree(comm, flags, 1);
+  if (OMPI_SUCCESS != res || flags[0]) {
+    goto out;
+  }
+
+  for (int j = 0 ; j < indeg ; ++j) {
+    plan->in_from[j] = in_msg[2 * j] == rank ? plan->srcs[j] : in_msg[2 * j];
+    plan->in_fwd_start[j] = nfwd;
+    nfwd += in_msg[2 * j + 1];
+  }
+  plan->in_fwd_start[indeg] = nfwd;
+  plan->in_fwd = (int *) malloc((nfwd + 1) * sizeof(int));
+
+  /* phase 2: tell each gateway whom it forwards to. Without memory for the
+   * lists, the messages are still matched (and truncated) */
+  for (int j = 0 ; j < indeg ; ++j) {
+    if (in_msg[2 * j + 1] > 0) {
+      if (NULL == plan->in_fwd) {
+        COMBINE_POST(res, nreqs, irecv(NULL, 0, MPI_INT, plan->srcs[j], tag, comm, reqs + nreqs));
+      } else {
+        COMBINE_POST(res, nreqs, irecv(plan->in_fwd + plan->in_fwd_start[j], in_msg[2 * j + 1],
+                                       MPI_INT, plan->srcs[j], tag, comm, reqs + nreqs));
+      }
+    }
+  }
+  for (int g = 0 ; g < plan->ngroups ; ++g) {
+    int first = plan->group_start[g], count = plan->group_start[g + 1] - first;
+
+    /* the ranks of the group, the gateway excepted */
+    for (int k = 1 ; k < count ; ++k) {
+      idx[first + k] = plan->dsts[plan->group[first + k]];
+    }
+    COMBINE_POST(res, nreqs, isend(idx + first + 1, count - 1, MPI_INT, plan->dsts[plan->group[first]],
+                                   tag, MCA_PML_BASE_SEND_STANDARD, comm, reqs + nreqs));
+  }
+  res = combine_wait(reqs, &nreqs, res);
+  flags[0] = OMPI_SUCCESS != res || NULL == plan->in_fwd;
+
+  /* the forwarded messages are sent and received by increasing source
+   * rank, so that the messages from a gateway match in order */
+  combine_sort(plan->in_order, indeg, plan->srcs, NULL);
+
+  /* whether a process failed in the messages of the plan */
+  res = combine_agree(comm, flags, 1);
+  plan->enabled = OMPI_SUCCESS == res && !flags[0];
+
+ out:
+  free(reqs);
+  free(out_msg);
+  free(in_msg);
+  free(dst_nodes);
+  free(idx);
+  return res;
+}
+
+int NBC_Combine_setup(ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module) {
+  ompi_coll_libnbc_combine_t *plan;
+
+  NBC_Combine_release(module);
+  /* these conditions are the same on all the processes */
+  if (0 == libnbc_neighbor_combine_size ||
+      !(OMPI_COMM_IS_GRAPH(comm) || OMPI_COMM_IS_DIST_GRAPH(comm))) {
+    return OMPI_SUCCESS;
+  }
+
+  plan = (ompi_coll_libnbc_combine_t *) calloc(1, sizeof(*plan));
+  if (NULL == plan) {
+    /* this process cannot combine, and so will not the others */
+    int flags[1] = {1};
+
+    return combine_agree(comm, flags, 1);
+  }
+  module->combine = plan;
+
+  return combine_setup(comm, module, plan);
+}
+
+ompi_coll_libnbc_combine_t *NBC_Combine_get(ompi_coll_libnbc_module_t *module) {
+  if (0 == libnbc_neighbor_combine_size || NULL == module->combine || !module->combine->enabled) {
+    return NULL;
+  }
+
+  return module->combine;
+}
+
+int NBC_Combine_sched_allgather(ompi_coll_libnbc_combine_t *plan, bool out, bool in, const void *sbuf,
+                                int scount, MPI_Datatype stype, void *rbuf, int rcount, MPI_Datatype rtype,
+                                MPI_Aint rcvext, NBC_Schedule *schedule) {
+  int res = OMPI_SUCCESS;
+
+  /* round 0: the direct messages, and the messages through the gateways */
+  for (int j = 0 ; j < plan->indegree && OMPI_SUCCESS == res ; ++j) {
+    if (!in || plan->in_from[j] == plan->srcs[j]) {
+      res = NBC_Sched_recv((char *) rbuf + j * rcount * rcvext, false, rcount, rtype, plan->srcs[j],
+                           schedule, false);
+    }
+  }
+  for (int i = 0 ; i < plan->outdegree && OMPI_SUCCESS == res ; ++i) {
+    if (!out || plan->out_gateway[i] == i) {
+      res = NBC_Sched_send(sbuf, false, scount, stype, plan->dsts[i], schedule, false);
+    }
+  }
+  if (!in) {
+    return res;
+  }
+  if (OMPI_SUCCESS == res) {
+    res = NBC_Sched_barrier(schedule);
+  }
+
+  /* round 1: the gateways forward within the node */
+  for (int k = 0 ; k < plan->indegree && OMPI_SUCCESS == res ; ++k) {
+    int j = plan->in_order[k];
+    char *slot = (char *) rbuf + j * rcount * rcvext;
+
+    for (int f = plan->in_fwd_start[j] ; f < plan->in_fwd_start[j + 1] && OMPI_SUCCESS == res ; ++f) {
+      res = NBC_Sched_send(slot, false, rcount, rtype, plan->in_fwd[f], schedule, false);
+    }
+    if (plan->in_from[j] != plan->srcs[j] && OMPI_SUCCESS == res) {
+      res = NBC_Sched_recv(slot, false, rcount, rtype, plan->in_from[j], schedule, false);
+    }
+  }
+
+  return res;
+}
+
+/* the temporary buffer of an alltoall holds the packed blocks of each
+ * group, then the blocks received as the gateway of each source. Returns
+ * its size, and the offsets of the regions in offsets if not NULL */
+static size_t combine_alltoall_layout(ompi_coll_libnbc_combine_t *plan, bool out, bool in, int scount,
+                                      MPI_Datatype stype, int rcount, MPI_Datatype rtype, ptrdiff_t *offsets) {
+  ptrdiff_t span, gap, total = 0;
+  int r = 0;
+
+  for (int g = 0 ; out && g < plan->ngroups ; ++g) {
+    int count = plan->group_start[g + 1] - plan->group_start[g];
+
+    span = opal_datatype_span(&stype->super, (int64_t) scount * count, &gap);
+    if (NULL != offsets) {
+      offsets[r++] = total - gap;
+    }
+    total += span;
+  }
+  for (int j = 0 ; in && j < plan->indegree ; ++j) {
+    int nfwd = plan->in_fwd_start[j + 1] - plan->in_fwd_start[j];
+
+    if (nfwd > 0) {
+      span = opal_datatype_span(&rtype->super, (int64_t) rcount * (nfwd + 1), &gap);
+      if (NULL != offsets) {
+        offsets[r++] = total - gap;
+      }
+      total += span;
+    }
+  }
+
+  return (size_t) total;
+}
+
+size_t NBC_Combine_alltoall_tmpbuf_size(ompi_coll_libnbc_combine_t *plan, bool out, bool in, int scount,
+                                        MPI_Datatype stype, int rcount, MPI_Datatype rtype) {
+  return combine_alltoall_layout(plan, out, in, scount, stype, rcount, rtype, NULL);
+}
+
+int NBC_Combine_sched_alltoall(ompi_coll_libnbc_combine_t *plan, bool out, bool in, const void *sbuf,
+                               int scount, MPI_Datatype stype, MPI_Aint sndext, void *rbuf, int rcount,
+                               MPI_Datatype rtype, MPI_Aint rcvext, NBC_Schedule *schedule) {
+  ptrdiff_t *offsets;
+  int res = OMPI_SUCCESS, r, ngroups = out ? plan->ngroups : 0;
+
+  offsets = (ptrdiff_t *) malloc((plan->ngroups + plan->indegree + 1) * sizeof(ptrdiff_t));
+  if (NULL == offsets) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+  (void) combine_alltoall_layout(plan, out, in, scount, stype, rcount, rtype, offsets);
+
+  /* round 0: the direct messages, and the packed blocks of the groups to
+   * and from the gateways */
+  for (int i = 0 ; i < plan->outdegree && OMPI_SUCCESS == res ; ++i) {
+    bool grouped = false;
+
+    if (out && plan->out_gateway[i] != i) {
+      continue;
+    }
+    for (int g = 0 ; g < ngroups && OMPI_SUCCESS == res ; ++g) {
+      int first = plan->group_start[g], count = plan->group_start[g + 1] - first;
+      char *pack = (char *) offsets[g];
+
+      if (plan->group[first] != i) {
+        continue;
+      }
+      for (int k = 0 ; k < count && OMPI_SUCCESS == res ; ++k) {
+        res = NBC_Sched_copy((char *) sbuf + plan->group[first + k] * scount * sndext, false, scount, stype,
+                             pack + k * scount * sndext, true, scount, stype, schedule, false);
+      }
+      if (OMPI_SUCCESS == res) {
+        res = NBC_Sched_send(pack, true, scount * count, stype, plan->dsts[i], schedule, false);
+      }
+      grouped = true;
+    }
+    if (!grouped && OMPI_SUCCESS == res) {
+      res = NBC_Sched_send((char *) sbuf + i * scount * sndext, false, scount, stype, plan->dsts[i],
+                           schedule, false);
+    }
+  }
+  r = ngroups;
+  for (int j = 0 ; j < plan->indegree && OMPI_SUCCESS == res ; ++j) {
+    int nfwd = in ? plan->in_fwd_start[j + 1] - plan->in_fwd_start[j] : 0;
+
+    if (nfwd > 0) {
+      res = NBC_Sched_recv((char *) offsets[r++], true, rcount * (nfwd + 1), rtype, plan->srcs[j],
+                           schedule, false);
+    } else if (!in || plan->in_from[j] == plan->srcs[j]) {
+      res = NBC_Sched_recv((char *) rbuf + j * rcount * rcvext, false, rcount, rtype, plan->srcs[j],
+                           schedule, false);
+    }
+  }
+  if (!in) {
+    free(offsets);
+    return res;
+  }
+  if (OMPI_SUCCESS == res) {
+    res = NBC_Sched_barrier(schedule);
+  }
+
+  /* round 1: the gateways keep their block and forward the others within
+   * the node. Their regions follow the in-edge order */
+  for (int k = 0 ; k < plan->indegree && OMPI_SUCCESS == res ; ++k) {
+    int j = plan->in_order[k], nfwd = plan->in_fwd_start[j + 1] - plan->in_fwd_start[j];
+    char *slot = (char *) rbuf + j * rcount * rcvext;
+
+    if (nfwd > 0) {
+      char *blocks;
+
+      r = ngroups;
+      for (int l = 0 ; l < j ; ++l) {
+        r += plan->in_fwd_start[l + 1] > plan->in_fwd_start[l];
+      }
+      blocks = (char *) offsets[r];
+      res = NBC_Sched_copy(blocks, true, rcount, rtype, slot, false, rcount, rtype, schedule, false);
+      for (int f = 0 ; f < nfwd && OMPI_SUCCESS == res ; ++f) {
+        res = NBC_Sched_send(blocks + (f + 1) * rcount * rcvext, true, rcount, rtype,
+                             plan->in_fwd[plan->in_fwd_start[j] + f], schedule, false);
+      }
+    } else if (plan->in_from[j] != plan->srcs[j]) {
+      res = NBC_Sched_recv(slot, false, rcount, rtype, plan->in_from[j], schedule, false);
+    }
+  }
+
+  free(offsets);
+  return res;
+}
@@ -0,0 +1,502 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/*
+ * Schedule cache.
+ *
+ * Each communicator keeps the schedules of its last collective calls in a
+ * hash table keyed on the arguments that determine a schedule (collective,
+ * counts, datatypes, operation, root, ...), and evicts the least recently
+ * used one once libnbc_schedule_cache_size entries are cached. The buffers
+ * are not part of the key: a cached schedule is a template that is re-bound
+ * to the buffers of a new call.
+ *
+ * The pointers of a schedule that are not offsets into the temporary buffer
+ * of the request point into the send, receive or temporary buffer of the
+ * call, or are constant (e.g. NULL). Which one it is cannot be told from a
+ * single schedule, so the cache learns it by comparing the schedules built
+ * for the same arguments with different buffers: a pointer which moved by
+ * as much as the send buffer, but not as much as the receive buffer, points
+ * into the send buffer. Each pointer thus keeps the set of buffers it may
+ * point into, and a schedule can be re-bound to new buffers as long as all
+ * the buffers of each of these sets moved by the same amount (this is
+ * always true when the buffers did not change). Otherwise, the schedule is
+ * built again, which narrows down the sets.
+ *
+ * The MPI standard requires the collective calls of a communicator to be
+ * issued in the same order by all its processes, so they are serialized,
+ * and the cache is not protected against concurrent accesses. The fused
+ * iallreduces, which are started from the progress function, bypass it.
+ */
+#include "nbc_internal.h"
+#include "opal/class/opal_hash_table.h"
+#include "ompi/op/op.h"
+
+/* what a pointer of a cached schedule may point into */
+#define NBC_CACHE_CONST NBC_CACHE_NBUFS
+#define NBC_CACHE_ANY ((1 << (NBC_CACHE_NBUFS + 1)) - 1)
+
+typedef struct {
+  int pos;          /* buf[pos], or buf2[pos - num_ops] of the schedule */
+  int mask;         /* bit b is set if it may point into buffer b */
+} nbc_cache_field_t;
+
+struct ompi_coll_libnbc_cache_entry_t {
+  opal_list_item_t super;
+  void *key;
+  size_t keylen;
+  opal_object_t **objs;         /* retained datatypes and operations of the key */
+  int nobjs;
+  NBC_Schedule *schedule;       /* last schedule built for this key, NULL if none */
+  const void *bufs[NBC_CACHE_NBUFS];      /* buffers of this schedule */
+  const void *next_bufs[NBC_CACHE_NBUFS]; /* buffers of the schedule being built */
+  nbc_cache_field_t *fields;
+  int nfields;
+  int masks;                    /* bit m is set if a field has the mask m */
+};
+typedef struct ompi_coll_libnbc_cache_entry_t ompi_coll_libnbc_cache_entry_t;
+
+struct ompi_coll_libnbc_cache_t {
+  opal_hash_table_t table;
+  opal_list_t lru;              /* most recently used entry first */
+};
+typedef struct ompi_coll_libnbc_cache_t ompi_coll_libnbc_cache_t;
+
+static void cache_entry_construct(ompi_coll_libnbc_cache_entry_t *entry)
+{
+  entry->key = NULL;
+  entry->keylen = 0;
+  entry->objs = NULL;
+  entry->nobjs = 0;
+  entry->schedule = NULL;
+  entry->fields = NULL;
+  entry->nfields = 0;
+  entry->masks = 0;
+}
+
+static void cache_entry_destruct(ompi_coll_libnbc_cache_entry_t *entry)
+{
+  for (int i = 0 ; i < entry->nobjs ; ++i) {
+    OBJ_RELEASE(entry->objs[i]);
+  }
+  free(entry->objs);
+  free(entry->key);
+  free(entry->fields);
+  if (NULL != entry->schedule) {
+    OBJ_RELEASE(entry->schedule);
+  }
+}
+
+static OBJ_CLASS_INSTANCE(ompi_coll_libnbc_cache_entry_t, opal_list_item_t,
+                          cache_entry_construct, cache_entry_destruct);
+
+static void nbc_cache_key_fini(NBC_Cache_key *key) {
+  if (key->data != key->inline_data) {
+    free(key->data);
+  }
+  if (key->objs != key->inline_objs) {
+    free(key->objs);
+  }
+  key->enabled = false;
+}
+
+void NBC_Cache_key_init(NBC_Cache_key *key, int coll, bool persistent, const void *sendbuf,
+                        const void *recvbuf, const void *tmpbuf) {
+  char flags[NBC_CACHE_NBUFS];
+
+  key->enabled = libnbc_schedule_cache_size > 0;
+  if (!key->enabled) {
+    return;
+  }
+
+  key->data = key->inline_data;
+  key->size = sizeof(key->inline_data);
+  key->len = 0;
+  key->objs = key->inline_objs;
+  key->objs_size = NBC_CACHE_KEY_INLINE_OBJS;
+  key->nobjs = 0;
+
+  key->bufs[NBC_CACHE_SENDBUF] = sendbuf;
+  key->bufs[NBC_CACHE_RECVBUF] = recvbuf;
+  key->bufs[NBC_CACHE_TMPBUF] = tmpbuf;
+
+  /* the schedules depend on which buffers are NULL, MPI_IN_PLACE or
+   * aliased, which also guarantees that aliased buffers move together */
+  for (int i = 0 ; i < NBC_CACHE_NBUFS ; ++i) {
+    flags[i] = NULL == key->bufs[i] ? 0 : (MPI_IN_PLACE == key->bufs[i] ? 1 : 2 + i);
+    for (int j = 0 ; j < i ; ++j) {
+      if (flags[i] > 1 && key->bufs[i] == key->bufs[j]) {
+        flags[i] = flags[j];
+        break;
+      }
+    }
+  }
+
+  NBC_Cache_key_add(key, &coll, sizeof(coll));
+  NBC_Cache_key_add(key, &persistent, sizeof(persistent));
+  NBC_Cache_key_add(key, flags, sizeof(flags));
+}
+
+void NBC_Cache_key_add(NBC_Cache_key *key, const void *data, size_t len) {
+  if (!key->enabled) {
+    return;
+  }
+
+  if (key->len + len > key->size) {
+    size_t size = 2 * (key->len + len);
+    char *tmp = malloc(size);
+
+    if (NULL == tmp) {
+      nbc_cache_key_fini(key);
+      return;
+    }
+    memcpy(tmp, key->data, key->len);
+    if (key->data != key->inline_data) {
+      free(key->data);
+    }
+    key->data = tmp;
+    key->size = size;
+  }
+
+  memcpy(key->data + key->len, data, len);
+  key->len += len;
+}
+
+/* the key holds the address of the object, which must stay valid as long
+ * as the entry is cached */
+static void nbc_cache_key_add_obj(NBC_Cache_key *key, opal_object_t *obj) {
+  NBC_Cache_key_add(key, &obj, sizeof(obj));
+  if (!key->enabled) {
+    return;
+  }
+
+  if (key->nobjs == key->objs_size) {
+    opal_object_t **tmp = malloc(2 * key->objs_size * sizeof(*tmp));
+
+    if (NULL == tmp) {
+      nbc_cache_key_fini(key);
+      return;
+    }
+    memcpy(tmp, key->objs, key->nobjs * sizeof(*tmp));
+    if (key->objs != key->inline_objs) {
+      free(key->objs);
+    }
+    key->objs = tmp;
+    key->objs_size *= 2;
+  }
+
+  key->objs[key->nobjs++] = obj;
+}
+
+void NBC_Cache_key_add_type(NBC_Cache_key *key, MPI_Datatype type) {
+  nbc_cache_key_add_obj(key, &type->super.super);
+}
+
+void NBC_Cache_key_add_op(NBC_Cache_key *key, MPI_Op op) {
+  nbc_cache_key_add_obj(key, &op->super);
+}
+
+/* returns the address of the pointer at position pos of a schedule */
+static inline void **nbc_cache_slot(const NBC_Schedule *schedule, int pos) {
+  return pos < schedule->num_ops ? &schedule->buf[pos] : &schedule->buf2[pos - schedule->num_ops];
+}
+
+/* records the pointer at position pos of a schedule. If the entry has a
+ * schedule, old is it, and the set of buffers the pointer may point into is
+ * narrowed down to those which moved as much as it. */
+static int nbc_cache_field(ompi_coll_libnbc_cache_entry_t *entry, const NBC_Schedule *schedule,
+                           const NBC_Schedule *old, int pos, bool is_tmp, const intptr_t *delta,
+                           int *nfields, int *size) {
+  intptr_t ptr, old_ptr;
+  int mask = 0;
+
+  ptr = (intptr_t) *nbc_cache_slot(schedule, pos);
+  if (NULL == old) {
+    if (is_tmp) {
+      return OMPI_SUCCESS;
+    }
+    if (*nfields == *size) {
+      nbc_cache_field_t *tmp;
+
+      *size = *size ? 2 * *size : 16;
+      tmp = (nbc_cache_field_t *) realloc(entry->fields, *size * sizeof(*tmp));
+      if (OPAL_UNLIKELY(NULL == tmp)) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+      }
+      entry->fields = tmp;
+    }
+    entry->fields[*nfields].pos = pos;
+    entry->fields[(*nfields)++].mask = NBC_CACHE_ANY;
+    return OMPI_SUCCESS;
+  }
+
+  old_ptr = (intptr_t) *nbc_cache_slot(old, pos);
+  if (is_tmp) {
+    /* offsets into the temporary buffer of the request do not move */
+    return old_ptr == ptr ? OMPI_SUCCESS : OMPI_ERROR;
+  }
+  if (*nfields == entry->nfields || entry->fields[*nfields].pos != pos) {
+    return OMPI_ERROR;
+  }
+  for (int b = 0 ; b <= NBC_CACHE_NBUFS ; ++b) {
+    if (ptr - old_ptr == delta[b]) {
+      mask |= 1 << b;
+    }
+  }
+  mask &= entry->fields[*nfields].mask;
+  if (0 == mask) {
+    return OMPI_ERROR;
+  }
+  entry->fields[(*nfields)++].mask = mask;
+
+  return OMPI_SUCCESS;
+}
+
+/* compares the operations of the schedule of the entry with those of
+ * another schedule built for the same key, and narrows down the buffers
+ * their pointers may point into. Without a schedule, the entry starts over
+ * with this one. */
+static int nbc_cache_learn(ompi_coll_libnbc_cache_entry_t *entry, NBC_Schedule *schedule) {
+  const NBC_Schedule *old = entry->schedule;
+  intptr_t delta[NBC_CACHE_NBUFS + 1];
+  int res = OMPI_SUCCESS, nfields = 0, size = 0;
+
+  if (NULL != old) {
+    int n = schedule->num_ops, l = schedule->num_local;
+
+/* compares the first num elements of an array of both schedules */
+#define NBC_CACHE_SAME(array, num) (0 == memcmp(schedule->array, old->array, (num) * sizeof(*old->array)))
+    if (old->num_ops != n || old->num_local != l || old->num_rounds != schedule->num_rounds ||
+        !NBC_CACHE_SAME(round_start, schedule->num_rounds + 1) ||
+        !NBC_CACHE_SAME(type, n) || !NBC_CACHE_SAME(flags, n) || !NBC_CACHE_SAME(count, n) ||
+        !NBC_CACHE_SAME(peer, n) || !NBC_CACHE_SAME(datatype, n) || !NBC_CACHE_SAME(count2, l) ||
+        !NBC_CACHE_SAME(datatype2, l) || !NBC_CACHE_SAME(op, l)) {
+      return OMPI_ERROR;
+    }
+#undef NBC_CACHE_SAME
+
+    for (int b = 0 ; b < NBC_CACHE_NBUFS ; ++b) {
+      delta[b] = (intptr_t) entry->next_bufs[b] - (intptr_t) entry->bufs[b];
+    }
+    delta[NBC_CACHE_CONST] = 0;
+  } else {
+    free(entry->fields);
+    entry->fields = NULL;
+    entry->nfields = 0;
+  }
+
+  for (int i = 0 ; i < schedule->num_ops && OMPI_SUCCESS == res ; ++i) {
+    res = nbc_cache_field(entry, schedule, old, i, schedule->flags[i] & NBC_SCHED_TMPBUF1,
+                          delta, &nfields, &size);
+    if (OMPI_SUCCESS == res && SEND != schedule->type[i] && RECV != schedule->type[i]) {
+      res = nbc_cache_field(entry, schedule, old, schedule->num_ops + schedule->peer[i],
+                            schedule->flags[i] & NBC_SCHED_TMPBUF2, delta, &nfields, &size);
+    }
+  }
+  if (OMPI_SUCCESS != res) {
+    return res;
+  }
+
+  if (NULL != old && nfields != entry->nfields) {
+    return OMPI_ERROR;
+  }
+  entry->nfields = nfields;
+  entry->masks = 0;
+  for (int i = 0 ; i < nfields ; ++i) {
+    entry->masks |= 1 << entry->fields[i].mask;
+  }
+
+  return OMPI_SUCCESS;
+}
+
+/* returns the schedule of the entry re-bound to the buffers, or NULL if it
+ * cannot be */
+static NBC_Schedule *nbc_cache_bind(ompi_coll_libnbc_cache_entry_t *entry, const void **bufs) {
+  intptr_t delta[NBC_CACHE_NBUFS + 1], mask_delta[NBC_CACHE_ANY + 1];
+  NBC_Schedule *schedule;
+  bool moved = false;
+
+  if (NULL == entry->schedule) {
+    return NULL;
+  }
+
+  for (int b = 0 ; b < NBC_CACHE_NBUFS ; ++b) {
+    delta[b] = (intptr_t) bufs[b] - (intptr_t) entry->bufs[b];
+  }
+  delta[NBC_CACHE_CONST] = 0;
+
+  /* all the buffers a pointer may point into must have moved by the same
+   * amount */
+  for (int m = 1 ; m <= NBC_CACHE_ANY ; ++m) {
+    int first = -1;
+
+    if (!(entry->masks & (1 << m))) {
+      continue;
+    }
+    for (int b = 0 ; b <= NBC_CACHE_NBUFS ; ++b) {
+      if (m & (1 << b)) {
+        if (-1 == first) {
+          first = b;
+        } else if (delta[b] != delta[first]) {
+          return NULL;
+        }
+      }
+    }
+    mask_delta[m] = delta[first];
+    moved |= 0 != delta[first];
+  }
+
+  if (!moved) {
+    OBJ_RETAIN(entry->schedule);
+    return entry->schedule;
+  }
+
+  schedule = NBC_Sched_dup(entry->schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return NULL;
+  }
+
+  for (int i = 0 ; i < entry->nfields ; ++i) {
+    void **slot = nbc_cache_slot(schedule, entry->fields[i].pos);
+
+    *slot = (void *) ((intptr_t) *slot + mask_delta[entry->fields[i].mask]);
+  }
+
+  return schedule;
+}
+
+NBC_Schedule *NBC_Cache_lookup(ompi_coll_libnbc_module_t *module, NBC_Cache_key *key,
+                               NBC_Cache_entry **entryp) {
+  ompi_coll_libnbc_cache_t *cache = module->cache;
+  ompi_coll_libnbc_cache_entry_t *entry;
+  NBC_Schedule *schedule = NULL;
+  void *value;
+
+  *entryp = NULL;
+  if (!key->enabled) {
+    return NULL;
+  }
+
+  if (NULL == cache) {
+    cache = (ompi_coll_libnbc_cache_t *) malloc(sizeof(*cache));
+    if (OPAL_UNLIKELY(NULL == cache)) {
+      nbc_cache_key_fini(key);
+      return NULL;
+    }
+    OBJ_CONSTRUCT(&cache->table, opal_hash_table_t);
+    OBJ_CONSTRUCT(&cache->lru, opal_list_t);
+    if (OPAL_SUCCESS != opal_hash_table_init(&cache->table, 2 * libnbc_schedule_cache_size)) {
+      OBJ_DESTRUCT(&cache->table);
+      OBJ_DESTRUCT(&cache->lru);
+      free(cache);
+      nbc_cache_key_fini(key);
+      return NULL;
+    }
+    module->cache = cache;
+  }
+
+  if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&cache->table, key->data, key->len, &value)) {
+    entry = (ompi_coll_libnbc_cache_entry_t *) value;
+    opal_list_remove_item(&cache->lru, &entry->super);
+    opal_list_prepend(&cache->lru, &entry->super);
+
+    schedule = nbc_cache_bind(entry, key->bufs);
+    if (NULL == schedule) {
+      memcpy(entry->next_bufs, key->bufs, sizeof(entry->next_bufs));
+      *entryp = entry;
+    }
+    NBC_DEBUG(5, "schedule cache %s for entry %p\n", schedule ? "hit" : "miss", (void *) entry);
+    nbc_cache_key_fini(key);
+    return schedule;
+  }
+
+  entry = OBJ_NEW(ompi_coll_libnbc_cache_entry_t);
+  if (OPAL_UNLIKELY(NULL == entry)) {
+    nbc_cache_key_fini(key);
+    return NULL;
+  }
+  entry->key = malloc(key->len);
+  if (key->nobjs > 0) {
+    entry->objs = (opal_object_t **) malloc(key->nobjs * sizeof(opal_object_t *));
+  }
+  if (OPAL_UNLIKELY(NULL == entry->key || (key->nobjs > 0 && NULL == entry->objs))) {
+    OBJ_RELEASE(entry);
+    nbc_cache_key_fini(key);
+    return NULL;
+  }
+  memcpy(entry->key, key->data, key->len);
+  entry->keylen = key->len;
+  for (int i = 0 ; i < key->nobjs ; ++i) {
+    OBJ_RETAIN(key->objs[i]);
+    entry->objs[entry->nobjs++] = key->objs[i];
+  }
+  memcpy(entry->next_bufs, key->bufs, sizeof(entry->next_bufs));
+  nbc_cache_key_fini(key);
+
+  if (OPAL_SUCCESS != opal_hash_table_set_value_ptr(&cache->table, entry->key, entry->keylen, entry)) {
+    OBJ_RELEASE(entry);
+    return NULL;
+  }
+  opal_list_prepend(&cache->lru, &entry->super);
+
+  /* evict the least recently used entries */
+  while (opal_list_get_size(&cache->lru) > (size_t) libnbc_schedule_cache_size) {
+    ompi_coll_libnbc_cache_entry_t *last =
+      (ompi_coll_libnbc_cache_entry_t *) opal_list_remove_last(&cache->lru);
+    opal_hash_table_remove_value_ptr(&cache->table, last->key, last->keylen);
+    OBJ_RELEASE(last);
+  }
+
+  *entryp = entry;
+  return NULL;
+}
+
+void NBC_Cache_insert(NBC_Cache_entry *entry, NBC_Schedule *schedule) {
+  if (NULL == entry) {
+    return;
+  }
+
+  if (OMPI_SUCCESS != nbc_cache_learn(entry, schedule)) {
+    /* a schedule with a different layout (which the key should prevent)
+     * or no memory: start over with the new schedule */
+    if (NULL != entry->schedule) {
+      OBJ_RELEASE(entry->schedule);
+      entry->schedule = NULL;
+    }
+    if (OMPI_SUCCESS != nbc_cache_learn(entry, schedule)) {
+      return;
+    }
+  }
+
+  if (NULL != entry->schedule) {
+    OBJ_RELEASE(entry->schedule);
+  }
+  OBJ_RETAIN(schedule);
+  entry->schedule = schedule;
+  memcpy(entry->bufs, entry->next_bufs, sizeof(entry->bufs));
+}
+
+void NBC_Cache_release(ompi_coll_libnbc_module_t *module) {
+  ompi_coll_libnbc_cache_t *cache = module->cache;
+  opal_list_item_t *item;
+
+  if (NULL == cache) {
+    return;
+  }
+
+  while (NULL != (item = opal_list_remove_first(&cache->lru))) {
+    OBJ_RELEASE(item);
+  }
+  OBJ_DESTRUCT(&cache->table);
+  OBJ_DESTRUCT(&cache->lru);
+  free(cache);
+  module->cache = NULL;
+}
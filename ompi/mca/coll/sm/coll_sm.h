@@ -25,14 +25,24 @@
 
 #include "ompi_config.h"
 
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+
 #include "mpi.h"
 #include "ompi/mca/mca.h"
 #include "opal/datatype/opal_convertor.h"
 #include "opal/mca/common/sm/common_sm.h"
+#include "opal/runtime/opal.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/sys/atomic.h"
 #include "ompi/mca/coll/coll.h"
 
 BEGIN_C_DECLS
 
+/* Largest allreduce (in bytes) done through the flag slots */
+#define MCA_COLL_SM_FLAG_MAX_BYTES 64
+
 /* Attempt to give some sort of progress / fairness if we're blocked
    in an sm collective for a long time: call opal_progress once in a
    great while.  Use a "goto" label for expdiency to exit loops. */
@@ -81,6 +91,11 @@ BEGIN_C_DECLS
             calculation of the "info" MCA parameter */
         int sm_info_comm_size;
 
+        /** MCA parameter: Size (in bytes) from which the bcasts and
+            allreduces read the user buffers of the other processes
+            directly, 0 to disable */
+        size_t sm_single_copy_threshold;
+
         /******* end of MCA params ********/
 
         /** How many fragment segments are protected by a single
@@ -119,6 +134,22 @@ BEGIN_C_DECLS
         volatile uint32_t mcsiuf_operation_count;
     } mca_coll_sm_in_use_flag_t;
 
+    /**
+     * Flag slot of a process for the barrier and the small allreduces.
+     * Each slot starts on its own cache line: the sense is written by
+     * its owner only, once the data below it is in place.
+     */
+    typedef struct mca_coll_sm_flag_slot_t {
+        /** Sense of the last operation this process arrived at */
+        volatile uint32_t mcsfs_sense;
+        /** Process id, for the single-copy reads */
+        pid_t mcsfs_pid;
+        /** User buffers published for the single-copy reads */
+        uint64_t mcsfs_addr[2];
+        /** Partial result of the subtree of this process */
+        char mcsfs_data[MCA_COLL_SM_FLAG_MAX_BYTES] __opal_attribute_aligned__(8);
+    } mca_coll_sm_flag_slot_t;
+
     /**
      * Structure containing pointers to various arrays of data in the
      * per-communicator shmem data segment (one of these indexes a
@@ -145,25 +176,17 @@ BEGIN_C_DECLS
            function */
         mca_common_sm_module_t *sm_bootstrap_meta;
 
-        /** Pointer to my barrier control pages (odd index pages are
-            "in", even index pages are "out") */
-        uint32_t *mcb_barrier_control_me;
-
-        /** Pointer to my parent's barrier control pages (will be NULL
-            for communicator rank 0; odd index pages are "in", even
-            index pages are "out") */
-        opal_atomic_uint32_t *mcb_barrier_control_parent;
+        /** Flag slots: one per process, followed by the release
+            slot written by rank 0 (see mca_coll_sm_flag_slot()) */
+        char *mcb_flags;
 
-        /** Pointers to my childrens' barrier control pages (they're
-            contiguous in memory, so we only point to the base -- the
-            number of children is in my entry in the mcb_tree); will
-            be NULL if this process has no children (odd index pages
-            are "in", even index pages are "out") */
-        uint32_t *mcb_barrier_control_children;
+        /** Sense of the last barrier or flag allreduce (flipped by
+            each of them) */
+        uint32_t mcb_flag_sense;
 
-        /** Number of barriers that we have executed (i.e., which set
-            of barrier buffers to use). */
-        int mcb_barrier_count;
+        /** Whether all the processes can read each other's memory
+            (see coll_sm_single_copy.c) */
+        bool mcb_single_copy;
 
         /** "In use" flags indicating which segments are available */
         mca_coll_sm_in_use_flag_t *mcb_in_use_flags;
@@ -195,6 +218,21 @@ BEGIN_C_DECLS
         /* Underlying reduce function and module */
 	mca_coll_base_module_reduce_fn_t previous_reduce;
 	mca_coll_base_module_t *previous_reduce_module;
+
+        /* Underlying functions and modules for the cases that the
+           shared memory algorithms do not handle (MPI_IN_PLACE
+           alltoall, alltoall on large communicators, scans on
+           non-contiguous datatypes) */
+	mca_coll_base_module_alltoall_fn_t previous_alltoall;
+	mca_coll_base_module_t *previous_alltoall_module;
+	mca_coll_base_module_alltoallv_fn_t previous_alltoallv;
+	mca_coll_base_module_t *previous_alltoallv_module;
+	mca_coll_base_module_alltoallw_fn_t previous_alltoallw;
+	mca_coll_base_module_t *previous_alltoallw_module;
+	mca_coll_base_module_scan_fn_t previous_scan;
+	mca_coll_base_module_t *previous_scan_module;
+	mca_coll_base_module_exscan_fn_t previous_exscan;
+	mca_coll_base_module_t *previous_exscan_module;
     } mca_coll_sm_module_t;
     OBJ_CLASS_DECLARATION(mca_coll_sm_module_t);
 
@@ -270,14 +308,14 @@ BEGIN_C_DECLS
 				 struct ompi_op_t *op,
 				 struct ompi_communicator_t *comm,
 				 mca_coll_base_module_t *module);
-    int mca_coll_sm_gather_intra(void *sbuf, int scount,
+    int mca_coll_sm_gather_intra(const void *sbuf, int scount,
 				 struct ompi_datatype_t *sdtype, void *rbuf,
 				 int rcount, struct ompi_datatype_t *rdtype,
 				 int root, struct ompi_communicator_t *comm,
 				 mca_coll_base_module_t *module);
-    int mca_coll_sm_gatherv_intra(void *sbuf, int scount,
+    int mca_coll_sm_gatherv_intra(const void *sbuf, int scount,
 				  struct ompi_datatype_t *sdtype, void *rbuf,
-				  int *rcounts, int *disps,
+				  const int *rcounts, const int *disps,
 				  struct ompi_datatype_t *rdtype, int root,
 				  struct ompi_communicator_t *comm,
 				  mca_coll_base_module_t *module);
@@ -294,7 +332,7 @@ BEGIN_C_DECLS
 				     struct ompi_communicator_t *comm,
 				     mca_coll_base_module_t *module);
     int mca_coll_sm_reduce_scatter_intra(const void *sbuf, void *rbuf,
-					 int *rcounts,
+					 const int *rcounts,
 					 struct ompi_datatype_t *dtype,
 					 struct ompi_op_t *op,
 					 struct ompi_communicator_t *comm,
@@ -318,6 +356,57 @@ BEGIN_C_DECLS
 
     int mca_coll_sm_ft_event(int state);
 
+    /*
+     * Engines shared by several collectives.  The max_bytes argument
+     * is the largest packed size exchanged between any two processes
+     * and must be the same on all processes: it determines how many
+     * segments everybody steps through.
+     */
+    int mca_coll_sm_gatherv_engine(const void *sbuf, int scount,
+                                   struct ompi_datatype_t *sdtype,
+                                   void *rbuf, const int *rcounts, const int *disps,
+                                   struct ompi_datatype_t *rdtype, int root,
+                                   size_t max_bytes,
+                                   struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module);
+    int mca_coll_sm_scatterv_engine(const void *sbuf, const int *scounts, const int *disps,
+                                    struct ompi_datatype_t *sdtype,
+                                    void *rbuf, int rcount,
+                                    struct ompi_datatype_t *rdtype, int root,
+                                    size_t max_bytes,
+                                    struct ompi_communicator_t *comm,
+                                    mca_coll_base_module_t *module);
+    int mca_coll_sm_alltoallw_engine(const void *sbuf, const int *scounts,
+                                     const ptrdiff_t *sdisps,
+                                     struct ompi_datatype_t * const *sdtypes,
+                                     void *rbuf, const int *rcounts,
+                                     const ptrdiff_t *rdisps,
+                                     struct ompi_datatype_t * const *rdtypes,
+                                     size_t max_bytes,
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module);
+    int mca_coll_sm_flag_allreduce(const void *sbuf, void *rbuf, int count,
+                                   struct ompi_datatype_t *dtype,
+                                   struct ompi_op_t *op,
+                                   struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module);
+    int mca_coll_sm_single_copy_init(struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module);
+    int mca_coll_sm_bcast_single_copy(void *buff, int count,
+                                      struct ompi_datatype_t *datatype, int root,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module);
+    int mca_coll_sm_allreduce_single_copy(const void *sbuf, void *rbuf, int count,
+                                          struct ompi_datatype_t *dtype,
+                                          struct ompi_op_t *op,
+                                          struct ompi_communicator_t *comm,
+                                          mca_coll_base_module_t *module);
+    int mca_coll_sm_scan_engine(const void *sbuf, void *rbuf, int count,
+                                struct ompi_datatype_t *dtype,
+                                struct ompi_op_t *op, bool exclusive,
+                                struct ompi_communicator_t *comm,
+                                mca_coll_base_module_t *module);
+
 /**
  * Global variables used in the macros (essentially constants, so
  * these are thread safe)
@@ -450,6 +539,83 @@ extern uint32_t mca_coll_sm_one;
         *ptr = 0; \
     } while (0)
 
+/**
+ * Get the next set of segments for an operation where all the
+ * processes take part.  The owner (typically the root) waits for the
+ * set to be idle and claims it for the whole communicator; the other
+ * processes wait for the claim.  Each process must FLAG_RELEASE()
+ * the returned flag once done with the set.  Returns the index of the
+ * first segment of the set.
+ */
+static inline int mca_coll_sm_segments_acquire(mca_coll_sm_comm_t *data,
+                                               bool owner, int size,
+                                               mca_coll_sm_in_use_flag_t **flag_out)
+{
+    mca_coll_sm_in_use_flag_t *flag;
+    int flag_num = (data->mcb_operation_count %
+                    mca_coll_sm_component.sm_comm_num_in_use_flags);
+
+    FLAG_SETUP(flag_num, flag, data);
+    if (owner) {
+        FLAG_WAIT_FOR_IDLE(flag, segments_acquire_owner_label);
+        FLAG_RETAIN(flag, size, data->mcb_operation_count);
+    } else {
+        FLAG_WAIT_FOR_OP(flag, data->mcb_operation_count, segments_acquire_label);
+    }
+    ++data->mcb_operation_count;
+
+    *flag_out = flag;
+    return flag_num * mca_coll_sm_component.sm_segs_per_inuse_flag;
+}
+
+/**
+ * Distance between the flag slots, a whole number of cache lines
+ */
+static inline size_t mca_coll_sm_flag_slot_size(void)
+{
+    size_t line = (size_t) opal_cache_line_size;
+    return (sizeof(mca_coll_sm_flag_slot_t) + line - 1) / line * line;
+}
+
+/**
+ * Size of the flag slots area at the beginning of the per-communicator
+ * shmem data segment: the slots of the processes and the release slot,
+ * aligned on a cache line, rounded up to the control size so that the
+ * areas that follow stay aligned
+ */
+static inline size_t mca_coll_sm_flags_area_size(int comm_size)
+{
+    size_t control = (size_t) mca_coll_sm_component.sm_control_size;
+    size_t len = (comm_size + 1) * mca_coll_sm_flag_slot_size() +
+        (size_t) opal_cache_line_size;
+    return (len + control - 1) / control * control;
+}
+
+/**
+ * Flag slot of a process, or the release slot if rank is the size of
+ * the communicator
+ */
+static inline mca_coll_sm_flag_slot_t *mca_coll_sm_flag_slot(mca_coll_sm_comm_t *data,
+                                                             int rank)
+{
+    return (mca_coll_sm_flag_slot_t *)
+        (data->mcb_flags + rank * mca_coll_sm_flag_slot_size());
+}
+
+/**
+ * Size of the block of a fragment slot reserved for each destination
+ * in the alltoall family: each process' slot is split in one block
+ * per process, rounded down to a cache line.  Returns 0 if the
+ * communicator is too large for the blocks to be useful, in which
+ * case the alltoall functions fall back to the underlying module.
+ */
+static inline size_t mca_coll_sm_alltoall_block_size(int size)
+{
+    size_t block = ((size_t) mca_coll_sm_component.sm_fragment_size / size) &
+        ~((size_t) 63);
+    return block;
+}
+
 END_C_DECLS
 
 #endif /* MCA_COLL_SM_EXPORT_H */
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,14 +20,22 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
 /*
  *	allgather
  *
- *	Function:	- allgather
+ *	Function:	- shared memory allgather
  *	Accepts:	- same as MPI_Allgather()
  *	Returns:	- MPI_SUCCESS or error code
  */
@@ -37,5 +45,21 @@ int mca_coll_sm_allgather_intra(const void *sbuf, int scount,
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    int ret, i, size = ompi_comm_size(comm);
+    int *counts, *disps;
+
+    counts = (int*) malloc(2 * size * sizeof(int));
+    if (NULL == counts) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    disps = counts + size;
+    for (i = 0; i < size; ++i) {
+        counts[i] = rcount;
+        disps[i] = i * rcount;
+    }
+
+    ret = mca_coll_sm_allgatherv_intra(sbuf, scount, sdtype, rbuf, counts, disps,
+                                       rdtype, comm, module);
+    free(counts);
+    return ret;
 }
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,23 +20,162 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
-/*
- *	allgatherv_intra
+/**
+ * Shared memory allgatherv, also used by allgather.
  *
- *	Function:	- allgatherv
- *	Accepts:	- same as MPI_Allgatherv()
- *	Returns:	- MPI_SUCCESS or error code
+ * Process 0 owns the set of segments.  For each segment, every
+ * process that still has data packs its next fragment in its own slot
+ * of the segment and notifies all the other processes; then it waits
+ * for each of the other processes that still have data and unpacks
+ * their fragment directly into the user buffer.  The counts are known
+ * everywhere, so all the processes step through the same number of
+ * segments without any agreement.
  */
 int mca_coll_sm_allgatherv_intra(const void *sbuf, int scount,
                                  struct ompi_datatype_t *sdtype,
-                                 void * rbuf, const int *rcounts, const int *disps,
+                                 void *rbuf, const int *rcounts, const int *disps,
                                  struct ompi_datatype_t *rdtype,
                                  struct ompi_communicator_t *comm,
-                                mca_coll_base_module_t *module)
+                                 mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int ret = OMPI_SUCCESS, rank, size, peer;
+    int segment_num, max_segment_num;
+    size_t step, num_steps, max_data, dsize, max_bytes = 0;
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+    opal_convertor_t *convertors;
+    size_t *bytes_left;
+    ptrdiff_t lb, extent;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    ompi_datatype_type_size(rdtype, &dsize);
+    for (peer = 0; peer < size; ++peer) {
+        if ((size_t)rcounts[peer] * dsize > max_bytes) {
+            max_bytes = (size_t)rcounts[peer] * dsize;
+        }
+    }
+    num_steps = (max_bytes + mca_coll_sm_component.sm_fragment_size - 1) /
+        mca_coll_sm_component.sm_fragment_size;
+
+    /* With MPI_IN_PLACE, my contribution already is at its place in
+       rbuf; otherwise copy it there */
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = ((char*) rbuf) + (ptrdiff_t)disps[rank] * extent;
+        scount = rcounts[rank];
+        sdtype = rdtype;
+    } else {
+        ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                   ((char*) rbuf) + (ptrdiff_t)disps[rank] * extent,
+                                   rcounts[rank], rdtype);
+        if (MPI_SUCCESS != ret) {
+            return ret;
+        }
+    }
+    if (0 == num_steps) {
+        return OMPI_SUCCESS;
+    }
+
+    /* My slot of the convertor array is used to send my contribution,
+       the others to receive the peers' ones */
+    convertors = (opal_convertor_t*) malloc(size * (sizeof(opal_convertor_t) +
+                                                    sizeof(size_t)));
+    if (NULL == convertors) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    bytes_left = (size_t*) (convertors + size);
+    for (peer = 0; peer < size; ++peer) {
+        OBJ_CONSTRUCT(&convertors[peer], opal_convertor_t);
+        bytes_left[peer] = 0;
+    }
+    for (peer = 0; peer < size && OMPI_SUCCESS == ret; ++peer) {
+        if (peer == rank) {
+            ret = opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                           &(sdtype->super),
+                                                           scount, sbuf, 0,
+                                                           &convertors[peer]);
+        } else {
+            ret = opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                           &(rdtype->super),
+                                                           rcounts[peer],
+                                                           ((char*) rbuf) +
+                                                           (ptrdiff_t)disps[peer] * extent,
+                                                           0,
+                                                           &convertors[peer]);
+        }
+        opal_convertor_get_packed_size(&convertors[peer], &bytes_left[peer]);
+    }
+
+    step = 0;
+    while (OMPI_SUCCESS == ret && step < num_steps) {
+        segment_num = mca_coll_sm_segments_acquire(data, 0 == rank, size, &flag);
+        max_segment_num = segment_num + mca_coll_sm_component.sm_segs_per_inuse_flag;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+
+            /* Publish my fragment to everybody */
+            if (bytes_left[rank] > 0) {
+                max_data = mca_coll_sm_component.sm_fragment_size;
+                COPY_FRAGMENT_IN(convertors[rank], index, rank, iov, max_data);
+                bytes_left[rank] -= max_data;
+
+                /* Wait for the write to absolutely complete */
+                opal_atomic_wmb();
+
+                for (peer = 0; peer < size; ++peer) {
+                    if (peer != rank) {
+                        CHILD_NOTIFY_PARENT(rank, peer, index, max_data);
+                    }
+                }
+            }
+
+            /* Collect the fragments of the others */
+            for (peer = 0; peer < size; ++peer) {
+                if (peer == rank || 0 == bytes_left[peer]) {
+                    continue;
+                }
+                PARENT_WAIT_FOR_NOTIFY_SPECIFIC(peer, rank, index, max_data,
+                                                allgatherv_label);
+                COPY_FRAGMENT_OUT(convertors[peer], peer, index, iov, max_data);
+                bytes_left[peer] -= max_data;
+            }
+            ++step;
+            ++segment_num;
+        } while (step < num_steps && segment_num < max_segment_num);
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE(flag);
+    }
+
+    for (peer = 0; peer < size; ++peer) {
+        OBJ_DESTRUCT(&convertors[peer]);
+    }
+    free(convertors);
+    return ret;
 }
+
@@ -24,14 +24,20 @@
 
 #include "ompi/constants.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
 #include "coll_sm.h"
 
 
 /**
  * Shared memory allreduce.
  *
- * For the moment, all we're doing is a reduce to root==0 and then a
- * broadcast.  It is possible that we'll do something better someday.
+ * Allreduces of a few bytes of a predefined datatype with a
+ * commutative operation are combined through the flag slots (see
+ * mca_coll_sm_flag_allreduce()), and the large ones are reduced in
+ * place from the user buffers when possible (see
+ * mca_coll_sm_allreduce_single_copy()).  Otherwise, all we're doing
+ * is a reduce to root==0 and then a broadcast.
  */
 int mca_coll_sm_allreduce_intra(const void *sbuf, void *rbuf, int count,
                                 struct ompi_datatype_t *dtype,
@@ -39,7 +45,35 @@ int mca_coll_sm_allreduce_intra(const void *sbuf, void *rbuf, int count,
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module)
 {
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
     int ret;
+    size_t dsize;
+
+    /* the flag slots hold count * dsize bytes, which must be the whole
+       span of the data (e.g., not the pairs of MAXLOC and MINLOC, whose
+       extent is larger than their size) */
+    ompi_datatype_type_size(dtype, &dsize);
+    if (dsize * count <= MCA_COLL_SM_FLAG_MAX_BYTES &&
+        ompi_datatype_is_predefined(dtype) && ompi_op_is_commute(op) &&
+        ompi_datatype_is_contiguous_memory_layout(dtype, count)) {
+        return mca_coll_sm_flag_allreduce(sbuf, rbuf, count, dtype, op,
+                                          comm, module);
+    }
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    if (sm_module->sm_comm_data->mcb_single_copy &&
+        dsize * count >= mca_coll_sm_component.sm_single_copy_threshold &&
+        ompi_datatype_is_predefined(dtype) &&
+        ompi_datatype_is_contiguous_memory_layout(dtype, count)) {
+        return mca_coll_sm_allreduce_single_copy(sbuf, rbuf, count, dtype, op,
+                                                 comm, module);
+    }
 
     /* Note that only the root can pass MPI_IN_PLACE to MPI_REDUCE, so
        have slightly different logic for that case. */
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,22 +20,70 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
 /*
  *	alltoall_intra
  *
- *	Function:	- MPI_Alltoall
+ *	Function:	- shared memory alltoall
  *	Accepts:	- same as MPI_Alltoall()
- *	Returns:	- MPI_SUCCESS or an MPI error code
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	All the blocks have the same size, so no agreement is needed
+ *	before running the alltoallw engine.
  */
 int mca_coll_sm_alltoall_intra(const void *sbuf, int scount,
-                               struct ompi_datatype_t *sdtype, void *rbuf,
-                               int rcount, struct ompi_datatype_t *rdtype,
+                               struct ompi_datatype_t *sdtype,
+                               void *rbuf, int rcount,
+                               struct ompi_datatype_t *rdtype,
                                struct ompi_communicator_t *comm,
-                                mca_coll_base_module_t *module)
+                               mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    int ret, i, size = ompi_comm_size(comm);
+    int *counts;
+    struct ompi_datatype_t **dtypes;
+    ptrdiff_t *byte_disps, lb, sextent, rextent;
+    size_t dsize;
+
+    if (MPI_IN_PLACE == sbuf || 0 == mca_coll_sm_alltoall_block_size(size)) {
+        return sm_module->previous_alltoall(sbuf, scount, sdtype, rbuf, rcount, rdtype,
+                                            comm, sm_module->previous_alltoall_module);
+    }
+
+    byte_disps = (ptrdiff_t*) malloc(2 * size * (sizeof(ptrdiff_t) + sizeof(int) +
+                                                 sizeof(struct ompi_datatype_t*)));
+    if (NULL == byte_disps) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    dtypes = (struct ompi_datatype_t**) (byte_disps + 2 * size);
+    counts = (int*) (dtypes + 2 * size);
+
+    ompi_datatype_get_extent(sdtype, &lb, &sextent);
+    ompi_datatype_get_extent(rdtype, &lb, &rextent);
+    for (i = 0; i < size; ++i) {
+        byte_disps[i] = (ptrdiff_t)i * scount * sextent;
+        byte_disps[size + i] = (ptrdiff_t)i * rcount * rextent;
+        dtypes[i] = sdtype;
+        dtypes[size + i] = rdtype;
+        counts[i] = scount;
+        counts[size + i] = rcount;
+    }
+    ompi_datatype_type_size(sdtype, &dsize);
+
+    ret = mca_coll_sm_alltoallw_engine(sbuf, counts, byte_disps, dtypes,
+                                       rbuf, counts + size, byte_disps + size, dtypes + size,
+                                       dsize * (size_t) scount, comm, module);
+    free(byte_disps);
+    return ret;
 }
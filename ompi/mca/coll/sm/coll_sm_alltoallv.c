@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,16 +20,28 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
 /*
  *	alltoallv_intra
  *
- *	Function:	- MPI_Alltoallv
+ *	Function:	- shared memory alltoallv
  *	Accepts:	- same as MPI_Alltoallv()
- *	Returns:	- MPI_SUCCESS or an MPI error code
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	The processes first agree on the largest block exchanged
+ *	between two processes, which sets the number of segments
+ *	everybody steps through.
  */
 int mca_coll_sm_alltoallv_intra(const void *sbuf, const int *scounts, const int *sdisps,
                                 struct ompi_datatype_t *sdtype,
@@ -38,5 +50,53 @@ int mca_coll_sm_alltoallv_intra(const void *sbuf, const int *scounts, const int
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    uint64_t my_max = 0, max_bytes;
+    struct ompi_datatype_t **dtypes;
+    ptrdiff_t *byte_disps, lb, sextent, rextent;
+    size_t ssize, rsize;
+
+    if (MPI_IN_PLACE == sbuf || 0 == mca_coll_sm_alltoall_block_size(size)) {
+        return sm_module->previous_alltoallv(sbuf, scounts, sdisps, sdtype,
+                                             rbuf, rcounts, rdisps, rdtype, comm,
+                                             sm_module->previous_alltoallv_module);
+    }
+
+    byte_disps = (ptrdiff_t*) malloc(2 * size * (sizeof(ptrdiff_t) +
+                                                 sizeof(struct ompi_datatype_t*)));
+    if (NULL == byte_disps) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    dtypes = (struct ompi_datatype_t**) (byte_disps + 2 * size);
+
+    ompi_datatype_get_extent(sdtype, &lb, &sextent);
+    ompi_datatype_get_extent(rdtype, &lb, &rextent);
+    ompi_datatype_type_size(sdtype, &ssize);
+    ompi_datatype_type_size(rdtype, &rsize);
+    for (i = 0; i < size; ++i) {
+        byte_disps[i] = (ptrdiff_t)sdisps[i] * sextent;
+        byte_disps[size + i] = (ptrdiff_t)rdisps[i] * rextent;
+        dtypes[i] = sdtype;
+        dtypes[size + i] = rdtype;
+        if (i == rank) {
+            continue;
+        }
+        if ((uint64_t)scounts[i] * ssize > my_max) {
+            my_max = (uint64_t)scounts[i] * ssize;
+        }
+        if ((uint64_t)rcounts[i] * rsize > my_max) {
+            my_max = (uint64_t)rcounts[i] * rsize;
+        }
+    }
+
+    ret = mca_coll_sm_allreduce_intra(&my_max, &max_bytes, 1, MPI_UINT64_T, MPI_MAX,
+                                      comm, module);
+    if (OMPI_SUCCESS == ret) {
+        ret = mca_coll_sm_alltoallw_engine(sbuf, scounts, byte_disps, dtypes,
+                                           rbuf, rcounts, byte_disps + size, dtypes + size,
+                                           (size_t) max_bytes, comm, module);
+    }
+    free(byte_disps);
+    return ret;
 }
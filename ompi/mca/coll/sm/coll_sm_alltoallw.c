@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,16 +20,181 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
+/**
+ * Shared memory alltoallw engine, also used by alltoall and
+ * alltoallv.  The displacements are in bytes.
+ *
+ * Process 0 owns the set of segments.  Each process' slot of a
+ * segment is split in one block per destination (see
+ * mca_coll_sm_alltoall_block_size()).  For each segment, every
+ * process packs its next fragment for each destination that still
+ * has data in the destination's block of its own slot, and notifies
+ * the destination; then it waits for each source that still has
+ * data for it and unpacks the fragment from its block of the
+ * source's slot directly into the user buffer.  All the processes
+ * step through the same number of segments (given by max_bytes).
+ */
+int mca_coll_sm_alltoallw_engine(const void *sbuf, const int *scounts,
+                                 const ptrdiff_t *sdisps,
+                                 struct ompi_datatype_t * const *sdtypes,
+                                 void *rbuf, const int *rcounts,
+                                 const ptrdiff_t *rdisps,
+                                 struct ompi_datatype_t * const *rdtypes,
+                                 size_t max_bytes,
+                                 struct ompi_communicator_t *comm,
+                                 mca_coll_base_module_t *module)
+{
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int ret, rank, size, peer;
+    int segment_num, max_segment_num;
+    size_t step, num_steps, max_data, block;
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+    opal_convertor_t *send_convertors, *recv_convertors;
+    size_t *send_left, *recv_left;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    block = mca_coll_sm_alltoall_block_size(size);
+    num_steps = (max_bytes + block - 1) / block;
+
+    /* Exchange with myself */
+    ret = ompi_datatype_sndrcv(((char*) sbuf) + sdisps[rank], scounts[rank], sdtypes[rank],
+                               ((char*) rbuf) + rdisps[rank], rcounts[rank], rdtypes[rank]);
+    if (MPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (0 == num_steps) {
+        return OMPI_SUCCESS;
+    }
+
+    send_convertors = (opal_convertor_t*) malloc(2 * size * (sizeof(opal_convertor_t) +
+                                                             sizeof(size_t)));
+    if (NULL == send_convertors) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    recv_convertors = send_convertors + size;
+    send_left = (size_t*) (recv_convertors + size);
+    recv_left = send_left + size;
+    for (peer = 0; peer < size; ++peer) {
+        OBJ_CONSTRUCT(&send_convertors[peer], opal_convertor_t);
+        OBJ_CONSTRUCT(&recv_convertors[peer], opal_convertor_t);
+        send_left[peer] = recv_left[peer] = 0;
+    }
+    for (peer = 0; peer < size && OMPI_SUCCESS == ret; ++peer) {
+        if (peer == rank) {
+            continue;
+        }
+        ret = opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                       &(sdtypes[peer]->super),
+                                                       scounts[peer],
+                                                       ((char*) sbuf) + sdisps[peer],
+                                                       0,
+                                                       &send_convertors[peer]);
+        if (OMPI_SUCCESS != ret) {
+            break;
+        }
+        opal_convertor_get_packed_size(&send_convertors[peer], &send_left[peer]);
+        ret = opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                       &(rdtypes[peer]->super),
+                                                       rcounts[peer],
+                                                       ((char*) rbuf) + rdisps[peer],
+                                                       0,
+                                                       &recv_convertors[peer]);
+        opal_convertor_get_packed_size(&recv_convertors[peer], &recv_left[peer]);
+    }
+
+    step = 0;
+    while (OMPI_SUCCESS == ret && step < num_steps) {
+        segment_num = mca_coll_sm_segments_acquire(data, 0 == rank, size, &flag);
+        max_segment_num = segment_num + mca_coll_sm_component.sm_segs_per_inuse_flag;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+
+            /* Post my fragments, starting with my right neighbor so
+               that all the processes do not hammer the same slot */
+            for (peer = (rank + 1) % size; peer != rank; peer = (peer + 1) % size) {
+                if (0 == send_left[peer]) {
+                    continue;
+                }
+                iov.iov_base = index->mcbmi_data +
+                    (rank * mca_coll_sm_component.sm_fragment_size) + peer * block;
+                iov.iov_len = max_data = block;
+                opal_convertor_pack(&send_convertors[peer], &iov, &mca_coll_sm_one,
+                                    &max_data);
+                send_left[peer] -= max_data;
+
+                /* Wait for the write to absolutely complete */
+                opal_atomic_wmb();
+
+                CHILD_NOTIFY_PARENT(rank, peer, index, max_data);
+            }
+
+            /* Collect the fragments for me */
+            for (peer = (rank + size - 1) % size; peer != rank;
+                 peer = (peer + size - 1) % size) {
+                if (0 == recv_left[peer]) {
+                    continue;
+                }
+                PARENT_WAIT_FOR_NOTIFY_SPECIFIC(peer, rank, index, max_data,
+                                                alltoallw_label);
+                iov.iov_base = index->mcbmi_data +
+                    (peer * mca_coll_sm_component.sm_fragment_size) + rank * block;
+                iov.iov_len = max_data;
+                opal_convertor_unpack(&recv_convertors[peer], &iov, &mca_coll_sm_one,
+                                      &max_data);
+                recv_left[peer] -= max_data;
+            }
+            ++step;
+            ++segment_num;
+        } while (step < num_steps && segment_num < max_segment_num);
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE(flag);
+    }
+
+    for (peer = 0; peer < size; ++peer) {
+        OBJ_DESTRUCT(&send_convertors[peer]);
+        OBJ_DESTRUCT(&recv_convertors[peer]);
+    }
+    free(send_convertors);
+    return ret;
+}
+
+
 /*
  *	alltoallw_intra
  *
- *	Function:	- MPI_Alltoallw
+ *	Function:	- shared memory alltoallw
  *	Accepts:	- same as MPI_Alltoallw()
- *	Returns:	- MPI_SUCCESS or an MPI error code
+ *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	The processes first agree on the largest block exchanged
+ *	between two processes, which sets the number of segments
+ *	everybody steps through.
  */
 int mca_coll_sm_alltoallw_intra(const void *sbuf, const int *scounts, const int *sdisps,
                                 struct ompi_datatype_t * const *sdtypes,
@@ -38,5 +203,45 @@ int mca_coll_sm_alltoallw_intra(const void *sbuf, const int *scounts, const int
                                 struct ompi_communicator_t *comm,
                                 mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    uint64_t my_max = 0, max_bytes;
+    ptrdiff_t *byte_disps;
+    size_t dsize;
+
+    if (MPI_IN_PLACE == sbuf || 0 == mca_coll_sm_alltoall_block_size(size)) {
+        return sm_module->previous_alltoallw(sbuf, scounts, sdisps, sdtypes,
+                                             rbuf, rcounts, rdisps, rdtypes, comm,
+                                             sm_module->previous_alltoallw_module);
+    }
+
+    byte_disps = (ptrdiff_t*) malloc(2 * size * sizeof(ptrdiff_t));
+    if (NULL == byte_disps) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < size; ++i) {
+        byte_disps[i] = sdisps[i];
+        byte_disps[size + i] = rdisps[i];
+        if (i == rank) {
+            continue;
+        }
+        ompi_datatype_type_size(sdtypes[i], &dsize);
+        if ((uint64_t)scounts[i] * dsize > my_max) {
+            my_max = (uint64_t)scounts[i] * dsize;
+        }
+        ompi_datatype_type_size(rdtypes[i], &dsize);
+        if ((uint64_t)rcounts[i] * dsize > my_max) {
+            my_max = (uint64_t)rcounts[i] * dsize;
+        }
+    }
+
+    ret = mca_coll_sm_allreduce_intra(&my_max, &max_bytes, 1, MPI_UINT64_T, MPI_MAX,
+                                      comm, module);
+    if (OMPI_SUCCESS == ret) {
+        ret = mca_coll_sm_alltoallw_engine(sbuf, scounts, byte_disps, sdtypes,
+                                           rbuf, rcounts, byte_disps + size, rdtypes,
+                                           (size_t) max_bytes, comm, module);
+    }
+    free(byte_disps);
+    return ret;
 }
@@ -22,43 +22,52 @@
 
 #include "ompi/constants.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
 #include "ompi/mca/coll/coll.h"
+#include "ompi/op/op.h"
 #include "opal/sys/atomic.h"
 #include "coll_sm.h"
 
 /**
- * Shared memory barrier.
+ * Shared memory barrier and allreduce of a few bytes.
  *
- * Tree-based algorithm for a barrier: a fan in to rank 0 followed by
- * a fan out using the barrier segments in the shared memory area.
+ * Combining tree with a sense reversing release: each process waits
+ * for the children of its node of the tree (mcb_tree) to arrive at the
+ * operation by polling their flag slots, combines their partial
+ * results into its own, and arrives in turn by writing the sense of
+ * the operation in its slot.  Rank 0 then writes the result and the
+ * sense in the release slot, which everybody else polls.  Each slot is
+ * on its own cache lines and written by a single process, so there are
+ * no atomic operations, and each process only waits for a cache line
+ * to change once per child and once for the release.
  *
- * There are 2 sets of barrier buffers -- since there can only be, at
- * most, 2 outstanding barriers at any time, there is no need for more
- * than this.  The generalized in-use flags, control, and data
- * segments are not used.
+ * The sense flips at each operation, so that the slots never have to
+ * be reset: a process cannot arrive at the next operation before the
+ * release of the current one, which itself means that all the
+ * processes arrived, i.e., read the slots of their children and the
+ * release of the previous operation.
  *
- * The general algorithm is for a given process to wait for its N
- * children to fan in by monitoring a uint32_t in its barrier "in"
- * buffer.  When this value reaches N (i.e., each of the children have
- * atomically incremented the value), then the process atomically
- * increases the uint32_t in its parent's "in" buffer.  Then the
- * process waits for the parent to set a "1" in the process' "out"
- * buffer.  Once this happens, the process writes a "1" in each of its
- * children's "out" buffers, and returns.
+ * The writes to the slots before an operation are visible to all the
+ * processes after it (the single-copy collectives publish their
+ * buffers this way).
  *
- * There's corner cases, of course, such as the root that has no
- * parent, and the leaves that have no children.  But that's the
- * general idea.
+ * A count of 0 makes a barrier; otherwise the data (at most
+ * MCA_COLL_SM_FLAG_MAX_BYTES) is combined up the tree, so the operation
+ * must be commutative, and dtype predefined and contiguous: the data is
+ * copied as count times the size of dtype.
  */
-int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
-                              mca_coll_base_module_t *module)
+int mca_coll_sm_flag_allreduce(const void *sbuf, void *rbuf, int count,
+                               struct ompi_datatype_t *dtype,
+                               struct ompi_op_t *op,
+                               struct ompi_communicator_t *comm,
+                               mca_coll_base_module_t *module)
 {
-    int rank, buffer_set;
+    int i, rank, size;
+    uint32_t sense;
+    size_t len = 0;
     mca_coll_sm_comm_t *data;
-    uint32_t i, num_children;
-    volatile uint32_t *me_in, *me_out, *children = NULL;
-    opal_atomic_uint32_t *parent;
-    int uint_control_size;
+    mca_coll_sm_tree_node_t *me;
+    mca_coll_sm_flag_slot_t *mine, *child, *release;
     mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
 
     /* Lazily enable the module the first time we invoke a collective
@@ -70,55 +79,55 @@ int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
         }
     }
 
-    uint_control_size =
-        mca_coll_sm_component.sm_control_size / sizeof(uint32_t);
     data = sm_module->sm_comm_data;
     rank = ompi_comm_rank(comm);
-    num_children = data->mcb_tree[rank].mcstn_num_children;
-    buffer_set = ((data->mcb_barrier_count++) % 2) * 2;
-    me_in = &data->mcb_barrier_control_me[buffer_set];
-    me_out = (uint32_t*)
-        (((char*) me_in) + mca_coll_sm_component.sm_control_size);
+    size = ompi_comm_size(comm);
+    me = &data->mcb_tree[rank];
+    mine = mca_coll_sm_flag_slot(data, rank);
+    release = mca_coll_sm_flag_slot(data, size);
+    sense = data->mcb_flag_sense = !data->mcb_flag_sense;
 
-    /* Wait for my children to write to my *in* buffer */
-
-    if (0 != num_children) {
-        /* Get children *out* buffer */
-        children = data->mcb_barrier_control_children + buffer_set +
-            uint_control_size;
-        SPIN_CONDITION(*me_in == num_children, exit_label1);
-        *me_in = 0;
+    if (count > 0) {
+        ompi_datatype_type_size(dtype, &len);
+        len *= count;
+        memcpy(mine->mcsfs_data, MPI_IN_PLACE == sbuf ? rbuf : sbuf, len);
     }
 
-    /* Send to my parent and wait for a response (don't poll on
-       parent's out buffer -- that would cause a lot of network
-       traffic / contention / faults / etc.  Instead, children poll on
-       local memory and therefore only num_children messages are sent
-       across the network [vs. num_children *each* time all the
-       children poll] -- i.e., the memory is only being polled by one
-       process, and it is only changed *once* by an external
-       process) */
-
-    if (0 != rank) {
-        /* Get parent *in* buffer */
-        parent = &data->mcb_barrier_control_parent[buffer_set];
-        opal_atomic_add (parent, 1);
-
-        SPIN_CONDITION(0 != *me_out, exit_label2);
-        *me_out = 0;
+    /* Fan in: wait for my children and combine their data */
+    for (i = 0; i < me->mcstn_num_children; ++i) {
+        child = mca_coll_sm_flag_slot(data, me->mcstn_children[i]->mcstn_id);
+        SPIN_CONDITION(sense == child->mcsfs_sense, exit_label1);
+        opal_atomic_rmb();
+        if (count > 0) {
+            ompi_op_reduce(op, child->mcsfs_data, mine->mcsfs_data, count, dtype);
+        }
     }
 
-    /* Send to my children */
-
-    for (i = 0; i < num_children; ++i) {
-        children[i * uint_control_size * 4] = 1;
+    if (NULL != me->mcstn_parent) {
+        /* Arrive, and wait for the release */
+        opal_atomic_wmb();
+        mine->mcsfs_sense = sense;
+        SPIN_CONDITION(sense == release->mcsfs_sense, exit_label2);
+        opal_atomic_rmb();
+    } else {
+        /* Everybody arrived: release them */
+        memcpy(release->mcsfs_data, mine->mcsfs_data, len);
+        opal_atomic_wmb();
+        release->mcsfs_sense = sense;
     }
 
-    /* All done!  End state of the control segment:
-
-       me_in: 0
-       me_out: 0
-    */
+    if (count > 0) {
+        memcpy(rbuf, release->mcsfs_data, len);
+    }
 
     return OMPI_SUCCESS;
 }
+
+/**
+ * Shared memory barrier: a flag allreduce of no data.
+ */
+int mca_coll_sm_barrier_intra(struct ompi_communicator_t *comm,
+                              mca_coll_base_module_t *module)
+{
+    return mca_coll_sm_flag_allreduce(NULL, NULL, 0, NULL, NULL, comm, module);
+}
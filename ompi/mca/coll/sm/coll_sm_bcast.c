@@ -79,6 +79,19 @@ int mca_coll_sm_bcast_intra(void *buff, int count,
     }
     data = sm_module->sm_comm_data;
 
+    /* Large messages are read directly from the root buffer, if they
+       are contiguous */
+    if (data->mcb_single_copy) {
+        ompi_datatype_type_size(datatype, &bytes);
+        if (bytes * count >= mca_coll_sm_component.sm_single_copy_threshold) {
+            ret = mca_coll_sm_bcast_single_copy(buff, count, datatype, root,
+                                                comm, module);
+            if (OMPI_ERR_NOT_SUPPORTED != ret) {
+                return ret;
+            }
+        }
+    }
+
     /* Setup some identities */
 
     rank = ompi_comm_rank(comm);
@@ -116,6 +116,10 @@ mca_coll_sm_component_t mca_coll_sm_component = {
        information variable */
     4,
 
+    /* (default) size from which the bcasts and allreduces are single
+       copy */
+    262144,
+
     /* default values for non-MCA parameters */
     /* Not specifying values here gives us all 0's */
 };
@@ -165,7 +169,7 @@ static int sm_verify_mca_variables(void)
         cs->sm_tree_degree = 255;
     }
 
-    coll_sm_shared_mem_used_data = (int)(4 * cs->sm_control_size +
+    coll_sm_shared_mem_used_data = (int)(mca_coll_sm_flags_area_size(cs->sm_info_comm_size) +
         (cs->sm_comm_num_in_use_flags * cs->sm_control_size) +
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_control_size * 2)) +
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_fragment_size)));
@@ -231,6 +235,14 @@ static int sm_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &cs->sm_tree_degree);
 
+    cs->sm_single_copy_threshold = 262144;
+    (void) mca_base_component_var_register(c, "single_copy_threshold",
+                                           "Size (in bytes) from which the bcasts and allreduces of contiguous data read the user buffers of the other processes directly instead of copying them through the shared memory segments, if the processes can read each other's memory (0 disables the single-copy mode)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->sm_single_copy_threshold);
+
     /* INFO: Calculate how much space we need in the per-communicator
        shmem data segment.  This formula taken directly from
        coll_sm_module.c. */
@@ -242,7 +254,7 @@ static int sm_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &cs->sm_info_comm_size);
 
-    coll_sm_shared_mem_used_data = (int)(4 * cs->sm_control_size +
+    coll_sm_shared_mem_used_data = (int)(mca_coll_sm_flags_area_size(cs->sm_info_comm_size) +
         (cs->sm_comm_num_in_use_flags * cs->sm_control_size) +
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_control_size * 2)) +
         (cs->sm_comm_num_segments * (cs->sm_info_comm_size * cs->sm_fragment_size)));
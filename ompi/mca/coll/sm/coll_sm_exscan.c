@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,14 +20,22 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
 /*
  *	exscan_intra
  *
- *	Function:	- basic exscan operation
+ *	Function:	- shared memory exscan
  *	Accepts:	- same arguments as MPI_Exscan()
  *	Returns:	- MPI_SUCCESS or error code
  */
@@ -37,5 +45,15 @@ int mca_coll_sm_exscan_intra(const void *sbuf, void *rbuf, int count,
                              struct ompi_communicator_t *comm,
                              mca_coll_base_module_t *module)
 {
-  return OMPI_ERR_NOT_IMPLEMENTED;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    size_t ddt_size;
+
+    ompi_datatype_type_size(dtype, &ddt_size);
+    if (!ompi_datatype_is_contiguous_memory_layout(dtype, count) ||
+        ddt_size > (size_t) mca_coll_sm_component.sm_fragment_size) {
+        return sm_module->previous_exscan(sbuf, rbuf, count, dtype, op, comm,
+                                          sm_module->previous_exscan_module);
+    }
+
+    return mca_coll_sm_scan_engine(sbuf, rbuf, count, dtype, op, true, comm, module);
 }
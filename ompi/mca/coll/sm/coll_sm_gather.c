@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,7 +20,15 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
@@ -30,6 +38,9 @@
  *      Function:       - shared memory gather
  *      Accepts:        - same as MPI_Gather()
  *      Returns:        - MPI_SUCCESS or error code
+ *
+ *      All the blocks have the same size, so no agreement is needed
+ *      before running the gatherv engine.
  */
 int mca_coll_sm_gather_intra(const void *sbuf, int scount,
                              struct ompi_datatype_t *sdtype, void *rbuf,
@@ -37,5 +48,32 @@ int mca_coll_sm_gather_intra(const void *sbuf, int scount,
                              int root, struct ompi_communicator_t *comm,
                              mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    int *counts = NULL, *disps = NULL;
+    size_t dsize;
+
+    if (root == rank) {
+        ompi_datatype_type_size(rdtype, &dsize);
+        dsize *= (size_t) rcount;
+
+        counts = (int*) malloc(2 * size * sizeof(int));
+        if (NULL == counts) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        disps = counts + size;
+        for (i = 0; i < size; ++i) {
+            counts[i] = rcount;
+            disps[i] = i * rcount;
+        }
+    } else {
+        ompi_datatype_type_size(sdtype, &dsize);
+        dsize *= (size_t) scount;
+    }
+
+    ret = mca_coll_sm_gatherv_engine(sbuf, scount, sdtype, rbuf, counts, disps,
+                                     rdtype, root, dsize, comm, module);
+    if (NULL != counts) {
+        free(counts);
+    }
+    return ret;
 }
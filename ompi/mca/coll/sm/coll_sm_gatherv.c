@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,23 +20,231 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
+/**
+ * Shared memory gatherv engine, also used by gather.
+ *
+ * The root owns the set of segments.  For each segment, each
+ * non-root process packs its next fragment in its own slot of the
+ * segment and notifies the root; the root waits for the processes
+ * that still have data, in rank order, and unpacks their fragment
+ * directly into the user buffer.  All the processes step through the
+ * same number of segments (given by max_bytes), the ones that are
+ * done sending simply do nothing in the remaining segments.
+ */
+int mca_coll_sm_gatherv_engine(const void *sbuf, int scount,
+                               struct ompi_datatype_t *sdtype,
+                               void *rbuf, const int *rcounts, const int *disps,
+                               struct ompi_datatype_t *rdtype, int root,
+                               size_t max_bytes,
+                               struct ompi_communicator_t *comm,
+                               mca_coll_base_module_t *module)
+{
+    struct iovec iov;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int ret, rank, size, peer;
+    int segment_num, max_segment_num;
+    size_t step, num_steps, max_data;
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    num_steps = (max_bytes + mca_coll_sm_component.sm_fragment_size - 1) /
+        mca_coll_sm_component.sm_fragment_size;
+
+    /*********************************************************************
+     * Root
+     *********************************************************************/
+
+    if (root == rank) {
+        opal_convertor_t *convertors;
+        size_t *bytes_left;
+        ptrdiff_t lb, extent;
+
+        /* Copy my own block */
+        ompi_datatype_get_extent(rdtype, &lb, &extent);
+        if (MPI_IN_PLACE != sbuf) {
+            ret = ompi_datatype_sndrcv(sbuf, scount, sdtype,
+                                       ((char*) rbuf) + (ptrdiff_t)disps[rank] * extent,
+                                       rcounts[rank], rdtype);
+            if (MPI_SUCCESS != ret) {
+                return ret;
+            }
+        }
+        if (0 == num_steps) {
+            return OMPI_SUCCESS;
+        }
+
+        /* One receive convertor per peer, so that each one keeps
+           track of its position in the user buffer */
+        convertors = (opal_convertor_t*) malloc(size * (sizeof(opal_convertor_t) +
+                                                        sizeof(size_t)));
+        if (NULL == convertors) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        bytes_left = (size_t*) (convertors + size);
+        for (peer = 0; peer < size; ++peer) {
+            OBJ_CONSTRUCT(&convertors[peer], opal_convertor_t);
+            bytes_left[peer] = 0;
+        }
+        ret = OMPI_SUCCESS;
+        for (peer = 0; peer < size && OMPI_SUCCESS == ret; ++peer) {
+            if (peer == rank) {
+                continue;
+            }
+            ret = opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+                                                           &(rdtype->super),
+                                                           rcounts[peer],
+                                                           ((char*) rbuf) +
+                                                           (ptrdiff_t)disps[peer] * extent,
+                                                           0,
+                                                           &convertors[peer]);
+            opal_convertor_get_packed_size(&convertors[peer], &bytes_left[peer]);
+        }
+
+        step = 0;
+        while (OMPI_SUCCESS == ret && step < num_steps) {
+            segment_num = mca_coll_sm_segments_acquire(data, true, size, &flag);
+            max_segment_num = segment_num + mca_coll_sm_component.sm_segs_per_inuse_flag;
+            do {
+                index = &(data->mcb_data_index[segment_num]);
+                for (peer = 0; peer < size; ++peer) {
+                    if (0 == bytes_left[peer]) {
+                        continue;
+                    }
+                    PARENT_WAIT_FOR_NOTIFY_SPECIFIC(peer, rank, index, max_data,
+                                                    gatherv_root_label);
+                    COPY_FRAGMENT_OUT(convertors[peer], peer, index, iov, max_data);
+                    bytes_left[peer] -= max_data;
+                }
+                ++step;
+                ++segment_num;
+            } while (step < num_steps && segment_num < max_segment_num);
+
+            /* Root is now done with this set of segments */
+            FLAG_RELEASE(flag);
+        }
+
+        for (peer = 0; peer < size; ++peer) {
+            OBJ_DESTRUCT(&convertors[peer]);
+        }
+        free(convertors);
+        return ret;
+    }
+
+    /*********************************************************************
+     * Non-root
+     *********************************************************************/
+
+    else {
+        opal_convertor_t convertor;
+        size_t bytes_left;
+
+        if (0 == num_steps) {
+            return OMPI_SUCCESS;
+        }
+
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+        if (OMPI_SUCCESS !=
+            (ret = opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+                                                            &(sdtype->super),
+                                                            scount,
+                                                            sbuf,
+                                                            0,
+                                                            &convertor))) {
+            OBJ_DESTRUCT(&convertor);
+            return ret;
+        }
+        opal_convertor_get_packed_size(&convertor, &bytes_left);
+
+        step = 0;
+        do {
+            segment_num = mca_coll_sm_segments_acquire(data, false, size, &flag);
+            max_segment_num = segment_num + mca_coll_sm_component.sm_segs_per_inuse_flag;
+            do {
+                if (bytes_left > 0) {
+                    index = &(data->mcb_data_index[segment_num]);
+                    max_data = mca_coll_sm_component.sm_fragment_size;
+                    COPY_FRAGMENT_IN(convertor, index, rank, iov, max_data);
+                    bytes_left -= max_data;
+
+                    /* Wait for the write to absolutely complete */
+                    opal_atomic_wmb();
+
+                    CHILD_NOTIFY_PARENT(rank, root, index, max_data);
+                }
+                ++step;
+                ++segment_num;
+            } while (step < num_steps && segment_num < max_segment_num);
+
+            /* We're finished with this set of segments */
+            FLAG_RELEASE(flag);
+        } while (step < num_steps);
+
+        OBJ_DESTRUCT(&convertor);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+
 /*
  *	gatherv_intra
  *
- *	Function:	- basic gatherv operation
- *	Accepts:	- same arguments as MPI_Gatherb()
+ *	Function:	- shared memory gatherv
+ *	Accepts:	- same arguments as MPI_Gatherv()
  *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Only the root knows all the counts, so it first broadcasts the
+ *	largest block size, which sets the number of segments everybody
+ *	steps through.
  */
 int mca_coll_sm_gatherv_intra(const void *sbuf, int scount,
-                              struct ompi_datatype_t *sdtype,
-                              void *rbuf, const int *rcounts, const int *disps,
+                              struct ompi_datatype_t *sdtype, void *rbuf,
+                              const int *rcounts, const int *disps,
                               struct ompi_datatype_t *rdtype, int root,
                               struct ompi_communicator_t *comm,
                               mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    uint64_t max_bytes = 0;
+    size_t dsize;
+
+    if (root == rank) {
+        ompi_datatype_type_size(rdtype, &dsize);
+        for (i = 0; i < size; ++i) {
+            if (i != root && (uint64_t)rcounts[i] * dsize > max_bytes) {
+                max_bytes = (uint64_t)rcounts[i] * dsize;
+            }
+        }
+    }
+    ret = mca_coll_sm_bcast_intra(&max_bytes, 1, MPI_UINT64_T, root, comm, module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+
+    return mca_coll_sm_gatherv_engine(sbuf, scount, sdtype, rbuf, rcounts, disps,
+                                      rdtype, root, (size_t) max_bytes, comm, module);
 }
@@ -90,6 +90,16 @@ static void mca_coll_sm_module_construct(mca_coll_sm_module_t *module)
     module->sm_comm_data = NULL;
     module->previous_reduce = NULL;
     module->previous_reduce_module = NULL;
+    module->previous_alltoall = NULL;
+    module->previous_alltoall_module = NULL;
+    module->previous_alltoallv = NULL;
+    module->previous_alltoallv_module = NULL;
+    module->previous_alltoallw = NULL;
+    module->previous_alltoallw_module = NULL;
+    module->previous_scan = NULL;
+    module->previous_scan_module = NULL;
+    module->previous_exscan = NULL;
+    module->previous_exscan_module = NULL;
     module->super.coll_module_disable = mca_coll_sm_module_disable;
 }
 
@@ -111,10 +121,25 @@ static void mca_coll_sm_module_destruct(mca_coll_sm_module_t *module)
         free(c);
     }
 
-    /* It should always be non-NULL, but just in case */
+    /* They should always be non-NULL, but just in case */
     if (NULL != module->previous_reduce_module) {
         OBJ_RELEASE(module->previous_reduce_module);
     }
+    if (NULL != module->previous_alltoall_module) {
+        OBJ_RELEASE(module->previous_alltoall_module);
+    }
+    if (NULL != module->previous_alltoallv_module) {
+        OBJ_RELEASE(module->previous_alltoallv_module);
+    }
+    if (NULL != module->previous_alltoallw_module) {
+        OBJ_RELEASE(module->previous_alltoallw_module);
+    }
+    if (NULL != module->previous_scan_module) {
+        OBJ_RELEASE(module->previous_scan_module);
+    }
+    if (NULL != module->previous_exscan_module) {
+        OBJ_RELEASE(module->previous_exscan_module);
+    }
 
     module->enabled = false;
 }
@@ -130,6 +155,31 @@ static int mca_coll_sm_module_disable(mca_coll_base_module_t *module, struct omp
         OBJ_RELEASE(sm_module->previous_reduce_module);
 	sm_module->previous_reduce_module = NULL;
     }
+    if (NULL != sm_module->previous_alltoall_module) {
+        sm_module->previous_alltoall = NULL;
+        OBJ_RELEASE(sm_module->previous_alltoall_module);
+        sm_module->previous_alltoall_module = NULL;
+    }
+    if (NULL != sm_module->previous_alltoallv_module) {
+        sm_module->previous_alltoallv = NULL;
+        OBJ_RELEASE(sm_module->previous_alltoallv_module);
+        sm_module->previous_alltoallv_module = NULL;
+    }
+    if (NULL != sm_module->previous_alltoallw_module) {
+        sm_module->previous_alltoallw = NULL;
+        OBJ_RELEASE(sm_module->previous_alltoallw_module);
+        sm_module->previous_alltoallw_module = NULL;
+    }
+    if (NULL != sm_module->previous_scan_module) {
+        sm_module->previous_scan = NULL;
+        OBJ_RELEASE(sm_module->previous_scan_module);
+        sm_module->previous_scan_module = NULL;
+    }
+    if (NULL != sm_module->previous_exscan_module) {
+        sm_module->previous_exscan = NULL;
+        OBJ_RELEASE(sm_module->previous_exscan_module);
+        sm_module->previous_exscan_module = NULL;
+    }
     return OMPI_SUCCESS;
 }
 
@@ -196,22 +246,22 @@ mca_coll_sm_comm_query(struct ompi_communicator_t *comm, int *priority)
     /* All is good -- return a module */
     sm_module->super.coll_module_enable = sm_module_enable;
     sm_module->super.ft_event        = mca_coll_sm_ft_event;
-    sm_module->super.coll_allgather  = NULL;
-    sm_module->super.coll_allgatherv = NULL;
+    sm_module->super.coll_allgather  = mca_coll_sm_allgather_intra;
+    sm_module->super.coll_allgatherv = mca_coll_sm_allgatherv_intra;
     sm_module->super.coll_allreduce  = mca_coll_sm_allreduce_intra;
-    sm_module->super.coll_alltoall   = NULL;
-    sm_module->super.coll_alltoallv  = NULL;
-    sm_module->super.coll_alltoallw  = NULL;
+    sm_module->super.coll_alltoall   = mca_coll_sm_alltoall_intra;
+    sm_module->super.coll_alltoallv  = mca_coll_sm_alltoallv_intra;
+    sm_module->super.coll_alltoallw  = mca_coll_sm_alltoallw_intra;
     sm_module->super.coll_barrier    = mca_coll_sm_barrier_intra;
     sm_module->super.coll_bcast      = mca_coll_sm_bcast_intra;
-    sm_module->super.coll_exscan     = NULL;
-    sm_module->super.coll_gather     = NULL;
-    sm_module->super.coll_gatherv    = NULL;
+    sm_module->super.coll_exscan     = mca_coll_sm_exscan_intra;
+    sm_module->super.coll_gather     = mca_coll_sm_gather_intra;
+    sm_module->super.coll_gatherv    = mca_coll_sm_gatherv_intra;
     sm_module->super.coll_reduce     = mca_coll_sm_reduce_intra;
-    sm_module->super.coll_reduce_scatter = NULL;
-    sm_module->super.coll_scan       = NULL;
-    sm_module->super.coll_scatter    = NULL;
-    sm_module->super.coll_scatterv   = NULL;
+    sm_module->super.coll_reduce_scatter = mca_coll_sm_reduce_scatter_intra;
+    sm_module->super.coll_scan       = mca_coll_sm_scan_intra;
+    sm_module->super.coll_scatter    = mca_coll_sm_scatter_intra;
+    sm_module->super.coll_scatterv   = mca_coll_sm_scatterv_intra;
 
     opal_output_verbose(10, ompi_coll_base_framework.framework_output,
                         "coll:sm:comm_query (%d/%s): pick me! pick me!",
@@ -226,15 +276,41 @@ mca_coll_sm_comm_query(struct ompi_communicator_t *comm, int *priority)
 static int sm_module_enable(mca_coll_base_module_t *module,
                             struct ompi_communicator_t *comm)
 {
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+
     if (NULL == comm->c_coll->coll_reduce ||
-        NULL == comm->c_coll->coll_reduce_module) {
+        NULL == comm->c_coll->coll_reduce_module ||
+        NULL == comm->c_coll->coll_alltoall ||
+        NULL == comm->c_coll->coll_alltoallv ||
+        NULL == comm->c_coll->coll_alltoallw ||
+        NULL == comm->c_coll->coll_scan ||
+        NULL == comm->c_coll->coll_exscan) {
         opal_output_verbose(10, ompi_coll_base_framework.framework_output,
-                            "coll:sm:enable (%d/%s): no underlying reduce; disqualifying myself",
+                            "coll:sm:enable (%d/%s): no underlying reduce, alltoall or scan; disqualifying myself",
                             comm->c_contextid, comm->c_name);
         return OMPI_ERROR;
     }
 
-    /* We do everything lazily in ompi_coll_sm_enable() */
+    /* Save the previous components' functions that we fall back on.
+       This must be done here and not in the lazy enable: by then the
+       communicator holds our own functions. */
+#define SM_SAVE_PREVIOUS(name)                                          \
+    do {                                                                \
+        sm_module->previous_ ## name = comm->c_coll->coll_ ## name;     \
+        sm_module->previous_ ## name ## _module =                       \
+            comm->c_coll->coll_ ## name ## _module;                     \
+        OBJ_RETAIN(sm_module->previous_ ## name ## _module);            \
+    } while (0)
+
+    SM_SAVE_PREVIOUS(reduce);
+    SM_SAVE_PREVIOUS(alltoall);
+    SM_SAVE_PREVIOUS(alltoallv);
+    SM_SAVE_PREVIOUS(alltoallw);
+    SM_SAVE_PREVIOUS(scan);
+    SM_SAVE_PREVIOUS(exscan);
+#undef SM_SAVE_PREVIOUS
+
+    /* We do everything else lazily in ompi_coll_sm_enable() */
     return OMPI_SUCCESS;
 }
 
@@ -251,7 +327,6 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
     opal_hwloc_base_memory_segment_t *maffinity;
     int parent, min_child, num_children;
     unsigned char *base = NULL;
-    const int num_barrier_buffers = 2;
 
     /* Just make sure we haven't been here already */
     if (sm_module->enabled) {
@@ -362,39 +437,19 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
     }
 
     /* Once the communicator is bootstrapped, setup the pointers into
-       the per-communicator shmem data segment.  First, setup the
-       barrier buffers.  There are 2 sets of barrier buffers (because
-       there can never be more than one outstanding barrier occuring
-       at any timie).  Setup pointers to my control buffers, my
-       parents, and [the beginning of] my children (note that the
-       children are contiguous, so having the first pointer and the
-       num_children from the mcb_tree data is sufficient). */
-    control_size = c->sm_control_size;
+       the per-communicator shmem data segment.  First, the flag
+       slots used by the barrier and the small allreduces, aligned on
+       a cache line.  The first operation waits for the sense 1. */
     base = data->sm_bootstrap_meta->module_data_addr;
-    data->mcb_barrier_control_me = (uint32_t*)
-        (base + (rank * control_size * num_barrier_buffers * 2));
-    if (data->mcb_tree[rank].mcstn_parent) {
-        data->mcb_barrier_control_parent = (opal_atomic_uint32_t*)
-            (base +
-             (data->mcb_tree[rank].mcstn_parent->mcstn_id * control_size *
-              num_barrier_buffers * 2));
-    } else {
-        data->mcb_barrier_control_parent = NULL;
-    }
-    if (data->mcb_tree[rank].mcstn_num_children > 0) {
-        data->mcb_barrier_control_children = (uint32_t*)
-            (base +
-             (data->mcb_tree[rank].mcstn_children[0]->mcstn_id * control_size *
-              num_barrier_buffers * 2));
-    } else {
-        data->mcb_barrier_control_children = NULL;
-    }
-    data->mcb_barrier_count = 0;
+    data->mcb_flags = (char *)
+        (((uintptr_t) base + opal_cache_line_size - 1) &
+         ~((uintptr_t) opal_cache_line_size - 1));
+    data->mcb_flag_sense = 0;
 
     /* Next, setup the pointer to the in-use flags.  The number of
        segments will be an even multiple of the number of in-use
        flags. */
-    base += (c->sm_control_size * size * num_barrier_buffers * 2);
+    base += mca_coll_sm_flags_area_size(size);
     data->mcb_in_use_flags = (mca_coll_sm_in_use_flag_t*) base;
 
     /* All things being equal, if we're rank 0, then make the in-use
@@ -452,18 +507,15 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
     free(maffinity);
 
     /* Zero out the control structures that belong to this process */
-    memset(data->mcb_barrier_control_me, 0,
-           num_barrier_buffers * 2 * c->sm_control_size);
+    memset(mca_coll_sm_flag_slot(data, rank), 0, mca_coll_sm_flag_slot_size());
+    if (0 == rank) {
+        memset(mca_coll_sm_flag_slot(data, size), 0, mca_coll_sm_flag_slot_size());
+    }
     for (i = 0; i < c->sm_comm_num_segments; ++i) {
         memset((void *) data->mcb_data_index[i].mcbmi_control, 0,
                c->sm_control_size);
     }
 
-    /* Save previous component's reduce information */
-    sm_module->previous_reduce = comm->c_coll->coll_reduce;
-    sm_module->previous_reduce_module = comm->c_coll->coll_reduce_module;
-    OBJ_RETAIN(sm_module->previous_reduce_module);
-
     /* Indicate that we have successfully attached and setup */
     opal_atomic_add (&(data->sm_bootstrap_meta->module_seg->seg_inited), 1);
 
@@ -482,6 +534,11 @@ int ompi_coll_sm_lazy_enable(mca_coll_base_module_t *module,
                             data->sm_bootstrap_meta->shmem_ds.seg_name);
     }
 
+    /* Check whether the large collectives can be single-copy */
+    if (OMPI_SUCCESS != (ret = mca_coll_sm_single_copy_init(comm, module))) {
+        return ret;
+    }
+
     /* All done */
 
     opal_output_verbose(10, ompi_coll_base_framework.framework_output,
@@ -541,9 +598,8 @@ static int bootstrap_comm(ompi_communicator_t *comm,
     /* Calculate how much space we need in the per-communicator shmem
        data segment.  There are several values to add:
 
-       - size of the barrier data (2 of these):
-           - fan-in data (num_procs * control_size)
-           - fan-out data (num_procs * control_size)
+       - size of the flag slots (see mca_coll_sm_flags_area_size()):
+           - (num_procs + 1) cache line aligned slots
        - size of the "in use" buffers:
            - num_in_use_buffers * control_size
        - size of the message fragment area (one for each segment):
@@ -552,14 +608,14 @@ static int bootstrap_comm(ompi_communicator_t *comm,
 
        So it's:
 
-           barrier: 2 * control_size + 2 * control_size
+           flags:   mca_coll_sm_flags_area_size(num_procs)
            in use:  num_in_use * control_size
            control: num_segments * (num_procs * control_size * 2 +
                                     num_procs * control_size)
            message: num_segments * (num_procs * frag_size)
      */
 
-    size = 4 * control_size +
+    size = mca_coll_sm_flags_area_size(comm_size) +
         (num_in_use * control_size) +
         (num_segments * (comm_size * control_size * 2)) +
         (num_segments * (comm_size * frag_size));
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,7 +20,15 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
@@ -30,6 +38,10 @@
  *	Function:	- reduce then scatter
  *	Accepts:	- same as MPI_Reduce_scatter()
  *	Returns:	- MPI_SUCCESS or error code
+ *
+ *	Shared memory reduce of the whole vector to process 0, followed
+ *	by a shared memory scatterv of the blocks.  The counts are known
+ *	everywhere, so the scatterv needs no agreement.
  */
 int mca_coll_sm_reduce_scatter_intra(const void *sbuf, void *rbuf, const int *rcounts,
                                      struct ompi_datatype_t *dtype,
@@ -37,5 +49,58 @@ int mca_coll_sm_reduce_scatter_intra(const void *sbuf, void *rbuf, const int *rc
                                      struct ompi_communicator_t *comm,
                                      mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    int *disps;
+    size_t dsize, max_bytes = 0;
+    ptrdiff_t gap = 0, span;
+    char *free_buf = NULL, *tmp_buf = NULL;
+
+    disps = (int*) malloc(size * sizeof(int));
+    if (NULL == disps) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    ompi_datatype_type_size(dtype, &dsize);
+    disps[0] = 0;
+    for (i = 0; i < size; ++i) {
+        if (i > 0) {
+            disps[i] = disps[i - 1] + rcounts[i - 1];
+        }
+        if (i > 0 && (size_t)rcounts[i] * dsize > max_bytes) {
+            max_bytes = (size_t)rcounts[i] * dsize;
+        }
+    }
+    if (0 == disps[size - 1] + rcounts[size - 1]) {
+        free(disps);
+        return OMPI_SUCCESS;
+    }
+
+    /* With MPI_IN_PLACE, the whole input vector is in rbuf */
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    if (0 == rank) {
+        span = opal_datatype_span(&dtype->super,
+                                  (int64_t)disps[size - 1] + rcounts[size - 1], &gap);
+        free_buf = (char*) malloc(span);
+        if (NULL == free_buf) {
+            free(disps);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        tmp_buf = free_buf - gap;
+    }
+
+    ret = mca_coll_sm_reduce_intra(sbuf, tmp_buf, disps[size - 1] + rcounts[size - 1],
+                                   dtype, op, 0, comm, module);
+    if (OMPI_SUCCESS == ret) {
+        ret = mca_coll_sm_scatterv_engine(tmp_buf, rcounts, disps, dtype,
+                                          rbuf, rcounts[rank], dtype, 0,
+                                          max_bytes, comm, module);
+    }
+
+    if (NULL != free_buf) {
+        free(free_buf);
+    }
+    free(disps);
+    return ret;
 }
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,14 +20,146 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/op/op.h"
 #include "coll_sm.h"
 
 
+/**
+ * Shared memory scan engine, for both scan and exscan.
+ *
+ * The partial results travel down a pipelined chain: for each
+ * segment, process r waits for the partial result of processes
+ * 0..r-1 in the slot of process r-1, combines it with its own
+ * fragment and publishes the partial result of processes 0..r in its
+ * own slot for process r+1.  Since each process keeps working on the
+ * next segment while its successor handles the previous one, the
+ * chain costs (size + number of fragments) steps rather than their
+ * product.  The operands are always combined in rank order, so
+ * non-commutative operations are fine.
+ *
+ * The datatype must be contiguous and fit in a fragment; fragments
+ * hold whole elements so that the reductions run straight from the
+ * shared segments.  Process 0 owns the set of segments.
+ */
+int mca_coll_sm_scan_engine(const void *sbuf, void *rbuf, int count,
+                            struct ompi_datatype_t *dtype,
+                            struct ompi_op_t *op, bool exclusive,
+                            struct ompi_communicator_t *comm,
+                            mca_coll_base_module_t *module)
+{
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data;
+    int ret, rank, size;
+    int segment_num, max_segment_num;
+    size_t ddt_size, segment_ddt_count, count_left, n, max_data;
+    ptrdiff_t extent, true_lb, true_extent, offset = 0;
+    char *my_slot, *prev_slot;
+    mca_coll_sm_in_use_flag_t *flag;
+    mca_coll_sm_data_index_t *index;
+
+    /* Lazily enable the module the first time we invoke a collective
+       on it */
+    if (!sm_module->enabled) {
+        if (OMPI_SUCCESS != (ret = ompi_coll_sm_lazy_enable(module, comm))) {
+            return ret;
+        }
+    }
+    data = sm_module->sm_comm_data;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+    if (MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    ompi_datatype_type_size(dtype, &ddt_size);
+    ompi_datatype_type_extent(dtype, &extent);
+    ompi_datatype_get_true_extent(dtype, &true_lb, &true_extent);
+    segment_ddt_count = mca_coll_sm_component.sm_fragment_size / ddt_size;
+    count_left = (size_t) count;
+
+    do {
+        segment_num = mca_coll_sm_segments_acquire(data, 0 == rank, size, &flag);
+        max_segment_num = segment_num + mca_coll_sm_component.sm_segs_per_inuse_flag;
+        do {
+            index = &(data->mcb_data_index[segment_num]);
+            n = (count_left < segment_ddt_count) ? count_left : segment_ddt_count;
+            max_data = n * ddt_size;
+
+            /* The slots hold the packed elements; shift them by the
+               lower bound so that they can be used as user buffers */
+            my_slot = index->mcbmi_data +
+                rank * mca_coll_sm_component.sm_fragment_size - true_lb;
+            prev_slot = my_slot - mca_coll_sm_component.sm_fragment_size;
+
+            if (rank > 0) {
+                PARENT_WAIT_FOR_NOTIFY_SPECIFIC(rank - 1, rank, index, max_data,
+                                                scan_label);
+            }
+
+            if (!exclusive) {
+                /* rbuf = (x_0 op ... op x_{r-1}) op x_r */
+                if (sbuf != rbuf) {
+                    ompi_datatype_copy_content_same_ddt(dtype, n, (char*) rbuf + offset,
+                                                        (char*) sbuf + offset);
+                }
+                if (rank > 0) {
+                    ompi_op_reduce(op, prev_slot, (char*) rbuf + offset, n, dtype);
+                }
+                if (rank < size - 1) {
+                    memcpy(my_slot + true_lb, (char*) rbuf + offset + true_lb, max_data);
+                }
+            } else {
+                /* My slot gets (x_0 op ... op x_{r-1}) op x_r, rbuf
+                   gets x_0 op ... op x_{r-1}.  Read x_r before
+                   writing rbuf, they may be the same buffer. */
+                if (rank < size - 1) {
+                    memcpy(my_slot + true_lb, (char*) sbuf + offset + true_lb, max_data);
+                    if (rank > 0) {
+                        ompi_op_reduce(op, prev_slot, my_slot, n, dtype);
+                    }
+                }
+                if (rank > 0) {
+                    memcpy((char*) rbuf + offset + true_lb, prev_slot + true_lb, max_data);
+                }
+            }
+
+            if (rank < size - 1) {
+                /* Wait for the write to absolutely complete */
+                opal_atomic_wmb();
+
+                CHILD_NOTIFY_PARENT(rank, rank + 1, index, max_data);
+            }
+
+            count_left -= n;
+            offset += (ptrdiff_t) n * extent;
+            ++segment_num;
+        } while (count_left > 0 && segment_num < max_segment_num);
+
+        /* We're finished with this set of segments */
+        FLAG_RELEASE(flag);
+    } while (count_left > 0);
+
+    return OMPI_SUCCESS;
+}
+
+
 /*
  *	scan
  *
- *	Function:	- basic scan operation
+ *	Function:	- shared memory scan
  *	Accepts:	- same arguments as MPI_Scan()
  *	Returns:	- MPI_SUCCESS or error code
  */
@@ -37,5 +169,15 @@ int mca_coll_sm_scan_intra(const void *sbuf, void *rbuf, int count,
                            struct ompi_communicator_t *comm,
                            mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    size_t ddt_size;
+
+    ompi_datatype_type_size(dtype, &ddt_size);
+    if (!ompi_datatype_is_contiguous_memory_layout(dtype, count) ||
+        ddt_size > (size_t) mca_coll_sm_component.sm_fragment_size) {
+        return sm_module->previous_scan(sbuf, rbuf, count, dtype, op, comm,
+                                        sm_module->previous_scan_module);
+    }
+
+    return mca_coll_sm_scan_engine(sbuf, rbuf, count, dtype, op, false, comm, module);
 }
@@ -2,7 +2,7 @@
  * Copyright (c) 2004-2005 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2005 The University of Tennessee and The University
+ * Copyright (c) 2004-2020 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2005 High Performance Computing Center Stuttgart,
@@ -20,16 +20,27 @@
 
 #include "ompi_config.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/datatype/opal_convertor.h"
+#include "opal/sys/atomic.h"
 #include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
 #include "coll_sm.h"
 
 
 /*
- *      scatter
+ *	scatter_intra
+ *
+ *	Function:	- shared memory scatter
+ *	Accepts:	- same arguments as MPI_Scatter()
+ *	Returns:	- MPI_SUCCESS or error code
  *
- *      Function:       - shared memory reduce
- *      Accepts:        - same as MPI_Scatter()
- *      Returns:        - MPI_SUCCESS or error code
+ *	All the blocks have the same size, so no agreement is needed
+ *	before running the scatterv engine.
  */
 int mca_coll_sm_scatter_intra(const void *sbuf, int scount,
                               struct ompi_datatype_t *sdtype, void *rbuf,
@@ -37,5 +48,32 @@ int mca_coll_sm_scatter_intra(const void *sbuf, int scount,
                               int root, struct ompi_communicator_t *comm,
                               mca_coll_base_module_t *module)
 {
-    return OMPI_ERR_NOT_IMPLEMENTED;
+    int ret, i, rank = ompi_comm_rank(comm), size = ompi_comm_size(comm);
+    int *counts = NULL, *disps = NULL;
+    size_t dsize;
+
+    if (root == rank) {
+        ompi_datatype_type_size(sdtype, &dsize);
+        dsize *= (size_t) scount;
+
+        counts = (int*) malloc(2 * size * sizeof(int));
+        if (NULL == counts) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        disps = counts + size;
+        for (i = 0; i < size; ++i) {
+            counts[i] = scount;
+            disps[i] = i * scount;
+        }
+    } else {
+        ompi_datatype_type_size(rdtype, &dsize);
+        dsize *= (size_t) rcount;
+    }
+
+    ret = mca_coll_sm_scatterv_engine(sbuf, counts, disps, sdtype, rbuf, rcount,
+                                      rdtype, root, dsize, comm, module);
+    if (NULL != counts) {
+        free(counts);
+    }
+    return ret;
 }
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file
+ *
+ * Single-copy bcast and allreduce for the large messages.
+ *
+ * Copying the data in and out of the shared memory segments costs two
+ * copies per process and pollutes the caches with the segments.  Above
+ * the single_copy_threshold, the processes instead publish the
+ * addresses of their user buffers in their flag slots, and the others
+ * read these buffers directly with process_vm_readv() (Cross Memory
+ * Attach).  Whether all the processes of the communicator can read
+ * each other's memory is checked once, when the module is enabled.
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_PRCTL_H
+#include <sys/prctl.h>
+#endif
+
+#if OMPI_COLL_SM_HAVE_CMA
+#include <sys/uio.h>
+
+#if OPAL_CMA_NEED_SYSCALL_DEFS
+#include "opal/sys/cma.h"
+#endif /* OPAL_CMA_NEED_SYSCALL_DEFS */
+#endif
+
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/op/op.h"
+#include "coll_sm.h"
+
+/* The allreduces reduce their slice by pieces of this size, so that
+   the data read from the other processes stays in the cache */
+#define SM_SINGLE_COPY_PIECE (128 * 1024)
+
+#if OMPI_COLL_SM_HAVE_CMA
+/*
+ * Reads len bytes at address remote of process pid into local
+ */
+static int sm_cma_read(pid_t pid, void *local, uint64_t remote, size_t len)
+{
+    struct iovec src_iov = {.iov_base = (void *)(intptr_t) remote, .iov_len = len};
+    struct iovec dst_iov = {.iov_base = local, .iov_len = len};
+    ssize_t ret;
+
+    /* process_vm_readv() may read less than asked for (see
+       btl_vader_get.c) */
+    while (0 < src_iov.iov_len) {
+        ret = process_vm_readv(pid, &dst_iov, 1, &src_iov, 1, 0);
+        if (0 >= ret) {
+            return OMPI_ERROR;
+        }
+        src_iov.iov_base = (void *)((char *) src_iov.iov_base + ret);
+        src_iov.iov_len -= ret;
+        dst_iov.iov_base = (void *)((char *) dst_iov.iov_base + ret);
+        dst_iov.iov_len -= ret;
+    }
+
+    return OMPI_SUCCESS;
+}
+#endif
+
+/*
+ * Checks whether the processes can read each other's memory: each one
+ * publishes its pid and the address of a known value, and reads it
+ * from the next process.  Called once all the processes attached to
+ * the shmem data segment.
+ */
+int mca_coll_sm_single_copy_init(struct ompi_communicator_t *comm,
+                                 mca_coll_base_module_t *module)
+{
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data = sm_module->sm_comm_data;
+    int ret = OMPI_SUCCESS;
+
+    data->mcb_single_copy = false;
+    if (0 == mca_coll_sm_component.sm_single_copy_threshold) {
+        return OMPI_SUCCESS;
+    }
+
+#if OMPI_COLL_SM_HAVE_CMA
+    {
+        int rank = ompi_comm_rank(comm);
+        int size = ompi_comm_size(comm);
+        mca_coll_sm_flag_slot_t *mine = mca_coll_sm_flag_slot(data, rank);
+        mca_coll_sm_flag_slot_t *peer = mca_coll_sm_flag_slot(data, (rank + 1) % size);
+        uint32_t check = 0;
+        int ok;
+
+        mine->mcsfs_pid = getpid();
+        mine->mcsfs_addr[0] = (uint64_t)(uintptr_t) &mca_coll_sm_one;
+#if defined PR_SET_PTRACER
+        /* let the other processes read our memory if the ptrace scope
+           is restricted (see btl_vader_component.c) */
+        (void) prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+#endif
+
+        ret = mca_coll_sm_barrier_intra(comm, module);
+        if (OMPI_SUCCESS != ret) {
+            return ret;
+        }
+        ok = OMPI_SUCCESS == sm_cma_read(peer->mcsfs_pid, &check, peer->mcsfs_addr[0],
+                                         sizeof(check)) && 1 == check;
+
+        ret = mca_coll_sm_flag_allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN,
+                                         comm, module);
+        data->mcb_single_copy = OMPI_SUCCESS == ret && ok;
+    }
+    opal_output_verbose(10, ompi_coll_base_framework.framework_output,
+                        "coll:sm:enable (%d/%s): single-copy %s",
+                        comm->c_contextid, comm->c_name,
+                        data->mcb_single_copy ? "enabled" : "not available");
+#endif
+
+    return ret;
+}
+
+/**
+ * Single-copy broadcast.
+ *
+ * The non-roots read the buffer of the root, which waits for them all
+ * before returning.  All the processes must have contiguous data;
+ * otherwise, OMPI_ERR_NOT_SUPPORTED is returned everywhere and the
+ * caller falls back to copying through the segments.
+ */
+int mca_coll_sm_bcast_single_copy(void *buff, int count,
+                                  struct ompi_datatype_t *datatype, int root,
+                                  struct ompi_communicator_t *comm,
+                                  mca_coll_base_module_t *module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data = sm_module->sm_comm_data;
+    mca_coll_sm_flag_slot_t *peer;
+    ptrdiff_t lb, extent;
+    size_t bytes;
+    int ret, can, ok = 1;
+
+    ompi_datatype_type_size(datatype, &bytes);
+    bytes *= count;
+    ompi_datatype_get_true_extent(datatype, &lb, &extent);
+
+    /* Publish the buffer and agree on the contiguity of the data */
+    mca_coll_sm_flag_slot(data, ompi_comm_rank(comm))->mcsfs_addr[0] =
+        (uint64_t)(uintptr_t)((char *) buff + lb);
+    can = ompi_datatype_is_contiguous_memory_layout(datatype, count);
+    ret = mca_coll_sm_flag_allreduce(MPI_IN_PLACE, &can, 1, MPI_INT, MPI_MIN,
+                                     comm, module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    if (!can) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    if (ompi_comm_rank(comm) != root) {
+        peer = mca_coll_sm_flag_slot(data, root);
+        ok = OMPI_SUCCESS == sm_cma_read(peer->mcsfs_pid, (char *) buff + lb,
+                                         peer->mcsfs_addr[0], bytes);
+    }
+
+    /* The root buffer must not change until everybody read it */
+    ret = mca_coll_sm_flag_allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN,
+                                     comm, module);
+    return (OMPI_SUCCESS == ret && !ok) ? OMPI_ERROR : ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * Single-copy allreduce of a predefined datatype.
+ *
+ * The data is cut into one slice per process.  Each process reduces
+ * its slice, reading it from the buffers of the others (in rank
+ * order, for the non commutative operations), into its receive
+ * buffer; then it reads the reduced slices of the others from their
+ * receive buffers.
+ */
+int mca_coll_sm_allreduce_single_copy(const void *sbuf, void *rbuf, int count,
+                                      struct ompi_datatype_t *dtype,
+                                      struct ompi_op_t *op,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+#if OMPI_COLL_SM_HAVE_CMA
+    mca_coll_sm_module_t *sm_module = (mca_coll_sm_module_t*) module;
+    mca_coll_sm_comm_t *data = sm_module->sm_comm_data;
+    int rank = ompi_comm_rank(comm);
+    int size = ompi_comm_size(comm);
+    int base = count / size, rem = count % size;
+    int first, n, piece, cnt, r, ret, ok;
+    const char *src = (MPI_IN_PLACE == sbuf) ? (const char *) rbuf : (const char *) sbuf;
+    mca_coll_sm_flag_slot_t *mine = mca_coll_sm_flag_slot(data, rank), *peer;
+    char *acc, *tmp = NULL;
+    size_t dsize, len;
+    ptrdiff_t off;
+
+    ompi_datatype_type_size(dtype, &dsize);
+    piece = SM_SINGLE_COPY_PIECE / dsize;
+    if (0 == piece) {
+        piece = 1;
+    }
+    /* keep going on errors, the others wait for us */
+    acc = (char *) malloc(2 * piece * dsize);
+    ok = NULL != acc;
+    if (ok) {
+        tmp = acc + piece * dsize;
+    }
+
+    mine->mcsfs_addr[0] = (uint64_t)(uintptr_t) src;
+    mine->mcsfs_addr[1] = (uint64_t)(uintptr_t) rbuf;
+    ret = mca_coll_sm_barrier_intra(comm, module);
+    if (OMPI_SUCCESS != ret) {
+        free(acc);
+        return ret;
+    }
+
+    /* Reduce my slice */
+    first = rank * base + (rank < rem ? rank : rem);
+    n = base + (rank < rem);
+    for (int done = 0; ok && done < n; done += cnt) {
+        cnt = (n - done < piece) ? n - done : piece;
+        off = (ptrdiff_t)(first + done) * dsize;
+        len = cnt * dsize;
+        for (r = size - 1; ok && r >= 0; --r) {
+            const char *p = tmp;
+
+            if (r == rank) {
+                p = src + off;
+            } else {
+                peer = mca_coll_sm_flag_slot(data, r);
+                ok = OMPI_SUCCESS == sm_cma_read(peer->mcsfs_pid, tmp,
+                                                 peer->mcsfs_addr[0] + off, len);
+            }
+            if (r == size - 1) {
+                memcpy(acc, p, len);
+            } else if (ok) {
+                ompi_op_reduce(op, (void *) p, acc, cnt, dtype);
+            }
+        }
+        if (ok) {
+            memcpy((char *) rbuf + off, acc, len);
+        }
+    }
+    free(acc);
+
+    /* Read the slices of the others once they are reduced */
+    ret = mca_coll_sm_barrier_intra(comm, module);
+    if (OMPI_SUCCESS != ret) {
+        return ret;
+    }
+    for (r = 0; ok && r < size; ++r) {
+        if (r == rank) {
+            continue;
+        }
+        peer = mca_coll_sm_flag_slot(data, r);
+        off = (ptrdiff_t)(r * base + (r < rem ? r : rem)) * dsize;
+        len = (base + (r < rem)) * dsize;
+        ok = OMPI_SUCCESS == sm_cma_read(peer->mcsfs_pid, (char *) rbuf + off,
+                                         peer->mcsfs_addr[1] + off, len);
+    }
+
+    /* The buffers must not change until everybody read them */
+    ret = mca_coll_sm_flag_allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN,
+                                     comm, module);
+    return (OMPI_SUCCESS == ret && !ok) ? OMPI_ERROR : ret;
+#else
+    return OMPI_ERR_NOT_SUPPORTED;
+#endif
+}
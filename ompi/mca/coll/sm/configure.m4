@@ -0,0 +1,35 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2026      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# MCA_coll_sm_CONFIG([action-if-can-compile],
+#                    [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_coll_sm_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/coll/sm/Makefile])
+
+    OPAL_VAR_SCOPE_PUSH([coll_sm_cma_happy])
+
+    # The single-copy API used by the large collectives is the one of
+    # btl/vader: reuse the result of its check (the OPAL components are
+    # configured first) rather than checking and reporting it again
+    AS_IF([test "$opal_check_cma_happy" = "1"],
+          [coll_sm_cma_happy=1],
+          [coll_sm_cma_happy=0])
+
+    AC_DEFINE_UNQUOTED([OMPI_COLL_SM_HAVE_CMA], [$coll_sm_cma_happy],
+        [If CMA support can be enabled within coll sm])
+
+    OPAL_VAR_SCOPE_POP
+
+    # always happy
+    [$1]
+])dnl
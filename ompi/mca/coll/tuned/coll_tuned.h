@@ -22,6 +22,7 @@
 #include "ompi/request/request.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
 #include "opal/util/output.h"
+#include "opal/mca/timer/base/base.h"
 
 /* also need the dynamic rule structures */
 #include "coll_tuned_dynamic_rules.h"
@@ -41,6 +42,9 @@ extern int   ompi_coll_tuned_alltoall_intermediate_msg;
 extern int   ompi_coll_tuned_alltoall_large_msg;
 extern int   ompi_coll_tuned_alltoall_min_procs;
 extern int   ompi_coll_tuned_alltoall_max_requests;
+extern bool  ompi_coll_tuned_learning;
+extern int   ompi_coll_tuned_learning_trials;
+extern bool  ompi_coll_tuned_persistent;
 
 /* forced algorithm choices */
 /* this structure is for storing the indexes to the forced algorithm mca params... */
@@ -141,6 +145,12 @@ int ompi_coll_tuned_gather_intra_dec_dynamic(GATHER_ARGS);
 int ompi_coll_tuned_gather_intra_do_this(GATHER_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_gather_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
+/* GatherV */
+int ompi_coll_tuned_gatherv_intra_dec_fixed(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_intra_dec_dynamic(GATHERV_ARGS);
+int ompi_coll_tuned_gatherv_intra_do_this(GATHERV_ARGS, int algorithm);
+int ompi_coll_tuned_gatherv_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+
 /* Reduce */
 int ompi_coll_tuned_reduce_intra_dec_fixed(REDUCE_ARGS);
 int ompi_coll_tuned_reduce_intra_dec_dynamic(REDUCE_ARGS);
@@ -165,16 +175,22 @@ int ompi_coll_tuned_scatter_intra_dec_dynamic(SCATTER_ARGS);
 int ompi_coll_tuned_scatter_intra_do_this(SCATTER_ARGS, int algorithm, int faninout, int segsize);
 int ompi_coll_tuned_scatter_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
+/* ScatterV */
+int ompi_coll_tuned_scatterv_intra_dec_fixed(SCATTERV_ARGS);
+int ompi_coll_tuned_scatterv_intra_dec_dynamic(SCATTERV_ARGS);
+int ompi_coll_tuned_scatterv_intra_do_this(SCATTERV_ARGS, int algorithm);
+int ompi_coll_tuned_scatterv_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
+
 /* Exscan */
 int ompi_coll_tuned_exscan_intra_dec_fixed(EXSCAN_ARGS);
 int ompi_coll_tuned_exscan_intra_dec_dynamic(EXSCAN_ARGS);
-int ompi_coll_tuned_exscan_intra_do_this(EXSCAN_ARGS, int algorithm);
+int ompi_coll_tuned_exscan_intra_do_this(EXSCAN_ARGS, int algorithm, int segsize);
 int ompi_coll_tuned_exscan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 /* Scan */
 int ompi_coll_tuned_scan_intra_dec_fixed(SCAN_ARGS);
 int ompi_coll_tuned_scan_intra_dec_dynamic(SCAN_ARGS);
-int ompi_coll_tuned_scan_intra_do_this(SCAN_ARGS, int algorithm);
+int ompi_coll_tuned_scan_intra_do_this(SCAN_ARGS, int algorithm, int segsize);
 int ompi_coll_tuned_scan_intra_check_forced_init (coll_tuned_force_algorithm_mca_param_indices_t *mca_param_indices);
 
 int mca_coll_tuned_ft_event(int state);
@@ -203,6 +219,27 @@ typedef struct mca_coll_tuned_component_t mca_coll_tuned_component_t;
  */
 OMPI_MODULE_DECLSPEC extern mca_coll_tuned_component_t mca_coll_tuned_component;
 
+/* online learning of the algorithms */
+/* one bucket per power of 2 of the message size, and one for empty messages */
+#define COLL_TUNED_LEARN_BUCKETS 65
+
+/* a candidate configuration, as passed to the do_this functions */
+struct ompi_coll_tuned_learn_choice_t {
+    int  algorithm;
+    int  faninout;
+    int  segsize;
+    int  max_requests;
+};
+typedef struct ompi_coll_tuned_learn_choice_t ompi_coll_tuned_learn_choice_t;
+
+/* learning state of a (collective, communicator, message size bucket) */
+struct ompi_coll_tuned_learn_bucket_t {
+    int     ncalls;      /* calls done in the bucket while learning */
+    int     choice;      /* 1 + index of the selected candidate, 0 while learning */
+    double *times;       /* accumulated time of each candidate */
+};
+typedef struct ompi_coll_tuned_learn_bucket_t ompi_coll_tuned_learn_bucket_t;
+
 struct mca_coll_tuned_module_t {
     mca_coll_base_module_t super;
 
@@ -212,8 +249,33 @@ struct mca_coll_tuned_module_t {
 
     /* the communicator rules for each MPI collective for ONLY my comsize */
     ompi_coll_com_rule_t *com_rules[COLLCOUNT];
+
+    /* the learned algorithms for each MPI collective (NULL if not learning) */
+    ompi_coll_tuned_learn_bucket_t *learned[COLLCOUNT];
+
+    /* the tag of the next persistent collective */
+    int persistent_tag;
 };
 typedef struct mca_coll_tuned_module_t mca_coll_tuned_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_tuned_module_t);
 
+/* online learning, see coll_tuned_learning.c */
+int ompi_coll_tuned_learning_register(void);
+int ompi_coll_tuned_learning_init(mca_coll_tuned_module_t *module, int coll_id);
+void ompi_coll_tuned_learning_fini(mca_coll_tuned_module_t *module);
+const ompi_coll_tuned_learn_choice_t *
+ompi_coll_tuned_learning_begin(mca_coll_tuned_module_t *module, int coll_id, size_t msg_size,
+                               ompi_coll_tuned_learn_bucket_t **bucket, opal_timer_t *start);
+int ompi_coll_tuned_learning_end(mca_coll_tuned_module_t *module, int coll_id,
+                                 ompi_coll_tuned_learn_bucket_t *bucket, opal_timer_t start,
+                                 struct ompi_communicator_t *comm, int rc);
+
+/* persistent collectives, see coll_tuned_persistent.c */
+int ompi_coll_tuned_persistent_open(void);
+void ompi_coll_tuned_persistent_close(void);
+int ompi_coll_tuned_bcast_intra_init(BCAST_INIT_ARGS);
+int ompi_coll_tuned_allreduce_intra_init(ALLREDUCE_INIT_ARGS);
+int ompi_coll_tuned_allgather_intra_init(ALLGATHER_INIT_ARGS);
+int ompi_coll_tuned_alltoall_intra_init(ALLTOALL_INIT_ARGS);
+
 #endif  /* MCA_COLL_TUNED_EXPORT_H */
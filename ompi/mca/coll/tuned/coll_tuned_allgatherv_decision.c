@@ -38,6 +38,9 @@ static mca_base_var_enum_value_t allgatherv_algorithms[] = {
     {3, "ring"},
     {4, "neighbor"},
     {5, "two_proc"},
+    {6, "ring_segmented"},
+    {7, "sparbit"},
+    {8, "k_nomial"},
     {0, NULL}
 };
 
@@ -76,10 +79,10 @@ ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorithm_mc
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgatherv_algorithm",
-                                        "Which allallgatherv algorithm is used. Can be locked down to choice of: 0 ignore, 1 default (allgathervv + bcast), 2 bruck, 3 ring, 4 neighbor exchange, 5: two proc only.",
+                                        "Which allallgatherv algorithm is used. Can be locked down to choice of: 0 ignore, 1 default (allgathervv + bcast), 2 bruck, 3 ring, 4 neighbor exchange, 5: two proc only, 6 segmented ring, 7 sparbit, 8 k-nomial.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
-                                        MCA_BASE_VAR_SCOPE_CONSTANT,
+                                        MCA_BASE_VAR_SCOPE_ALL,
                                         &coll_tuned_allgatherv_forced_algorithm);
     OBJ_RELEASE(new_enum);
     if (mca_param_indices->algorithm_param_index < 0) {
@@ -90,20 +93,20 @@ ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorithm_mc
     mca_param_indices->segsize_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgatherv_algorithm_segmentsize",
-                                        "Segment size in bytes used by default for allgatherv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation. Currently, available algorithms do not support segmentation.",
+                                        "Segment size in bytes used by default for allgatherv algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation.",
                                         MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
-                                        MCA_BASE_VAR_SCOPE_CONSTANT,
+                                        MCA_BASE_VAR_SCOPE_ALL,
                                         &coll_tuned_allgatherv_segment_size);
 
     coll_tuned_allgatherv_tree_fanout = ompi_coll_tuned_init_tree_fanout; /* get system wide default */
     mca_param_indices->tree_fanout_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgatherv_algorithm_tree_fanout",
-                                        "Fanout for n-tree used for allgatherv algorithms. Only has meaning if algorithm is forced and supports n-tree topo based operation. Currently, available algorithms do not support n-tree topologies.",
+                                        "Fanout for n-tree used for allgatherv algorithms, the radix of the k-nomial algorithm (radix > 1). Only has meaning if algorithm is forced and supports n-tree topo based operation.",
                                         MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
-                                        MCA_BASE_VAR_SCOPE_CONSTANT,
+                                        MCA_BASE_VAR_SCOPE_ALL,
                                         &coll_tuned_allgatherv_tree_fanout);
 
     coll_tuned_allgatherv_chain_fanout = ompi_coll_tuned_init_chain_fanout; /* get system wide default */
@@ -113,7 +116,7 @@ ompi_coll_tuned_allgatherv_intra_check_forced_init(coll_tuned_force_algorithm_mc
                                       "Fanout for chains used for allgatherv algorithms. Only has meaning if algorithm is forced and supports chain topo based operation. Currently, available algorithms do not support chain topologies.",
                                       MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                       OPAL_INFO_LVL_5,
-                                      MCA_BASE_VAR_SCOPE_CONSTANT,
+                                      MCA_BASE_VAR_SCOPE_ALL,
                                       &coll_tuned_allgatherv_chain_fanout);
 
     return (MPI_SUCCESS);
@@ -158,6 +161,20 @@ int ompi_coll_tuned_allgatherv_intra_do_this(const void *sbuf, int scount,
         return ompi_coll_base_allgatherv_intra_two_procs(sbuf, scount, sdtype,
                                                          rbuf, rcounts, rdispls, rdtype,
                                                          comm, module);
+    case (6):
+        return ompi_coll_base_allgatherv_intra_ring_segmented(sbuf, scount, sdtype,
+                                                              rbuf, rcounts, rdispls, rdtype,
+                                                              comm, module, segsize);
+    case (7):
+        return ompi_coll_base_allgatherv_intra_sparbit(sbuf, scount, sdtype,
+                                                       rbuf, rcounts, rdispls, rdtype,
+                                                       comm, module);
+    case (8):
+        /* the radix is the fanout of the rule, or the forced tree fanout */
+        return ompi_coll_base_allgatherv_intra_k_nomial(sbuf, scount, sdtype,
+                                                        rbuf, rcounts, rdispls, rdtype,
+                                                        comm, module,
+                                                        (faninout > 1) ? faninout : ompi_coll_tuned_init_tree_fanout);
     } /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:allgatherv_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
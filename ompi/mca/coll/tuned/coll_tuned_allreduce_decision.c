@@ -32,6 +32,7 @@ static int coll_tuned_allreduce_forced_algorithm = 0;
 static int coll_tuned_allreduce_segment_size = 0;
 static int coll_tuned_allreduce_tree_fanout;
 static int coll_tuned_allreduce_chain_fanout;
+static int coll_tuned_allreduce_knomial_radix = 4;
 
 /* valid values for coll_tuned_allreduce_forced_algorithm */
 static mca_base_var_enum_value_t allreduce_algorithms[] = {
@@ -42,6 +43,7 @@ static mca_base_var_enum_value_t allreduce_algorithms[] = {
     {4, "ring"},
     {5, "segmented_ring"},
     {6, "rabenseifner"},
+    {7, "rabenseifner_knomial"},
     {0, NULL}
 };
 
@@ -77,7 +79,7 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allreduce_algorithm",
-                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring",
+                                        "Which allreduce algorithm is used. Can be locked down to any of: 0 ignore, 1 basic linear, 2 nonoverlapping (tuned reduce + tuned bcast), 3 recursive doubling, 4 ring, 5 segmented ring, 6 rabenseifner, 7 rabenseifner k-nomial",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_ALL,
@@ -117,6 +119,14 @@ int ompi_coll_tuned_allreduce_intra_check_forced_init (coll_tuned_force_algorith
                                       MCA_BASE_VAR_SCOPE_ALL,
                                       &coll_tuned_allreduce_chain_fanout);
 
+    coll_tuned_allreduce_knomial_radix = 4;
+    mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                    "allreduce_algorithm_knomial_radix",
+                                    "Radix of the reduce-scatter and allgather steps of the k-nomial rabenseifner allreduce algorithm (radix > 1).",
+                                    MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                    OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
+                                    &coll_tuned_allreduce_knomial_radix);
+
     return (MPI_SUCCESS);
 }
 
@@ -145,6 +155,9 @@ int ompi_coll_tuned_allreduce_intra_do_this(const void *sbuf, void *rbuf, int co
         return ompi_coll_base_allreduce_intra_ring_segmented(sbuf, rbuf, count, dtype, op, comm, module, segsize);
     case (6):
         return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op, comm, module);
+    case (7):
+        return ompi_coll_base_allreduce_intra_redscat_allgather_knomial(sbuf, rbuf, count, dtype, op, comm, module,
+                                                                        coll_tuned_allreduce_knomial_radix);
     } /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:allreduce_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                  algorithm, ompi_coll_tuned_forced_max_algorithms[ALLREDUCE]));
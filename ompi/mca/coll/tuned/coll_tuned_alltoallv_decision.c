@@ -27,12 +27,16 @@
 
 /* alltoallv algorithm variables */
 static int coll_tuned_alltoallv_forced_algorithm = 0;
+static int coll_tuned_alltoallv_max_requests = 0;
 
 /* valid values for coll_tuned_alltoallv_forced_algorithm */
 static mca_base_var_enum_value_t alltoallv_algorithms[] = {
     {0, "ignore"},
     {1, "basic_linear"},
     {2, "pairwise"},
+    {3, "sparse"},
+    {4, "linear_sync"},
+    {5, "bruck"},
     {0, NULL}
 };
 
@@ -71,7 +75,9 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
                                         "alltoallv_algorithm",
                                         "Which alltoallv algorithm is used. "
                                         "Can be locked down to choice of: 0 ignore, "
-                                        "1 basic linear, 2 pairwise.",
+                                        "1 basic linear, 2 pairwise, 3 sparse (linear skipping "
+                                        "the zero counts), 4 linear with limited number of "
+                                        "outstanding requests, 5 bruck (for tiny blocks).",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_ALL,
@@ -82,6 +88,19 @@ int ompi_coll_tuned_alltoallv_intra_check_forced_init(coll_tuned_force_algorithm
         return mca_param_indices->algorithm_param_index;
     }
 
+    coll_tuned_alltoallv_max_requests = 0;
+    mca_param_indices->max_requests_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "alltoallv_algorithm_max_requests",
+                                        "Maximum number of outstanding send or recv requests.  Only has meaning for the linear_sync algorithm, 0 means no limit.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_ALL,
+                                        &coll_tuned_alltoallv_max_requests);
+    if (mca_param_indices->max_requests_param_index < 0) {
+        return mca_param_indices->max_requests_param_index;
+    }
+
     return (MPI_SUCCESS);
 }
 
@@ -112,6 +131,19 @@ int ompi_coll_tuned_alltoallv_intra_do_this(const void *sbuf, const int *scounts
         return ompi_coll_base_alltoallv_intra_pairwise(sbuf, scounts, sdisps, sdtype,
                                                        rbuf, rcounts, rdisps, rdtype,
                                                        comm, module);
+    case (3):
+        return ompi_coll_base_alltoallv_intra_sparse(sbuf, scounts, sdisps, sdtype,
+                                                     rbuf, rcounts, rdisps, rdtype,
+                                                     comm, module);
+    case (4):
+        return ompi_coll_base_alltoallv_intra_linear_sync(sbuf, scounts, sdisps, sdtype,
+                                                          rbuf, rcounts, rdisps, rdtype,
+                                                          comm, module,
+                                                          coll_tuned_alltoallv_max_requests);
+    case (5):
+        return ompi_coll_base_alltoallv_intra_bruck(sbuf, scounts, sdisps, sdtype,
+                                                    rbuf, rcounts, rdisps, rdtype,
+                                                    comm, module);
     }  /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,
                  "coll:tuned:alltoall_intra_do_this attempt to select "
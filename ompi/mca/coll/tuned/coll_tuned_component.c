@@ -37,6 +37,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "coll_tuned.h"
 #include "coll_tuned_dynamic_file.h"
+#include "ompi/mca/coll/base/coll_tags.h"
 
 /*
  * Public string showing the coll ompi_tuned component version number
@@ -64,6 +65,13 @@ int   ompi_coll_tuned_alltoall_large_msg = 3000;
 int   ompi_coll_tuned_alltoall_min_procs = 0; /* disable by default */
 int   ompi_coll_tuned_alltoall_max_requests  = 0; /* no limit for alltoall by default */
 
+/* online learning of the algorithms, disabled by default */
+bool  ompi_coll_tuned_learning = false;
+int   ompi_coll_tuned_learning_trials = 4;
+
+/* algorithmic persistent collectives, set up at initialization */
+bool  ompi_coll_tuned_persistent = true;
+
 /* forced alogrithm variables */
 /* indices for the MCA parameters */
 coll_tuned_force_algorithm_mca_param_indices_t ompi_coll_tuned_forced_params[COLLCOUNT] = {{0}};
@@ -184,6 +192,37 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &ompi_coll_tuned_dynamic_rules_filename);
 
+    ompi_coll_tuned_learning = false;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "learning",
+                                           "Learn on each communicator the fastest algorithm for each collective and message size (by powers of 2), by trying the candidate algorithms on the first calls. File based rules and forced algorithms take precedence",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_learning);
+
+    ompi_coll_tuned_learning_trials = 4;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "learning_trials",
+                                           "Number of timed calls of each candidate algorithm before selecting one, when learning (after one untimed call)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_learning_trials);
+    if (ompi_coll_tuned_learning_trials < 1) {
+        ompi_coll_tuned_learning_trials = 1;
+    }
+    ompi_coll_tuned_learning_register();
+
+    ompi_coll_tuned_persistent = true;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "persistent",
+                                           "Provide the persistent bcast, allreduce, allgather and alltoall, whose algorithm, temporary buffers and point-to-point requests are set up at initialization",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_tuned_persistent);
+
     /* register forced params */
     ompi_coll_tuned_allreduce_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLREDUCE]);
     ompi_coll_tuned_alltoall_intra_check_forced_init(&ompi_coll_tuned_forced_params[ALLTOALL]);
@@ -196,7 +235,9 @@ static int tuned_register(void)
     ompi_coll_tuned_reduce_scatter_intra_check_forced_init(&ompi_coll_tuned_forced_params[REDUCESCATTER]);
     ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init(&ompi_coll_tuned_forced_params[REDUCESCATTERBLOCK]);
     ompi_coll_tuned_gather_intra_check_forced_init(&ompi_coll_tuned_forced_params[GATHER]);
+    ompi_coll_tuned_gatherv_intra_check_forced_init(&ompi_coll_tuned_forced_params[GATHERV]);
     ompi_coll_tuned_scatter_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCATTER]);
+    ompi_coll_tuned_scatterv_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCATTERV]);
     ompi_coll_tuned_exscan_intra_check_forced_init(&ompi_coll_tuned_forced_params[EXSCAN]);
     ompi_coll_tuned_scan_intra_check_forced_init(&ompi_coll_tuned_forced_params[SCAN]);
 
@@ -246,6 +287,8 @@ static int tuned_open(void)
         }
     }
 
+    ompi_coll_tuned_persistent_open();
+
     OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:component_open: done!"));
 
     return OMPI_SUCCESS;
@@ -267,6 +310,8 @@ static int tuned_close(void)
         mca_coll_tuned_component.all_base_rules = NULL;
     }
 
+    ompi_coll_tuned_persistent_close();
+
     return OMPI_SUCCESS;
 }
 
@@ -278,8 +323,16 @@ mca_coll_tuned_module_construct(mca_coll_tuned_module_t *module)
     for( int i = 0; i < COLLCOUNT; i++ ) {
         tuned_module->user_forced[i].algorithm = 0;
         tuned_module->com_rules[i] = NULL;
+        tuned_module->learned[i] = NULL;
     }
+    tuned_module->persistent_tag = MCA_COLL_BASE_TAG_PERSISTENT_BASE;
+}
+
+static void
+mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
+{
+    ompi_coll_tuned_learning_fini(module);
 }
 
 OBJ_CLASS_INSTANCE(mca_coll_tuned_module_t, mca_coll_base_module_t,
-                   mca_coll_tuned_module_construct, NULL);
+                   mca_coll_tuned_module_construct, mca_coll_tuned_module_destruct);
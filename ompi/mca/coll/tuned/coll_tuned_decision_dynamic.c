@@ -25,6 +25,7 @@
 #include "ompi/constants.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/communicator/communicator.h"
+#include "ompi/op/op.h"
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_tags.h"
@@ -38,10 +39,105 @@
  * Else
  *      use forced rules (-coll_tuned_dynamic_ALG_intra_algorithm = algorithm-number)
  * Else
+ *      use learned rules (-coll_tuned_learning = 1)
+ * Else
  *      use fixed (compiled) rule set (or nested ifs)
  *
  */
 
+/*
+ * Online learning of the algorithms (see coll_tuned_learning.c): the
+ * arguments of the collective are passed through a tuned_learn_args_t to
+ * the function running it with the algorithm chosen for the call.
+ */
+typedef struct {
+    const void *sbuf;
+    void *rbuf;
+    int scount, rcount, root;
+    struct ompi_datatype_t *sdtype, *rdtype;
+    struct ompi_op_t *op;
+} tuned_learn_args_t;
+
+typedef int (*tuned_learn_run_fn_t)(const tuned_learn_args_t *args,
+                                    const ompi_coll_tuned_learn_choice_t *choice,
+                                    struct ompi_communicator_t *comm,
+                                    mca_coll_base_module_t *module);
+
+/*
+ * Runs the collective coll_id with the algorithm learned for messages of
+ * msg_size bytes, and records its time.
+ */
+static int tuned_learn(int coll_id, size_t msg_size, tuned_learn_run_fn_t run,
+                       const tuned_learn_args_t *args, struct ompi_communicator_t *comm,
+                       mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+    const ompi_coll_tuned_learn_choice_t *choice;
+    ompi_coll_tuned_learn_bucket_t *bucket;
+    opal_timer_t start = 0;
+    int rc;
+
+    choice = ompi_coll_tuned_learning_begin(tuned_module, coll_id, msg_size, &bucket, &start);
+    rc = run(args, choice, comm, module);
+    return ompi_coll_tuned_learning_end(tuned_module, coll_id, bucket, start, comm, rc);
+}
+
+static int learn_allreduce(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                           struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_allreduce_intra_do_this(a->sbuf, a->rbuf, a->scount, a->sdtype, a->op,
+                                                   comm, module, c->algorithm, c->faninout,
+                                                   c->segsize);
+}
+
+static int learn_alltoall(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                          struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_alltoall_intra_do_this(a->sbuf, a->scount, a->sdtype, a->rbuf, a->rcount,
+                                                  a->rdtype, comm, module, c->algorithm,
+                                                  c->faninout, c->segsize, c->max_requests);
+}
+
+static int learn_barrier(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                         struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_barrier_intra_do_this(comm, module, c->algorithm, c->faninout,
+                                                 c->segsize);
+}
+
+static int learn_bcast(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                       struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_bcast_intra_do_this(a->rbuf, a->scount, a->sdtype, a->root, comm, module,
+                                               c->algorithm, c->faninout, c->segsize);
+}
+
+static int learn_reduce(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                        struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_reduce_intra_do_this(a->sbuf, a->rbuf, a->scount, a->sdtype, a->op,
+                                                a->root, comm, module, c->algorithm, c->faninout,
+                                                c->segsize, c->max_requests);
+}
+
+static int learn_reduce_scatter_block(const tuned_learn_args_t *a,
+                                      const ompi_coll_tuned_learn_choice_t *c,
+                                      struct ompi_communicator_t *comm,
+                                      mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_reduce_scatter_block_intra_do_this(a->sbuf, a->rbuf, a->rcount, a->sdtype,
+                                                              a->op, comm, module, c->algorithm,
+                                                              c->faninout, c->segsize);
+}
+
+static int learn_allgather(const tuned_learn_args_t *a, const ompi_coll_tuned_learn_choice_t *c,
+                           struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    return ompi_coll_tuned_allgather_intra_do_this(a->sbuf, a->scount, a->sdtype, a->rbuf, a->rcount,
+                                                   a->rdtype, comm, module, c->algorithm,
+                                                   c->faninout, c->segsize);
+}
+
 /*
  *  allreduce_intra
  *
@@ -86,6 +182,14 @@ ompi_coll_tuned_allreduce_intra_dec_dynamic (const void *sbuf, void *rbuf, int c
                                                        tuned_module->user_forced[ALLREDUCE].tree_fanout,
                                                        tuned_module->user_forced[ALLREDUCE].segsize);
     }
+    if (tuned_module->learned[ALLREDUCE] && ompi_op_is_commute(op)) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .sbuf = sbuf, .rbuf = rbuf, .scount = count, .sdtype = dtype, .op = op };
+        size_t dsize;
+
+        ompi_datatype_type_size(dtype, &dsize);
+        return tuned_learn(ALLREDUCE, dsize * (size_t)count, learn_allreduce, &args, comm, module);
+    }
     return ompi_coll_tuned_allreduce_intra_dec_fixed (sbuf, rbuf, count, dtype, op,
                                                       comm, module);
 }
@@ -141,6 +245,16 @@ int ompi_coll_tuned_alltoall_intra_dec_dynamic(const void *sbuf, int scount,
                                                       tuned_module->user_forced[ALLTOALL].segsize,
                                                       tuned_module->user_forced[ALLTOALL].max_requests);
     }
+    if (tuned_module->learned[ALLTOALL]) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .sbuf = sbuf, .scount = scount, .sdtype = sdtype,
+                                    .rbuf = rbuf, .rcount = rcount, .rdtype = rdtype };
+        size_t dsize;
+
+        ompi_datatype_type_size(rdtype, &dsize);
+        return tuned_learn(ALLTOALL, dsize * (size_t)rcount * (size_t)ompi_comm_size(comm),
+                           learn_alltoall, &args, comm, module);
+    }
     return ompi_coll_tuned_alltoall_intra_dec_fixed (sbuf, scount, sdtype,
                                                      rbuf, rcount, rdtype,
                                                      comm, module);
@@ -230,6 +344,10 @@ int ompi_coll_tuned_barrier_intra_dec_dynamic(struct ompi_communicator_t *comm,
                                                      tuned_module->user_forced[BARRIER].tree_fanout,
                                                      tuned_module->user_forced[BARRIER].segsize);
     }
+    if (tuned_module->learned[BARRIER]) {
+        /* learn the algorithm online */
+        return tuned_learn(BARRIER, 0, learn_barrier, NULL, comm, module);
+    }
     return ompi_coll_tuned_barrier_intra_dec_fixed (comm, module);
 }
 
@@ -277,6 +395,14 @@ int ompi_coll_tuned_bcast_intra_dec_dynamic(void *buf, int count,
                                                    tuned_module->user_forced[BCAST].chain_fanout,
                                                    tuned_module->user_forced[BCAST].segsize);
     }
+    if (tuned_module->learned[BCAST]) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .rbuf = buf, .scount = count, .sdtype = dtype, .root = root };
+        size_t dsize;
+
+        ompi_datatype_type_size(dtype, &dsize);
+        return tuned_learn(BCAST, dsize * (size_t)count, learn_bcast, &args, comm, module);
+    }
     return ompi_coll_tuned_bcast_intra_dec_fixed (buf, count, dtype, root,
                                                   comm, module);
 }
@@ -329,6 +455,15 @@ int ompi_coll_tuned_reduce_intra_dec_dynamic( const void *sbuf, void *rbuf,
                                                     tuned_module->user_forced[REDUCE].segsize,
                                                     tuned_module->user_forced[REDUCE].max_requests);
     }
+    if (tuned_module->learned[REDUCE] && ompi_op_is_commute(op)) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .sbuf = sbuf, .rbuf = rbuf, .scount = count, .sdtype = dtype, .op = op,
+                                    .root = root };
+        size_t dsize;
+
+        ompi_datatype_type_size(dtype, &dsize);
+        return tuned_learn(REDUCE, dsize * (size_t)count, learn_reduce, &args, comm, module);
+    }
     return ompi_coll_tuned_reduce_intra_dec_fixed (sbuf, rbuf, count, dtype,
                                                    op, root, comm, module);
 }
@@ -434,6 +569,15 @@ int ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic(const void *sbuf, voi
                                                                   tuned_module->user_forced[REDUCESCATTERBLOCK].chain_fanout,
                                                                   tuned_module->user_forced[REDUCESCATTERBLOCK].segsize);
     }
+    if (tuned_module->learned[REDUCESCATTERBLOCK] && ompi_op_is_commute(op)) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .sbuf = sbuf, .rbuf = rbuf, .rcount = rcount, .sdtype = dtype, .op = op };
+        size_t dsize;
+
+        ompi_datatype_type_size(dtype, &dsize);
+        return tuned_learn(REDUCESCATTERBLOCK, dsize * (size_t)rcount * (size_t)ompi_comm_size(comm),
+                           learn_reduce_scatter_block, &args, comm, module);
+    }
     return ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed (sbuf, rbuf, rcount,
                                                                  dtype, op, comm, module);
 }
@@ -494,6 +638,16 @@ int ompi_coll_tuned_allgather_intra_dec_dynamic(const void *sbuf, int scount,
     }
 
     /* Use default decision */
+    if (tuned_module->learned[ALLGATHER]) {
+        /* learn the algorithm online */
+        tuned_learn_args_t args = { .sbuf = sbuf, .scount = scount, .sdtype = sdtype,
+                                    .rbuf = rbuf, .rcount = rcount, .rdtype = rdtype };
+        size_t dsize;
+
+        ompi_datatype_type_size(rdtype, &dsize);
+        return tuned_learn(ALLGATHER, dsize * (size_t)rcount * (size_t)ompi_comm_size(comm),
+                           learn_allgather, &args, comm, module);
+    }
     return ompi_coll_tuned_allgather_intra_dec_fixed (sbuf, scount, sdtype,
                                                       rbuf, rcount, rdtype,
                                                       comm, module);
@@ -584,9 +738,16 @@ int ompi_coll_tuned_gather_intra_dec_dynamic(const void *sbuf, int scount,
         int comsize, alg, faninout, segsize, max_requests;
         size_t dsize;
 
+        /* total amount of data, computed from the arguments that are
+           significant on each process so that all agree */
         comsize = ompi_comm_size(comm);
-        ompi_datatype_type_size (sdtype, &dsize);
-        dsize *= comsize;
+        if (ompi_comm_rank(comm) == root) {
+            ompi_datatype_type_size (rdtype, &dsize);
+            dsize *= (ptrdiff_t)comsize * (ptrdiff_t)rcount;
+        } else {
+            ompi_datatype_type_size (sdtype, &dsize);
+            dsize *= (ptrdiff_t)comsize * (ptrdiff_t)scount;
+        }
 
         alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[GATHER],
                                                         dsize, &faninout, &segsize, &max_requests);
@@ -614,6 +775,45 @@ int ompi_coll_tuned_gather_intra_dec_dynamic(const void *sbuf, int scount,
                                                    root, comm, module);
 }
 
+int ompi_coll_tuned_gatherv_intra_dec_dynamic(const void *sbuf, int scount,
+                                              struct ompi_datatype_t *sdtype,
+                                              void* rbuf, const int *rcounts, const int *disps,
+                                              struct ompi_datatype_t *rdtype,
+                                              int root,
+                                              struct ompi_communicator_t *comm,
+                                              mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_dec_dynamic"));
+
+    /**
+     * check to see if we have some filebased rules. As the counts are
+     * only known by the root, the rules for the smallest message size
+     * of the communicator size are used.
+     */
+    if (tuned_module->com_rules[GATHERV]) {
+        int alg, faninout, segsize, max_requests;
+
+        alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[GATHERV],
+                                                        0, &faninout, &segsize, &max_requests);
+
+        if (alg) {
+            /* we have found a valid choice from the file based rules for this message size */
+            return ompi_coll_tuned_gatherv_intra_do_this (sbuf, scount, sdtype, rbuf, rcounts, disps, rdtype, root, comm, module,
+                                                         alg);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (tuned_module->user_forced[GATHERV].algorithm) {
+        return ompi_coll_tuned_gatherv_intra_do_this(sbuf, scount, sdtype, rbuf, rcounts, disps, rdtype, root, comm, module,
+                                                    tuned_module->user_forced[GATHERV].algorithm);
+    }
+
+    return ompi_coll_tuned_gatherv_intra_dec_fixed (sbuf, scount, sdtype, rbuf, rcounts, disps, rdtype, root, comm, module);
+}
+
 int ompi_coll_tuned_scatter_intra_dec_dynamic(const void *sbuf, int scount,
                                               struct ompi_datatype_t *sdtype,
                                               void* rbuf, int rcount,
@@ -633,9 +833,16 @@ int ompi_coll_tuned_scatter_intra_dec_dynamic(const void *sbuf, int scount,
         int comsize, alg, faninout, segsize, max_requests;
         size_t dsize;
 
+        /* total amount of data, computed from the arguments that are
+           significant on each process so that all agree */
         comsize = ompi_comm_size(comm);
-        ompi_datatype_type_size (sdtype, &dsize);
-        dsize *= comsize;
+        if (ompi_comm_rank(comm) == root) {
+            ompi_datatype_type_size (sdtype, &dsize);
+            dsize *= (ptrdiff_t)comsize * (ptrdiff_t)scount;
+        } else {
+            ompi_datatype_type_size (rdtype, &dsize);
+            dsize *= (ptrdiff_t)comsize * (ptrdiff_t)rcount;
+        }
 
         alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[SCATTER],
                                                         dsize, &faninout, &segsize, &max_requests);
@@ -678,12 +885,11 @@ int ompi_coll_tuned_exscan_intra_dec_dynamic(const void *sbuf, void* rbuf, int c
      * check to see if we have some filebased rules.
      */
     if (tuned_module->com_rules[EXSCAN]) {
-        int comsize, alg, faninout, segsize, max_requests;
+        int alg, faninout, segsize, max_requests;
         size_t dsize;
 
-        comsize = ompi_comm_size(comm);
         ompi_datatype_type_size (dtype, &dsize);
-        dsize *= comsize;
+        dsize *= count;
 
         alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[EXSCAN],
                                                         dsize, &faninout, &segsize, &max_requests);
@@ -692,18 +898,19 @@ int ompi_coll_tuned_exscan_intra_dec_dynamic(const void *sbuf, void* rbuf, int c
             /* we have found a valid choice from the file based rules for this message size */
             return ompi_coll_tuned_exscan_intra_do_this (sbuf, rbuf, count, dtype,
                                                          op, comm, module,
-                                                         alg);
+                                                         alg, segsize);
         } /* found a method */
     } /*end if any com rules to check */
 
     if (tuned_module->user_forced[EXSCAN].algorithm) {
         return ompi_coll_tuned_exscan_intra_do_this(sbuf, rbuf, count, dtype,
                                                     op, comm, module,
-                                                    tuned_module->user_forced[EXSCAN].algorithm);
+                                                    tuned_module->user_forced[EXSCAN].algorithm,
+                                                    tuned_module->user_forced[EXSCAN].segsize);
     }
 
-    return ompi_coll_base_exscan_intra_linear(sbuf, rbuf, count, dtype,
-                                              op, comm, module);
+    return ompi_coll_tuned_exscan_intra_dec_fixed(sbuf, rbuf, count, dtype,
+                                                  op, comm, module);
 }
 
 int ompi_coll_tuned_scan_intra_dec_dynamic(const void *sbuf, void* rbuf, int count,
@@ -721,12 +928,11 @@ int ompi_coll_tuned_scan_intra_dec_dynamic(const void *sbuf, void* rbuf, int cou
      * check to see if we have some filebased rules.
      */
     if (tuned_module->com_rules[SCAN]) {
-        int comsize, alg, faninout, segsize, max_requests;
+        int alg, faninout, segsize, max_requests;
         size_t dsize;
 
-        comsize = ompi_comm_size(comm);
         ompi_datatype_type_size (dtype, &dsize);
-        dsize *= comsize;
+        dsize *= count;
 
         alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[SCAN],
                                                         dsize, &faninout, &segsize, &max_requests);
@@ -735,16 +941,56 @@ int ompi_coll_tuned_scan_intra_dec_dynamic(const void *sbuf, void* rbuf, int cou
             /* we have found a valid choice from the file based rules for this message size */
             return ompi_coll_tuned_scan_intra_do_this (sbuf, rbuf, count, dtype,
                                                        op, comm, module,
-                                                       alg);
+                                                       alg, segsize);
         } /* found a method */
     } /*end if any com rules to check */
 
     if (tuned_module->user_forced[SCAN].algorithm) {
         return ompi_coll_tuned_scan_intra_do_this(sbuf, rbuf, count, dtype,
                                                   op, comm, module,
-                                                  tuned_module->user_forced[SCAN].algorithm);
+                                                  tuned_module->user_forced[SCAN].algorithm,
+                                                  tuned_module->user_forced[SCAN].segsize);
+    }
+
+    return ompi_coll_tuned_scan_intra_dec_fixed(sbuf, rbuf, count, dtype,
+                                                op, comm, module);
+}
+
+int ompi_coll_tuned_scatterv_intra_dec_dynamic(const void *sbuf, const int *scounts,
+                                               const int *disps, struct ompi_datatype_t *sdtype,
+                                               void* rbuf, int rcount,
+                                               struct ompi_datatype_t *rdtype,
+                                               int root,
+                                               struct ompi_communicator_t *comm,
+                                               mca_coll_base_module_t *module)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t*) module;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatterv_intra_dec_dynamic"));
+
+    /**
+     * check to see if we have some filebased rules. As the counts are
+     * only known by the root, the rules for the smallest message size
+     * of the communicator size are used.
+     */
+    if (tuned_module->com_rules[SCATTERV]) {
+        int alg, faninout, segsize, max_requests;
+
+        alg = ompi_coll_tuned_get_target_method_params (tuned_module->com_rules[SCATTERV],
+                                                        0, &faninout, &segsize, &max_requests);
+
+        if (alg) {
+            /* we have found a valid choice from the file based rules for this message size */
+            return ompi_coll_tuned_scatterv_intra_do_this (sbuf, scounts, disps, sdtype, rbuf, rcount, rdtype, root, comm, module,
+                                                         alg);
+        } /* found a method */
+    } /*end if any com rules to check */
+
+    if (tuned_module->user_forced[SCATTERV].algorithm) {
+        return ompi_coll_tuned_scatterv_intra_do_this(sbuf, scounts, disps, sdtype, rbuf, rcount, rdtype, root, comm, module,
+                                                    tuned_module->user_forced[SCATTERV].algorithm);
     }
 
-    return ompi_coll_base_scan_intra_linear(sbuf, rbuf, count, dtype,
-                                            op, comm, module);
+    return ompi_coll_tuned_scatterv_intra_dec_fixed (sbuf, scounts, disps, sdtype, rbuf, rcount, rdtype, root, comm, module);
 }
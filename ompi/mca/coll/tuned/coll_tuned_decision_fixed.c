@@ -475,6 +475,7 @@ int ompi_coll_tuned_reduce_scatter_intra_dec_fixed( const void *sbuf, void *rbuf
     const double b = 8.0;
     const size_t small_message_size = 12 * 1024;
     const size_t large_message_size = 256 * 1024;
+    const size_t segment_size = 128 * 1024;
 
     OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_reduce_scatter_intra_dec_fixed"));
 
@@ -505,6 +506,13 @@ int ompi_coll_tuned_reduce_scatter_intra_dec_fixed( const void *sbuf, void *rbuf
                                                                        dtype, op,
                                                                        comm, module);
     }
+    /* pipeline the blocks larger than a segment */
+    if (total_message_size > (size_t)comm_size * segment_size) {
+        return ompi_coll_base_reduce_scatter_intra_ring_segmented(sbuf, rbuf, rcounts,
+                                                                   dtype, op,
+                                                                   comm, module,
+                                                                   segment_size);
+    }
     return ompi_coll_base_reduce_scatter_intra_ring(sbuf, rbuf, rcounts,
                                                      dtype, op,
                                                      comm, module);
@@ -525,7 +533,18 @@ int ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed(const void *sbuf, void
                                                          struct ompi_communicator_t *comm,
                                                          mca_coll_base_module_t *module)
 {
+    const size_t segment_size = 128 * 1024;
+    size_t dsize;
+
     OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed"));
+
+    /* pipeline the blocks larger than a segment along a ring */
+    ompi_datatype_type_size(dtype, &dsize);
+    if (ompi_op_is_commute(op) && (dsize * (size_t)rcount > segment_size)) {
+        return ompi_coll_base_reduce_scatter_block_intra_ring_segmented(sbuf, rbuf, rcount,
+                                                                        dtype, op, comm, module,
+                                                                        segment_size);
+    }
     return ompi_coll_base_reduce_scatter_block_basic_linear(sbuf, rbuf, rcount,
                                                             dtype, op, comm, module);
 }
@@ -644,9 +663,10 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(const void *sbuf, int scount,
                                                struct ompi_communicator_t *comm,
                                                mca_coll_base_module_t *module)
 {
-    int i;
+    int i, max_count;
     int communicator_size;
     size_t dsize, total_dsize;
+    const size_t segment_size = 128 * 1024;
 
     communicator_size = ompi_comm_size(comm);
 
@@ -665,8 +685,10 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(const void *sbuf, int scount,
     }
 
     total_dsize = 0;
+    max_count = 0;
     for (i = 0; i < communicator_size; i++) {
         total_dsize += dsize * (ptrdiff_t)rcounts[i];
+        if (rcounts[i] > max_count) max_count = rcounts[i];
     }
 
     OPAL_OUTPUT((ompi_coll_tuned_stream,
@@ -679,6 +701,17 @@ int ompi_coll_tuned_allgatherv_intra_dec_fixed(const void *sbuf, int scount,
         return ompi_coll_base_allgatherv_intra_bruck(sbuf, scount, sdtype,
                                                      rbuf, rcounts, rdispls, rdtype,
                                                      comm, module);
+    } else if (total_dsize > (size_t)communicator_size * segment_size) {
+        /* pipeline the blocks larger than a segment */
+        return ompi_coll_base_allgatherv_intra_ring_segmented(sbuf, scount, sdtype,
+                                                              rbuf, rcounts, rdispls, rdtype,
+                                                              comm, module, segment_size);
+    } else if (dsize * (size_t)max_count * communicator_size > 4 * total_dsize) {
+        /* Skewed counts: the ring and neighbor exchange move the largest
+         * block one hop per step, sparbit spreads it in log(p) steps */
+        return ompi_coll_base_allgatherv_intra_sparbit(sbuf, scount, sdtype,
+                                                       rbuf, rcounts, rdispls, rdtype,
+                                                       comm, module);
     } else {
         if (communicator_size % 2) {
             return ompi_coll_base_allgatherv_intra_ring(sbuf, scount, sdtype,
@@ -762,6 +795,40 @@ int ompi_coll_tuned_gather_intra_dec_fixed(const void *sbuf, int scount,
                                                     root, comm, module);
 }
 
+/*
+ *	gatherv_intra_dec
+ *
+ *	Function:	- seletects gatherv algorithm to use
+ *	Accepts:	- same arguments as MPI_Gatherv()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal gatherv function.
+ */
+
+int ompi_coll_tuned_gatherv_intra_dec_fixed(const void *sbuf, int scount,
+                                            struct ompi_datatype_t *sdtype,
+                                            void* rbuf, const int *rcounts, const int *disps,
+                                            struct ompi_datatype_t *rdtype,
+                                            int root,
+                                            struct ompi_communicator_t *comm,
+                                            mca_coll_base_module_t *module)
+{
+    const int large_communicator_size = 60;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_gatherv_intra_dec_fixed"));
+
+    /* The counts are only known by the root, the decision can only
+     * depend on the size of the communicator */
+    if (ompi_comm_size(comm) > large_communicator_size) {
+        return ompi_coll_base_gatherv_intra_binomial(sbuf, scount, sdtype,
+                                                     rbuf, rcounts, disps, rdtype,
+                                                     root, comm, module);
+    }
+    return ompi_coll_base_gatherv_intra_basic_linear(sbuf, scount, sdtype,
+                                                     rbuf, rcounts, disps, rdtype,
+                                                     root, comm, module);
+}
+
 /*
  *	scatter_intra_dec
  *
@@ -807,3 +874,115 @@ int ompi_coll_tuned_scatter_intra_dec_fixed(const void *sbuf, int scount,
                                                      rbuf, rcount, rdtype,
                                                      root, comm, module);
 }
+
+/*
+ *	scatterv_intra_dec
+ *
+ *	Function:	- seletects scatterv algorithm to use
+ *	Accepts:	- same arguments as MPI_Scatterv()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal scatterv function.
+ */
+
+int ompi_coll_tuned_scatterv_intra_dec_fixed(const void *sbuf, const int *scounts,
+                                             const int *disps, struct ompi_datatype_t *sdtype,
+                                             void* rbuf, int rcount,
+                                             struct ompi_datatype_t *rdtype,
+                                             int root,
+                                             struct ompi_communicator_t *comm,
+                                             mca_coll_base_module_t *module)
+{
+    const int large_communicator_size = 60;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "ompi_coll_tuned_scatterv_intra_dec_fixed"));
+
+    /* The counts are only known by the root, the decision can only
+     * depend on the size of the communicator */
+    if (ompi_comm_size(comm) > large_communicator_size) {
+        return ompi_coll_base_scatterv_intra_binomial(sbuf, scounts, disps, sdtype,
+                                                      rbuf, rcount, rdtype,
+                                                      root, comm, module);
+    }
+    return ompi_coll_base_scatterv_intra_basic_linear(sbuf, scounts, disps, sdtype,
+                                                      rbuf, rcount, rdtype,
+                                                      root, comm, module);
+}
+
+/*
+ *	exscan_intra_dec
+ *
+ *	Function:	- seletects exscan algorithm to use
+ *	Accepts:	- same arguments as MPI_Exscan()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal exscan function.
+ */
+int ompi_coll_tuned_exscan_intra_dec_fixed(const void *sbuf, void* rbuf, int count,
+                                           struct ompi_datatype_t *dtype,
+                                           struct ompi_op_t *op,
+                                           struct ompi_communicator_t *comm,
+                                           mca_coll_base_module_t *module)
+{
+    const size_t small_message_size = 8 * 1024;
+    const size_t segment_size = 128 * 1024;
+    int communicator_size = ompi_comm_size(comm);
+    size_t dsize, total_dsize;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_exscan_intra_dec_fixed"));
+
+    ompi_datatype_type_size(dtype, &dsize);
+    total_dsize = dsize * (size_t)count;
+
+    /* Latency bound: the log(p) rounds of recursive doubling win, the
+     * redundant reductions are cheap. */
+    if (total_dsize <= small_message_size) {
+        return ompi_coll_base_exscan_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                             op, comm, module);
+    }
+    /* Large enough for the chain to fill: the segments flow along the
+     * ranks and every link carries the message only once. */
+    if (communicator_size > 2 &&
+        total_dsize >= (size_t)communicator_size * segment_size) {
+        return ompi_coll_base_exscan_intra_pipeline(sbuf, rbuf, count, dtype,
+                                                    op, comm, module, segment_size);
+    }
+    return ompi_coll_base_exscan_intra_binomial(sbuf, rbuf, count, dtype,
+                                                op, comm, module);
+}
+
+/*
+ *	scan_intra_dec
+ *
+ *	Function:	- seletects scan algorithm to use
+ *	Accepts:	- same arguments as MPI_Scan()
+ *	Returns:	- MPI_SUCCESS or error code, passed from corresponding
+ *                        internal scan function.
+ */
+int ompi_coll_tuned_scan_intra_dec_fixed(const void *sbuf, void* rbuf, int count,
+                                         struct ompi_datatype_t *dtype,
+                                         struct ompi_op_t *op,
+                                         struct ompi_communicator_t *comm,
+                                         mca_coll_base_module_t *module)
+{
+    const size_t small_message_size = 8 * 1024;
+    const size_t segment_size = 128 * 1024;
+    int communicator_size = ompi_comm_size(comm);
+    size_t dsize, total_dsize;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_scan_intra_dec_fixed"));
+
+    ompi_datatype_type_size(dtype, &dsize);
+    total_dsize = dsize * (size_t)count;
+
+    if (total_dsize <= small_message_size) {
+        return ompi_coll_base_scan_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                           op, comm, module);
+    }
+    if (communicator_size > 2 &&
+        total_dsize >= (size_t)communicator_size * segment_size) {
+        return ompi_coll_base_scan_intra_pipeline(sbuf, rbuf, count, dtype,
+                                                  op, comm, module, segment_size);
+    }
+    return ompi_coll_base_scan_intra_binomial(sbuf, rbuf, count, dtype,
+                                              op, comm, module);
+}
@@ -0,0 +1,363 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Online learning of the collective algorithms.
+ *
+ * When coll_tuned_learning is set, the first calls of a collective on
+ * a communicator, for a given message size bucket (a power of 2), go
+ * in turn through a list of candidate algorithms.  The first round is
+ * a warm up, then each candidate is timed during
+ * coll_tuned_learning_trials rounds.  The processes then agree on the
+ * candidate with the smallest accumulated time (maximum over the
+ * processes), which is used for all the later calls in the bucket.
+ *
+ * All the processes make the same calls with the same message size,
+ * so they go through the candidates in the same order without any
+ * communication until the agreement.  Only the collectives for which
+ * the message size used for the decision is the same on all the
+ * processes are learned.
+ *
+ * The learned choices can be read through the coll_tuned_learned_rules
+ * MPI_T performance variable, bound to a communicator, in the format
+ * of the dynamic rules file.
+ */
+
+#include "ompi_config.h"
+
+#include <float.h>
+#include <stdio.h>
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "coll_tuned.h"
+
+typedef struct {
+    const char *name;
+    const ompi_coll_tuned_learn_choice_t *choices;
+    int n_choices;
+} coll_tuned_learn_table_t;
+
+/*
+ * Candidates, as { algorithm, faninout, segsize, max_requests }.  The
+ * algorithms restricted to some communicator sizes (two_proc) are not
+ * listed, the others fall back to a valid algorithm when needed.
+ */
+static const ompi_coll_tuned_learn_choice_t learn_allgather[] = {
+    { 1, 0, 0, 0 },         /* linear */
+    { 2, 0, 0, 0 },         /* bruck */
+    { 3, 0, 0, 0 },         /* recursive doubling */
+    { 4, 0, 0, 0 },         /* ring */
+    { 5, 0, 0, 0 },         /* neighbor exchange */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_allreduce[] = {
+    { 2, 0, 0, 0 },         /* nonoverlapping */
+    { 3, 0, 0, 0 },         /* recursive doubling */
+    { 4, 0, 0, 0 },         /* ring */
+    { 5, 0, 1 << 20, 0 },   /* segmented ring */
+    { 6, 0, 0, 0 },         /* rabenseifner */
+    { 7, 0, 0, 0 },         /* rabenseifner k-nomial */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_alltoall[] = {
+    { 1, 0, 0, 0 },         /* linear */
+    { 2, 0, 0, 0 },         /* pairwise */
+    { 3, 0, 0, 0 },         /* modified bruck */
+    { 4, 0, 0, 8 },         /* linear sync */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_barrier[] = {
+    { 1, 0, 0, 0 },         /* linear */
+    { 2, 0, 0, 0 },         /* double ring */
+    { 3, 0, 0, 0 },         /* recursive doubling */
+    { 4, 0, 0, 0 },         /* bruck */
+    { 6, 0, 0, 0 },         /* tree */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_bcast[] = {
+    { 2, 4, 8192, 0 },      /* chain */
+    { 3, 0, 8192, 0 },      /* pipeline */
+    { 3, 0, 131072, 0 },    /* pipeline */
+    { 4, 0, 1024, 0 },      /* split binary tree */
+    { 4, 0, 8192, 0 },      /* split binary tree */
+    { 6, 0, 0, 0 },         /* binomial */
+    { 7, 0, 0, 0 },         /* knomial */
+    { 8, 0, 0, 0 },         /* scatter allgather */
+    { 9, 0, 0, 0 },         /* scatter allgather ring */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_reduce[] = {
+    { 1, 0, 0, 0 },         /* linear */
+    { 2, 4, 32768, 0 },     /* chain */
+    { 3, 0, 65536, 0 },     /* pipeline */
+    { 4, 0, 32768, 0 },     /* binary */
+    { 5, 0, 0, 0 },         /* binomial */
+    { 5, 0, 32768, 0 },     /* binomial */
+    { 6, 0, 32768, 0 },     /* in-order binary */
+    { 7, 0, 0, 0 },         /* rabenseifner */
+};
+
+static const ompi_coll_tuned_learn_choice_t learn_reduce_scatter_block[] = {
+    { 1, 0, 0, 0 },         /* basic linear */
+    { 2, 0, 0, 0 },         /* recursive doubling */
+    { 3, 0, 0, 0 },         /* recursive halving */
+    { 4, 0, 0, 0 },         /* butterfly */
+};
+
+#define LEARN_TABLE(NAME, CHOICES) { NAME, CHOICES, sizeof(CHOICES) / sizeof(CHOICES[0]) }
+
+static const coll_tuned_learn_table_t learn_tables[COLLCOUNT] = {
+    [ALLGATHER] = LEARN_TABLE("allgather", learn_allgather),
+    [ALLREDUCE] = LEARN_TABLE("allreduce", learn_allreduce),
+    [ALLTOALL] = LEARN_TABLE("alltoall", learn_alltoall),
+    [BARRIER] = LEARN_TABLE("barrier", learn_barrier),
+    [BCAST] = LEARN_TABLE("bcast", learn_bcast),
+    [REDUCE] = LEARN_TABLE("reduce", learn_reduce),
+    [REDUCESCATTERBLOCK] = LEARN_TABLE("reduce_scatter_block", learn_reduce_scatter_block),
+};
+
+/* upper bound of the size of the rules text for one communicator */
+#define LEARN_RULES_MAX_LENGTH (COLLCOUNT * (64 + COLL_TUNED_LEARN_BUCKETS * 48))
+
+static inline int learn_bucket_index(size_t msg_size)
+{
+    int b = 0;
+
+    while (msg_size >= ((size_t)1 << 16)) {
+        msg_size >>= 16;
+        b += 16;
+    }
+    while (0 != msg_size) {
+        msg_size >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/* smallest message size of a bucket */
+static inline size_t learn_bucket_start(int b)
+{
+    return (0 == b) ? 0 : ((size_t)1 << (b - 1));
+}
+
+int ompi_coll_tuned_learning_init(mca_coll_tuned_module_t *module, int coll_id)
+{
+    ompi_coll_tuned_learn_bucket_t *buckets;
+    double *times;
+    int b, n = learn_tables[coll_id].n_choices;
+
+    if (0 == n) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    buckets = (ompi_coll_tuned_learn_bucket_t*)calloc(COLL_TUNED_LEARN_BUCKETS,
+                                                      sizeof(ompi_coll_tuned_learn_bucket_t));
+    times = (double*)calloc(COLL_TUNED_LEARN_BUCKETS * n, sizeof(double));
+    if (NULL == buckets || NULL == times) {
+        free(buckets);
+        free(times);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (b = 0; b < COLL_TUNED_LEARN_BUCKETS; b++) {
+        buckets[b].times = times + b * n;
+    }
+    module->learned[coll_id] = buckets;
+    return OMPI_SUCCESS;
+}
+
+void ompi_coll_tuned_learning_fini(mca_coll_tuned_module_t *module)
+{
+    for (int i = 0; i < COLLCOUNT; i++) {
+        if (NULL != module->learned[i]) {
+            free(module->learned[i][0].times);
+            free(module->learned[i]);
+            module->learned[i] = NULL;
+        }
+    }
+}
+
+/*
+ * Returns the configuration to use for this call, and starts the
+ * timer if the bucket is still learning.
+ */
+const ompi_coll_tuned_learn_choice_t *
+ompi_coll_tuned_learning_begin(mca_coll_tuned_module_t *module, int coll_id, size_t msg_size,
+                               ompi_coll_tuned_learn_bucket_t **bucket, opal_timer_t *start)
+{
+    const coll_tuned_learn_table_t *table = &learn_tables[coll_id];
+    ompi_coll_tuned_learn_bucket_t *b = &module->learned[coll_id][learn_bucket_index(msg_size)];
+
+    *bucket = b;
+    if (OPAL_LIKELY(0 != b->choice)) {
+        return &table->choices[b->choice - 1];
+    }
+    *start = opal_timer_base_get_cycles();
+    return &table->choices[b->ncalls % table->n_choices];
+}
+
+/*
+ * Accounts for the time of a call while learning, and selects the
+ * fastest candidate once all of them have been timed.  Returns the
+ * return code of the collective.
+ */
+int ompi_coll_tuned_learning_end(mca_coll_tuned_module_t *module, int coll_id,
+                                 ompi_coll_tuned_learn_bucket_t *bucket, opal_timer_t start,
+                                 struct ompi_communicator_t *comm, int rc)
+{
+    const coll_tuned_learn_table_t *table = &learn_tables[coll_id];
+    int i, err, n = table->n_choices;
+
+    if (OPAL_LIKELY(0 != bucket->choice)) {
+        return rc;
+    }
+
+    /* the first round is not timed, it includes the setup costs */
+    if (bucket->ncalls >= n) {
+        bucket->times[bucket->ncalls % n] += (MPI_SUCCESS == rc) ?
+            (double)(opal_timer_base_get_cycles() - start) : DBL_MAX;
+    }
+    bucket->ncalls++;
+    if (bucket->ncalls < n * (ompi_coll_tuned_learning_trials + 1)) {
+        return rc;
+    }
+
+    /* agree on the slowest process for each candidate */
+    err = ompi_coll_base_allreduce_intra_recursivedoubling(MPI_IN_PLACE, bucket->times, n,
+                                                           &ompi_mpi_double.dt,
+                                                           &ompi_mpi_op_max.op,
+                                                           comm, &module->super);
+    if (MPI_SUCCESS != err) {
+        return (MPI_SUCCESS == rc) ? err : rc;
+    }
+    bucket->choice = 1;
+    for (i = 1; i < n; i++) {
+        if (bucket->times[i] < bucket->times[bucket->choice - 1]) {
+            bucket->choice = i + 1;
+        }
+    }
+    OPAL_OUTPUT((ompi_coll_tuned_stream,
+                 "coll:tuned:learning %s bucket %d selected algorithm %d (faninout %d segsize %d)",
+                 table->name, (int)(bucket - module->learned[coll_id]),
+                 table->choices[bucket->choice - 1].algorithm,
+                 table->choices[bucket->choice - 1].faninout,
+                 table->choices[bucket->choice - 1].segsize));
+    return rc;
+}
+
+/*
+ * The tuned module of a communicator, if it provides some of the
+ * learned collectives.
+ */
+static mca_coll_tuned_module_t *learn_find_module(struct ompi_communicator_t *comm)
+{
+    mca_coll_base_module_t *modules[] = {
+        comm->c_coll->coll_allgather_module, comm->c_coll->coll_allreduce_module,
+        comm->c_coll->coll_alltoall_module, comm->c_coll->coll_barrier_module,
+        comm->c_coll->coll_bcast_module, comm->c_coll->coll_reduce_module,
+        comm->c_coll->coll_reduce_scatter_block_module,
+    };
+
+    for (size_t i = 0; i < sizeof(modules) / sizeof(modules[0]); i++) {
+        if (NULL != modules[i] &&
+            OBJ_CLASS(mca_coll_tuned_module_t) == ((opal_object_t*)modules[i])->obj_class) {
+            return (mca_coll_tuned_module_t*)modules[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Write the learned choices of a communicator as a dynamic rules file.
+ * Consecutive buckets with the same choice are merged, and the first
+ * rule of each collective is extended down to the empty message.
+ */
+static int learn_rules_get(const struct mca_base_pvar_t *pvar, void *value, void *obj)
+{
+    struct ompi_communicator_t *comm = (struct ompi_communicator_t *) obj;
+    mca_coll_tuned_module_t *module = learn_find_module(comm);
+    char *rules = (char*)value, lines[COLL_TUNED_LEARN_BUCKETS * 48];
+    size_t len = 0, max = LEARN_RULES_MAX_LENGTH, lines_len;
+    int c, b, prev, n_colls = 0, n_rules;
+
+    rules[0] = '\0';
+    if (NULL == module) {
+        return OMPI_SUCCESS;
+    }
+
+    for (c = 0; c < COLLCOUNT; c++) {
+        for (b = 0; NULL != module->learned[c] && b < COLL_TUNED_LEARN_BUCKETS; b++) {
+            if (0 != module->learned[c][b].choice) {
+                n_colls++;
+                break;
+            }
+        }
+    }
+    if (0 == n_colls) {
+        return OMPI_SUCCESS;
+    }
+
+    len += snprintf(rules + len, max - len, "%d # number of collectives\n", n_colls);
+    for (c = 0; c < COLLCOUNT; c++) {
+        if (NULL == module->learned[c]) {
+            continue;
+        }
+        for (prev = 0, n_rules = 0, lines_len = 0, b = 0; b < COLL_TUNED_LEARN_BUCKETS; b++) {
+            const ompi_coll_tuned_learn_choice_t *choice;
+
+            if (0 == module->learned[c][b].choice || prev == module->learned[c][b].choice) {
+                continue;
+            }
+            prev = module->learned[c][b].choice;
+            choice = &learn_tables[c].choices[prev - 1];
+            lines_len += snprintf(lines + lines_len, sizeof(lines) - lines_len, "%lu %d %d %d\n",
+                                  (0 == n_rules) ? 0UL : (unsigned long)learn_bucket_start(b),
+                                  choice->algorithm, choice->faninout, choice->segsize);
+            n_rules++;
+        }
+        if (0 == n_rules) {
+            continue;
+        }
+        len += snprintf(rules + len, max - len, "%d # %s\n1\n%d %d\n%s", c, learn_tables[c].name,
+                        ompi_comm_size(comm), n_rules, lines);
+    }
+    return OMPI_SUCCESS;
+}
+
+static int learn_rules_notify(struct mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                              void *obj, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = LEARN_RULES_MAX_LENGTH;
+    }
+    return OMPI_SUCCESS;
+}
+
+int ompi_coll_tuned_learning_register(void)
+{
+    (void) mca_base_component_pvar_register(&mca_coll_tuned_component.super.collm_version,
+                                            "learned_rules",
+                                            "Algorithms learned on a communicator "
+                                            "(coll_tuned_learning), in the format of the "
+                                            "coll_tuned_dynamic_rules_filename file",
+                                            OPAL_INFO_LVL_4, MCA_BASE_PVAR_CLASS_GENERIC,
+                                            MCA_BASE_VAR_TYPE_STRING, NULL, MCA_BASE_VAR_BIND_MPI_COMM,
+                                            MCA_BASE_PVAR_FLAG_READONLY | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            learn_rules_get, NULL, learn_rules_notify, NULL);
+    return OMPI_SUCCESS;
+}
@@ -103,15 +103,22 @@ ompi_coll_tuned_comm_query(struct ompi_communicator_t *comm, int *priority)
     tuned_module->super.coll_alltoallw  = NULL;
     tuned_module->super.coll_barrier    = ompi_coll_tuned_barrier_intra_dec_fixed;
     tuned_module->super.coll_bcast      = ompi_coll_tuned_bcast_intra_dec_fixed;
-    tuned_module->super.coll_exscan     = NULL;
+    tuned_module->super.coll_exscan     = ompi_coll_tuned_exscan_intra_dec_fixed;
     tuned_module->super.coll_gather     = ompi_coll_tuned_gather_intra_dec_fixed;
-    tuned_module->super.coll_gatherv    = NULL;
+    tuned_module->super.coll_gatherv    = ompi_coll_tuned_gatherv_intra_dec_fixed;
     tuned_module->super.coll_reduce     = ompi_coll_tuned_reduce_intra_dec_fixed;
     tuned_module->super.coll_reduce_scatter = ompi_coll_tuned_reduce_scatter_intra_dec_fixed;
     tuned_module->super.coll_reduce_scatter_block = ompi_coll_tuned_reduce_scatter_block_intra_dec_fixed;
-    tuned_module->super.coll_scan       = NULL;
+    tuned_module->super.coll_scan       = ompi_coll_tuned_scan_intra_dec_fixed;
     tuned_module->super.coll_scatter    = ompi_coll_tuned_scatter_intra_dec_fixed;
-    tuned_module->super.coll_scatterv   = NULL;
+    tuned_module->super.coll_scatterv   = ompi_coll_tuned_scatterv_intra_dec_fixed;
+
+    if (ompi_coll_tuned_persistent) {
+        tuned_module->super.coll_allgather_init = ompi_coll_tuned_allgather_intra_init;
+        tuned_module->super.coll_allreduce_init = ompi_coll_tuned_allreduce_intra_init;
+        tuned_module->super.coll_alltoall_init  = ompi_coll_tuned_alltoall_intra_init;
+        tuned_module->super.coll_bcast_init     = ompi_coll_tuned_bcast_intra_init;
+    }
 
     return &(tuned_module->super);
 }
@@ -171,6 +178,14 @@ ompi_coll_tuned_forced_getvalues( enum COLLTYPE type,
         }                                                               \
     }
 
+#define COLL_TUNED_LEARN(TMOD, TYPE, EXECUTE)                           \
+    {                                                                   \
+        if( OMPI_SUCCESS == ompi_coll_tuned_learning_init((TMOD), (TYPE)) ) { \
+            OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned: enable learning for "#TYPE)); \
+            EXECUTE;                                                    \
+        }                                                               \
+    }
+
 /*
  * Init module on the communicator
  */
@@ -236,7 +251,7 @@ tuned_module_enable( mca_coll_base_module_t *module,
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, GATHER,
                                       tuned_module->super.coll_gather     = ompi_coll_tuned_gather_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, GATHERV,
-                                      tuned_module->super.coll_gatherv    = NULL);
+                                      tuned_module->super.coll_gatherv    = ompi_coll_tuned_gatherv_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, REDUCE,
                                       tuned_module->super.coll_reduce     = ompi_coll_tuned_reduce_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, REDUCESCATTER,
@@ -248,7 +263,28 @@ tuned_module_enable( mca_coll_base_module_t *module,
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, SCATTER,
                                       tuned_module->super.coll_scatter    = ompi_coll_tuned_scatter_intra_dec_dynamic);
         COLL_TUNED_EXECUTE_IF_DYNAMIC(tuned_module, SCATTERV,
-                                      tuned_module->super.coll_scatterv   = NULL);
+                                      tuned_module->super.coll_scatterv   = ompi_coll_tuned_scatterv_intra_dec_dynamic);
+    }
+
+    if (ompi_coll_tuned_learning && OMPI_COMM_IS_INTRA(comm)) {
+        OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:module_init Learning"));
+
+        /* the dynamic decisions use the learned algorithms when there
+           are neither file based rules nor forced algorithms */
+        COLL_TUNED_LEARN(tuned_module, ALLGATHER,
+                         tuned_module->super.coll_allgather  = ompi_coll_tuned_allgather_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, ALLREDUCE,
+                         tuned_module->super.coll_allreduce  = ompi_coll_tuned_allreduce_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, ALLTOALL,
+                         tuned_module->super.coll_alltoall   = ompi_coll_tuned_alltoall_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, BARRIER,
+                         tuned_module->super.coll_barrier    = ompi_coll_tuned_barrier_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, BCAST,
+                         tuned_module->super.coll_bcast      = ompi_coll_tuned_bcast_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, REDUCE,
+                         tuned_module->super.coll_reduce     = ompi_coll_tuned_reduce_intra_dec_dynamic);
+        COLL_TUNED_LEARN(tuned_module, REDUCESCATTERBLOCK,
+                         tuned_module->super.coll_reduce_scatter_block = ompi_coll_tuned_reduce_scatter_block_intra_dec_dynamic);
     }
 
     /* general n fan out tree */
@@ -0,0 +1,1091 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Persistent collectives.
+ *
+ * The persistent bcast, allreduce, allgather and alltoall select their
+ * algorithm as the fixed decision functions of the blocking collectives
+ * do, and set it up once at initialization: the topology is built, the
+ * temporary buffer is allocated, and all the point-to-point communications
+ * are created as persistent PML requests. An algorithm is a sequence of
+ * steps, each of them starting some of these requests, then running local
+ * copies and reductions once they completed. MPI_Start starts the first
+ * step, and the progress function moves on to the next step whenever the
+ * requests of a step completed.
+ *
+ * Each persistent collective gets its own tag at initialization (which is
+ * collective, and thus ordered), so that several of them may be active at
+ * the same time on a communicator.
+ */
+
+#include "ompi_config.h"
+
+#include "mpi.h"
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_base_topo.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/mca/pml/pml.h"
+#include "ompi/op/op.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/bit_ops.h"
+#include "coll_tuned.h"
+
+#define COLL_TUNED_PREQ_COPY   0
+#define COLL_TUNED_PREQ_REDUCE 1
+
+/* a local operation, run once the requests of its step completed */
+typedef struct {
+    int type;                     /* COLL_TUNED_PREQ_COPY or _REDUCE */
+    const void *src;
+    void *dst;                    /* dst = src (op) dst for a reduction */
+    int scount, dcount;
+    ompi_datatype_t *sdtype, *ddtype;
+} coll_tuned_preq_action_t;
+
+/* a step starts nreqs requests, and runs nactions actions once they
+ * completed */
+typedef struct {
+    int nreqs;
+    int nactions;
+} coll_tuned_preq_step_t;
+
+struct ompi_coll_tuned_preq_t {
+    ompi_coll_base_nbc_request_t super;
+    struct ompi_communicator_t *comm;
+    int tag;
+    ompi_op_t *op;                /* retained operation of the reductions */
+    ompi_datatype_t *types[2];    /* retained datatypes of the actions */
+    char *tmpbuf;                 /* temporary buffer, as allocated */
+
+    coll_tuned_preq_step_t *steps;
+    int nsteps, max_steps;
+    bool step_closed;             /* the next request or action opens a step */
+    ompi_request_t **reqs;        /* the requests of the steps, in order */
+    int nreqs, max_reqs;
+    coll_tuned_preq_action_t *actions; /* the actions of the steps, in order */
+    int nactions, max_actions;
+
+    /* current step of an active collective */
+    int step, first_req, first_action;
+    bool step_started;
+    bool free_called;             /* freed while active, released on completion */
+};
+typedef struct ompi_coll_tuned_preq_t ompi_coll_tuned_preq_t;
+
+static void ompi_coll_tuned_preq_construct(ompi_coll_tuned_preq_t *preq)
+{
+    preq->op = NULL;
+    preq->types[0] = preq->types[1] = NULL;
+    preq->tmpbuf = NULL;
+    preq->steps = NULL;
+    preq->nsteps = preq->max_steps = 0;
+    preq->step_closed = false;
+    preq->reqs = NULL;
+    preq->nreqs = preq->max_reqs = 0;
+    preq->actions = NULL;
+    preq->nactions = preq->max_actions = 0;
+    preq->free_called = false;
+}
+
+static void ompi_coll_tuned_preq_destruct(ompi_coll_tuned_preq_t *preq)
+{
+    for (int i = 0 ; i < preq->nreqs ; ++i) {
+        ompi_request_free(&preq->reqs[i]);
+    }
+    free(preq->reqs);
+    free(preq->steps);
+    free(preq->actions);
+    free(preq->tmpbuf);
+    if (NULL != preq->op) {
+        OBJ_RELEASE(preq->op);
+    }
+    for (int i = 0 ; i < 2 ; ++i) {
+        if (NULL != preq->types[i]) {
+            OBJ_RELEASE(preq->types[i]);
+        }
+    }
+}
+
+static OBJ_CLASS_INSTANCE(ompi_coll_tuned_preq_t, ompi_coll_base_nbc_request_t,
+                          ompi_coll_tuned_preq_construct, ompi_coll_tuned_preq_destruct);
+
+/* the active persistent collectives */
+static opal_list_t coll_tuned_preq_active;
+static opal_mutex_t coll_tuned_preq_lock;
+static bool coll_tuned_preq_in_progress = false;
+static bool coll_tuned_preq_registered = false;
+
+static int coll_tuned_preq_progress(void);
+
+/*
+ * Setting up an algorithm
+ */
+
+static int coll_tuned_preq_grow(void **array, int *max, int num, size_t size)
+{
+    void *tmp;
+
+    if (num < *max) {
+        return OMPI_SUCCESS;
+    }
+    tmp = realloc(*array, (*max ? 2 * *max : 16) * size);
+    if (NULL == tmp) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    *array = tmp;
+    *max = *max ? 2 * *max : 16;
+
+    return OMPI_SUCCESS;
+}
+
+/* returns the step a request (comm is true) or an action is added to */
+static coll_tuned_preq_step_t *coll_tuned_preq_get_step(ompi_coll_tuned_preq_t *preq, bool comm)
+{
+    /* the requests of a step are started before its actions run */
+    if (0 == preq->nsteps || preq->step_closed ||
+        (comm && preq->steps[preq->nsteps - 1].nactions > 0)) {
+        if (OMPI_SUCCESS != coll_tuned_preq_grow((void **) &preq->steps, &preq->max_steps,
+                                                 preq->nsteps, sizeof(*preq->steps))) {
+            return NULL;
+        }
+        preq->steps[preq->nsteps].nreqs = 0;
+        preq->steps[preq->nsteps++].nactions = 0;
+        preq->step_closed = false;
+    }
+
+    return &preq->steps[preq->nsteps - 1];
+}
+
+/* ends the current step: the next requests wait for its completion */
+static void coll_tuned_preq_end_step(ompi_coll_tuned_preq_t *preq)
+{
+    preq->step_closed = true;
+}
+
+static int coll_tuned_preq_add_req(ompi_coll_tuned_preq_t *preq, bool send, const void *buf,
+                                   size_t count, ompi_datatype_t *dtype, int peer)
+{
+    coll_tuned_preq_step_t *step;
+    int err;
+
+    /* all the processes agree on the empty messages */
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+
+    step = coll_tuned_preq_get_step(preq, true);
+    if (NULL == step ||
+        OMPI_SUCCESS != coll_tuned_preq_grow((void **) &preq->reqs, &preq->max_reqs,
+                                             preq->nreqs, sizeof(*preq->reqs))) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    if (send) {
+        err = MCA_PML_CALL(isend_init(buf, count, dtype, peer, preq->tag,
+                                      MCA_PML_BASE_SEND_STANDARD, preq->comm,
+                                      &preq->reqs[preq->nreqs]));
+    } else {
+        err = MCA_PML_CALL(irecv_init((void *) buf, count, dtype, peer, preq->tag,
+                                      preq->comm, &preq->reqs[preq->nreqs]));
+    }
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+    preq->nreqs++;
+    step->nreqs++;
+
+    return OMPI_SUCCESS;
+}
+
+static inline int coll_tuned_preq_send(ompi_coll_tuned_preq_t *preq, const void *buf,
+                                       size_t count, ompi_datatype_t *dtype, int peer)
+{
+    return coll_tuned_preq_add_req(preq, true, buf, count, dtype, peer);
+}
+
+static inline int coll_tuned_preq_recv(ompi_coll_tuned_preq_t *preq, void *buf,
+                                       size_t count, ompi_datatype_t *dtype, int peer)
+{
+    return coll_tuned_preq_add_req(preq, false, buf, count, dtype, peer);
+}
+
+static int coll_tuned_preq_add_action(ompi_coll_tuned_preq_t *preq, int type,
+                                      const void *src, int scount, ompi_datatype_t *sdtype,
+                                      void *dst, int dcount, ompi_datatype_t *ddtype)
+{
+    coll_tuned_preq_step_t *step;
+    coll_tuned_preq_action_t *action;
+
+    step = coll_tuned_preq_get_step(preq, false);
+    if (NULL == step ||
+        OMPI_SUCCESS != coll_tuned_preq_grow((void **) &preq->actions, &preq->max_actions,
+                                             preq->nactions, sizeof(*preq->actions))) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    action = &preq->actions[preq->nactions++];
+    action->type = type;
+    action->src = src;
+    action->scount = scount;
+    action->sdtype = sdtype;
+    action->dst = dst;
+    action->dcount = dcount;
+    action->ddtype = ddtype;
+    step->nactions++;
+
+    return OMPI_SUCCESS;
+}
+
+static inline int coll_tuned_preq_copy(ompi_coll_tuned_preq_t *preq,
+                                       const void *src, int scount, ompi_datatype_t *sdtype,
+                                       void *dst, int dcount, ompi_datatype_t *ddtype)
+{
+    if (0 == scount || src == dst) {
+        return OMPI_SUCCESS;
+    }
+    return coll_tuned_preq_add_action(preq, COLL_TUNED_PREQ_COPY, src, scount, sdtype,
+                                      dst, dcount, ddtype);
+}
+
+/* dst = src (op) dst */
+static inline int coll_tuned_preq_reduce(ompi_coll_tuned_preq_t *preq, const void *src,
+                                         void *dst, int count, ompi_datatype_t *dtype)
+{
+    if (0 == count) {
+        return OMPI_SUCCESS;
+    }
+    return coll_tuned_preq_add_action(preq, COLL_TUNED_PREQ_REDUCE, src, count, dtype,
+                                      dst, count, dtype);
+}
+
+/* allocates the temporary buffer for count elements of datatype, and
+ * sets *buf to the address of its first element. Nothing is allocated
+ * for an empty buffer, *buf is then NULL */
+static int coll_tuned_preq_tmpbuf(ompi_coll_tuned_preq_t *preq, ompi_datatype_t *dtype,
+                                  int64_t count, char **buf)
+{
+    ptrdiff_t span, gap = 0;
+
+    *buf = NULL;
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    if (0 == span) {
+        return OMPI_SUCCESS;
+    }
+    preq->tmpbuf = (char *) malloc(span);
+    if (NULL == preq->tmpbuf) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    *buf = preq->tmpbuf - gap;
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Running an algorithm
+ */
+
+/* runs the steps from the current one on, until one has to wait for its
+ * requests. *done is set once the last step completed */
+static int coll_tuned_preq_advance(ompi_coll_tuned_preq_t *preq, bool *done)
+{
+    int err;
+
+    *done = false;
+
+    while (preq->step < preq->nsteps) {
+        coll_tuned_preq_step_t *step = &preq->steps[preq->step];
+        ompi_request_t **reqs = preq->reqs + preq->first_req;
+
+        if (!preq->step_started) {
+            if (step->nreqs > 0) {
+                err = MCA_PML_CALL(start(step->nreqs, reqs));
+                if (MPI_SUCCESS != err) {
+                    return err;
+                }
+            }
+            preq->step_started = true;
+        }
+
+        for (int i = 0 ; i < step->nreqs ; ++i) {
+            if (!REQUEST_COMPLETE(reqs[i])) {
+                return OMPI_SUCCESS;
+            }
+        }
+        for (int i = 0 ; i < step->nreqs ; ++i) {
+            if (OPAL_UNLIKELY(MPI_SUCCESS != reqs[i]->req_status.MPI_ERROR)) {
+                return reqs[i]->req_status.MPI_ERROR;
+            }
+        }
+
+        for (int i = 0 ; i < step->nactions ; ++i) {
+            coll_tuned_preq_action_t *action = &preq->actions[preq->first_action + i];
+
+            if (COLL_TUNED_PREQ_REDUCE == action->type) {
+                ompi_op_reduce(preq->op, (void *) action->src, action->dst,
+                               action->scount, action->sdtype);
+            } else {
+                err = ompi_datatype_sndrcv(action->src, action->scount, action->sdtype,
+                                           action->dst, action->dcount, action->ddtype);
+                if (MPI_SUCCESS != err) {
+                    return err;
+                }
+            }
+        }
+
+        preq->first_req += step->nreqs;
+        preq->first_action += step->nactions;
+        preq->step++;
+        preq->step_started = false;
+    }
+
+    *done = true;
+
+    return OMPI_SUCCESS;
+}
+
+static int coll_tuned_preq_start(size_t count, ompi_request_t **requests)
+{
+    for (size_t i = 0 ; i < count ; ++i) {
+        ompi_coll_tuned_preq_t *preq = (ompi_coll_tuned_preq_t *) requests[i];
+        bool done;
+        int err;
+
+        preq->super.super.req_state = OMPI_REQUEST_ACTIVE;
+        preq->super.super.req_complete = REQUEST_PENDING;
+        preq->super.super.req_status.MPI_ERROR = MPI_SUCCESS;
+        preq->step = preq->first_req = preq->first_action = 0;
+        preq->step_started = false;
+
+        err = coll_tuned_preq_advance(preq, &done);
+        if (MPI_SUCCESS != err || done) {
+            preq->super.super.req_status.MPI_ERROR = err;
+            ompi_request_complete(&preq->super.super, true);
+            continue;
+        }
+
+        OPAL_THREAD_LOCK(&coll_tuned_preq_lock);
+        if (!coll_tuned_preq_registered) {
+            coll_tuned_preq_registered = true;
+            opal_progress_register(coll_tuned_preq_progress);
+        }
+        opal_list_append(&coll_tuned_preq_active, &preq->super.super.super.super);
+        OPAL_THREAD_UNLOCK(&coll_tuned_preq_lock);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int coll_tuned_preq_progress(void)
+{
+    ompi_coll_tuned_preq_t *preq, *next;
+    int completed = 0;
+
+    if (0 == opal_list_get_size(&coll_tuned_preq_active)) {
+        /* nothing to do, do not grab the lock */
+        return 0;
+    }
+
+    OPAL_THREAD_LOCK(&coll_tuned_preq_lock);
+    /* return if invoked recursively */
+    if (!coll_tuned_preq_in_progress) {
+        coll_tuned_preq_in_progress = true;
+
+        OPAL_LIST_FOREACH_SAFE(preq, next, &coll_tuned_preq_active, ompi_coll_tuned_preq_t) {
+            bool done;
+            int err;
+
+            OPAL_THREAD_UNLOCK(&coll_tuned_preq_lock);
+            err = coll_tuned_preq_advance(preq, &done);
+            OPAL_THREAD_LOCK(&coll_tuned_preq_lock);
+            if (MPI_SUCCESS != err || done) {
+                opal_list_remove_item(&coll_tuned_preq_active, &preq->super.super.super.super);
+                preq->super.super.req_status.MPI_ERROR = err;
+                if (preq->free_called) {
+                    /* nobody is left to complete it, release it */
+                    OMPI_REQUEST_FINI(&preq->super.super);
+                    OBJ_RELEASE(preq);
+                } else {
+                    ompi_request_complete(&preq->super.super, true);
+                }
+                completed++;
+            }
+        }
+
+        coll_tuned_preq_in_progress = false;
+    }
+    OPAL_THREAD_UNLOCK(&coll_tuned_preq_lock);
+
+    return completed;
+}
+
+static int coll_tuned_preq_free(ompi_request_t **request)
+{
+    ompi_coll_tuned_preq_t *preq = (ompi_coll_tuned_preq_t *) *request;
+
+    *request = MPI_REQUEST_NULL;
+
+    /* an active collective is released by the progress once it completes */
+    OPAL_THREAD_LOCK(&coll_tuned_preq_lock);
+    if (!REQUEST_COMPLETE(&preq->super.super)) {
+        preq->free_called = true;
+        OPAL_THREAD_UNLOCK(&coll_tuned_preq_lock);
+        return OMPI_SUCCESS;
+    }
+    OPAL_THREAD_UNLOCK(&coll_tuned_preq_lock);
+
+    OMPI_REQUEST_FINI(&preq->super.super);
+    OBJ_RELEASE(preq);
+
+    return OMPI_SUCCESS;
+}
+
+static int coll_tuned_preq_cancel(ompi_request_t *request, int complete)
+{
+    return MPI_ERR_REQUEST;
+}
+
+/* allocates the persistent request of a collective */
+static ompi_coll_tuned_preq_t *
+coll_tuned_preq_new(struct ompi_communicator_t *comm, mca_coll_base_module_t *module,
+                    ompi_op_t *op, ompi_datatype_t *type0, ompi_datatype_t *type1)
+{
+    mca_coll_tuned_module_t *tuned_module = (mca_coll_tuned_module_t *) module;
+    ompi_coll_tuned_preq_t *preq;
+
+    preq = OBJ_NEW(ompi_coll_tuned_preq_t);
+    if (NULL == preq) {
+        return NULL;
+    }
+
+    OMPI_REQUEST_INIT(&preq->super.super, true);
+    preq->super.super.req_type = OMPI_REQUEST_COLL;
+    preq->super.super.req_mpi_object.comm = comm;
+    preq->super.super.req_start = coll_tuned_preq_start;
+    preq->super.super.req_free = coll_tuned_preq_free;
+    preq->super.super.req_cancel = coll_tuned_preq_cancel;
+    preq->comm = comm;
+
+    /* the initialization is collective, so all the processes pick the
+     * same tag */
+    preq->tag = tuned_module->persistent_tag--;
+    if (preq->tag == MCA_COLL_BASE_TAG_PERSISTENT_END) {
+        preq->tag = tuned_module->persistent_tag = MCA_COLL_BASE_TAG_PERSISTENT_BASE;
+    }
+
+    /* the application may free them before the request */
+    if (NULL != op) {
+        OBJ_RETAIN(op);
+        preq->op = op;
+    }
+    if (NULL != type0) {
+        OBJ_RETAIN(type0);
+        preq->types[0] = type0;
+    }
+    if (NULL != type1) {
+        OBJ_RETAIN(type1);
+        preq->types[1] = type1;
+    }
+
+    return preq;
+}
+
+static inline void coll_tuned_preq_return(ompi_coll_tuned_preq_t *preq, int err,
+                                          ompi_request_t **request)
+{
+    if (MPI_SUCCESS == err) {
+        *request = &preq->super.super;
+    } else {
+        OBJ_RELEASE(preq);
+    }
+}
+
+/*
+ * Broadcast
+ */
+
+/* the segments are received from the parent, and forwarded to the
+ * children one step later */
+static int coll_tuned_preq_bcast_tree(ompi_coll_tuned_preq_t *preq, char *buffer, int count,
+                                      ompi_datatype_t *datatype, ompi_coll_tree_t *tree,
+                                      int segcount)
+{
+    int rank = ompi_comm_rank(preq->comm), num_segments, err = MPI_SUCCESS;
+    ptrdiff_t lb, extent;
+
+    if (0 == count) {
+        return MPI_SUCCESS;
+    }
+    ompi_datatype_get_extent(datatype, &lb, &extent);
+    num_segments = (count + segcount - 1) / segcount;
+
+    for (int s = 0 ; s <= num_segments && MPI_SUCCESS == err ; ++s) {
+        if (rank == tree->tree_root) {
+            if (s == num_segments) {
+                break;
+            }
+        } else if (s < num_segments) {
+            err = coll_tuned_preq_recv(preq, buffer + (ptrdiff_t) s * segcount * extent,
+                                       s < num_segments - 1 ? segcount : count - s * segcount,
+                                       datatype, tree->tree_prev);
+        }
+        /* the root sends segment s, the others forward segment s - 1 */
+        if (rank == tree->tree_root || s > 0) {
+            int seg = rank == tree->tree_root ? s : s - 1;
+
+            for (int i = 0 ; i < tree->tree_nextsize && MPI_SUCCESS == err ; ++i) {
+                err = coll_tuned_preq_send(preq, buffer + (ptrdiff_t) seg * segcount * extent,
+                                           seg < num_segments - 1 ? segcount : count - seg * segcount,
+                                           datatype, tree->tree_next[i]);
+            }
+        }
+        /* the leaves post all their receives at once */
+        if (tree->tree_nextsize > 0) {
+            coll_tuned_preq_end_step(preq);
+        }
+    }
+
+    return err;
+}
+
+/* same decision as ompi_coll_tuned_bcast_intra_dec_fixed, the split binary
+ * trees being replaced by binary trees */
+int ompi_coll_tuned_bcast_intra_init(void *buff, int count,
+                                     struct ompi_datatype_t *datatype, int root,
+                                     struct ompi_communicator_t *comm,
+                                     struct ompi_info_t *info, ompi_request_t **request,
+                                     mca_coll_base_module_t *module)
+{
+    const size_t small_message_size = 2048;
+    const size_t intermediate_message_size = 370728;
+    const double a_p16  = 3.2118e-6; /* [1 / byte] */
+    const double b_p16  = 8.7936;
+    const double a_p64  = 2.3679e-6; /* [1 / byte] */
+    const double b_p64  = 1.1787;
+    const double a_p128 = 1.6134e-6; /* [1 / byte] */
+    const double b_p128 = 2.1102;
+    int communicator_size = ompi_comm_size(comm), segsize, segcount = count, err;
+    size_t message_size, dsize;
+    ompi_coll_tree_t *tree;
+    ompi_coll_tuned_preq_t *preq;
+
+    ompi_datatype_type_size(datatype, &dsize);
+    message_size = dsize * (unsigned long)count;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_bcast_intra_init"
+                 " root %d rank %d com_size %d msg_length %lu",
+                 root, ompi_comm_rank(comm), communicator_size, (unsigned long)message_size));
+
+    if ((message_size < small_message_size) || (count <= 1)) {
+        /* Binomial without segmentation */
+        segsize = 0;
+        tree = ompi_coll_base_topo_build_bmtree(comm, root);
+    } else if (message_size < intermediate_message_size) {
+        /* Binary with 1KB segments */
+        segsize = 1024;
+        tree = ompi_coll_base_topo_build_tree(2, comm, root);
+    } else if (communicator_size < (a_p128 * message_size + b_p128)) {
+        /* Pipeline with 128KB segments */
+        segsize = 1024 << 7;
+        tree = ompi_coll_base_topo_build_chain(1, comm, root);
+    } else if (communicator_size < 13) {
+        /* Binary with 8KB segments */
+        segsize = 1024 << 3;
+        tree = ompi_coll_base_topo_build_tree(2, comm, root);
+    } else if (communicator_size < (a_p64 * message_size + b_p64)) {
+        /* Pipeline with 64KB segments */
+        segsize = 1024 << 6;
+        tree = ompi_coll_base_topo_build_chain(1, comm, root);
+    } else if (communicator_size < (a_p16 * message_size + b_p16)) {
+        /* Pipeline with 16KB segments */
+        segsize = 1024 << 4;
+        tree = ompi_coll_base_topo_build_chain(1, comm, root);
+    } else {
+        /* Pipeline with 8KB segments */
+        segsize = 1024 << 3;
+        tree = ompi_coll_base_topo_build_chain(1, comm, root);
+    }
+    if (NULL == tree) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    COLL_BASE_COMPUTED_SEGCOUNT((size_t)segsize, dsize, segcount);
+
+    preq = coll_tuned_preq_new(comm, module, NULL, NULL, NULL);
+    if (NULL == preq) {
+        ompi_coll_base_topo_destroy_tree(&tree);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    err = coll_tuned_preq_bcast_tree(preq, (char *) buff, count, datatype, tree, segcount);
+    ompi_coll_base_topo_destroy_tree(&tree);
+
+    coll_tuned_preq_return(preq, err, request);
+    return err;
+}
+
+/*
+ * Allreduce
+ */
+
+/* the result is accumulated in rbuf, the data of the peers is received in
+ * the temporary buffer */
+static int coll_tuned_preq_allreduce_recursivedoubling(ompi_coll_tuned_preq_t *preq, char *rbuf,
+                                                       int count, ompi_datatype_t *dtype)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm);
+    int adjsize, extra_ranks, newrank, distance, err = MPI_SUCCESS;
+    bool commute = ompi_op_is_commute(preq->op);
+    char *tmpbuf;
+
+    err = coll_tuned_preq_tmpbuf(preq, dtype, count, &tmpbuf);
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+
+    /* Determine nearest power of two less than or equal to size */
+    adjsize = opal_next_poweroftwo(size) >> 1;
+
+    /* the first 2 * extra_ranks processes are paired, the even ones sit
+       out the exchanges */
+    extra_ranks = size - adjsize;
+    if (rank < 2 * extra_ranks) {
+        if (0 == (rank % 2)) {
+            err = coll_tuned_preq_send(preq, rbuf, count, dtype, rank + 1);
+            newrank = -1;
+        } else {
+            err = coll_tuned_preq_recv(preq, tmpbuf, count, dtype, rank - 1);
+            if (MPI_SUCCESS == err) {
+                err = coll_tuned_preq_reduce(preq, tmpbuf, rbuf, count, dtype);
+            }
+            newrank = rank >> 1;
+        }
+        coll_tuned_preq_end_step(preq);
+    } else {
+        newrank = rank - extra_ranks;
+    }
+
+    for (distance = 0x1 ; distance < adjsize && newrank >= 0 && MPI_SUCCESS == err ; distance <<= 1) {
+        int newremote = newrank ^ distance;
+        int remote = (newremote < extra_ranks) ? (newremote * 2 + 1) : (newremote + extra_ranks);
+
+        err = coll_tuned_preq_send(preq, rbuf, count, dtype, remote);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, tmpbuf, count, dtype, remote);
+        }
+        if (MPI_SUCCESS != err) {
+            break;
+        }
+        /* result = lower ranks (op) higher ranks */
+        if (commute || remote < rank) {
+            err = coll_tuned_preq_reduce(preq, tmpbuf, rbuf, count, dtype);
+        } else {
+            err = coll_tuned_preq_reduce(preq, rbuf, tmpbuf, count, dtype);
+            if (MPI_SUCCESS == err) {
+                err = coll_tuned_preq_copy(preq, tmpbuf, count, dtype, rbuf, count, dtype);
+            }
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+    if (rank < 2 * extra_ranks && MPI_SUCCESS == err) {
+        if (0 == (rank % 2)) {
+            err = coll_tuned_preq_recv(preq, rbuf, count, dtype, rank + 1);
+        } else {
+            err = coll_tuned_preq_send(preq, rbuf, count, dtype, rank - 1);
+        }
+    }
+
+    return err;
+}
+
+/* reduce-scatter then allgather along a ring, for commutative operations
+ * and count > size */
+static int coll_tuned_preq_allreduce_ring(ompi_coll_tuned_preq_t *preq, char *rbuf,
+                                          int count, ompi_datatype_t *dtype)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm);
+    int split_rank, early_blockcount, late_blockcount, err = MPI_SUCCESS;
+    int send_to = (rank + 1) % size, recv_from = (rank + size - 1) % size;
+    ptrdiff_t lb, extent;
+    char *tmpbuf;
+
+#define BLOCK_COUNT(b) ((b) < split_rank ? early_blockcount : late_blockcount)
+#define BLOCK(b) (rbuf + ((ptrdiff_t) (b) * late_blockcount + ((b) < split_rank ? (b) : split_rank)) * extent)
+
+    ompi_datatype_get_extent(dtype, &lb, &extent);
+    COLL_BASE_COMPUTE_BLOCKCOUNT(count, size, split_rank, early_blockcount, late_blockcount);
+
+    err = coll_tuned_preq_tmpbuf(preq, dtype, early_blockcount, &tmpbuf);
+    if (MPI_SUCCESS != err) {
+        return err;
+    }
+
+    /* after step k, the block (rank - k - 1) contains the contributions of
+       the k + 2 processes up to rank */
+    for (int k = 0 ; k < size - 1 && MPI_SUCCESS == err ; ++k) {
+        int send_block = (rank - k + size) % size;
+        int recv_block = (rank - k - 1 + size) % size;
+
+        err = coll_tuned_preq_send(preq, BLOCK(send_block), BLOCK_COUNT(send_block), dtype, send_to);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, tmpbuf, BLOCK_COUNT(recv_block), dtype, recv_from);
+        }
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_reduce(preq, tmpbuf, BLOCK(recv_block), BLOCK_COUNT(recv_block), dtype);
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+    /* the block (rank + 1) is complete, circulate the complete blocks */
+    for (int k = 0 ; k < size - 1 && MPI_SUCCESS == err ; ++k) {
+        int send_block = (rank + 1 - k + size) % size;
+        int recv_block = (rank - k + size) % size;
+
+        err = coll_tuned_preq_send(preq, BLOCK(send_block), BLOCK_COUNT(send_block), dtype, send_to);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, BLOCK(recv_block), BLOCK_COUNT(recv_block), dtype, recv_from);
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+#undef BLOCK
+#undef BLOCK_COUNT
+
+    return err;
+}
+
+/* same decision as ompi_coll_tuned_allreduce_intra_dec_fixed, with the
+ * segmented ring replaced by the ring, and the nonoverlapping algorithm by
+ * recursive doubling */
+int ompi_coll_tuned_allreduce_intra_init(const void *sbuf, void *rbuf, int count,
+                                         struct ompi_datatype_t *dtype,
+                                         struct ompi_op_t *op,
+                                         struct ompi_communicator_t *comm,
+                                         struct ompi_info_t *info, ompi_request_t **request,
+                                         mca_coll_base_module_t *module)
+{
+    size_t dsize, block_dsize;
+    int comm_size = ompi_comm_size(comm), err;
+    const size_t intermediate_message = 10000;
+    ompi_coll_tuned_preq_t *preq;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_allreduce_intra_init"));
+
+    ompi_datatype_type_size(dtype, &dsize);
+    block_dsize = dsize * (ptrdiff_t)count;
+
+    preq = coll_tuned_preq_new(comm, module, op, dtype, NULL);
+    if (NULL == preq) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    err = MPI_SUCCESS;
+    if (MPI_IN_PLACE != sbuf) {
+        err = coll_tuned_preq_copy(preq, sbuf, count, dtype, rbuf, count, dtype);
+    }
+    if (MPI_SUCCESS == err) {
+        if (block_dsize >= intermediate_message && ompi_op_is_commute(op) && count > comm_size) {
+            err = coll_tuned_preq_allreduce_ring(preq, (char *) rbuf, count, dtype);
+        } else {
+            err = coll_tuned_preq_allreduce_recursivedoubling(preq, (char *) rbuf, count, dtype);
+        }
+    }
+
+    coll_tuned_preq_return(preq, err, request);
+    return err;
+}
+
+/*
+ * Allgather
+ */
+
+static int coll_tuned_preq_allgather_recursivedoubling(ompi_coll_tuned_preq_t *preq, char *rbuf,
+                                                       int rcount, ompi_datatype_t *rdtype)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm), err = MPI_SUCCESS;
+    ptrdiff_t lb, extent, block;
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    block = (ptrdiff_t) rcount * extent;
+
+    /* before the exchange at distance, each process has the blocks of the
+       distance processes of its group */
+    for (int distance = 1 ; distance < size && MPI_SUCCESS == err ; distance <<= 1) {
+        int remote = rank ^ distance;
+
+        err = coll_tuned_preq_send(preq, rbuf + (rank & ~(distance - 1)) * block,
+                                   (size_t) distance * rcount, rdtype, remote);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, rbuf + (remote & ~(distance - 1)) * block,
+                                       (size_t) distance * rcount, rdtype, remote);
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+    return err;
+}
+
+static int coll_tuned_preq_allgather_bruck(ompi_coll_tuned_preq_t *preq, char *rbuf,
+                                           int rcount, ompi_datatype_t *rdtype)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm), err = MPI_SUCCESS;
+    ptrdiff_t lb, extent, block;
+    char *shift_buf;
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    block = (ptrdiff_t) rcount * extent;
+
+    /* the block of the process is moved to the beginning of rbuf */
+    err = coll_tuned_preq_copy(preq, rbuf + rank * block, rcount, rdtype, rbuf, rcount, rdtype);
+
+    /* each step doubles the number of blocks, received after the others
+       from rank + distance */
+    for (int distance = 1 ; distance < size && MPI_SUCCESS == err ; distance <<= 1) {
+        int blockcount = distance <= (size >> 1) ? distance : size - distance;
+
+        err = coll_tuned_preq_send(preq, rbuf, (size_t) blockcount * rcount, rdtype,
+                                   (rank - distance + size) % size);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, rbuf + distance * block, (size_t) blockcount * rcount,
+                                       rdtype, (rank + distance) % size);
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+    /* block i is the one of rank + i, shift them locally */
+    if (0 != rank && MPI_SUCCESS == err) {
+        err = coll_tuned_preq_tmpbuf(preq, rdtype, (int64_t)(size - rank) * rcount, &shift_buf);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+        err = coll_tuned_preq_copy(preq, rbuf, (size - rank) * rcount, rdtype,
+                                   shift_buf, (size - rank) * rcount, rdtype);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_copy(preq, rbuf + (size - rank) * block, rank * rcount, rdtype,
+                                       rbuf, rank * rcount, rdtype);
+        }
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_copy(preq, shift_buf, (size - rank) * rcount, rdtype,
+                                       rbuf + rank * block, (size - rank) * rcount, rdtype);
+        }
+    }
+
+    return err;
+}
+
+static int coll_tuned_preq_allgather_ring(ompi_coll_tuned_preq_t *preq, char *rbuf,
+                                          int rcount, ompi_datatype_t *rdtype)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm), err = MPI_SUCCESS;
+    ptrdiff_t lb, extent, block;
+
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+    block = (ptrdiff_t) rcount * extent;
+
+    /* at step k, the block of rank - k is forwarded to the right */
+    for (int k = 0 ; k < size - 1 && MPI_SUCCESS == err ; ++k) {
+        err = coll_tuned_preq_send(preq, rbuf + ((rank - k + size) % size) * block, rcount, rdtype,
+                                   (rank + 1) % size);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_recv(preq, rbuf + ((rank - k - 1 + size) % size) * block, rcount,
+                                       rdtype, (rank - 1 + size) % size);
+        }
+        coll_tuned_preq_end_step(preq);
+    }
+
+    return err;
+}
+
+/* same decision as ompi_coll_tuned_allgather_intra_dec_fixed, the neighbor
+ * exchange being replaced by the ring */
+int ompi_coll_tuned_allgather_intra_init(const void *sbuf, int scount,
+                                         struct ompi_datatype_t *sdtype,
+                                         void *rbuf, int rcount,
+                                         struct ompi_datatype_t *rdtype,
+                                         struct ompi_communicator_t *comm,
+                                         struct ompi_info_t *info, ompi_request_t **request,
+                                         mca_coll_base_module_t *module)
+{
+    int communicator_size = ompi_comm_size(comm), rank = ompi_comm_rank(comm), pow2_size, err;
+    size_t dsize, total_dsize;
+    ptrdiff_t lb, extent;
+    ompi_coll_tuned_preq_t *preq;
+
+    ompi_datatype_type_size(rdtype, &dsize);
+    total_dsize = dsize * (ptrdiff_t)rcount * (ptrdiff_t)communicator_size;
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_allgather_intra_init"
+                 " rank %d com_size %d msg_length %lu",
+                 rank, communicator_size, (unsigned long)total_dsize));
+
+    preq = coll_tuned_preq_new(comm, module, NULL,
+                               MPI_IN_PLACE != sbuf ? sdtype : NULL, rdtype);
+    if (NULL == preq) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* the block of the process */
+    err = MPI_SUCCESS;
+    if (MPI_IN_PLACE != sbuf) {
+        ompi_datatype_get_extent(rdtype, &lb, &extent);
+        err = coll_tuned_preq_copy(preq, sbuf, scount, sdtype,
+                                   (char *) rbuf + (ptrdiff_t) rank * rcount * extent,
+                                   rcount, rdtype);
+    }
+
+    pow2_size = opal_next_poweroftwo_inclusive(communicator_size);
+    if (MPI_SUCCESS != err) {
+        /* nothing */
+    } else if (pow2_size == communicator_size && (2 == communicator_size || total_dsize < 50000)) {
+        err = coll_tuned_preq_allgather_recursivedoubling(preq, (char *) rbuf, rcount, rdtype);
+    } else if (total_dsize < 50000) {
+        err = coll_tuned_preq_allgather_bruck(preq, (char *) rbuf, rcount, rdtype);
+    } else {
+        err = coll_tuned_preq_allgather_ring(preq, (char *) rbuf, rcount, rdtype);
+    }
+
+    coll_tuned_preq_return(preq, err, request);
+    return err;
+}
+
+/*
+ * Alltoall
+ */
+
+/* the exchanges with the peers at distance 1 to size - 1 are done
+ * window peers per step */
+static int coll_tuned_preq_alltoall_linear(ompi_coll_tuned_preq_t *preq,
+                                           const char *sbuf, int scount, ompi_datatype_t *sdtype,
+                                           char *rbuf, int rcount, ompi_datatype_t *rdtype,
+                                           int window)
+{
+    int rank = ompi_comm_rank(preq->comm), size = ompi_comm_size(preq->comm), err = MPI_SUCCESS;
+    ptrdiff_t lb, sext, rext;
+
+    ompi_datatype_get_extent(sdtype, &lb, &sext);
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+
+    for (int i = 1 ; i < size && MPI_SUCCESS == err ; ++i) {
+        int from = (rank + i) % size, to = (rank - i + size) % size;
+
+        err = coll_tuned_preq_recv(preq, rbuf + (ptrdiff_t) from * rcount * rext, rcount, rdtype, from);
+        if (MPI_SUCCESS == err) {
+            err = coll_tuned_preq_send(preq, sbuf + (ptrdiff_t) to * scount * sext, scount, sdtype, to);
+        }
+        if (0 == i % window) {
+            coll_tuned_preq_end_step(preq);
+        }
+    }
+
+    return err;
+}
+
+/* same decision as ompi_coll_tuned_alltoall_intra_dec_fixed, the bruck
+ * algorithm being replaced by the linear one, and the two processes one
+ * by the pairwise one */
+int ompi_coll_tuned_alltoall_intra_init(const void *sbuf, int scount,
+                                        struct ompi_datatype_t *sdtype,
+                                        void *rbuf, int rcount,
+                                        struct ompi_datatype_t *rdtype,
+                                        struct ompi_communicator_t *comm,
+                                        struct ompi_info_t *info, ompi_request_t **request,
+                                        mca_coll_base_module_t *module)
+{
+    int communicator_size = ompi_comm_size(comm), rank = ompi_comm_rank(comm), window, err;
+    size_t dsize, block_dsize;
+    ptrdiff_t lb, sext, rext;
+    ompi_coll_tuned_preq_t *preq;
+
+    preq = coll_tuned_preq_new(comm, module, NULL,
+                               MPI_IN_PLACE != sbuf ? sdtype : NULL, rdtype);
+    if (NULL == preq) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    err = MPI_SUCCESS;
+    if (MPI_IN_PLACE == sbuf) {
+        /* send from a copy of the receive buffer */
+        char *tmpbuf;
+
+        sdtype = rdtype;
+        scount = rcount;
+        err = coll_tuned_preq_tmpbuf(preq, rdtype, (int64_t) communicator_size * rcount, &tmpbuf);
+        if (MPI_SUCCESS == err) {
+            sbuf = tmpbuf;
+            err = coll_tuned_preq_copy(preq, rbuf, communicator_size * rcount, rdtype,
+                                       (void *) sbuf, communicator_size * rcount, rdtype);
+        }
+    }
+    if (MPI_SUCCESS != err) {
+        coll_tuned_preq_return(preq, err, request);
+        return err;
+    }
+
+    ompi_datatype_type_size(sdtype, &dsize);
+    block_dsize = dsize * (ptrdiff_t)scount;
+    ompi_datatype_get_extent(sdtype, &lb, &sext);
+    ompi_datatype_get_extent(rdtype, &lb, &rext);
+
+    if (2 != communicator_size && block_dsize < (size_t) ompi_coll_tuned_alltoall_intermediate_msg) {
+        window = communicator_size;
+    } else if (2 != communicator_size &&
+               block_dsize < (size_t) ompi_coll_tuned_alltoall_large_msg &&
+               communicator_size <= ompi_coll_tuned_alltoall_min_procs) {
+        /* a send and a receive per peer */
+        window = ompi_coll_tuned_alltoall_max_requests / 2;
+        if (window < 1) {
+            window = ompi_coll_tuned_alltoall_max_requests > 0 ? 1 : communicator_size;
+        }
+    } else {
+        /* pairwise */
+        window = 1;
+    }
+
+    OPAL_OUTPUT((ompi_coll_tuned_stream, "ompi_coll_tuned_alltoall_intra_init"
+                 " rank %d com_size %d block_dsize %lu window %d",
+                 rank, communicator_size, (unsigned long)block_dsize, window));
+
+    err = coll_tuned_preq_alltoall_linear(preq, sbuf, scount, sdtype, (char *) rbuf,
+                                          rcount, rdtype, window);
+    if (MPI_SUCCESS == err) {
+        /* the block of the process, once the receives of the first step
+           completed */
+        err = coll_tuned_preq_copy(preq, (char *) sbuf + (ptrdiff_t) rank * scount * sext,
+                                   scount, sdtype, (char *) rbuf + (ptrdiff_t) rank * rcount * rext,
+                                   rcount, rdtype);
+    }
+
+    coll_tuned_preq_return(preq, err, request);
+    return err;
+}
+
+int ompi_coll_tuned_persistent_open(void)
+{
+    OBJ_CONSTRUCT(&coll_tuned_preq_active, opal_list_t);
+    OBJ_CONSTRUCT(&coll_tuned_preq_lock, opal_mutex_t);
+
+    return OMPI_SUCCESS;
+}
+
+void ompi_coll_tuned_persistent_close(void)
+{
+    if (coll_tuned_preq_registered) {
+        opal_progress_unregister(coll_tuned_preq_progress);
+        coll_tuned_preq_registered = false;
+    }
+    OBJ_DESTRUCT(&coll_tuned_preq_active);
+    OBJ_DESTRUCT(&coll_tuned_preq_lock);
+}
@@ -37,6 +37,7 @@ static mca_base_var_enum_value_t reduce_scatter_block_algorithms[] = {
     {2, "recursive_doubling"},
     {3, "recursive_halving"},
     {4, "butterfly"},
+    {5, "ring_segmented"},
     {0, NULL}
 };
 
@@ -77,7 +78,7 @@ int ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init (coll_tuned_for
                                         "reduce_scatter_block_algorithm",
                                         "Which reduce reduce_scatter_block algorithm is used. "
                                         "Can be locked down to choice of: 0 ignore, 1 basic_linear, 2 recursive_doubling, "
-                                        "3 recursive_halving, 4 butterfly",
+                                        "3 recursive_halving, 4 butterfly, 5 segmented ring",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_ALL,
@@ -132,6 +133,8 @@ int ompi_coll_tuned_reduce_scatter_block_intra_do_this(const void *sbuf, void *r
                                                                                 dtype, op, comm, module);
     case (4): return ompi_coll_base_reduce_scatter_block_intra_butterfly(sbuf, rbuf, rcount, dtype, op, comm, 
                                                                          module);
+    case (5): return ompi_coll_base_reduce_scatter_block_intra_ring_segmented(sbuf, rbuf, rcount, dtype, op,
+                                                                              comm, module, segsize);
     } /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream, "coll:tuned:reduce_scatter_block_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                  algorithm, ompi_coll_tuned_forced_max_algorithms[REDUCESCATTERBLOCK]));
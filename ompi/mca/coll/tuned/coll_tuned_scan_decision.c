@@ -24,12 +24,15 @@
 
 /* scan algorithm variables */
 static int coll_tuned_scan_forced_algorithm = 0;
+static int coll_tuned_scan_segment_size = 0;
 
 /* valid values for coll_tuned_scan_forced_algorithm */
 static mca_base_var_enum_value_t scan_algorithms[] = {
     {0, "ignore"},
     {1, "linear"},
     {2, "recursive_doubling"},
+    {3, "binomial"},
+    {4, "pipeline"},
     {0, NULL}
 };
 
@@ -68,7 +71,7 @@ int ompi_coll_tuned_scan_intra_check_forced_init (coll_tuned_force_algorithm_mca
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "scan_algorithm",
-                                        "Which scan algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 recursive_doubling",
+                                        "Which scan algorithm is used. Can be locked down to choice of: 0 ignore, 1 linear, 2 recursive_doubling, 3 binomial (up-sweep/down-sweep), 4 pipeline",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
                                         MCA_BASE_VAR_SCOPE_ALL,
@@ -78,6 +81,16 @@ int ompi_coll_tuned_scan_intra_check_forced_init (coll_tuned_force_algorithm_mca
         return mca_param_indices->algorithm_param_index;
     }
 
+    coll_tuned_scan_segment_size = 0;
+    mca_param_indices->segsize_param_index =
+        mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                        "scan_algorithm_segmentsize",
+                                        "Segment size in bytes used by default for scan algorithms. Only has meaning if algorithm is forced and supports segmenting. 0 bytes means no segmentation.",
+                                        MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                        OPAL_INFO_LVL_5,
+                                        MCA_BASE_VAR_SCOPE_ALL,
+                                        &coll_tuned_scan_segment_size);
+
     return (MPI_SUCCESS);
 }
 
@@ -86,17 +99,22 @@ int ompi_coll_tuned_scan_intra_do_this(const void *sbuf, void* rbuf, int count,
                                          struct ompi_op_t *op,
                                          struct ompi_communicator_t *comm,
                                          mca_coll_base_module_t *module,
-                                         int algorithm)
+                                         int algorithm, int segsize)
 {
-    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this selected algorithm %d",
-                 algorithm));
+    OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this selected algorithm %d segsize %d",
+                 algorithm, segsize));
 
     switch (algorithm) {
-    case (0):
+    case (0):  return ompi_coll_tuned_scan_intra_dec_fixed(sbuf, rbuf, count, dtype,
+                                                           op, comm, module);
     case (1):  return ompi_coll_base_scan_intra_linear(sbuf, rbuf, count, dtype,
                                                        op, comm, module);
     case (2):  return ompi_coll_base_scan_intra_recursivedoubling(sbuf, rbuf, count, dtype,
                                                                   op, comm, module);
+    case (3):  return ompi_coll_base_scan_intra_binomial(sbuf, rbuf, count, dtype,
+                                                         op, comm, module);
+    case (4):  return ompi_coll_base_scan_intra_pipeline(sbuf, rbuf, count, dtype,
+                                                         op, comm, module, segsize);
     } /* switch */
     OPAL_OUTPUT((ompi_coll_tuned_stream,"coll:tuned:scan_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
                  algorithm, ompi_coll_tuned_forced_max_algorithms[SCAN]));
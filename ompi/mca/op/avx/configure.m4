@@ -0,0 +1,101 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2026      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# OMPI_OP_AVX_CHECK_ISA(name, flags, test-body, [action-if-found], [action-if-not-found])
+# ---------------------------------------------------------------------------------------
+# Check whether the compiler accepts the given flags and can build a
+# program using the intrinsics of the corresponding instruction set.
+AC_DEFUN([OMPI_OP_AVX_CHECK_ISA],[
+    AC_MSG_CHECKING([if $CC supports $1 intrinsics with $2])
+    op_avx_CFLAGS_save="$CFLAGS"
+    CFLAGS="$CFLAGS $2"
+    AC_LINK_IFELSE([AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                    [[$3]])],
+                   [op_avx_isa_happy=1],
+                   [op_avx_isa_happy=0])
+    CFLAGS="$op_avx_CFLAGS_save"
+    AS_IF([test $op_avx_isa_happy -eq 1],
+          [AC_MSG_RESULT([yes])
+           $4],
+          [AC_MSG_RESULT([no])
+           $5])
+])dnl
+
+# MCA_ompi_op_avx_CONFIG([action-if-can-compile],
+#                        [action-if-cant-compile])
+# ------------------------------------------------
+AC_DEFUN([MCA_ompi_op_avx_CONFIG],[
+    AC_CONFIG_FILES([ompi/mca/op/avx/Makefile])
+
+    op_sse41_support=0
+    op_avx2_support=0
+    op_avx512_support=0
+    op_avx_cpu_detect=0
+
+    # The kernels are only meaningful on x86 processors
+    case "${host}" in
+        x86_64-*|i?86-*)
+            op_avx_on_x86=1 ;;
+        *)
+            op_avx_on_x86=0 ;;
+    esac
+
+    AS_IF([test $op_avx_on_x86 -eq 1],
+          [AC_MSG_CHECKING([for __builtin_cpu_supports])
+           AC_LINK_IFELSE([AC_LANG_PROGRAM([[]],
+                                           [[__builtin_cpu_init();
+                                             return __builtin_cpu_supports("avx2");]])],
+                          [op_avx_cpu_detect=1
+                           AC_MSG_RESULT([yes])],
+                          [AC_MSG_RESULT([no])])])
+
+    AS_IF([test $op_avx_cpu_detect -eq 1],
+          [OMPI_OP_AVX_CHECK_ISA([AVX-512], [-mavx512f -mavx512bw],
+                                 [[__m512i a = _mm512_set1_epi8(1);
+                                   a = _mm512_max_epi8(_mm512_add_epi16(a, a), a);
+                                   return _mm512_cmpeq_epi64_mask(a, a) == 0;]],
+                                 [op_avx512_support=1
+                                  MCA_BUILD_OP_AVX512_FLAGS="-mavx512f -mavx512bw"])
+           OMPI_OP_AVX_CHECK_ISA([AVX2], [-mavx2],
+                                 [[__m256i a = _mm256_set1_epi8(1);
+                                   a = _mm256_max_epu16(_mm256_mullo_epi32(a, a), a);
+                                   return _mm256_movemask_epi8(a) == 0;]],
+                                 [op_avx2_support=1
+                                  MCA_BUILD_OP_AVX2_FLAGS="-mavx2"])
+           OMPI_OP_AVX_CHECK_ISA([SSE4.1], [-msse4.1],
+                                 [[__m128i a = _mm_set1_epi8(1);
+                                   a = _mm_max_epi8(_mm_mullo_epi32(a, a), a);
+                                   return _mm_movemask_epi8(a) == 0;]],
+                                 [op_sse41_support=1
+                                  MCA_BUILD_OP_SSE41_FLAGS="-msse4.1"])])
+
+    AM_CONDITIONAL([MCA_BUILD_ompi_op_has_avx512_support],
+                   [test $op_avx512_support -eq 1])
+    AM_CONDITIONAL([MCA_BUILD_ompi_op_has_avx2_support],
+                   [test $op_avx2_support -eq 1])
+    AM_CONDITIONAL([MCA_BUILD_ompi_op_has_sse41_support],
+                   [test $op_sse41_support -eq 1])
+    AC_SUBST([MCA_BUILD_OP_AVX512_FLAGS])
+    AC_SUBST([MCA_BUILD_OP_AVX2_FLAGS])
+    AC_SUBST([MCA_BUILD_OP_SSE41_FLAGS])
+
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX512], [$op_avx512_support],
+                       [Whether the op/avx component provides AVX-512 kernels])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_AVX2], [$op_avx2_support],
+                       [Whether the op/avx component provides AVX2 kernels])
+    AC_DEFINE_UNQUOTED([OMPI_MCA_OP_HAVE_SSE41], [$op_sse41_support],
+                       [Whether the op/avx component provides SSE4.1 kernels])
+
+    AS_IF([test $op_avx512_support -eq 1 || test $op_avx2_support -eq 1 || test $op_sse41_support -eq 1],
+          [$1],
+          [$2])
+])dnl
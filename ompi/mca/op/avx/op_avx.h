@@ -0,0 +1,87 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_OP_AVX_EXPORT_H
+#define MCA_OP_AVX_EXPORT_H
+
+#include "ompi_config.h"
+
+#include "ompi/mca/mca.h"
+#include "opal/class/opal_object.h"
+
+#include "ompi/mca/op/op.h"
+
+BEGIN_C_DECLS
+
+/**
+ * Instruction sets for which the component may provide kernels.
+ * Used as bits both for what was compiled in and for what the
+ * processor supports.
+ */
+#define OMPI_OP_AVX_HAS_SSE41_FLAG   0x0001
+#define OMPI_OP_AVX_HAS_AVX2_FLAG    0x0002
+#define OMPI_OP_AVX_HAS_AVX512_FLAG  0x0004
+
+/**
+ * Derive a struct from the base op component struct, allowing us to
+ * cache some component-specific information on our well-known
+ * component struct.
+ */
+typedef struct {
+    /** The base op component struct */
+    ompi_op_base_component_1_0_0_t super;
+
+    /** Instruction sets for which kernels were compiled in */
+    int32_t supported;
+    /** Instruction sets supported by the processor, restricted by the
+        user through the "support" MCA parameter */
+    int32_t flags;
+    /** Priority of the component */
+    int priority;
+} ompi_op_avx_component_t;
+
+/**
+ * Globally exported variable.  Note that it is a *avx* component
+ * (defined above), which has the ompi_op_base_component_t as its
+ * first member.
+ */
+OMPI_DECLSPEC extern ompi_op_avx_component_t
+    mca_op_avx_component;
+
+/*
+ * Function tables, one set per instruction set.  Each table is
+ * indexed like ompi_op_base_functions; a NULL entry means the
+ * (operation, type) pair has no vectorized kernel for this
+ * instruction set and the base function is kept.
+ */
+#if OMPI_MCA_OP_HAVE_AVX512
+extern ompi_op_base_handler_fn_t
+    ompi_op_avx_functions_avx512[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+extern ompi_op_base_3buff_handler_fn_t
+    ompi_op_avx_3buff_functions_avx512[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+#endif  /* OMPI_MCA_OP_HAVE_AVX512 */
+#if OMPI_MCA_OP_HAVE_AVX2
+extern ompi_op_base_handler_fn_t
+    ompi_op_avx_functions_avx2[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+extern ompi_op_base_3buff_handler_fn_t
+    ompi_op_avx_3buff_functions_avx2[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+#endif  /* OMPI_MCA_OP_HAVE_AVX2 */
+#if OMPI_MCA_OP_HAVE_SSE41
+extern ompi_op_base_handler_fn_t
+    ompi_op_avx_functions_sse41[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+extern ompi_op_base_3buff_handler_fn_t
+    ompi_op_avx_3buff_functions_sse41[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX];
+#endif  /* OMPI_MCA_OP_HAVE_SSE41 */
+
+END_C_DECLS
+
+#endif /* MCA_OP_AVX_EXPORT_H */
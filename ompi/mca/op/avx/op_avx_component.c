@@ -0,0 +1,230 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * This is the "avx" op component source code.  It provides SIMD
+ * versions of the MPI predefined operations for the SSE4.1, AVX2 and
+ * AVX-512 instruction sets.  The best instruction set supported both
+ * by the build and by the processor is selected once, at
+ * initialization, using the cpuid information.
+ */
+
+#include "ompi_config.h"
+
+#include "opal/util/output.h"
+
+#include "ompi/constants.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/base/base.h"
+#include "ompi/mca/op/avx/op_avx.h"
+
+static int avx_component_open(void);
+static int avx_component_close(void);
+static int avx_component_init_query(bool enable_progress_threads,
+                                    bool enable_mpi_thread_multiple);
+static struct ompi_op_base_module_1_0_0_t *
+    avx_component_op_query(struct ompi_op_t *op, int *priority);
+static int avx_component_register(void);
+
+ompi_op_avx_component_t mca_op_avx_component = {
+    {
+        .opc_version = {
+            OMPI_OP_BASE_VERSION_1_0_0,
+
+            .mca_component_name = "avx",
+            MCA_BASE_MAKE_VERSION(component, OMPI_MAJOR_VERSION, OMPI_MINOR_VERSION,
+                                  OMPI_RELEASE_VERSION),
+            .mca_open_component = avx_component_open,
+            .mca_close_component = avx_component_close,
+            .mca_register_component_params = avx_component_register,
+        },
+        .opc_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+
+        .opc_init_query = avx_component_init_query,
+        .opc_op_query = avx_component_op_query,
+    },
+};
+
+/*
+ * Instruction sets compiled into this component
+ */
+static int32_t avx_component_compiled_flags(void)
+{
+    int32_t flags = 0;
+#if OMPI_MCA_OP_HAVE_AVX512
+    flags |= OMPI_OP_AVX_HAS_AVX512_FLAG;
+#endif
+#if OMPI_MCA_OP_HAVE_AVX2
+    flags |= OMPI_OP_AVX_HAS_AVX2_FLAG;
+#endif
+#if OMPI_MCA_OP_HAVE_SSE41
+    flags |= OMPI_OP_AVX_HAS_SSE41_FLAG;
+#endif
+    return flags;
+}
+
+/*
+ * Instruction sets supported by the processor (and enabled by the
+ * operating system)
+ */
+static int32_t avx_component_cpu_flags(void)
+{
+    int32_t flags = 0;
+
+    __builtin_cpu_init();
+    /* The AVX-512 kernels use byte and word operations */
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        flags |= OMPI_OP_AVX_HAS_AVX512_FLAG;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        flags |= OMPI_OP_AVX_HAS_AVX2_FLAG;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        flags |= OMPI_OP_AVX_HAS_SSE41_FLAG;
+    }
+    return flags;
+}
+
+/*
+ * Component open
+ */
+static int avx_component_open(void)
+{
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Component close
+ */
+static int avx_component_close(void)
+{
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Register MCA params.
+ */
+static int avx_component_register(void)
+{
+    mca_op_avx_component.supported = avx_component_compiled_flags();
+    (void) mca_base_component_var_register(&mca_op_avx_component.super.opc_version,
+                                           "capabilities",
+                                           "Instruction sets for which this component was built "
+                                           "(bitmask: 1 = SSE4.1, 2 = AVX2, 4 = AVX-512)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_DEFAULT_ONLY,
+                                           OPAL_INFO_LVL_4,
+                                           MCA_BASE_VAR_SCOPE_CONSTANT,
+                                           &mca_op_avx_component.supported);
+
+    mca_op_avx_component.flags = mca_op_avx_component.supported;
+    (void) mca_base_component_var_register(&mca_op_avx_component.super.opc_version,
+                                           "support",
+                                           "Instruction sets this component is allowed to use; "
+                                           "restricted at runtime to what the processor supports "
+                                           "(bitmask: 1 = SSE4.1, 2 = AVX2, 4 = AVX-512)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_4,
+                                           MCA_BASE_VAR_SCOPE_LOCAL,
+                                           &mca_op_avx_component.flags);
+
+    mca_op_avx_component.priority = 20;
+    (void) mca_base_component_var_register(&mca_op_avx_component.super.opc_version,
+                                           "priority",
+                                           "Priority of the avx op component",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_op_avx_component.priority);
+
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Query whether this component wants to be used in this process.
+ */
+static int avx_component_init_query(bool enable_progress_threads,
+                                    bool enable_mpi_thread_multiple)
+{
+    mca_op_avx_component.flags &= mca_op_avx_component.supported;
+    mca_op_avx_component.flags &= avx_component_cpu_flags();
+
+    opal_output_verbose(10, ompi_op_base_framework.framework_output,
+                        "op:avx: compiled support 0x%x, usable 0x%x",
+                        mca_op_avx_component.supported, mca_op_avx_component.flags);
+
+    if (0 == mca_op_avx_component.flags) {
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Query whether this component can be used for a specific op
+ */
+static struct ompi_op_base_module_1_0_0_t *
+    avx_component_op_query(struct ompi_op_t *op, int *priority)
+{
+    ompi_op_base_handler_fn_t *fns = NULL;
+    ompi_op_base_3buff_handler_fn_t *fns_3buff = NULL;
+    ompi_op_base_module_t *module;
+    bool found = false;
+    int i;
+
+    if (0 == (OMPI_OP_FLAGS_INTRINSIC & op->o_flags)) {
+        return NULL;
+    }
+
+    /* Use the widest instruction set available */
+#if OMPI_MCA_OP_HAVE_AVX512
+    if (NULL == fns && (mca_op_avx_component.flags & OMPI_OP_AVX_HAS_AVX512_FLAG)) {
+        fns = ompi_op_avx_functions_avx512[op->o_f_to_c_index];
+        fns_3buff = ompi_op_avx_3buff_functions_avx512[op->o_f_to_c_index];
+    }
+#endif
+#if OMPI_MCA_OP_HAVE_AVX2
+    if (NULL == fns && (mca_op_avx_component.flags & OMPI_OP_AVX_HAS_AVX2_FLAG)) {
+        fns = ompi_op_avx_functions_avx2[op->o_f_to_c_index];
+        fns_3buff = ompi_op_avx_3buff_functions_avx2[op->o_f_to_c_index];
+    }
+#endif
+#if OMPI_MCA_OP_HAVE_SSE41
+    if (NULL == fns && (mca_op_avx_component.flags & OMPI_OP_AVX_HAS_SSE41_FLAG)) {
+        fns = ompi_op_avx_functions_sse41[op->o_f_to_c_index];
+        fns_3buff = ompi_op_avx_3buff_functions_sse41[op->o_f_to_c_index];
+    }
+#endif
+    if (NULL == fns) {
+        return NULL;
+    }
+
+    /* The operations and types without a kernel are left NULL, so
+       that the framework keeps the previously selected functions */
+    module = OBJ_NEW(ompi_op_base_module_t);
+    for (i = 0; i < OMPI_OP_BASE_TYPE_MAX; ++i) {
+        module->opm_fns[i] = fns[i];
+        module->opm_3buff_fns[i] = fns_3buff[i];
+        found |= (NULL != fns[i]) || (NULL != fns_3buff[i]);
+    }
+    if (!found) {
+        OBJ_RELEASE(module);
+        return NULL;
+    }
+
+    *priority = mca_op_avx_component.priority;
+    return module;
+}
@@ -0,0 +1,295 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Vectorized kernels for the MPI predefined operations.  This file is
+ * compiled once per instruction set, with one of GENERATE_AVX512_CODE,
+ * GENERATE_AVX2_CODE or GENERATE_SSE41_CODE defined and the matching
+ * compiler flags, and exports one pair of function tables per
+ * instruction set.
+ */
+
+#include "ompi_config.h"
+
+#include <immintrin.h>
+
+#include "ompi/op/op.h"
+#include "ompi/mca/op/op.h"
+#include "ompi/mca/op/avx/op_avx.h"
+
+/*
+ * Instruction set specific definitions.  The vector types and most
+ * intrinsics only differ by their prefix; the integer loads, stores
+ * and bitwise operations also differ by their suffix.
+ */
+#if defined(GENERATE_AVX512_CODE)
+#define OP_AVX_ISA              avx512
+#define OP_AVX_VBYTES           64
+#define OP_AVX_MM(op)           _mm512_##op
+#define OP_AVX_ITYPE            __m512i
+#define OP_AVX_FTYPE            __m512
+#define OP_AVX_DTYPE            __m512d
+#define OP_AVX_LOADI(p)         _mm512_loadu_si512((const void*)(p))
+#define OP_AVX_STOREI(p, v)     _mm512_storeu_si512((void*)(p), (v))
+#define OP_AVX_AND(a, b)        _mm512_and_si512((a), (b))
+#define OP_AVX_OR(a, b)         _mm512_or_si512((a), (b))
+#define OP_AVX_XOR(a, b)        _mm512_xor_si512((a), (b))
+/* 64-bit integer min/max only exist with AVX-512 */
+#define OP_AVX_HAS_MINMAX_64    1
+#elif defined(GENERATE_AVX2_CODE)
+#define OP_AVX_ISA              avx2
+#define OP_AVX_VBYTES           32
+#define OP_AVX_MM(op)           _mm256_##op
+#define OP_AVX_ITYPE            __m256i
+#define OP_AVX_FTYPE            __m256
+#define OP_AVX_DTYPE            __m256d
+#define OP_AVX_LOADI(p)         _mm256_loadu_si256((const __m256i*)(p))
+#define OP_AVX_STOREI(p, v)     _mm256_storeu_si256((__m256i*)(p), (v))
+#define OP_AVX_AND(a, b)        _mm256_and_si256((a), (b))
+#define OP_AVX_OR(a, b)         _mm256_or_si256((a), (b))
+#define OP_AVX_XOR(a, b)        _mm256_xor_si256((a), (b))
+#define OP_AVX_HAS_MINMAX_64    0
+#elif defined(GENERATE_SSE41_CODE)
+#define OP_AVX_ISA              sse41
+#define OP_AVX_VBYTES           16
+#define OP_AVX_MM(op)           _mm_##op
+#define OP_AVX_ITYPE            __m128i
+#define OP_AVX_FTYPE            __m128
+#define OP_AVX_DTYPE            __m128d
+#define OP_AVX_LOADI(p)         _mm_loadu_si128((const __m128i*)(p))
+#define OP_AVX_STOREI(p, v)     _mm_storeu_si128((__m128i*)(p), (v))
+#define OP_AVX_AND(a, b)        _mm_and_si128((a), (b))
+#define OP_AVX_OR(a, b)         _mm_or_si128((a), (b))
+#define OP_AVX_XOR(a, b)        _mm_xor_si128((a), (b))
+#define OP_AVX_HAS_MINMAX_64    0
+#else
+#error "op/avx: one of GENERATE_AVX512_CODE, GENERATE_AVX2_CODE or GENERATE_SSE41_CODE must be defined"
+#endif
+
+#define OP_AVX_LOADF(p)         OP_AVX_MM(loadu_ps)((const float*)(p))
+#define OP_AVX_STOREF(p, v)     OP_AVX_MM(storeu_ps)((float*)(p), (v))
+#define OP_AVX_LOADD(p)         OP_AVX_MM(loadu_pd)((const double*)(p))
+#define OP_AVX_STORED(p, v)     OP_AVX_MM(storeu_pd)((double*)(p), (v))
+
+/* Name of a kernel, e.g. ompi_op_avx_2buff_sum_int32_t_avx2 */
+#define OP_AVX_CONCAT_(a, b)    a##_##b
+#define OP_AVX_CONCAT(a, b)     OP_AVX_CONCAT_(a, b)
+#define OP_AVX_FN(ftype, name, type) \
+    OP_AVX_CONCAT(ompi_op_avx_##ftype##_##name##_##type, OP_AVX_ISA)
+
+/* Scalar versions, used for the tail of the buffers.  They follow
+   the argument order of the base functions so that the NaN behavior
+   of the floating point min/max matches the vector instructions. */
+#define OP_AVX_S_SUM(a, b)      ((a) + (b))
+#define OP_AVX_S_PROD(a, b)     ((a) * (b))
+#define OP_AVX_S_MAX(a, b)      ((a) > (b) ? (a) : (b))
+#define OP_AVX_S_MIN(a, b)      ((a) < (b) ? (a) : (b))
+#define OP_AVX_S_BAND(a, b)     ((a) & (b))
+#define OP_AVX_S_BOR(a, b)      ((a) | (b))
+#define OP_AVX_S_BXOR(a, b)     ((a) ^ (b))
+
+/*
+ * Generate the 2-buffer (out = out op in) and 3-buffer (out = in1 op
+ * in2) kernels of an operation on a type, given the vector type, the
+ * load/store macros, the vector operation and the scalar operation.
+ */
+#define OP_AVX_FUNC(name, type, vtype, load, store, vop, sop)           \
+    static void OP_AVX_FN(2buff, name, type)(void *_in, void *_out, int *count, \
+                                             struct ompi_datatype_t **dtype, \
+                                             struct ompi_op_base_module_1_0_0_t *module) \
+    {                                                                   \
+        const int step = OP_AVX_VBYTES / sizeof(type);                  \
+        int left = *count;                                              \
+        type *in = (type*)_in, *out = (type*)_out;                      \
+        for (; left >= step; left -= step, in += step, out += step) {   \
+            vtype vin = load(in);                                       \
+            vtype vout = load(out);                                     \
+            store(out, vop(vout, vin));                                 \
+        }                                                               \
+        for (; left > 0; left--, in++, out++) {                         \
+            *out = sop(*out, *in);                                      \
+        }                                                               \
+    }                                                                   \
+    static void OP_AVX_FN(3buff, name, type)(void * restrict _in1,      \
+                                             void * restrict _in2,      \
+                                             void * restrict _out, int *count, \
+                                             struct ompi_datatype_t **dtype, \
+                                             struct ompi_op_base_module_1_0_0_t *module) \
+    {                                                                   \
+        const int step = OP_AVX_VBYTES / sizeof(type);                  \
+        int left = *count;                                              \
+        type *in1 = (type*)_in1, *in2 = (type*)_in2, *out = (type*)_out; \
+        for (; left >= step; left -= step, in1 += step, in2 += step, out += step) { \
+            vtype v1 = load(in1);                                       \
+            vtype v2 = load(in2);                                       \
+            store(out, vop(v1, v2));                                    \
+        }                                                               \
+        for (; left > 0; left--, in1++, in2++, out++) {                 \
+            *out = sop(*in1, *in2);                                     \
+        }                                                               \
+    }
+
+#define OP_AVX_INT_FUNC(name, type, vop, sop) \
+    OP_AVX_FUNC(name, type, OP_AVX_ITYPE, OP_AVX_LOADI, OP_AVX_STOREI, vop, sop)
+#define OP_AVX_FLOAT_FUNC(name, vop, sop) \
+    OP_AVX_FUNC(name, float, OP_AVX_FTYPE, OP_AVX_LOADF, OP_AVX_STOREF, vop, sop)
+#define OP_AVX_DOUBLE_FUNC(name, vop, sop) \
+    OP_AVX_FUNC(name, double, OP_AVX_DTYPE, OP_AVX_LOADD, OP_AVX_STORED, vop, sop)
+
+/*************************************************************************
+ * Sum
+ *************************************************************************/
+
+OP_AVX_INT_FUNC(sum, int8_t,   OP_AVX_MM(add_epi8),  OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, uint8_t,  OP_AVX_MM(add_epi8),  OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, int16_t,  OP_AVX_MM(add_epi16), OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, uint16_t, OP_AVX_MM(add_epi16), OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, int32_t,  OP_AVX_MM(add_epi32), OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, uint32_t, OP_AVX_MM(add_epi32), OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, int64_t,  OP_AVX_MM(add_epi64), OP_AVX_S_SUM)
+OP_AVX_INT_FUNC(sum, uint64_t, OP_AVX_MM(add_epi64), OP_AVX_S_SUM)
+OP_AVX_FLOAT_FUNC(sum,  OP_AVX_MM(add_ps), OP_AVX_S_SUM)
+OP_AVX_DOUBLE_FUNC(sum, OP_AVX_MM(add_pd), OP_AVX_S_SUM)
+
+/*************************************************************************
+ * Product.  There is no 8-bit multiplication, and the 64-bit one
+ * requires AVX-512DQ, so these are left to the base functions.
+ *************************************************************************/
+
+OP_AVX_INT_FUNC(prod, int16_t,  OP_AVX_MM(mullo_epi16), OP_AVX_S_PROD)
+OP_AVX_INT_FUNC(prod, uint16_t, OP_AVX_MM(mullo_epi16), OP_AVX_S_PROD)
+OP_AVX_INT_FUNC(prod, int32_t,  OP_AVX_MM(mullo_epi32), OP_AVX_S_PROD)
+OP_AVX_INT_FUNC(prod, uint32_t, OP_AVX_MM(mullo_epi32), OP_AVX_S_PROD)
+OP_AVX_FLOAT_FUNC(prod,  OP_AVX_MM(mul_ps), OP_AVX_S_PROD)
+OP_AVX_DOUBLE_FUNC(prod, OP_AVX_MM(mul_pd), OP_AVX_S_PROD)
+
+/*************************************************************************
+ * Max and min
+ *************************************************************************/
+
+OP_AVX_INT_FUNC(max, int8_t,   OP_AVX_MM(max_epi8),  OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, uint8_t,  OP_AVX_MM(max_epu8),  OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, int16_t,  OP_AVX_MM(max_epi16), OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, uint16_t, OP_AVX_MM(max_epu16), OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, int32_t,  OP_AVX_MM(max_epi32), OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, uint32_t, OP_AVX_MM(max_epu32), OP_AVX_S_MAX)
+#if OP_AVX_HAS_MINMAX_64
+OP_AVX_INT_FUNC(max, int64_t,  OP_AVX_MM(max_epi64), OP_AVX_S_MAX)
+OP_AVX_INT_FUNC(max, uint64_t, OP_AVX_MM(max_epu64), OP_AVX_S_MAX)
+#endif
+OP_AVX_FLOAT_FUNC(max,  OP_AVX_MM(max_ps), OP_AVX_S_MAX)
+OP_AVX_DOUBLE_FUNC(max, OP_AVX_MM(max_pd), OP_AVX_S_MAX)
+
+OP_AVX_INT_FUNC(min, int8_t,   OP_AVX_MM(min_epi8),  OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, uint8_t,  OP_AVX_MM(min_epu8),  OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, int16_t,  OP_AVX_MM(min_epi16), OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, uint16_t, OP_AVX_MM(min_epu16), OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, int32_t,  OP_AVX_MM(min_epi32), OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, uint32_t, OP_AVX_MM(min_epu32), OP_AVX_S_MIN)
+#if OP_AVX_HAS_MINMAX_64
+OP_AVX_INT_FUNC(min, int64_t,  OP_AVX_MM(min_epi64), OP_AVX_S_MIN)
+OP_AVX_INT_FUNC(min, uint64_t, OP_AVX_MM(min_epu64), OP_AVX_S_MIN)
+#endif
+OP_AVX_FLOAT_FUNC(min,  OP_AVX_MM(min_ps), OP_AVX_S_MIN)
+OP_AVX_DOUBLE_FUNC(min, OP_AVX_MM(min_pd), OP_AVX_S_MIN)
+
+/*************************************************************************
+ * Bitwise operations; the vector operation does not depend on the type
+ *************************************************************************/
+
+#define OP_AVX_BITWISE_FUNCS(name, vop, sop)       \
+    OP_AVX_INT_FUNC(name, int8_t,   vop, sop)      \
+    OP_AVX_INT_FUNC(name, uint8_t,  vop, sop)      \
+    OP_AVX_INT_FUNC(name, int16_t,  vop, sop)      \
+    OP_AVX_INT_FUNC(name, uint16_t, vop, sop)      \
+    OP_AVX_INT_FUNC(name, int32_t,  vop, sop)      \
+    OP_AVX_INT_FUNC(name, uint32_t, vop, sop)      \
+    OP_AVX_INT_FUNC(name, int64_t,  vop, sop)      \
+    OP_AVX_INT_FUNC(name, uint64_t, vop, sop)
+
+OP_AVX_BITWISE_FUNCS(band, OP_AVX_AND, OP_AVX_S_BAND)
+OP_AVX_BITWISE_FUNCS(bor,  OP_AVX_OR,  OP_AVX_S_BOR)
+OP_AVX_BITWISE_FUNCS(bxor, OP_AVX_XOR, OP_AVX_S_BXOR)
+
+/*************************************************************************
+ * Function tables
+ *************************************************************************/
+
+#define C_INTEGER_8_16_32(name, ftype)                                        \
+    [OMPI_OP_BASE_TYPE_INT8_T] = OP_AVX_FN(ftype, name, int8_t),             \
+    [OMPI_OP_BASE_TYPE_UINT8_T] = OP_AVX_FN(ftype, name, uint8_t),           \
+    [OMPI_OP_BASE_TYPE_INT16_T] = OP_AVX_FN(ftype, name, int16_t),           \
+    [OMPI_OP_BASE_TYPE_UINT16_T] = OP_AVX_FN(ftype, name, uint16_t),         \
+    [OMPI_OP_BASE_TYPE_INT32_T] = OP_AVX_FN(ftype, name, int32_t),           \
+    [OMPI_OP_BASE_TYPE_UINT32_T] = OP_AVX_FN(ftype, name, uint32_t)
+
+#define C_INTEGER_64(name, ftype)                                             \
+    [OMPI_OP_BASE_TYPE_INT64_T] = OP_AVX_FN(ftype, name, int64_t),           \
+    [OMPI_OP_BASE_TYPE_UINT64_T] = OP_AVX_FN(ftype, name, uint64_t)
+
+#define C_INTEGER(name, ftype)                                                \
+    C_INTEGER_8_16_32(name, ftype),                                           \
+    C_INTEGER_64(name, ftype)
+
+#define C_INTEGER_PROD(ftype)                                                 \
+    [OMPI_OP_BASE_TYPE_INT16_T] = OP_AVX_FN(ftype, prod, int16_t),           \
+    [OMPI_OP_BASE_TYPE_UINT16_T] = OP_AVX_FN(ftype, prod, uint16_t),         \
+    [OMPI_OP_BASE_TYPE_INT32_T] = OP_AVX_FN(ftype, prod, int32_t),           \
+    [OMPI_OP_BASE_TYPE_UINT32_T] = OP_AVX_FN(ftype, prod, uint32_t)
+
+#if OP_AVX_HAS_MINMAX_64
+#define C_INTEGER_MINMAX(name, ftype) C_INTEGER(name, ftype)
+#else
+#define C_INTEGER_MINMAX(name, ftype) C_INTEGER_8_16_32(name, ftype)
+#endif
+
+#define FLOATING_POINT(name, ftype)                                           \
+    [OMPI_OP_BASE_TYPE_FLOAT] = OP_AVX_FN(ftype, name, float),               \
+    [OMPI_OP_BASE_TYPE_DOUBLE] = OP_AVX_FN(ftype, name, double)
+
+#define OP_AVX_TABLE(ftype)                                                   \
+    {                                                                         \
+        [OMPI_OP_BASE_FORTRAN_MAX] = {                                        \
+            C_INTEGER_MINMAX(max, ftype),                                     \
+            FLOATING_POINT(max, ftype),                                       \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_MIN] = {                                        \
+            C_INTEGER_MINMAX(min, ftype),                                     \
+            FLOATING_POINT(min, ftype),                                       \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_SUM] = {                                        \
+            C_INTEGER(sum, ftype),                                            \
+            FLOATING_POINT(sum, ftype),                                       \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_PROD] = {                                       \
+            C_INTEGER_PROD(ftype),                                            \
+            FLOATING_POINT(prod, ftype),                                      \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_BAND] = {                                       \
+            C_INTEGER(band, ftype),                                           \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_BOR] = {                                        \
+            C_INTEGER(bor, ftype),                                            \
+        },                                                                    \
+        [OMPI_OP_BASE_FORTRAN_BXOR] = {                                       \
+            C_INTEGER(bxor, ftype),                                           \
+        },                                                                    \
+    }
+
+ompi_op_base_handler_fn_t
+OP_AVX_CONCAT(ompi_op_avx_functions, OP_AVX_ISA)[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX] =
+    OP_AVX_TABLE(2buff);
+
+ompi_op_base_3buff_handler_fn_t
+OP_AVX_CONCAT(ompi_op_avx_3buff_functions, OP_AVX_ISA)[OMPI_OP_BASE_FORTRAN_OP_MAX][OMPI_OP_BASE_TYPE_MAX] =
+    OP_AVX_TABLE(3buff);
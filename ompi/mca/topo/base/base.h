@@ -49,6 +49,9 @@ OMPI_DECLSPEC int mca_topo_base_lazy_init(void);
  */
 OMPI_DECLSPEC extern mca_base_framework_t ompi_topo_base_framework;
 
+/* Honor the reorder argument of the cartesian and graph topologies */
+OMPI_DECLSPEC extern bool mca_topo_base_reorder;
+
 /* Select a topo module for a particular type of topology */
 OMPI_DECLSPEC int
 mca_topo_base_comm_select(const ompi_communicator_t*  comm,
@@ -132,6 +135,24 @@ mca_topo_base_graph_create(mca_topo_base_module_t *topo_module,
                            bool reorder,
                            ompi_communicator_t** new_comm);
 
+/*
+ * Topology aware reordering: compute the rank in old_comm of each rank
+ * of the new communicator. Collective over old_comm.
+ */
+OMPI_DECLSPEC int
+mca_topo_base_cart_reorder(ompi_communicator_t *old_comm,
+                           int ndims,
+                           const int *dims,
+                           int nprocs,
+                           int *ranks);
+
+OMPI_DECLSPEC int
+mca_topo_base_graph_reorder(ompi_communicator_t *old_comm,
+                            int nnodes,
+                            const int *index,
+                            const int *edges,
+                            int *ranks);
+
 OMPI_DECLSPEC int
 mca_topo_base_graph_get(ompi_communicator_t *comm,
                         int maxindex,
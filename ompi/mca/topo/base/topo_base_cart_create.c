@@ -42,7 +42,9 @@
  * @param reorder ranking may be reordered (true) or not (false) (logical)
  * @param comm_cart communicator with new cartesian topology (handle)
  *
- * Open MPI currently ignores the 'reorder' flag.
+ * If reorder is true, the grid is laid out on the nodes and sockets
+ * of the processes (see topo_base_reorder.c), unless the topo_base_reorder
+ * parameter is false.
  *
  * @retval OMPI_SUCCESS
  */
@@ -55,7 +57,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
                               bool reorder,
                               ompi_communicator_t** comm_topo)
 {
-    int nprocs = 1, i, new_rank, num_procs, ret;
+    int nprocs = 1, i, new_rank, num_procs, ret, *ranks = NULL;
     ompi_communicator_t *new_comm;
     ompi_proc_t **topo_procs = NULL;
     mca_topo_base_comm_cart_2_2_0_t* cart;
@@ -82,7 +84,25 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         num_procs = nprocs;
     }
 
-    if (new_rank > (nprocs-1)) {
+    /* all the processes of old_comm take part in the reordering */
+    if (reorder && mca_topo_base_reorder && ndims > 0 && nprocs > 1) {
+        ranks = (int*)malloc(nprocs * sizeof(int));
+        if (NULL == ranks) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        ret = mca_topo_base_cart_reorder(old_comm, ndims, dims, nprocs, ranks);
+        if (OMPI_SUCCESS != ret) {
+            free(ranks);
+            return ret;
+        }
+        for (i = 0, new_rank = MPI_UNDEFINED; i < nprocs; ++i) {
+            if (ranks[i] == old_comm->c_local_group->grp_my_rank) {
+                new_rank = i;
+            }
+        }
+    }
+
+    if (MPI_UNDEFINED == new_rank || new_rank > (nprocs-1)) {
         ndims = 0;
         new_rank = MPI_UNDEFINED;
         num_procs = 0;
@@ -90,6 +110,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
 
     cart = OBJ_NEW(mca_topo_base_comm_cart_2_2_0_t);
     if( NULL == cart ) {
+        free(ranks);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
     cart->ndims = ndims;
@@ -99,6 +120,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
     if( ndims > 0 ) {
         cart->dims = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->dims) {
+            free(ranks);
             OBJ_RELEASE(cart);
             return OMPI_ERROR;
         }
@@ -107,6 +129,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
         /* Cartesian communicator; copy the right data to the common information */
         cart->periods = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->periods) {
+            free(ranks);
             OBJ_RELEASE(cart);
             return OMPI_ERR_OUT_OF_RESOURCE;
         }
@@ -114,6 +137,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
 
         cart->coords = (int*)malloc(sizeof(int) * ndims);
         if (NULL == cart->coords) {
+            free(ranks);
             OBJ_RELEASE(cart);
             return OMPI_ERR_OUT_OF_RESOURCE;
         }
@@ -138,10 +162,15 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
            copy and rearrange it as it deems fit. */
         topo_procs = (ompi_proc_t**)malloc(num_procs * sizeof(ompi_proc_t *));
         if (NULL == topo_procs) {
+            free(ranks);
             OBJ_RELEASE(cart);
             return OMPI_ERR_OUT_OF_RESOURCE;
         }
-        if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
+        if (NULL != ranks) {
+            for(i = 0 ; i < num_procs; i++) {
+                topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group, ranks[i]);
+            }
+        } else if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
             memcpy(topo_procs,
                    old_comm->c_local_group->grp_proc_pointers,
                    num_procs * sizeof(ompi_proc_t *));
@@ -151,6 +180,7 @@ int mca_topo_base_cart_create(mca_topo_base_module_t *topo,
             }
         }
     }
+    free(ranks);
 
     /* allocate a new communicator */
     new_comm = ompi_comm_allocate(num_procs, 0);
@@ -57,6 +57,23 @@ OBJ_CLASS_INSTANCE(mca_topo_base_module_t, opal_object_t,
                    mca_topo_base_module_construct,
                    mca_topo_base_module_destruct);
 
+bool mca_topo_base_reorder = true;
+
+static int mca_topo_base_register(mca_base_register_flag_t flags)
+{
+    mca_topo_base_reorder = true;
+    (void) mca_base_var_register("ompi", "topo", "base", "reorder",
+                                 "Reorder the ranks of the cartesian and graph topologies created "
+                                 "with reorder set to true, so that the neighbors share a node, "
+                                 "and then a socket, as much as possible",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_5,
+                                 MCA_BASE_VAR_SCOPE_ALL_EQ,
+                                 &mca_topo_base_reorder);
+
+    return OMPI_SUCCESS;
+}
+
 static int mca_topo_base_close(void)
 {
     return mca_base_framework_components_close(&ompi_topo_base_framework, NULL);
@@ -98,7 +115,7 @@ int mca_topo_base_neighbor_count (ompi_communicator_t *comm, int *indegree, int
   return OMPI_SUCCESS;
 }
 
-MCA_BASE_FRAMEWORK_DECLARE(ompi, topo, "OMPI Topo", NULL,
+MCA_BASE_FRAMEWORK_DECLARE(ompi, topo, "OMPI Topo", mca_topo_base_register,
                            mca_topo_base_open, mca_topo_base_close,
                            mca_topo_base_static_components, 0);
 
@@ -36,6 +36,10 @@
  * @param reorder ranking may be reordered (true) or not (false) (logical)
  * @param comm_graph communicator with graph topology added (handle)
  *
+ * If reorder is true, the graph is laid out on the nodes and sockets of
+ * the processes (see topo_base_reorder.c), unless the topo_base_reorder
+ * parameter is false.
+ *
  * @retval MPI_SUCCESS
  * @retval MPI_ERR_OUT_OF_RESOURCE
  */
@@ -49,7 +53,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
                                ompi_communicator_t** comm_topo)
 {
     ompi_communicator_t *new_comm;
-    int new_rank, num_procs, ret, i;
+    int new_rank, num_procs, ret, i, *ranks = NULL;
     ompi_proc_t **topo_procs = NULL;
     mca_topo_base_comm_graph_2_2_0_t* graph;
 
@@ -63,7 +67,25 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
     if( num_procs > nnodes ) {
         num_procs = nnodes;
     }
-    if( new_rank > (nnodes - 1) ) {
+    /* all the processes of old_comm take part in the reordering */
+    if( reorder && mca_topo_base_reorder && nnodes > 1 ) {
+        ranks = (int*)malloc(nnodes * sizeof(int));
+        if( NULL == ranks ) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        ret = mca_topo_base_graph_reorder(old_comm, nnodes, index, edges, ranks);
+        if( OMPI_SUCCESS != ret ) {
+            free(ranks);
+            return ret;
+        }
+        for( i = 0, new_rank = MPI_UNDEFINED; i < nnodes; ++i ) {
+            if( ranks[i] == old_comm->c_local_group->grp_my_rank ) {
+                new_rank = i;
+            }
+        }
+    }
+
+    if( MPI_UNDEFINED == new_rank || new_rank > (nnodes - 1) ) {
         new_rank = MPI_UNDEFINED;
         num_procs = 0;
         nnodes = 0;
@@ -71,6 +93,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
 
     graph = OBJ_NEW(mca_topo_base_comm_graph_2_2_0_t);
     if( NULL == graph ) {
+        free(ranks);
         return OMPI_ERR_OUT_OF_RESOURCE;
     }
     graph->nnodes = nnodes;
@@ -86,6 +109,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
     if (MPI_UNDEFINED != new_rank) {
         graph->index = (int*)malloc(sizeof(int) * nnodes);
         if (NULL == graph->index) {
+            free(ranks);
             OBJ_RELEASE(graph);
             return OMPI_ERR_OUT_OF_RESOURCE;
         }
@@ -94,6 +118,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
         /* Graph communicator; copy the right data to the common information */
         graph->edges = (int*)malloc(sizeof(int) * index[nnodes-1]);
         if (NULL == graph->edges) {
+            free(ranks);
             OBJ_RELEASE(graph);
             return OMPI_ERR_OUT_OF_RESOURCE;
         }
@@ -101,10 +126,15 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
 
         topo_procs = (ompi_proc_t**)malloc(num_procs * sizeof(ompi_proc_t *));
         if (NULL == topo_procs) {
+           free(ranks);
            OBJ_RELEASE(graph);
            return OMPI_ERR_OUT_OF_RESOURCE;
         }
-        if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
+        if (NULL != ranks) {
+            for(i = 0 ; i < num_procs; i++) {
+                topo_procs[i] = ompi_group_peer_lookup(old_comm->c_local_group, ranks[i]);
+            }
+        } else if(OMPI_GROUP_IS_DENSE(old_comm->c_local_group)) {
             memcpy(topo_procs,
                    old_comm->c_local_group->grp_proc_pointers,
                    num_procs * sizeof(ompi_proc_t *));
@@ -114,6 +144,7 @@ int mca_topo_base_graph_create(mca_topo_base_module_t *topo,
             }
         }
     }
+    free(ranks);
 
     /* allocate a new communicator */
     new_comm = ompi_comm_allocate(nnodes, 0);
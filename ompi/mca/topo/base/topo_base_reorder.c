@@ -0,0 +1,441 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "ompi/constants.h"
+
+#include "opal/mca/hwloc/base/base.h"
+#include "ompi/group/group.h"
+#include "ompi/mca/topo/base/base.h"
+#include "ompi/mca/topo/topo.h"
+
+/*
+ * Rank reordering for the cartesian and graph topologies.
+ *
+ * The processes of the new communicator are sorted by node, then by
+ * socket, into "slots". The topology is then laid out on the slots so
+ * that each node, and each socket of a node, gets a compact part of it:
+ * the cartesian grid is cut into blocks of the size of a node, themselves
+ * cut into blocks of the size of a socket, and the graph is partitioned
+ * greedily. The result is ranks[new rank] = rank in the old communicator.
+ */
+
+/* the slots, and the node and socket of each of them */
+typedef struct {
+    int rank;
+    int node;
+    int socket;
+} mca_topo_base_slot_t;
+
+static int slot_compare(const void *a, const void *b)
+{
+    const mca_topo_base_slot_t *sa = (const mca_topo_base_slot_t *) a;
+    const mca_topo_base_slot_t *sb = (const mca_topo_base_slot_t *) b;
+
+    if (sa->node != sb->node) {
+        return sa->node < sb->node ? -1 : 1;
+    }
+    if (sa->socket != sb->socket) {
+        return sa->socket < sb->socket ? -1 : 1;
+    }
+    return sa->rank < sb->rank ? -1 : (sa->rank > sb->rank);
+}
+
+/*
+ * Sorts the nprocs first processes of comm by node and socket. A node
+ * (socket) is identified by the lowest rank in comm of its processes, so
+ * that all the processes agree on it. Collective over comm.
+ */
+static int reorder_get_slots(ompi_communicator_t *comm, int nprocs,
+                             mca_topo_base_slot_t *slots)
+{
+    int size = ompi_comm_size(comm), rank = ompi_comm_rank(comm);
+    int key[2] = {rank, rank}, *keys, err;
+
+    for (int i = 0 ; i < rank ; ++i) {
+        ompi_proc_t *proc = ompi_group_peer_lookup(comm->c_local_group, i);
+
+        if (OPAL_PROC_ON_LOCAL_NODE(proc->super.proc_flags)) {
+            if (key[0] == rank) {
+                key[0] = i;
+            }
+            if (OPAL_PROC_ON_LOCAL_SOCKET(proc->super.proc_flags)) {
+                key[1] = i;
+                break;
+            }
+        }
+    }
+
+    keys = (int *) malloc(2 * size * sizeof(int));
+    if (NULL == keys) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    err = comm->c_coll->coll_allgather(key, 2, MPI_INT, keys, 2, MPI_INT, comm,
+                                       comm->c_coll->coll_allgather_module);
+    if (OMPI_SUCCESS != err) {
+        free(keys);
+        return err;
+    }
+
+    for (int i = 0 ; i < nprocs ; ++i) {
+        slots[i].rank = i;
+        slots[i].node = keys[2 * i];
+        slots[i].socket = keys[2 * i + 1];
+    }
+    free(keys);
+    qsort(slots, nprocs, sizeof(*slots), slot_compare);
+
+    return OMPI_SUCCESS;
+}
+
+/* returns the number of processes of each node (socket if socket), or 0
+ * if they do not all have the same */
+static int reorder_group_size(const mca_topo_base_slot_t *slots, int nprocs, bool socket)
+{
+    int group_size = 0, count = 0;
+
+    for (int i = 0 ; i < nprocs ; ++i) {
+        count++;
+        if (i == nprocs - 1 ||
+            (socket ? slots[i].socket != slots[i + 1].socket : slots[i].node != slots[i + 1].node)) {
+            if (0 != group_size && count != group_size) {
+                return 0;
+            }
+            group_size = count;
+            count = 0;
+        }
+    }
+
+    return group_size;
+}
+
+/*
+ * Cartesian topologies
+ */
+
+/* finds the shape of the blocks of volume processes tiling box, cutting
+ * the fewest faces between neighbors, in block. Returns false if there is
+ * none */
+static bool cart_block_shape(int ndims, const int *box, int volume, int *block)
+{
+    int *current, cuts, best = -1, box_volume = 1;
+    bool found = false;
+
+    current = (int *) malloc(ndims * sizeof(int));
+    if (NULL == current) {
+        return false;
+    }
+    for (int i = 0 ; i < ndims ; ++i) {
+        current[i] = 1;
+        box_volume *= box[i];
+    }
+
+    /* enumerate the divisors of the box dimensions as an odometer */
+    while (true) {
+        int product = 1, i;
+
+        for (i = 0 ; i < ndims ; ++i) {
+            product *= current[i];
+        }
+        if (product == volume) {
+            cuts = 0;
+            for (i = 0 ; i < ndims ; ++i) {
+                cuts += (box[i] / current[i] - 1) * (box_volume / box[i]);
+            }
+            if (!found || cuts < best) {
+                memcpy(block, current, ndims * sizeof(int));
+                best = cuts;
+                found = true;
+            }
+        }
+
+        for (i = 0 ; i < ndims ; ++i) {
+            do {
+                current[i]++;
+            } while (current[i] <= box[i] && 0 != box[i] % current[i]);
+            if (current[i] <= box[i]) {
+                break;
+            }
+            current[i] = 1;
+        }
+        if (i == ndims) {
+            break;
+        }
+    }
+    free(current);
+
+    return found;
+}
+
+/* appends the cartesian ranks of the cells of the box at lo to order,
+ * block by block for each of the nlevels block volumes */
+static int cart_block_order(int ndims, const int *dims, const int *lo, const int *box,
+                            const int *levels, int nlevels, int *order, int *pos)
+{
+    int *block, *cell, err = OMPI_SUCCESS;
+
+    block = (int *) malloc(2 * ndims * sizeof(int));
+    if (NULL == block) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    cell = block + ndims;
+
+    /* skip the levels that do not tile the box */
+    while (nlevels > 0 && !cart_block_shape(ndims, box, levels[0], block)) {
+        levels++;
+        nlevels--;
+    }
+    if (0 == nlevels) {
+        for (int i = 0 ; i < ndims ; ++i) {
+            block[i] = 1;
+        }
+    }
+
+    /* the blocks (cells if there are no more levels), in row-major order */
+    memcpy(cell, lo, ndims * sizeof(int));
+    while (OMPI_SUCCESS == err) {
+        int i;
+
+        if (0 == nlevels) {
+            int rank = 0;
+
+            for (i = 0 ; i < ndims ; ++i) {
+                rank = rank * dims[i] + cell[i];
+            }
+            order[(*pos)++] = rank;
+        } else {
+            err = cart_block_order(ndims, dims, cell, block, levels + 1, nlevels - 1,
+                                   order, pos);
+        }
+
+        for (i = ndims - 1 ; i >= 0 ; --i) {
+            cell[i] += block[i];
+            if (cell[i] < lo[i] + box[i]) {
+                break;
+            }
+            cell[i] = lo[i];
+        }
+        if (i < 0) {
+            break;
+        }
+    }
+    free(block);
+
+    return err;
+}
+
+int mca_topo_base_cart_reorder(ompi_communicator_t *comm, int ndims, const int *dims,
+                               int nprocs, int *ranks)
+{
+    mca_topo_base_slot_t *slots;
+    int node_size, socket_size, levels[2], nlevels = 0, pos = 0, *order = NULL, *lo = NULL, err;
+
+    slots = (mca_topo_base_slot_t *) malloc(nprocs * sizeof(*slots));
+    if (NULL == slots) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    err = reorder_get_slots(comm, nprocs, slots);
+    if (OMPI_SUCCESS != err) {
+        goto out;
+    }
+
+    /* blocks of the size of a node, then of a socket */
+    node_size = reorder_group_size(slots, nprocs, false);
+    socket_size = reorder_group_size(slots, nprocs, true);
+    if (node_size > 1 && node_size < nprocs) {
+        levels[nlevels++] = node_size;
+    }
+    if (socket_size > 1 && socket_size < (0 == nlevels ? nprocs : node_size)) {
+        levels[nlevels++] = socket_size;
+    }
+
+    order = (int *) malloc(nprocs * sizeof(int));
+    lo = (int *) calloc(ndims + 1, sizeof(int));
+    if (NULL == order || NULL == lo) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto out;
+    }
+    err = cart_block_order(ndims, dims, lo, dims, levels, nlevels, order, &pos);
+    if (OMPI_SUCCESS != err) {
+        goto out;
+    }
+
+    /* the slot j holds the cell order[j] */
+    for (int j = 0 ; j < nprocs ; ++j) {
+        ranks[order[j]] = slots[j].rank;
+    }
+
+  out:
+    free(lo);
+    free(order);
+    free(slots);
+    return err;
+}
+
+/*
+ * Graph topologies
+ */
+
+/* the unassigned vertices, in a binary heap ordered by decreasing gain
+ * (2 * socket gain + node gain), then by increasing vertex, so that the
+ * greedy placement picks the same vertex on all the processes */
+typedef struct {
+    int *heap;          /* the vertices */
+    int *where;         /* position of each vertex in heap, -1 once assigned */
+    int *node_gain;
+    int *socket_gain;
+    int size;
+} graph_heap_t;
+
+static inline bool graph_heap_before(const graph_heap_t *h, int u, int v)
+{
+    int gu = 2 * h->socket_gain[u] + h->node_gain[u];
+    int gv = 2 * h->socket_gain[v] + h->node_gain[v];
+
+    return gu > gv || (gu == gv && u < v);
+}
+
+static inline void graph_heap_swap(graph_heap_t *h, int i, int j)
+{
+    int v = h->heap[i];
+
+    h->heap[i] = h->heap[j];
+    h->heap[j] = v;
+    h->where[h->heap[i]] = i;
+    h->where[h->heap[j]] = j;
+}
+
+static void graph_heap_up(graph_heap_t *h, int i)
+{
+    while (i > 0 && graph_heap_before(h, h->heap[i], h->heap[(i - 1) / 2])) {
+        graph_heap_swap(h, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void graph_heap_down(graph_heap_t *h, int i)
+{
+    while (true) {
+        int first = i, l = 2 * i + 1, r = 2 * i + 2;
+
+        if (l < h->size && graph_heap_before(h, h->heap[l], h->heap[first])) {
+            first = l;
+        }
+        if (r < h->size && graph_heap_before(h, h->heap[r], h->heap[first])) {
+            first = r;
+        }
+        if (first == i) {
+            return;
+        }
+        graph_heap_swap(h, i, first);
+        i = first;
+    }
+}
+
+static int graph_heap_pop(graph_heap_t *h)
+{
+    int v = h->heap[0];
+
+    graph_heap_swap(h, 0, --h->size);
+    h->where[v] = -1;
+    graph_heap_down(h, 0);
+
+    return v;
+}
+
+/* clears the gains of the n vertices of list */
+static void graph_heap_reset(graph_heap_t *h, const int *list, int n, bool node)
+{
+    for (int i = 0 ; i < n ; ++i) {
+        int v = list[i];
+
+        h->socket_gain[v] = 0;
+        if (node) {
+            h->node_gain[v] = 0;
+        }
+        if (-1 != h->where[v]) {
+            graph_heap_down(h, h->where[v]);
+        }
+    }
+}
+
+int mca_topo_base_graph_reorder(ompi_communicator_t *comm, int nnodes, const int *index,
+                                const int *edges, int *ranks)
+{
+    mca_topo_base_slot_t *slots;
+    int *buffer = NULL, *node_touched, *socket_touched, nnode_touched = 0, nsocket_touched = 0, err;
+    graph_heap_t h;
+
+    slots = (mca_topo_base_slot_t *) malloc(nnodes * sizeof(*slots));
+    if (NULL == slots) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    err = reorder_get_slots(comm, nnodes, slots);
+    if (OMPI_SUCCESS != err) {
+        goto out;
+    }
+
+    buffer = (int *) calloc(6 * nnodes, sizeof(int));
+    if (NULL == buffer) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto out;
+    }
+    h.node_gain = buffer;
+    h.socket_gain = buffer + nnodes;
+    h.heap = buffer + 2 * nnodes;
+    h.where = buffer + 3 * nnodes;
+    h.size = nnodes;
+    node_touched = buffer + 4 * nnodes;
+    socket_touched = buffer + 5 * nnodes;
+    /* all the gains are 0: the vertices in increasing order form a heap */
+    for (int v = 0 ; v < nnodes ; ++v) {
+        h.heap[v] = h.where[v] = v;
+    }
+
+    /* fill the slots in order with the vertex having the most edges to the
+     * vertices already on the socket, then on the node. Only the vertices
+     * with a non-zero gain are reset when moving to the next socket or
+     * node, so the placement takes O((nnodes + edges) log(nnodes)) */
+    for (int j = 0 ; j < nnodes ; ++j) {
+        int best;
+
+        if (j > 0 && slots[j].node != slots[j - 1].node) {
+            graph_heap_reset(&h, node_touched, nnode_touched, true);
+            nnode_touched = nsocket_touched = 0;
+        } else if (j > 0 && slots[j].socket != slots[j - 1].socket) {
+            graph_heap_reset(&h, socket_touched, nsocket_touched, false);
+            nsocket_touched = 0;
+        }
+
+        best = graph_heap_pop(&h);
+        ranks[best] = slots[j].rank;
+        for (int e = (0 == best ? 0 : index[best - 1]) ; e < index[best] ; ++e) {
+            int v = edges[e];
+
+            if (-1 == h.where[v]) {
+                continue;
+            }
+            if (0 == h.node_gain[v]++) {
+                node_touched[nnode_touched++] = v;
+            }
+            if (0 == h.socket_gain[v]++) {
+                socket_touched[nsocket_touched++] = v;
+            }
+            graph_heap_up(&h, h.where[v]);
+        }
+    }
+
+  out:
+    free(buffer);
+    free(slots);
+    return err;
+}
@@ -24,6 +24,7 @@
 #include "ompi/memchecker.h"
 #include "ompi/mca/topo/topo.h"
 #include "ompi/mca/topo/base/base.h"
+#include "ompi/mca/coll/base/base.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -91,6 +92,13 @@ int MPI_Dist_graph_create(MPI_Comm comm_old, int n, const int sources[],
     err = topo->topo.dist_graph.dist_graph_create(topo, comm_old, n, sources, degrees,
                                                   destinations, weights, &(info->super),
                                                   reorder, newcomm);
+    if (OMPI_SUCCESS == err) {
+        /* the coll modules may now prepare the neighborhood collectives */
+        err = mca_coll_base_comm_topo(*newcomm);
+        if (OMPI_SUCCESS != err) {
+            ompi_comm_free(newcomm);
+        }
+    }
     OMPI_ERRHANDLER_RETURN(err, comm_old, err, FUNC_NAME);
 }
 
@@ -30,6 +30,7 @@
 #include "ompi/memchecker.h"
 #include "ompi/mca/topo/topo.h"
 #include "ompi/mca/topo/base/base.h"
+#include "ompi/mca/coll/base/base.h"
 
 #if OMPI_BUILD_MPI_PROFILING
 #if OPAL_HAVE_WEAK_SYMBOLS
@@ -103,6 +104,13 @@ int MPI_Dist_graph_create_adjacent(MPI_Comm comm_old,
                                                            sources, sourceweights, outdegree,
                                                            destinations, destweights, &(info->super),
                                                            reorder, comm_dist_graph);
+    if (OMPI_SUCCESS == err) {
+        /* the coll modules may now prepare the neighborhood collectives */
+        err = mca_coll_base_comm_topo(*comm_dist_graph);
+        if (OMPI_SUCCESS != err) {
+            ompi_comm_free(comm_dist_graph);
+        }
+    }
     OMPI_ERRHANDLER_RETURN(err, comm_old, err, FUNC_NAME);
 }
 
@@ -30,6 +30,7 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/errhandler/errhandler.h"
 #include "ompi/mca/topo/base/base.h"
+#include "ompi/mca/coll/base/base.h"
 #include "ompi/memchecker.h"
 
 #if OMPI_BUILD_MPI_PROFILING
@@ -104,6 +105,16 @@ int MPI_Graph_create(MPI_Comm old_comm, int nnodes, const int indx[],
     err = topo->topo.graph.graph_create(topo, old_comm,
                                         nnodes, indx, edges,
                                         (0 == reorder) ? false : true, comm_graph);
+    if (MPI_SUCCESS == err && MPI_COMM_NULL != *comm_graph) {
+        /* the coll modules may now prepare the neighborhood collectives */
+        err = mca_coll_base_comm_topo(*comm_graph);
+        if (MPI_SUCCESS != err) {
+            /* the new communicator already owns the topo module */
+            ompi_comm_free(comm_graph);
+            OPAL_CR_EXIT_LIBRARY();
+            return OMPI_ERRHANDLER_INVOKE(old_comm, err, FUNC_NAME);
+        }
+    }
     OPAL_CR_EXIT_LIBRARY();
 
     if (MPI_SUCCESS != err) {
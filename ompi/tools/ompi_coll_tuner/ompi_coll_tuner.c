@@ -0,0 +1,723 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Offline tuner for the coll/tuned component.  For each communicator
+ * size and message size of the sweep, every algorithm exposed through
+ * the coll_tuned_<collective>_algorithm control variables is forced
+ * (together with a set of segment sizes and fanouts where the
+ * algorithm uses them) and timed.  The fastest configurations are
+ * written as a rules file that can be given back to the tuned
+ * component with
+ *   --mca coll_tuned_use_dynamic_rules 1
+ *   --mca coll_tuned_dynamic_rules_filename <file>
+ *
+ * The forced algorithms are read when a communicator is created, so a
+ * new communicator is duplicated for each configuration.
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <getopt.h>
+
+#include "mpi.h"
+#include "ompi/mca/coll/base/coll_base_functions.h"
+
+#define TUNER_MAX_NAME      64
+#define TUNER_MAX_LIST      64
+#define TUNER_MAX_CONFIGS   256
+#define TUNER_MIN_REPS      5
+#define TUNER_BYTES_BUDGET  (1 << 26)
+
+typedef int (*tuner_run_fn_t)(size_t bytes, int size, MPI_Comm comm);
+
+typedef struct {
+    const char *name;       /* as in the coll_tuned_<name>_algorithm variables */
+    int id;                 /* collective id in the rules file */
+    tuner_run_fn_t run;
+    bool sweep;             /* does the decision depend on the message size */
+    const char *segmented;  /* algorithms using the segment size */
+    const char *chained;    /* algorithms using the forced fanout (or radix) */
+} tuner_coll_t;
+
+typedef struct {
+    int alg;
+    int faninout;
+    int segsize;
+    char name[TUNER_MAX_NAME];
+} tuner_config_t;
+
+static char *tuner_sbuf = NULL, *tuner_rbuf = NULL;
+static int *tuner_counts = NULL, *tuner_displs = NULL;
+
+/*
+ * The bytes argument is the message size as computed by the dynamic
+ * decision of the tuned component (coll_tuned_decision_dynamic.c) for
+ * the collective; the counts are derived from it. Small sizes still
+ * exchange one element with each peer, the buffers are sized for that.
+ */
+static int tuner_count(size_t bytes, size_t unit)
+{
+    return (bytes < unit) ? 1 : (int)(bytes / unit);
+}
+
+static int tuner_run_allgather(size_t bytes, int size, MPI_Comm comm)
+{
+    int count = tuner_count(bytes, size);
+    return MPI_Allgather(tuner_sbuf, count, MPI_BYTE, tuner_rbuf, count, MPI_BYTE, comm);
+}
+
+static int tuner_run_allgatherv(size_t bytes, int size, MPI_Comm comm)
+{
+    int i, count = tuner_count(bytes, size);
+    for (i = 0; i < size; i++) {
+        tuner_counts[i] = count;
+        tuner_displs[i] = i * count;
+    }
+    return MPI_Allgatherv(tuner_sbuf, count, MPI_BYTE, tuner_rbuf,
+                          tuner_counts, tuner_displs, MPI_BYTE, comm);
+}
+
+static int tuner_run_allreduce(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Allreduce(tuner_sbuf, tuner_rbuf, tuner_count(bytes, sizeof(int)),
+                         MPI_INT, MPI_SUM, comm);
+}
+
+static int tuner_run_alltoall(size_t bytes, int size, MPI_Comm comm)
+{
+    int count = tuner_count(bytes, size);
+    return MPI_Alltoall(tuner_sbuf, count, MPI_BYTE, tuner_rbuf, count, MPI_BYTE, comm);
+}
+
+static int tuner_run_alltoallv(size_t bytes, int size, MPI_Comm comm)
+{
+    int i, count = tuner_count(bytes, size);
+    for (i = 0; i < size; i++) {
+        tuner_counts[i] = count;
+        tuner_displs[i] = i * count;
+    }
+    return MPI_Alltoallv(tuner_sbuf, tuner_counts, tuner_displs, MPI_BYTE,
+                         tuner_rbuf, tuner_counts, tuner_displs, MPI_BYTE, comm);
+}
+
+static int tuner_run_barrier(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Barrier(comm);
+}
+
+static int tuner_run_bcast(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Bcast(tuner_sbuf, tuner_count(bytes, 1), MPI_BYTE, 0, comm);
+}
+
+static int tuner_run_exscan(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Exscan(tuner_sbuf, tuner_rbuf, tuner_count(bytes, sizeof(int)),
+                      MPI_INT, MPI_SUM, comm);
+}
+
+static int tuner_run_gather(size_t bytes, int size, MPI_Comm comm)
+{
+    int count = tuner_count(bytes, size);
+    return MPI_Gather(tuner_sbuf, count, MPI_BYTE, tuner_rbuf, count, MPI_BYTE, 0, comm);
+}
+
+static int tuner_run_reduce(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Reduce(tuner_sbuf, tuner_rbuf, tuner_count(bytes, sizeof(int)),
+                      MPI_INT, MPI_SUM, 0, comm);
+}
+
+static int tuner_run_reduce_scatter(size_t bytes, int size, MPI_Comm comm)
+{
+    int i, count = tuner_count(bytes, size * sizeof(int));
+    for (i = 0; i < size; i++) {
+        tuner_counts[i] = count;
+    }
+    return MPI_Reduce_scatter(tuner_sbuf, tuner_rbuf, tuner_counts, MPI_INT, MPI_SUM, comm);
+}
+
+static int tuner_run_reduce_scatter_block(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Reduce_scatter_block(tuner_sbuf, tuner_rbuf,
+                                    tuner_count(bytes, size * sizeof(int)),
+                                    MPI_INT, MPI_SUM, comm);
+}
+
+static int tuner_run_scan(size_t bytes, int size, MPI_Comm comm)
+{
+    return MPI_Scan(tuner_sbuf, tuner_rbuf, tuner_count(bytes, sizeof(int)),
+                    MPI_INT, MPI_SUM, comm);
+}
+
+static int tuner_run_scatter(size_t bytes, int size, MPI_Comm comm)
+{
+    int count = tuner_count(bytes, size);
+    return MPI_Scatter(tuner_sbuf, count, MPI_BYTE, tuner_rbuf, count, MPI_BYTE, 0, comm);
+}
+
+static const tuner_coll_t tuner_colls[] = {
+    { "allgather", ALLGATHER, tuner_run_allgather, true, "", "" },
+    { "allgatherv", ALLGATHERV, tuner_run_allgatherv, true, "", "k_nomial" },
+    { "allreduce", ALLREDUCE, tuner_run_allreduce, true, "segmented_ring", "" },
+    { "alltoall", ALLTOALL, tuner_run_alltoall, true, "", "" },
+    { "alltoallv", ALLTOALLV, tuner_run_alltoallv, false, "", "" },
+    { "barrier", BARRIER, tuner_run_barrier, false, "", "" },
+    { "bcast", BCAST, tuner_run_bcast, true,
+      "chain,pipeline,split_binary_tree,binary_tree,binomial,knomial,"
+      "scatter_allgather,scatter_allgather_ring", "chain" },
+    { "exscan", EXSCAN, tuner_run_exscan, true, "", "" },
+    { "gather", GATHER, tuner_run_gather, true, "linear_sync", "" },
+    { "reduce", REDUCE, tuner_run_reduce, true,
+      "chain,pipeline,binary,binomial,in-order_binary", "chain" },
+    { "reduce_scatter", REDUCESCATTER, tuner_run_reduce_scatter, true, "", "" },
+    { "reduce_scatter_block", REDUCESCATTERBLOCK, tuner_run_reduce_scatter_block, true, "", "" },
+    { "scan", SCAN, tuner_run_scan, true, "", "" },
+    { "scatter", SCATTER, tuner_run_scatter, true, "", "" },
+};
+#define TUNER_NCOLLS ((int)(sizeof(tuner_colls) / sizeof(tuner_colls[0])))
+
+/* options */
+static char *filename = NULL;
+static bool coll_selected[TUNER_NCOLLS];
+static int comm_sizes[TUNER_MAX_LIST], n_comm_sizes = 0;
+static unsigned long msg_min = 1, msg_max = 1 << 22, msg_factor = 4;
+static int seg_sizes[TUNER_MAX_LIST] = { 1024, 8192, 32768, 131072 }, n_seg_sizes = 4;
+static int fanouts[TUNER_MAX_LIST] = { 2, 4, 8 }, n_fanouts = 3;
+static int max_reps = 100;
+
+static void print_help(char *progname)
+{
+    printf("%s: generate a dynamic rules file for the tuned collective component\n", progname);
+    printf("Usage: mpirun -n <np> %s [options]\n", progname);
+    printf("  -o, --output <file>       rules file to write (mandatory)\n");
+    printf("  -c, --colls <list>        comma-separated collectives to tune (default: all)\n");
+    printf("  -p, --comm-sizes <list>   communicator sizes (default: powers of 2 up to np, and np)\n");
+    printf("  -m, --msg-sizes <min:max> message size range in bytes (default: %lu:%lu)\n",
+           msg_min, msg_max);
+    printf("  -f, --factor <n>          message size multiplier between steps (default: %lu)\n",
+           msg_factor);
+    printf("  -s, --segsizes <list>     segment sizes tried by the segmented algorithms\n");
+    printf("  -F, --fanouts <list>      fanouts (or radices) tried by the chain and k-nomial algorithms\n");
+    printf("  -r, --reps <n>            maximum repetitions per measurement (default: %d)\n", max_reps);
+    printf("  -h, --help                print this help\n");
+}
+
+static int parse_int_list(char *arg, int *list)
+{
+    char *tok, *save = NULL;
+    int n = 0;
+
+    for (tok = strtok_r(arg, ",", &save); NULL != tok && n < TUNER_MAX_LIST;
+         tok = strtok_r(NULL, ",", &save)) {
+        list[n] = atoi(tok);
+        if (list[n] <= 0) {
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+static bool in_list(const char *list, const char *name)
+{
+    size_t len = strlen(name);
+    const char *p = list;
+
+    while (NULL != (p = strstr(p, name))) {
+        if ((p == list || ',' == p[-1]) && (',' == p[len] || '\0' == p[len])) {
+            return true;
+        }
+        p += len;
+    }
+    return false;
+}
+
+static int parse_opts(int rank, int argc, char **argv)
+{
+    static struct option long_options[] = {
+        { "output", required_argument, 0, 'o' },
+        { "colls", required_argument, 0, 'c' },
+        { "comm-sizes", required_argument, 0, 'p' },
+        { "msg-sizes", required_argument, 0, 'm' },
+        { "factor", required_argument, 0, 'f' },
+        { "segsizes", required_argument, 0, 's' },
+        { "fanouts", required_argument, 0, 'F' },
+        { "reps", required_argument, 0, 'r' },
+        { "help", no_argument, 0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+    int i, c;
+    bool any_coll = false;
+
+    while (-1 != (c = getopt_long(argc, argv, "o:c:p:m:f:s:F:r:h", long_options, NULL))) {
+        switch (c) {
+        case 'h':
+            if (0 == rank) {
+                print_help(argv[0]);
+            }
+            return 1;
+        case 'o':
+            filename = strdup(optarg);
+            break;
+        case 'c':
+            for (i = 0; i < TUNER_NCOLLS; i++) {
+                coll_selected[i] = in_list(optarg, tuner_colls[i].name);
+                any_coll |= coll_selected[i];
+            }
+            if (!any_coll) {
+                return -1;
+            }
+            break;
+        case 'p':
+            if ((n_comm_sizes = parse_int_list(optarg, comm_sizes)) <= 0) {
+                return -1;
+            }
+            break;
+        case 'm':
+            if (2 != sscanf(optarg, "%lu:%lu", &msg_min, &msg_max) || msg_min > msg_max) {
+                return -1;
+            }
+            if (0 == msg_min) {
+                msg_min = 1;
+            }
+            break;
+        case 'f':
+            msg_factor = strtoul(optarg, NULL, 10);
+            if (msg_factor < 2) {
+                return -1;
+            }
+            break;
+        case 's':
+            if ((n_seg_sizes = parse_int_list(optarg, seg_sizes)) <= 0) {
+                return -1;
+            }
+            break;
+        case 'F':
+            if ((n_fanouts = parse_int_list(optarg, fanouts)) <= 0) {
+                return -1;
+            }
+            break;
+        case 'r':
+            if ((max_reps = atoi(optarg)) < 1) {
+                return -1;
+            }
+            break;
+        default:
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int tuner_set_cvar(const char *name, int value)
+{
+    MPI_T_cvar_handle handle;
+    int rc, index, count;
+
+    rc = MPI_T_cvar_get_index(name, &index);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = MPI_T_cvar_handle_alloc(index, NULL, &handle, &count);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = MPI_T_cvar_write(handle, &value);
+    MPI_T_cvar_handle_free(&handle);
+    return rc;
+}
+
+static int tuner_get_cvar(const char *name, int *value)
+{
+    MPI_T_cvar_handle handle;
+    int rc, index, count;
+
+    rc = MPI_T_cvar_get_index(name, &index);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = MPI_T_cvar_handle_alloc(index, NULL, &handle, &count);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    rc = MPI_T_cvar_read(handle, value);
+    MPI_T_cvar_handle_free(&handle);
+    return rc;
+}
+
+static int tuner_force(const tuner_coll_t *coll, const tuner_config_t *config)
+{
+    char name[256];
+    int rc, fanout;
+
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm", coll->name);
+    rc = tuner_set_cvar(name, config->alg);
+    if (MPI_SUCCESS != rc) {
+        return rc;
+    }
+    /* not all the collectives have these variables */
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_segmentsize", coll->name);
+    (void) tuner_set_cvar(name, config->segsize);
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_chain_fanout", coll->name);
+    if (0 != config->faninout) {
+        /* each collective forces one of the two fanouts */
+        (void) tuner_set_cvar(name, config->faninout);
+        snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_tree_fanout", coll->name);
+        (void) tuner_set_cvar(name, config->faninout);
+        return MPI_SUCCESS;
+    }
+    /* back to the defaults, whatever an earlier configuration forced */
+    if (MPI_SUCCESS == tuner_get_cvar("coll_tuned_init_chain_fanout", &fanout)) {
+        (void) tuner_set_cvar(name, fanout);
+    }
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm_tree_fanout", coll->name);
+    if (MPI_SUCCESS == tuner_get_cvar("coll_tuned_init_tree_fanout", &fanout)) {
+        (void) tuner_set_cvar(name, fanout);
+    }
+    return MPI_SUCCESS;
+}
+
+/*
+ * Build the list of configurations to try for a collective: the fixed
+ * decision first (algorithm 0, for reference only), then every
+ * algorithm of the enumerator, multiplied by the segment sizes and
+ * fanouts it supports.
+ */
+static int tuner_get_configs(const tuner_coll_t *coll, int size, tuner_config_t *configs)
+{
+    char name[256], item[TUNER_MAX_NAME];
+    int i, s, f, rc, index, value, num, len, n = 0;
+    int verbosity, bind, scope, desc_len = 0, name_len = sizeof(name);
+    MPI_Datatype datatype;
+    MPI_T_enum enumtype;
+
+    configs[n].alg = 0;
+    configs[n].faninout = 0;
+    configs[n].segsize = 0;
+    strcpy(configs[n].name, "fixed");
+    n++;
+
+    snprintf(name, sizeof(name), "coll_tuned_%s_algorithm", coll->name);
+    rc = MPI_T_cvar_get_index(name, &index);
+    if (MPI_SUCCESS != rc) {
+        return n;
+    }
+    rc = MPI_T_cvar_get_info(index, name, &name_len, &verbosity, &datatype,
+                             &enumtype, NULL, &desc_len, &bind, &scope);
+    if (MPI_SUCCESS != rc || MPI_T_ENUM_NULL == enumtype) {
+        return n;
+    }
+    len = sizeof(name);
+    MPI_T_enum_get_info(enumtype, &num, name, &len);
+
+    for (i = 0; i < num; i++) {
+        len = sizeof(item);
+        if (MPI_SUCCESS != MPI_T_enum_get_item(enumtype, i, &value, item, &len) || 0 == value) {
+            continue;
+        }
+        for (s = -1; s < (in_list(coll->segmented, item) ? n_seg_sizes : 0); s++) {
+            for (f = -1; f < (in_list(coll->chained, item) ? n_fanouts : 0); f++) {
+                if ((f >= 0 && fanouts[f] >= size) || n >= TUNER_MAX_CONFIGS) {
+                    continue;
+                }
+                configs[n].alg = value;
+                configs[n].segsize = (s < 0) ? 0 : seg_sizes[s];
+                configs[n].faninout = (f < 0) ? 0 : fanouts[f];
+                strncpy(configs[n].name, item, TUNER_MAX_NAME - 1);
+                configs[n].name[TUNER_MAX_NAME - 1] = '\0';
+                n++;
+            }
+        }
+    }
+    return n;
+}
+
+/*
+ * Average time of one operation, maximum over the processes, or a
+ * negative value if the configuration failed on any process.  The
+ * synchronizations use the control communicator, so that they are not
+ * affected by the forced algorithms.
+ */
+static double tuner_time(const tuner_coll_t *coll, size_t bytes, int size,
+                         MPI_Comm comm, MPI_Comm ctrl)
+{
+    int r, reps, err, any_err;
+    double t, tmax;
+
+    reps = (int)(TUNER_BYTES_BUDGET / (bytes + 1));
+    reps = (reps > max_reps) ? max_reps : reps;
+    reps = (reps < TUNER_MIN_REPS) ? TUNER_MIN_REPS : reps;
+
+    err = (MPI_SUCCESS != coll->run(bytes, size, comm));  /* warm up */
+    MPI_Allreduce(&err, &any_err, 1, MPI_INT, MPI_MAX, ctrl);
+    if (any_err) {
+        return -1.0;
+    }
+
+    MPI_Barrier(ctrl);
+    t = MPI_Wtime();
+    for (r = 0; r < reps; r++) {
+        coll->run(bytes, size, comm);
+    }
+    t = (MPI_Wtime() - t) / reps;
+    MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, ctrl);
+    return tmax;
+}
+
+static unsigned long tuner_geometric_mean(size_t a, size_t b)
+{
+    unsigned long lo = a, hi = b;
+
+    /* largest value whose square does not exceed a * b */
+    while (lo < hi) {
+        unsigned long mid = lo + (hi - lo + 1) / 2;
+        if (mid <= (a * b) / mid) lo = mid;
+        else hi = mid - 1;
+    }
+    return lo;
+}
+
+/*
+ * Tune one collective on the ctrl communicator, and append its rules
+ * for this communicator size to the (per collective) rules buffer of
+ * rank 0.
+ */
+static void tuner_run_coll(const tuner_coll_t *coll, MPI_Comm ctrl, size_t *msgs, int n_msgs,
+                           char **rules, size_t *rules_len, int *n_rules)
+{
+    tuner_config_t *configs;
+    double *times;
+    int i, m, n_configs, size, rank, best, prev = -1, n_out = 0;
+    char line[512], *section = NULL;
+    size_t section_len = 0;
+    MPI_Comm comm;
+
+    MPI_Comm_size(ctrl, &size);
+    MPI_Comm_rank(ctrl, &rank);
+
+    configs = (tuner_config_t*)malloc(TUNER_MAX_CONFIGS * sizeof(tuner_config_t));
+    n_configs = tuner_get_configs(coll, size, configs);
+    times = (double*)malloc(n_configs * n_msgs * sizeof(double));
+
+    for (i = 0; i < n_configs; i++) {
+        if (MPI_SUCCESS != tuner_force(coll, &configs[i])) {
+            for (m = 0; m < n_msgs; m++) times[i * n_msgs + m] = -1.0;
+            continue;
+        }
+        MPI_Comm_dup(ctrl, &comm);
+        MPI_Comm_set_errhandler(comm, MPI_ERRORS_RETURN);
+        for (m = 0; m < n_msgs; m++) {
+            /* segmenting is pointless below the segment size */
+            if (0 != configs[i].segsize && msgs[m] <= (size_t)configs[i].segsize) {
+                times[i * n_msgs + m] = -1.0;
+                continue;
+            }
+            times[i * n_msgs + m] = tuner_time(coll, msgs[m], size, comm, ctrl);
+        }
+        MPI_Comm_free(&comm);
+    }
+    (void) tuner_force(coll, &configs[0]);
+
+    if (0 != rank) {
+        goto done;
+    }
+
+    for (m = 0; m < n_msgs; m++) {
+        best = -1;
+        for (i = 1; i < n_configs; i++) {
+            double t = times[i * n_msgs + m];
+            if (t >= 0.0 && (best < 0 || t < times[best * n_msgs + m])) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            continue;  /* keep the previous rule, or the fixed decision */
+        }
+        printf("%-20s %5d %10lu  %-24s fanout %2d segsize %7d %12.2f us (fixed %12.2f us)\n",
+               coll->name, size, (unsigned long)msgs[m], configs[best].name,
+               configs[best].faninout, configs[best].segsize,
+               times[best * n_msgs + m] * 1e6, times[m] * 1e6);
+        if (best == prev) {
+            continue;
+        }
+        prev = best;
+        /* the rule starts halfway (geometrically) from the previous
+           measured size, and the first rule must start at 0 */
+        snprintf(line, sizeof(line), "%lu %d %d %d # %s\n",
+                 (0 == n_out) ? 0UL : tuner_geometric_mean(msgs[m - 1], msgs[m]),
+                 configs[best].alg, configs[best].faninout, configs[best].segsize,
+                 configs[best].name);
+        section = realloc(section, section_len + strlen(line) + 1);
+        strcpy(section + section_len, line);
+        section_len += strlen(line);
+        n_out++;
+        if (!coll->sweep) {
+            break;
+        }
+    }
+    fflush(stdout);
+
+    if (0 != n_out) {
+        snprintf(line, sizeof(line), "%d # communicator size\n%d # number of message sizes\n",
+                 size, n_out);
+        *rules = realloc(*rules, *rules_len + strlen(line) + section_len + 1);
+        strcpy(*rules + *rules_len, line);
+        *rules_len += strlen(line);
+        strcpy(*rules + *rules_len, section);
+        *rules_len += section_len;
+        (*n_rules)++;
+    }
+    free(section);
+
+ done:
+    free(times);
+    free(configs);
+}
+
+int main(int argc, char **argv)
+{
+    int i, c, p, ret, rank, commsize, provided, n_msgs, n_colls;
+    size_t msgs[TUNER_MAX_LIST], max_bytes;
+    char *rules[TUNER_NCOLLS];
+    size_t rules_len[TUNER_NCOLLS];
+    int n_rules[TUNER_NCOLLS];
+    MPI_Comm ctrl;
+    FILE *fp;
+
+    /* The forced algorithms are only taken into account with the
+       dynamic rules, which cannot be enabled after MPI_Init, and a
+       rules file would take precedence over them.  Make sure the tuned
+       component is used unless the user selected the components. */
+    setenv("OMPI_MCA_coll_tuned_use_dynamic_rules", "1", 1);
+    unsetenv("OMPI_MCA_coll_tuned_dynamic_rules_filename");
+    setenv("OMPI_MCA_coll", "basic,libnbc,self,tuned", 0);
+
+    MPI_Init(&argc, &argv);
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &commsize);
+
+    for (i = 0; i < TUNER_NCOLLS; i++) {
+        coll_selected[i] = true;
+    }
+    ret = parse_opts(rank, argc, argv);
+    if (0 == ret && NULL == filename) {
+        ret = -1;
+    }
+    if (0 != ret) {
+        if (ret < 0 && 0 == rank) {
+            print_help(argv[0]);
+        }
+        MPI_T_finalize();
+        MPI_Finalize();
+        exit(ret < 0 ? 1 : 0);
+    }
+
+    if (0 == n_comm_sizes) {
+        for (p = 2; p < commsize; p *= 2) {
+            comm_sizes[n_comm_sizes++] = p;
+        }
+        comm_sizes[n_comm_sizes++] = commsize;
+    }
+    for (n_msgs = 0, max_bytes = msg_min; max_bytes <= msg_max && n_msgs < TUNER_MAX_LIST;
+         max_bytes *= msg_factor) {
+        msgs[n_msgs++] = max_bytes;
+    }
+    max_bytes = msgs[n_msgs - 1];
+    /* the counts are at least one element per peer (see tuner_count) */
+    if (max_bytes < commsize * sizeof(int)) {
+        max_bytes = commsize * sizeof(int);
+    }
+
+    tuner_sbuf = (char*)calloc(max_bytes + sizeof(int), 1);
+    tuner_rbuf = (char*)calloc(max_bytes + sizeof(int), 1);
+    tuner_counts = (int*)malloc(commsize * sizeof(int));
+    tuner_displs = (int*)malloc(commsize * sizeof(int));
+    if (NULL == tuner_sbuf || NULL == tuner_rbuf || NULL == tuner_counts || NULL == tuner_displs) {
+        fprintf(stderr, "Fail to allocate memory. Abort\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    for (c = 0; c < TUNER_NCOLLS; c++) {
+        rules[c] = NULL;
+        rules_len[c] = 0;
+        n_rules[c] = 0;
+    }
+
+    for (i = 0; i < n_comm_sizes; i++) {
+        p = comm_sizes[i];
+        if (p < 2 || p > commsize) {
+            continue;
+        }
+        MPI_Comm_split(MPI_COMM_WORLD, (rank < p) ? 0 : MPI_UNDEFINED, rank, &ctrl);
+        if (MPI_COMM_NULL != ctrl) {
+            for (c = 0; c < TUNER_NCOLLS; c++) {
+                if (!coll_selected[c]) {
+                    continue;
+                }
+                if (tuner_colls[c].sweep) {
+                    tuner_run_coll(&tuner_colls[c], ctrl, msgs, n_msgs,
+                                   &rules[c], &rules_len[c], &n_rules[c]);
+                } else {
+                    /* a single rule, measured at a medium size */
+                    size_t msg = (BARRIER == tuner_colls[c].id) ? 0 : msgs[n_msgs / 2];
+                    tuner_run_coll(&tuner_colls[c], ctrl, &msg, 1,
+                                   &rules[c], &rules_len[c], &n_rules[c]);
+                }
+            }
+            MPI_Comm_free(&ctrl);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (0 == rank) {
+        fp = fopen(filename, "w");
+        if (NULL == fp) {
+            fprintf(stderr, "Cannot open %s. Abort\n", filename);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        for (n_colls = 0, c = 0; c < TUNER_NCOLLS; c++) {
+            n_colls += (0 != n_rules[c]);
+        }
+        fprintf(fp, "# coll/tuned dynamic rules generated by ompi_coll_tuner on %d processes\n"
+                "# message size, algorithm, fanout and segment size for each range\n",
+                commsize);
+        fprintf(fp, "%d # number of collectives\n", n_colls);
+        for (c = 0; c < TUNER_NCOLLS; c++) {
+            if (0 == n_rules[c]) {
+                continue;
+            }
+            fprintf(fp, "%d # %s\n%d # number of communicator sizes\n%s",
+                    tuner_colls[c].id, tuner_colls[c].name, n_rules[c], rules[c]);
+        }
+        fclose(fp);
+    }
+
+    for (c = 0; c < TUNER_NCOLLS; c++) {
+        free(rules[c]);
+    }
+    free(tuner_sbuf);
+    free(tuner_rbuf);
+    free(tuner_counts);
+    free(tuner_displs);
+    free(filename);
+
+    MPI_T_finalize();
+    MPI_Finalize();
+    return 0;
+}
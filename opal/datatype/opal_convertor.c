@@ -269,6 +269,13 @@ complete_contiguous_data_pack:
         return 1;
     }
 
+    if( OPAL_UNLIKELY(pConv->flags & CONVERTOR_STACK_OUTDATED) ) {
+        size_t position = pConv->bConverted;
+        opal_convertor_set_position_nocheck( pConv, &position );
+    }
+    if( OPAL_UNLIKELY(opal_convertor_parallel_eligible( pConv, iov, *out_size )) ) {
+        return opal_convertor_parallel_advance( pConv, iov, out_size, max_data );
+    }
     return pConv->fAdvance( pConv, iov, out_size, max_data );
 }
 
@@ -321,6 +328,13 @@ complete_contiguous_data_unpack:
         return 1;
     }
 
+    if( OPAL_UNLIKELY(pConv->flags & CONVERTOR_STACK_OUTDATED) ) {
+        size_t position = pConv->bConverted;
+        opal_convertor_set_position_nocheck( pConv, &position );
+    }
+    if( OPAL_UNLIKELY(opal_convertor_parallel_eligible( pConv, iov, *out_size )) ) {
+        return opal_convertor_parallel_advance( pConv, iov, out_size, max_data );
+    }
     return pConv->fAdvance( pConv, iov, out_size, max_data );
 }
 
@@ -414,7 +428,9 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
                                              size_t* position )
 {
     int32_t rc;
+    uint32_t outdated = convertor->flags & CONVERTOR_STACK_OUTDATED;
 
+    convertor->flags &= ~CONVERTOR_STACK_OUTDATED;
     /**
      * create_stack_with_pos_contig always set the position relative to the ZERO
      * position, so there is no need for special handling. In all other cases,
@@ -425,7 +441,7 @@ int32_t opal_convertor_set_position_nocheck( opal_convertor_t* convertor,
         rc = opal_convertor_create_stack_with_pos_contig( convertor, (*position),
                                                           opal_datatype_local_sizes );
     } else {
-        if( (0 == (*position)) || ((*position) < convertor->bConverted) ) {
+        if( (0 == (*position)) || ((*position) < convertor->bConverted) || outdated ) {
             rc = opal_convertor_create_stack_at_begining( convertor, opal_datatype_local_sizes );
             if( 0 == (*position) ) return rc;
         }
@@ -549,7 +565,9 @@ size_t opal_convertor_compute_remote_size( opal_convertor_t* pConvertor )
         }                                                               \
         convertor->flags &= ~CONVERTOR_NO_OP;                           \
         {                                                               \
-            uint32_t required_stack_length = datatype->loops + 1;       \
+            uint32_t required_stack_length = 1 +                        \
+                ((convertor->use_desc == &(datatype->opt_desc)) ?       \
+                 datatype->opt_loops : datatype->loops);                \
                                                                         \
             if( required_stack_length > convertor->stack_size ) {       \
                 assert(convertor->pStack == convertor->static_stack);   \
@@ -57,6 +57,7 @@ BEGIN_C_DECLS
 #define CONVERTOR_CUDA_UNIFIED     0x10000000
 #define CONVERTOR_HAS_REMOTE_SIZE  0x20000000
 #define CONVERTOR_SKIP_CUDA_INIT   0x40000000
+#define CONVERTOR_STACK_OUTDATED   0x80000000  /**< bConverted moved without the stack, see opal_convertor_raw */
 
 union dt_elem_desc;
 typedef struct opal_convertor_t opal_convertor_t;
@@ -327,7 +328,8 @@ opal_convertor_set_position( opal_convertor_t* convertor,
     /*
      * If the convertor is already at the correct position we are happy.
      */
-    if( OPAL_LIKELY((*position) == convertor->bConverted) ) return OPAL_SUCCESS;
+    if( OPAL_LIKELY(((*position) == convertor->bConverted) &&
+                    !(convertor->flags & CONVERTOR_STACK_OUTDATED)) ) return OPAL_SUCCESS;
 
     /* Remove the completed flag if it's already set */
     convertor->flags &= ~CONVERTOR_COMPLETED;
@@ -1,6 +1,6 @@
 /* -*- Mode: C; c-basic-offset:4 ; -*- */
 /*
- * Copyright (c) 2004-2014 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2009      Oak Ridge National Labs.  All rights reserved.
@@ -19,6 +19,7 @@
 #include "opal_config.h"
 
 #include "opal/datatype/opal_convertor.h"
+#include "opal/datatype/opal_datatype_internal.h"
 
 BEGIN_C_DECLS
 
@@ -49,6 +50,37 @@ opal_convertor_master_t* opal_convertor_find_or_create_master( uint32_t remote_a
  */
 void opal_convertor_destroy_masters( void );
 
+/*
+ * Pack or unpack a single large buffer with the help of opal_ddt_parallel_threads
+ * threads, each converting a contiguous range of the packed data. Fall back on
+ * the convertor's own fAdvance when the buffer is too small to be split.
+ */
+int32_t opal_convertor_parallel_advance( opal_convertor_t* pConv,
+                                         struct iovec* iov, uint32_t* out_size,
+                                         size_t* max_data );
+
+/*
+ * Stop the threads used by opal_convertor_parallel_advance.
+ */
+void opal_convertor_parallel_finalize( void );
+
+/*
+ * Only homogeneous conversions to or from a single user provided buffer, larger
+ * than opal_ddt_parallel_threshold, are worth being split across threads.
+ */
+static inline int
+opal_convertor_parallel_eligible( const opal_convertor_t* pConv,
+                                  const struct iovec* iov, uint32_t out_size )
+{
+    if( OPAL_LIKELY(opal_ddt_parallel_threads <= 1) ) return 0;
+    if( (1 != out_size) || (NULL == iov[0].iov_base) ) return 0;
+    if( (iov[0].iov_len < opal_ddt_parallel_threshold) ||
+        ((pConv->local_size - pConv->bConverted) < opal_ddt_parallel_threshold) ) return 0;
+    if( !(pConv->flags & CONVERTOR_HOMOGENEOUS) ||
+        (pConv->flags & (CONVERTOR_WITH_CHECKSUM | CONVERTOR_CUDA | CONVERTOR_CUDA_UNIFIED)) ) return 0;
+    return 0 == pConv->partial_length;
+}
+
 
 END_C_DECLS
 
@@ -0,0 +1,314 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "opal/constants.h"
+#include "opal/threads/threads.h"
+#include "opal/threads/mutex.h"
+#include "opal/datatype/opal_convertor_internal.h"
+#include "opal/datatype/opal_datatype_internal.h"
+
+/*
+ * Parallel pack and unpack of large non-contiguous buffers.
+ *
+ * A single call to opal_convertor_pack or opal_convertor_unpack is cut
+ * in contiguous ranges of the packed stream, one per thread. Each range
+ * gets its own clone of the convertor, moved to the beginning of the
+ * range with opal_convertor_set_position, so the ranges are converted
+ * independently. This is done in two rounds: first all the clones are
+ * positioned, which aligns the beginning of every range on a predefined
+ * element, then each range is converted up to the beginning of the
+ * next one. The calling thread converts the first range with the
+ * original convertor and takes the state of the clone of the last range
+ * once everything is done.
+ *
+ * The worker threads are created on demand and kept around until the
+ * datatype engine is finalized. Only one call at a time uses them,
+ * concurrent calls from other threads fall back to the sequential path.
+ * The waits block on a pthread condition bound to the opal mutex, they
+ * never call opal_progress: idle workers sleep, and a conversion started
+ * from a progress callback does not reenter the progress engine.
+ */
+
+/* The ranges are never smaller than this */
+#define OPAL_CONVERTOR_PARALLEL_MIN_CHUNK  (64 * 1024)
+
+typedef struct {
+    opal_convertor_t  convertor;
+    opal_convertor_t* pConv;      /* the convertor working on this range */
+    size_t            position;   /* beginning of the range */
+    size_t            length;     /* bytes to convert */
+    unsigned char*    buffer;     /* packed data of the range */
+    size_t            converted;
+    int32_t           rc;
+} opal_convertor_parallel_chunk_t;
+
+typedef void (*opal_convertor_parallel_fn_t)( opal_convertor_parallel_chunk_t* chunk, bool unpack );
+
+static struct {
+    opal_mutex_t                  lock;
+    pthread_cond_t                work_cond;  /* workers wait for a new round */
+    pthread_cond_t                done_cond;  /* the caller waits for the end of a round */
+    opal_mutex_t                  in_use;     /* one parallel conversion at a time */
+    opal_thread_t*                threads;
+    int                           nthreads;
+    bool                          shutdown;
+    /* the current round */
+    opal_convertor_parallel_fn_t  fn;
+    opal_convertor_parallel_chunk_t* chunks;
+    bool                          unpack;
+    int                           nchunks;
+    int                           next;       /* next chunk to be handed out */
+    int                           pending;    /* chunks handed out and not yet done */
+} opal_convertor_parallel = {
+    .lock      = OPAL_MUTEX_STATIC_INIT,
+    .work_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER,
+    .in_use    = OPAL_MUTEX_STATIC_INIT,
+};
+
+/* Block on cond until signaled, without progressing */
+#define OPAL_CONVERTOR_PARALLEL_WAIT(cond) \
+    pthread_cond_wait( &opal_convertor_parallel.cond, &opal_convertor_parallel.lock.m_lock_pthread )
+
+/* Convert the chunks of the current round until there are none left.
+ * Called with the lock held, returns with the lock held. */
+static void opal_convertor_parallel_work( void )
+{
+    opal_convertor_parallel_chunk_t* chunk;
+
+    while( opal_convertor_parallel.next < opal_convertor_parallel.nchunks ) {
+        chunk = &opal_convertor_parallel.chunks[opal_convertor_parallel.next++];
+        opal_convertor_parallel.pending++;
+        opal_mutex_unlock( &opal_convertor_parallel.lock );
+        opal_convertor_parallel.fn( chunk, opal_convertor_parallel.unpack );
+        opal_mutex_lock( &opal_convertor_parallel.lock );
+        if( 0 == --opal_convertor_parallel.pending &&
+            opal_convertor_parallel.next == opal_convertor_parallel.nchunks ) {
+            pthread_cond_signal( &opal_convertor_parallel.done_cond );
+        }
+    }
+}
+
+static void* opal_convertor_parallel_worker( opal_object_t* arg )
+{
+    opal_mutex_lock( &opal_convertor_parallel.lock );
+    while( !opal_convertor_parallel.shutdown ) {
+        opal_convertor_parallel_work();
+        OPAL_CONVERTOR_PARALLEL_WAIT( work_cond );
+    }
+    opal_mutex_unlock( &opal_convertor_parallel.lock );
+    return NULL;
+}
+
+/* Make sure nthreads - 1 workers are running, return how many there are */
+static int opal_convertor_parallel_start_workers( int nthreads )
+{
+    opal_thread_t* threads;
+
+    if( opal_convertor_parallel.nthreads >= nthreads - 1 ) {
+        return opal_convertor_parallel.nthreads;
+    }
+    threads = (opal_thread_t*)realloc( opal_convertor_parallel.threads,
+                                       (nthreads - 1) * sizeof(opal_thread_t) );
+    if( NULL == threads ) {
+        return opal_convertor_parallel.nthreads;
+    }
+    opal_convertor_parallel.threads = threads;
+    /* the objects do not keep pointers to themselves, they survive the realloc */
+    while( opal_convertor_parallel.nthreads < nthreads - 1 ) {
+        opal_thread_t* thread = &threads[opal_convertor_parallel.nthreads];
+        OBJ_CONSTRUCT( thread, opal_thread_t );
+        thread->t_run = opal_convertor_parallel_worker;
+        thread->t_arg = NULL;
+        if( OPAL_SUCCESS != opal_thread_start( thread ) ) {
+            OBJ_DESTRUCT( thread );
+            break;
+        }
+        opal_convertor_parallel.nthreads++;
+    }
+    return opal_convertor_parallel.nthreads;
+}
+
+/* Run fn on all the chunks, the calling thread being in charge of the
+ * first one. */
+static void opal_convertor_parallel_run( opal_convertor_parallel_fn_t fn,
+                                         opal_convertor_parallel_chunk_t* chunks,
+                                         int nchunks, bool unpack )
+{
+    opal_mutex_lock( &opal_convertor_parallel.lock );
+    opal_convertor_parallel.fn      = fn;
+    opal_convertor_parallel.chunks  = chunks;
+    opal_convertor_parallel.unpack  = unpack;
+    opal_convertor_parallel.nchunks = nchunks;
+    opal_convertor_parallel.next    = 1;
+    opal_convertor_parallel.pending = 0;
+    pthread_cond_broadcast( &opal_convertor_parallel.work_cond );
+    opal_mutex_unlock( &opal_convertor_parallel.lock );
+
+    fn( &chunks[0], unpack );
+
+    opal_mutex_lock( &opal_convertor_parallel.lock );
+    opal_convertor_parallel_work();
+    while( 0 != opal_convertor_parallel.pending ) {
+        OPAL_CONVERTOR_PARALLEL_WAIT( done_cond );
+    }
+    opal_convertor_parallel.nchunks = 0;
+    opal_convertor_parallel.next    = 0;
+    opal_mutex_unlock( &opal_convertor_parallel.lock );
+}
+
+/* First round: move the clone to the beginning of its range, on a
+ * predefined element boundary */
+static void opal_convertor_parallel_position( opal_convertor_parallel_chunk_t* chunk, bool unpack )
+{
+    size_t position = chunk->position;
+
+    chunk->rc = opal_convertor_set_position( chunk->pConv, &position );
+    if( 0 != chunk->pConv->partial_length ) {
+        position -= chunk->pConv->partial_length;
+        chunk->pConv->partial_length = 0;
+        chunk->rc = opal_convertor_set_position_nocheck( chunk->pConv, &position );
+    }
+    chunk->position = position;
+}
+
+/* Second round: convert the range */
+static void opal_convertor_parallel_convert( opal_convertor_parallel_chunk_t* chunk, bool unpack )
+{
+    struct iovec iov = { .iov_base = (IOVBASE_TYPE*)chunk->buffer, .iov_len = chunk->length };
+    uint32_t iov_count = 1;
+
+    chunk->converted = 0;
+    if( 0 == chunk->length ) {
+        chunk->rc = 0;
+        return;
+    }
+    chunk->rc = chunk->pConv->fAdvance( chunk->pConv, &iov, &iov_count, &chunk->converted );
+}
+
+int32_t opal_convertor_parallel_advance( opal_convertor_t* pConv,
+                                         struct iovec* iov, uint32_t* out_size,
+                                         size_t* max_data )
+{
+    opal_convertor_parallel_chunk_t* chunks;
+    opal_convertor_parallel_chunk_t* last;
+    bool unpack = !!(pConv->flags & CONVERTOR_RECV);
+    size_t start = pConv->bConverted, length, chunk_length, total = 0;
+    int nchunks, i;
+    int32_t rc;
+
+    length = pConv->local_size - start;
+    if( iov[0].iov_len < length ) length = iov[0].iov_len;
+
+    nchunks = opal_ddt_parallel_threads;
+    if( (size_t)nchunks > length / OPAL_CONVERTOR_PARALLEL_MIN_CHUNK ) {
+        nchunks = (int)(length / OPAL_CONVERTOR_PARALLEL_MIN_CHUNK);
+    }
+    if( nchunks < 2 || 0 != opal_mutex_trylock( &opal_convertor_parallel.in_use ) ) {
+        return pConv->fAdvance( pConv, iov, out_size, max_data );
+    }
+    opal_mutex_lock( &opal_convertor_parallel.lock );
+    i = opal_convertor_parallel_start_workers( nchunks );
+    opal_mutex_unlock( &opal_convertor_parallel.lock );
+    if( nchunks > i + 1 ) nchunks = i + 1;
+    chunks = (opal_convertor_parallel_chunk_t*)malloc( nchunks * sizeof(opal_convertor_parallel_chunk_t) );
+    if( nchunks < 2 || NULL == chunks ) {
+        free( chunks );
+        opal_mutex_unlock( &opal_convertor_parallel.in_use );
+        return pConv->fAdvance( pConv, iov, out_size, max_data );
+    }
+
+    chunk_length = length / nchunks;
+    chunks[0].pConv    = pConv;
+    chunks[0].position = start;
+    for( i = 1; i < nchunks; i++ ) {
+        OBJ_CONSTRUCT( &chunks[i].convertor, opal_convertor_t );
+        opal_convertor_clone( pConv, &chunks[i].convertor, 0 );
+        chunks[i].pConv    = &chunks[i].convertor;
+        chunks[i].position = start + i * chunk_length;
+    }
+    opal_convertor_parallel_run( opal_convertor_parallel_position, chunks + 1, nchunks - 1, unpack );
+
+    for( i = 0, rc = 0; i < nchunks; i++ ) {
+        size_t end = (i == nchunks - 1) ? start + length : chunks[i + 1].position;
+        if( i > 0 && chunks[i].rc < 0 ) rc = chunks[i].rc;
+        chunks[i].length = (end > chunks[i].position) ? end - chunks[i].position : 0;
+        chunks[i].buffer = (unsigned char*)iov[0].iov_base + (chunks[i].position - start);
+    }
+    if( 0 == rc ) {
+        opal_convertor_parallel_run( opal_convertor_parallel_convert, chunks, nchunks, unpack );
+        for( i = 0; i < nchunks; i++ ) {
+            if( chunks[i].rc < 0 ) rc = chunks[i].rc;
+            total += chunks[i].converted;
+            /* a range stopping short leaves a hole in the packed stream */
+            if( i < nchunks - 1 && chunks[i].converted != chunks[i].length ) rc = -1;
+        }
+    }
+
+    if( 0 == rc ) {
+        /* The original convertor is now at the end of the first range, it
+         * takes the state of the convertor of the last one. */
+        last = &chunks[nchunks - 1];
+        if( 0 == last->length ) {
+            for( i = nchunks - 1; i > 0 && 0 == chunks[i].length; i-- );
+            last = &chunks[i];
+        }
+        if( last->pConv != pConv ) {
+            memcpy( pConv->pStack, last->pConv->pStack,
+                    sizeof(dt_stack_t) * (last->pConv->stack_pos + 1) );
+            pConv->stack_pos      = last->pConv->stack_pos;
+            pConv->bConverted     = last->pConv->bConverted;
+            pConv->partial_length = last->pConv->partial_length;
+            pConv->flags          = last->pConv->flags;
+        }
+        iov[0].iov_len = total;
+        *max_data = total;
+        *out_size = 1;
+        rc = (pConv->flags & CONVERTOR_COMPLETED) ? 1 : 0;
+    } else if( pConv->bConverted != start ) {
+        /* the first range moved the original convertor, nothing has been
+         * reported as converted so move it back where it started */
+        size_t position = start;
+        (void)opal_convertor_set_position( pConv, &position );
+    }
+
+    for( i = 1; i < nchunks; i++ ) {
+        OBJ_DESTRUCT( &chunks[i].convertor );
+    }
+    free( chunks );
+    opal_mutex_unlock( &opal_convertor_parallel.in_use );
+    return rc;
+}
+
+void opal_convertor_parallel_finalize( void )
+{
+    opal_mutex_lock( &opal_convertor_parallel.lock );
+    opal_convertor_parallel.shutdown = true;
+    pthread_cond_broadcast( &opal_convertor_parallel.work_cond );
+    opal_mutex_unlock( &opal_convertor_parallel.lock );
+
+    for( int i = 0; i < opal_convertor_parallel.nthreads; i++ ) {
+        opal_thread_join( &opal_convertor_parallel.threads[i], NULL );
+        OBJ_DESTRUCT( &opal_convertor_parallel.threads[i] );
+    }
+    free( opal_convertor_parallel.threads );
+    opal_convertor_parallel.threads  = NULL;
+    opal_convertor_parallel.nthreads = 0;
+    opal_convertor_parallel.shutdown = false;
+}
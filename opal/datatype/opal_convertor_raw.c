@@ -94,6 +94,22 @@ opal_convertor_raw( opal_convertor_t* pConvertor,
         *iov_count = 1;
         return 1;  /* we're done */
     }
+    if( NULL != pData->iovec ) {
+        /* The memory layout of the datatype is cached, build the iovecs directly
+         * from the current position. Only bConverted is updated, the stack will
+         * be rebuilt if the convertor is used for anything else.
+         */
+        *length = pConvertor->local_size - pConvertor->bConverted;
+        opal_datatype_iovec_window( pData, pConvertor->count, pConvertor->pBaseBuf,
+                                    pConvertor->bConverted, iov, iov_count, length );
+        pConvertor->bConverted += *length;
+        if( pConvertor->bConverted == pConvertor->local_size ) {
+            pConvertor->flags |= CONVERTOR_COMPLETED;
+            return 1;
+        }
+        pConvertor->flags |= CONVERTOR_STACK_OUTDATED;
+        return 0;
+    }
 
     DO_DEBUG( opal_output( 0, "opal_convertor_raw( %p, {%p, %" PRIu32 "}, %"PRIsize_t " )\n", (void*)pConvertor,
                            (void*)iov, *iov_count, *length ); );
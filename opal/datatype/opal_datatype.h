@@ -3,7 +3,7 @@
  * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2017 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2006 High Performance Computing Center Stuttgart,
@@ -40,6 +40,9 @@
 #include "opal_config.h"
 
 #include <stddef.h>
+#ifdef HAVE_SYS_UIO_H
+#include <sys/uio.h>
+#endif
 
 #include "opal/class/opal_object.h"
 
@@ -100,6 +103,8 @@ struct dt_type_desc_t {
 };
 typedef struct dt_type_desc_t dt_type_desc_t;
 
+typedef struct opal_datatype_iovec_t opal_datatype_iovec_t;
+
 
 /*
  * The datatype description.
@@ -119,6 +124,7 @@ struct opal_datatype_t {
     size_t             nbElems;  /**< total number of elements inside the datatype */
     uint32_t           align;    /**< data should be aligned to */
     uint32_t           loops;    /**< number of loops on the iternal type stack */
+    uint32_t           opt_loops; /**< number of loops on the stack when walking opt_desc */
 
     /* Attribute fields */
     char               name[OPAL_MAX_OBJECT_NAME];  /**< name of the datatype */
@@ -133,9 +139,11 @@ struct opal_datatype_t {
                                       layer). This field should never be initialized in homogeneous
                                       environments */
     /* --- cacheline 5 boundary (320 bytes) was 32-36 bytes ago --- */
+    opal_datatype_iovec_t *iovec; /**< cached run-length description of the contiguous blocks of the
+                                       datatype, built on demand (see opal_datatype_iovec_window) */
 
-    /* size: 352, cachelines: 6, members: 15 */
-    /* last cacheline: 28-32 bytes */
+    /* size: 360, cachelines: 6, members: 16 */
+    /* last cacheline: 36-40 bytes */
 };
 
 typedef struct opal_datatype_t opal_datatype_t;
@@ -316,6 +324,26 @@ opal_datatype_copy_content_same_ddt( const opal_datatype_t* pData, int32_t count
 
 OPAL_DECLSPEC int opal_datatype_compute_ptypes( opal_datatype_t* datatype );
 
+/**
+ * Build and attach to a committed datatype the cached description of its memory
+ * layout used by opal_datatype_iovec_window. This is done at commit time when the
+ * opal_ddt_iovec_cache MCA parameter is set, or on the first call to
+ * opal_datatype_iovec_window otherwise.
+ */
+OPAL_DECLSPEC int32_t opal_datatype_iovec_build( opal_datatype_t* pData );
+
+/**
+ * Describe the memory holding the packed bytes [position, position + *length) of
+ * count datatypes starting at base, in at most *iov_count iovecs. On return
+ * *iov_count is the number of iovecs filled and *length the number of bytes they
+ * cover, which is less than requested if there were not enough iovecs. The cost
+ * does not depend on the position.
+ */
+OPAL_DECLSPEC int32_t
+opal_datatype_iovec_window( const opal_datatype_t* pData, size_t count, void* base,
+                            size_t position, struct iovec* iov, uint32_t* iov_count,
+                            size_t* length );
+
 OPAL_DECLSPEC const opal_datatype_t*
 opal_datatype_match_size( int size, uint16_t datakind, uint16_t datalang );
 
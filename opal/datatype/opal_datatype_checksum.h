@@ -1,6 +1,6 @@
 /* -*- Mode: C; c-basic-offset:4 ; -*- */
 /*
- * Copyright (c) 2004-2009 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2006 The Regents of the University of California.
@@ -23,6 +23,20 @@
 #include "opal/datatype/opal_datatype_memcpy.h"
 #include "opal/util/crc.h"
 
+/*
+ * A strided copy going through MEMCPY_CSUM for every block, for the
+ * cases where MEMCPY_CSUM does more than a memcpy.
+ */
+#define MEMCPY_STRIDED_CSUM_BY_BLOCK( DST, DST_STRIDE, SRC, SRC_STRIDE, BLENGTH, COUNT, CONVERTOR ) \
+do { \
+    unsigned char *_dst = (DST), *_src = (SRC); \
+    for( size_t _i = 0; _i < (COUNT); _i++ ) { \
+        MEMCPY_CSUM( _dst, _src, (BLENGTH), (CONVERTOR) ); \
+        _dst += (DST_STRIDE); \
+        _src += (SRC_STRIDE); \
+    } \
+} while (0)
+
 #if defined(CHECKSUM)
 
 #if defined (OPAL_CSUM_DST)
@@ -39,6 +53,10 @@ do { \
 } while (0)
 #endif  /* if OPAL_CSUM_DST */
 
+/* The checksum is accumulated in order, block by block */
+#define MEMCPY_STRIDED_CSUM( DST, DST_STRIDE, SRC, SRC_STRIDE, BLENGTH, COUNT, CONVERTOR ) \
+    MEMCPY_STRIDED_CSUM_BY_BLOCK( (DST), (DST_STRIDE), (SRC), (SRC_STRIDE), (BLENGTH), (COUNT), (CONVERTOR) )
+
 #define COMPUTE_CSUM( SRC, BLENGTH, CONVERTOR ) \
 do { \
     (CONVERTOR)->checksum += OPAL_CSUM_PARTIAL( (SRC), (BLENGTH), &(CONVERTOR)->csum_ui1, &(CONVERTOR)->csum_ui2 ); \
@@ -49,6 +67,9 @@ do { \
 #define MEMCPY_CSUM( DST, SRC, BLENGTH, CONVERTOR ) \
     MEMCPY( (DST), (SRC), (BLENGTH) )
 
+#define MEMCPY_STRIDED_CSUM( DST, DST_STRIDE, SRC, SRC_STRIDE, BLENGTH, COUNT, CONVERTOR ) \
+    MEMCPY_STRIDED( (DST), (DST_STRIDE), (SRC), (SRC_STRIDE), (BLENGTH), (COUNT) )
+
 #define COMPUTE_CSUM( SRC, BLENGTH, CONVERTOR )
 
 #endif  /* if CHECKSUM */
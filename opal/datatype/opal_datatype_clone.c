@@ -3,7 +3,7 @@
  * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2017 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2006 High Performance Computing Center Stuttgart,
@@ -44,6 +44,7 @@ int32_t opal_datatype_clone( const opal_datatype_t * src_type, opal_datatype_t *
 
     dest_type->flags &= (~OPAL_DATATYPE_FLAG_PREDEFINED);
     dest_type->ptypes = NULL;
+    dest_type->iovec = NULL;
     dest_type->desc.desc = temp;
 
     /**
@@ -171,18 +171,19 @@ static inline int32_t _copy_content_same_ddt( const opal_datatype_t* datatype, i
         return 0;  /* completed */
     }
 
-    pStack = (dt_stack_t*)alloca( sizeof(dt_stack_t) * (datatype->loops + 1) );
+    description = datatype->opt_desc.desc;
+    if( NULL == description ) {
+        description = datatype->desc.desc;
+        pStack = (dt_stack_t*)alloca( sizeof(dt_stack_t) * (datatype->loops + 1) );
+    } else {
+        pStack = (dt_stack_t*)alloca( sizeof(dt_stack_t) * (datatype->opt_loops + 1) );
+    }
     pStack->count = count;
     pStack->index   = -1;
     pStack->disp    = 0;
     pos_desc = 0;
     stack_pos = 0;
 
-    description = datatype->opt_desc.desc;
-    if( NULL == description ) {
-        description = datatype->desc.desc;
-    }
-
     UPDATE_INTERNAL_COUNTERS( description, 0, pElem, count_desc );
 
     while( 1 ) {
@@ -3,7 +3,7 @@
  * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2017 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2006 High Performance Computing Center Stuttgart,
@@ -55,6 +55,8 @@ static void opal_datatype_construct( opal_datatype_t* pData )
 
     pData->ptypes             = NULL;
     pData->loops              = 0;
+    pData->opt_loops          = 0;
+    pData->iovec              = NULL;
 }
 
 static void opal_datatype_destruct( opal_datatype_t* datatype )
@@ -83,6 +85,7 @@ static void opal_datatype_destruct( opal_datatype_t* datatype )
         free(datatype->ptypes);
         datatype->ptypes = NULL;
     }
+    opal_datatype_iovec_release( datatype );
 
     /* make sure the name is set to empty */
     datatype->name[0] = '\0';
@@ -102,7 +102,8 @@ int opal_convertor_create_stack_with_pos_general( opal_convertor_t* pConvertor,
     pStack->disp = count * (pData->ub - pData->lb) + pElems[loop_length].elem.disp;
 
     pos_desc  = 0;
-    remoteLength = (size_t*)alloca( sizeof(size_t) * (pConvertor->pDesc->loops + 1));
+    remoteLength = (size_t*)alloca( sizeof(size_t) * (1 + ((pConvertor->use_desc == &(pData->opt_desc)) ?
+                                                           pData->opt_loops : pData->loops)) );
     remoteLength[0] = 0;  /* initial value set to ZERO */
     loop_length = 0;
 
@@ -519,6 +519,11 @@ extern bool opal_ddt_copy_debug;
 extern bool opal_ddt_unpack_debug;
 extern bool opal_ddt_pack_debug;
 extern bool opal_ddt_raw_debug;
+extern int opal_ddt_parallel_threads;
+extern size_t opal_ddt_parallel_threshold;
+extern bool opal_ddt_iovec_cache;
+
+void opal_datatype_iovec_release( struct opal_datatype_t* pData );
 
 END_C_DECLS
 #endif  /* OPAL_DATATYPE_INTERNAL_H_HAS_BEEN_INCLUDED */
@@ -0,0 +1,238 @@
+/* -*- Mode: C; c-basic-offset:4 ; -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "opal/constants.h"
+#include "opal/sys/atomic.h"
+#include "opal/datatype/opal_datatype.h"
+#include "opal/datatype/opal_datatype_internal.h"
+#include "opal/datatype/opal_convertor.h"
+
+/*
+ * Cached description of the memory layout of a datatype.
+ *
+ * The list of contiguous blocks of one datatype, as generated by
+ * opal_convertor_raw, is compressed into runs of blocks of the same length
+ * separated by the same stride. Each run also remembers the position in
+ * the packed stream of its first byte, so the block holding any packed
+ * position is found with a binary search over the runs, and the memory
+ * for any range of the packed stream of any number of datatypes can be
+ * described without walking the datatype description.
+ */
+
+#define OPAL_DATATYPE_IOVEC_RAW_COUNT 128
+
+typedef struct {
+    ptrdiff_t disp;      /**< displacement of the first block, from the user buffer */
+    ptrdiff_t stride;    /**< distance between the beginning of two consecutive blocks */
+    size_t    length;    /**< length of each block */
+    size_t    count;     /**< number of blocks */
+    size_t    position;  /**< packed position of the first byte of the run */
+} opal_datatype_iovec_run_t;
+
+struct opal_datatype_iovec_t {
+    size_t                    nb_runs;
+    size_t                    nb_blocks;  /**< total number of contiguous blocks */
+    opal_datatype_iovec_run_t runs[];
+};
+
+static int
+opal_datatype_iovec_add_block( opal_datatype_iovec_t** iovec, size_t* max_runs,
+                               ptrdiff_t disp, size_t length, size_t position )
+{
+    opal_datatype_iovec_t* cache = *iovec;
+    opal_datatype_iovec_run_t* run;
+
+    if( 0 != cache->nb_runs ) {
+        run = &cache->runs[cache->nb_runs - 1];
+        if( run->length == length ) {
+            if( 1 == run->count ) {
+                run->stride = disp - run->disp;
+                run->count  = 2;
+                goto done;
+            }
+            if( (disp - run->disp) == (ptrdiff_t)run->count * run->stride ) {
+                run->count++;
+                goto done;
+            }
+        }
+    }
+    if( cache->nb_runs == *max_runs ) {
+        *max_runs *= 2;
+        cache = (opal_datatype_iovec_t*)realloc( cache, sizeof(opal_datatype_iovec_t) +
+                                                 (*max_runs) * sizeof(opal_datatype_iovec_run_t) );
+        if( NULL == cache ) return OPAL_ERR_OUT_OF_RESOURCE;
+        *iovec = cache;
+    }
+    run = &cache->runs[cache->nb_runs++];
+    run->disp     = disp;
+    run->stride   = 0;
+    run->length   = length;
+    run->count    = 1;
+    run->position = position;
+ done:
+    cache->nb_blocks++;
+    return OPAL_SUCCESS;
+}
+
+static opal_datatype_iovec_t*
+opal_datatype_iovec_create( const opal_datatype_t* pData )
+{
+    struct iovec iov[OPAL_DATATYPE_IOVEC_RAW_COUNT];
+    opal_datatype_iovec_t* cache;
+    opal_convertor_t* pConv;
+    size_t max_runs = 8, length, position = 0, block_length = 0;
+    ptrdiff_t block_disp = 0;
+    uint32_t iov_count, i;
+    int rc;
+
+    cache = (opal_datatype_iovec_t*)malloc( sizeof(opal_datatype_iovec_t) +
+                                            max_runs * sizeof(opal_datatype_iovec_run_t) );
+    if( NULL == cache ) return NULL;
+    cache->nb_runs = 0;
+    cache->nb_blocks = 0;
+
+    pConv = opal_convertor_create( opal_local_arch, 0 );
+    if( OPAL_UNLIKELY(NULL == pConv) ) goto error;
+    /* with a NULL buffer the iovecs hold the displacements */
+    if( OPAL_SUCCESS != opal_convertor_prepare_for_send( pConv, pData, 1, NULL ) ) goto error;
+
+    do {
+        iov_count = OPAL_DATATYPE_IOVEC_RAW_COUNT;
+        rc = opal_convertor_raw( pConv, iov, &iov_count, &length );
+        for( i = 0; i < iov_count; i++ ) {
+            if( 0 == iov[i].iov_len ) continue;
+            /* opal_convertor_raw does not merge blocks from different calls */
+            if( (0 != block_length) &&
+                ((ptrdiff_t)iov[i].iov_base == block_disp + (ptrdiff_t)block_length) ) {
+                block_length += iov[i].iov_len;
+                continue;
+            }
+            if( (0 != block_length) &&
+                (OPAL_SUCCESS != opal_datatype_iovec_add_block( &cache, &max_runs, block_disp,
+                                                                block_length, position )) ) {
+                goto error;
+            }
+            position    += block_length;
+            block_disp   = (ptrdiff_t)iov[i].iov_base;
+            block_length = iov[i].iov_len;
+        }
+    } while( 0 == rc );
+    if( (0 != block_length) &&
+        (OPAL_SUCCESS != opal_datatype_iovec_add_block( &cache, &max_runs, block_disp,
+                                                        block_length, position )) ) {
+        goto error;
+    }
+    OBJ_RELEASE( pConv );
+    return cache;
+
+ error:
+    if( NULL != pConv ) OBJ_RELEASE( pConv );
+    free( cache );
+    return NULL;
+}
+
+int32_t opal_datatype_iovec_build( opal_datatype_t* pData )
+{
+    opal_datatype_iovec_t* cache;
+    intptr_t expected = 0;
+
+    if( NULL != pData->iovec ) return OPAL_SUCCESS;
+    if( !opal_datatype_is_committed(pData) ) return OPAL_ERR_BAD_PARAM;
+
+    cache = opal_datatype_iovec_create( pData );
+    if( NULL == cache ) return OPAL_ERR_OUT_OF_RESOURCE;
+    /* another thread might have been faster */
+    if( !opal_atomic_compare_exchange_strong_ptr( (opal_atomic_intptr_t*)&pData->iovec,
+                                                  &expected, (intptr_t)cache ) ) {
+        free( cache );
+    }
+    return OPAL_SUCCESS;
+}
+
+void opal_datatype_iovec_release( opal_datatype_t* pData )
+{
+    free( pData->iovec );
+    pData->iovec = NULL;
+}
+
+int32_t opal_datatype_iovec_window( const opal_datatype_t* pData, size_t count, void* base,
+                                    size_t position, struct iovec* iov, uint32_t* iov_count,
+                                    size_t* length )
+{
+    const opal_datatype_iovec_t* cache = pData->iovec;
+    const opal_datatype_iovec_run_t* run;
+    ptrdiff_t extent = pData->ub - pData->lb;
+    size_t remaining = *length, done = 0, index, offset, block, skip, len;
+    size_t lo, hi, mid;
+    unsigned char* ptr;
+    uint32_t idx = 0;
+
+    if( OPAL_UNLIKELY(NULL == cache) ) {
+        if( OPAL_SUCCESS != opal_datatype_iovec_build( (opal_datatype_t*)pData ) )
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        cache = pData->iovec;
+    }
+    *length = 0;
+    if( (0 == pData->size) || (position >= count * pData->size) ) {
+        *iov_count = 0;
+        return OPAL_SUCCESS;
+    }
+    if( remaining > count * pData->size - position )
+        remaining = count * pData->size - position;
+
+    /* find the run, the block and the offset in the block of the position */
+    index  = position / pData->size;
+    offset = position % pData->size;
+    for( lo = 0, hi = cache->nb_runs - 1; lo < hi; ) {
+        mid = (lo + hi + 1) / 2;
+        if( cache->runs[mid].position <= offset ) lo = mid;
+        else hi = mid - 1;
+    }
+    run   = &cache->runs[lo];
+    block = (offset - run->position) / run->length;
+    skip  = (offset - run->position) % run->length;
+
+    ptr = (unsigned char*)base + index * extent + run->disp + block * run->stride + skip;
+    len = run->length - skip;
+    while( (0 != remaining) && (idx < *iov_count) ) {
+        if( len > remaining ) len = remaining;
+        if( (0 != idx) && (ptr == (unsigned char*)iov[idx - 1].iov_base + iov[idx - 1].iov_len) ) {
+            iov[idx - 1].iov_len += len;
+        } else {
+            iov[idx].iov_base = (IOVBASE_TYPE*)ptr;
+            iov[idx].iov_len  = len;
+            idx++;
+        }
+        done      += len;
+        remaining -= len;
+        if( ++block == run->count ) {
+            block = 0;
+            if( ++run == &cache->runs[cache->nb_runs] ) {
+                run = cache->runs;
+                index++;
+            }
+            ptr = (unsigned char*)base + index * extent + run->disp;
+        } else {
+            ptr += run->stride - (ptrdiff_t)skip;  /* only the first block starts at an offset */
+        }
+        skip = 0;
+        len  = run->length;
+    }
+    *iov_count = idx;
+    *length    = done;
+    return OPAL_SUCCESS;
+}
@@ -3,7 +3,7 @@
  * Copyright (c) 2004-2006 The Trustees of Indiana University and Indiana
  *                         University Research and Technology
  *                         Corporation.  All rights reserved.
- * Copyright (c) 2004-2018 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2004-2006 High Performance Computing Center Stuttgart,
@@ -47,6 +47,10 @@ bool opal_ddt_position_debug = false;
 bool opal_ddt_copy_debug = false;
 bool opal_ddt_raw_debug = false;
 int opal_ddt_verbose = -1;  /* Has the datatype verbose it's own output stream */
+/* by default pack and unpack are done by the calling thread only */
+int opal_ddt_parallel_threads = 1;
+size_t opal_ddt_parallel_threshold = 16 * 1024 * 1024;
+bool opal_ddt_iovec_cache = false;
 
 extern int opal_cuda_verbose;
 
@@ -158,9 +162,36 @@ OPAL_DECLSPEC const opal_datatype_t* opal_datatype_basicDatatypes[OPAL_DATATYPE_
 
 int opal_datatype_register_params(void)
 {
-#if OPAL_ENABLE_DEBUG
     int ret;
 
+    ret = mca_base_var_register ("opal", "opal", NULL, "ddt_parallel_threads",
+                                 "Number of threads used to pack or unpack large non-contiguous buffers (1 = only the calling thread)",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_ddt_parallel_threads);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "opal", NULL, "ddt_parallel_threshold",
+                                 "Minimum size in bytes of a pack or unpack to be split across the ddt_parallel_threads threads",
+                                 MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_ddt_parallel_threshold);
+    if (0 > ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "opal", NULL, "ddt_iovec_cache",
+                                 "Whether to cache at commit time the list of contiguous memory blocks of non-contiguous datatypes, used to speed up the generation of iovecs (nonzero = enabled)",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_ddt_iovec_cache);
+    if (0 > ret) {
+        return ret;
+    }
+
+#if OPAL_ENABLE_DEBUG
     ret = mca_base_var_register ("opal", "mpi", NULL, "ddt_unpack_debug",
                                  "Whether to output debugging information in the ddt unpack functions (nonzero = enabled)",
                                  MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_3,
@@ -238,6 +269,9 @@ static void opal_datatype_finalize (void)
     /* clear all master convertors */
     opal_convertor_destroy_masters();
 
+    /* stop the threads used by the parallel pack and unpack */
+    opal_convertor_parallel_finalize();
+
     opal_output_close (opal_datatype_dfd);
     opal_datatype_dfd = -1;
 }
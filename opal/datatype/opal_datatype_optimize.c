@@ -25,6 +25,7 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "opal/datatype/opal_datatype.h"
 #include "opal/datatype/opal_convertor.h"
@@ -258,6 +259,175 @@ opal_datatype_optimize_short( opal_datatype_t* pData,
     return OPAL_SUCCESS;
 }
 
+/*
+ * Datatypes built from an explicit list of displacements (hindexed, indexed_block,
+ * struct replicated by hand) often describe a repeating pattern that the merging
+ * above cannot express: the same sequence of elements shifted by a constant
+ * displacement. Fold such sequences into a loop, which keeps the description
+ * small and allows the convertor to skip whole iterations when repositioning.
+ */
+#define OPAL_DATATYPE_FOLD_MAX_PERIOD  32  /* longest pattern looked for, in items of the level */
+#define OPAL_DATATYPE_FOLD_MIN_COUNT    4  /* fewer repetitions are not worth a loop */
+
+static ptrdiff_t
+opal_datatype_fold_first_disp( const dt_elem_desc_t* pElem )
+{
+    if( OPAL_DATATYPE_LOOP == pElem->elem.common.type )
+        return pElem[pElem->loop.items].end_loop.first_elem_disp;
+    return pElem->elem.disp;
+}
+
+static size_t
+opal_datatype_fold_size( const dt_elem_desc_t* pElem )
+{
+    if( OPAL_DATATYPE_LOOP == pElem->elem.common.type )
+        return (size_t)pElem->loop.loops * pElem[pElem->loop.items].end_loop.size;
+    return pElem->elem.count * pElem->elem.blocklen *
+        opal_datatype_basicDatatypes[pElem->elem.common.type]->size;
+}
+
+/* Is the item (an element or a complete loop) a single contiguous block ? */
+static bool
+opal_datatype_fold_contiguous( const dt_elem_desc_t* pElem )
+{
+    if( OPAL_DATATYPE_LOOP == pElem->elem.common.type )
+        return (pElem->loop.common.flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) &&
+            ((1 == pElem->loop.loops) ||
+             (pElem->loop.extent == (ptrdiff_t)pElem[pElem->loop.items].end_loop.size));
+    return (1 == pElem->elem.count) ||
+        (pElem->elem.extent == (ptrdiff_t)(pElem->elem.blocklen *
+                                           opal_datatype_basicDatatypes[pElem->elem.common.type]->size));
+}
+
+/**
+ * Flags of a loop over the items units[0..nb-1], built the same way as for the
+ * loops of the original description: contiguous when the items follow each
+ * other without gaps, and without gaps between the iterations when the extent
+ * of the loop is the size of its content.
+ */
+static uint16_t
+opal_datatype_fold_flags( const dt_elem_desc_t* pElem, const uint32_t* units, uint32_t nb,
+                          size_t size, ptrdiff_t extent )
+{
+    ptrdiff_t next = opal_datatype_fold_first_disp( pElem + units[0] );
+
+    for( uint32_t j = 0; j < nb; j++ ) {
+        if( !opal_datatype_fold_contiguous( pElem + units[j] ) ||
+            (opal_datatype_fold_first_disp( pElem + units[j] ) != next) ) return 0;
+        next += opal_datatype_fold_size( pElem + units[j] );
+    }
+    if( extent == (ptrdiff_t)size )
+        return OPAL_DATATYPE_FLAG_CONTIGUOUS | OPAL_DATATYPE_FLAG_NO_GAPS;
+    return OPAL_DATATYPE_FLAG_CONTIGUOUS;
+}
+
+/* Is the description b identical to the description a shifted by disp ? */
+static bool
+opal_datatype_fold_match( const dt_elem_desc_t* a, const dt_elem_desc_t* b,
+                          uint32_t length, ptrdiff_t disp )
+{
+    for( uint32_t i = 0; i < length; i++ ) {
+        if( (a[i].elem.common.type != b[i].elem.common.type) ||
+            (a[i].elem.common.flags != b[i].elem.common.flags) ) return false;
+        if( OPAL_DATATYPE_LOOP == a[i].elem.common.type ) {
+            if( (a[i].loop.loops != b[i].loop.loops) || (a[i].loop.items != b[i].loop.items) ||
+                (a[i].loop.extent != b[i].loop.extent) ) return false;
+        } else if( OPAL_DATATYPE_END_LOOP == a[i].elem.common.type ) {
+            if( (a[i].end_loop.items != b[i].end_loop.items) || (a[i].end_loop.size != b[i].end_loop.size) ||
+                ((a[i].end_loop.first_elem_disp + disp) != b[i].end_loop.first_elem_disp) ) return false;
+        } else {
+            if( (a[i].elem.blocklen != b[i].elem.blocklen) || (a[i].elem.count != b[i].elem.count) ||
+                (a[i].elem.extent != b[i].elem.extent) || ((a[i].elem.disp + disp) != b[i].elem.disp) ) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Fold the repeating patterns of the sequence of items (elements and complete
+ * loops) of one level of a description, starting with the content of the inner
+ * loops. The description is updated in place, and the new number of entries
+ * is returned. nb_loops is increased by the number of loops created.
+ */
+static uint32_t
+opal_datatype_fold_level( dt_elem_desc_t* pElem, uint32_t used, uint32_t* nb_loops )
+{
+    dt_elem_desc_t* pFolded;
+    uint32_t *units, nb_units = 0, i, j, p, r, length, folded = 0;
+    uint16_t flags;
+    size_t size;
+
+    /* fold the inner loops first, and locate the items of this level */
+    units = (uint32_t*)malloc( sizeof(uint32_t) * (used + 1) );
+    if( NULL == units ) return used;  /* the description is still correct, just not folded */
+    for( i = 0; i < used; i++ ) {
+        units[nb_units++] = i;
+        if( OPAL_DATATYPE_LOOP == pElem[i].elem.common.type ) {
+            uint32_t items = pElem[i].loop.items;
+            uint32_t body = opal_datatype_fold_level( pElem + i + 1, items - 1, nb_loops );
+            if( body != (items - 1) ) {
+                memmove( pElem + i + 1 + body, pElem + i + items, (used - i - items) * sizeof(dt_elem_desc_t) );
+                used -= (items - 1 - body);
+                pElem[i].loop.items = body + 1;
+                pElem[i + 1 + body].end_loop.items = body + 1;
+            }
+            i += pElem[i].loop.items;
+        }
+    }
+    units[nb_units] = used;
+
+    pFolded = (dt_elem_desc_t*)malloc( sizeof(dt_elem_desc_t) * used );
+    if( NULL == pFolded ) {
+        free( units );
+        return used;
+    }
+    for( i = 0; i < nb_units; ) {
+        uint32_t best_period = 0, best_count = 0, best_gain = 0;
+        ptrdiff_t best_extent = 0;
+
+        for( p = 1; (p <= OPAL_DATATYPE_FOLD_MAX_PERIOD) && ((i + 2 * p) <= nb_units); p++ ) {
+            ptrdiff_t extent = opal_datatype_fold_first_disp( pElem + units[i + p] ) -
+                               opal_datatype_fold_first_disp( pElem + units[i] );
+            length = units[i + p] - units[i];
+            if( 0 == extent ) continue;
+            for( r = 1; (i + (r + 1) * p) <= nb_units; r++ ) {
+                if( !opal_datatype_fold_match( pElem + units[i], pElem + units[i + r * p],
+                                               length, r * extent ) ) break;
+            }
+            /* r copies of the pattern are replaced by one surrounded by the loop markers */
+            if( (r >= OPAL_DATATYPE_FOLD_MIN_COUNT) && (r * length > length + 2) &&
+                ((r - 1) * length - 2 > best_gain) ) {
+                best_gain   = (r - 1) * length - 2;
+                best_period = p;
+                best_count  = r;
+                best_extent = extent;
+            }
+        }
+        if( 0 == best_period ) {
+            length = units[i + 1] - units[i];
+            memcpy( pFolded + folded, pElem + units[i], length * sizeof(dt_elem_desc_t) );
+            folded += length;
+            i++;
+            continue;
+        }
+        length = units[i + best_period] - units[i];
+        for( size = 0, j = i; j < (i + best_period); j++ )
+            size += opal_datatype_fold_size( pElem + units[j] );
+        flags = opal_datatype_fold_flags( pElem, units + i, best_period, size, best_extent );
+        CREATE_LOOP_START( pFolded + folded, best_count, length + 1, best_extent, flags );
+        memcpy( pFolded + folded + 1, pElem + units[i], length * sizeof(dt_elem_desc_t) );
+        CREATE_LOOP_END( pFolded + folded + 1 + length, length + 1,
+                         opal_datatype_fold_first_disp( pElem + units[i] ), size, flags );
+        folded += length + 2;
+        (*nb_loops)++;
+        i += best_count * best_period;
+    }
+    memcpy( pElem, pFolded, folded * sizeof(dt_elem_desc_t) );
+    free( pFolded );
+    free( units );
+    return folded;
+}
+
 int32_t opal_datatype_commit( opal_datatype_t * pData )
 {
     ddt_endloop_desc_t* pLast = &(pData->desc.desc[pData->desc.used].end_loop);
@@ -299,6 +469,12 @@ int32_t opal_datatype_commit( opal_datatype_t * pData )
     /*if( pData->size == (pData->true_ub - pData->true_lb) ) return OPAL_SUCCESS; */
 
     (void)opal_datatype_optimize_short( pData, 1, &(pData->opt_desc) );
+    pData->opt_loops = pData->loops;
+    if( !(pData->flags & OPAL_DATATYPE_FLAG_CONTIGUOUS) && (pData->opt_desc.used > 2) ) {
+        uint32_t nb_loops = 0;
+        pData->opt_desc.used = opal_datatype_fold_level( pData->opt_desc.desc, pData->opt_desc.used, &nb_loops );
+        pData->opt_loops += 2 * nb_loops;  /* the loops created exist only in opt_desc */
+    }
     if( 0 != pData->opt_desc.used ) {
         /* let's add a fake element at the end just to avoid useless comparaisons
          * in pack/unpack functions.
@@ -310,5 +486,8 @@ int32_t opal_datatype_commit( opal_datatype_t * pData )
         pLast->first_elem_disp = first_elem_disp;
         pLast->size            = pData->size;
     }
+    if( opal_ddt_iovec_cache && !(pData->flags & OPAL_DATATYPE_FLAG_NO_GAPS) ) {
+        (void)opal_datatype_iovec_build( pData );
+    }
     return OPAL_SUCCESS;
 }
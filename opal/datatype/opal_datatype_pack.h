@@ -24,6 +24,9 @@
 #undef MEMCPY_CSUM
 #define MEMCPY_CSUM( DST, SRC, BLENGTH, CONVERTOR ) \
     CONVERTOR->cbmemcpy( (DST), (SRC), (BLENGTH), (CONVERTOR) )
+#undef MEMCPY_STRIDED_CSUM
+#define MEMCPY_STRIDED_CSUM( DST, DST_STRIDE, SRC, SRC_STRIDE, BLENGTH, COUNT, CONVERTOR ) \
+    MEMCPY_STRIDED_CSUM_BY_BLOCK( (DST), (DST_STRIDE), (SRC), (SRC_STRIDE), (BLENGTH), (COUNT), (CONVERTOR) )
 #endif
 
 /**
@@ -107,31 +110,36 @@ pack_predefined_data( opal_convertor_t* CONVERTOR,
     *(COUNT) -= cando_count;
 
     if( 1 == _elem->blocklen ) { /* Do as many full blocklen as possible */
-        for(; cando_count > 0; cando_count--) {
+        if( 0 != cando_count ) {
             OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
                                              (CONVERTOR)->pDesc, (CONVERTOR)->count );
-            DO_DEBUG( opal_output( 0, "pack memcpy( %p, %p, %lu ) => space %lu [blen = 1]\n",
-                                   (void*)_packed, (void*)_memory, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE) - (_packed - *(packed))) ); );
-            MEMCPY_CSUM( _packed, _memory, blocklen_bytes, (CONVERTOR) );
-            _packed     += blocklen_bytes;
-            _memory     += _elem->extent;
+            OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(cando_count - 1) * _elem->extent, blocklen_bytes,
+                                             (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+            DO_DEBUG( opal_output( 0, "pack strided memcpy( %p, %p, %lu x %lu ) => space %lu [blen = 1]\n",
+                                   (void*)_packed, (void*)_memory, (unsigned long)cando_count, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE)) ); );
+            MEMCPY_STRIDED_CSUM( _packed, blocklen_bytes, _memory, _elem->extent,
+                                 blocklen_bytes, cando_count, (CONVERTOR) );
+            _packed += cando_count * blocklen_bytes;
+            _memory += (ptrdiff_t)cando_count * _elem->extent;
         }
         goto update_and_return;
     }
 
     if( (1 < _elem->count) && (_elem->blocklen <= cando_count) ) {
+        size_t nblocks = cando_count / _elem->blocklen;  /* Do as many full blocklen as possible */
         blocklen_bytes *= _elem->blocklen;
 
-        do { /* Do as many full blocklen as possible */
-            OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
-                                             (CONVERTOR)->pDesc, (CONVERTOR)->count );
-            DO_DEBUG( opal_output( 0, "pack 2. memcpy( %p, %p, %lu ) => space %lu\n",
-                                   (void*)_packed, (void*)_memory, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE) - (_packed - *(packed))) ); );
-            MEMCPY_CSUM( _packed, _memory, blocklen_bytes, (CONVERTOR) );
-            _packed     += blocklen_bytes;
-            _memory     += _elem->extent;
-            cando_count -= _elem->blocklen;
-        } while (_elem->blocklen <= cando_count);
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
+                                         (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(nblocks - 1) * _elem->extent, blocklen_bytes,
+                                         (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        DO_DEBUG( opal_output( 0, "pack 2. strided memcpy( %p, %p, %lu x %lu ) => space %lu\n",
+                               (void*)_packed, (void*)_memory, (unsigned long)nblocks, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE)) ); );
+        MEMCPY_STRIDED_CSUM( _packed, blocklen_bytes, _memory, _elem->extent,
+                             blocklen_bytes, nblocks, (CONVERTOR) );
+        _packed     += nblocks * blocklen_bytes;
+        _memory     += (ptrdiff_t)nblocks * _elem->extent;
+        cando_count -= nblocks * _elem->blocklen;
     }
 
     /**
@@ -170,14 +178,17 @@ static inline void pack_contiguous_loop( opal_convertor_t* CONVERTOR,
 
     if( (_copy_loops * _end_loop->size) > *(SPACE) )
         _copy_loops = (*(SPACE) / _end_loop->size);
-    for(size_t _i = 0; _i < _copy_loops; _i++ ) {
+    if( 0 != _copy_loops ) {
         OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, _end_loop->size, (CONVERTOR)->pBaseBuf,
-                                    (CONVERTOR)->pDesc, (CONVERTOR)->count );
-        DO_DEBUG( opal_output( 0, "pack 3. memcpy( %p, %p, %lu ) => space %lu\n",
-                               (void*)*(packed), (void*)_memory, (unsigned long)_end_loop->size, (unsigned long)(*(SPACE) - _i * _end_loop->size) ); );
-        MEMCPY_CSUM( *(packed), _memory, _end_loop->size, (CONVERTOR) );
-        *(packed) += _end_loop->size;
-        _memory   += _loop->extent;
+                                         (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(_copy_loops - 1) * _loop->extent, _end_loop->size,
+                                         (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        DO_DEBUG( opal_output( 0, "pack 3. strided memcpy( %p, %p, %lu x %lu ) => space %lu\n",
+                               (void*)*(packed), (void*)_memory, (unsigned long)_copy_loops, (unsigned long)_end_loop->size, (unsigned long)(*(SPACE)) ); );
+        MEMCPY_STRIDED_CSUM( *(packed), _end_loop->size, _memory, _loop->extent,
+                             _end_loop->size, _copy_loops, (CONVERTOR) );
+        *(packed) += _copy_loops * _end_loop->size;
+        _memory   += (ptrdiff_t)_copy_loops * _loop->extent;
     }
     *(memory) = _memory - _end_loop->first_elem_disp;
     *(SPACE) -= _copy_loops * _end_loop->size;
@@ -162,6 +162,8 @@ int opal_convertor_generic_simple_position( opal_convertor_t* pConvertor,
     dt_elem_desc_t* pElem;    /* current position */
     unsigned char *base_pointer = pConvertor->pBaseBuf;
     ptrdiff_t extent = pConvertor->pDesc->ub - pConvertor->pDesc->lb;
+    ptrdiff_t loop_extent;
+    size_t full_loops, loop_size;
 
     DUMP( "opal_convertor_generic_simple_position( %p, &%ld )\n", (void*)pConvertor, (long)*position );
     assert(*position > pConvertor->bConverted);
@@ -221,7 +223,24 @@ int opal_convertor_generic_simple_position( opal_convertor_t* pConvertor,
             DO_DEBUG( opal_output( 0, "position end_loop count %" PRIsize_t " stack_pos %d pos_desc %d disp %lx space %lu\n",
                                    pStack->count, pConvertor->stack_pos, pos_desc,
                                    pStack->disp, (unsigned long)iov_len_local ); );
-            if( --(pStack->count) == 0 ) { /* end of loop */
+            if( pStack->index == -1 ) {
+                loop_extent = extent;
+                loop_size   = pConvertor->pDesc->size;
+            } else {
+                assert( OPAL_DATATYPE_LOOP == description[pStack->index].loop.common.type );
+                loop_extent = description[pStack->index].loop.extent;
+                loop_size   = pElem->end_loop.size;
+            }
+            /* The current iteration is done. Jump over all the following iterations
+             * that are entirely covered by the remaining length, their extent being
+             * constant there is no need to look inside.
+             */
+            full_loops = --(pStack->count);
+            if( (0 != loop_size) && (iov_len_local / loop_size) < full_loops )
+                full_loops = iov_len_local / loop_size;
+            pStack->count -= full_loops;
+            iov_len_local -= full_loops * loop_size;
+            if( pStack->count == 0 ) { /* end of loop */
                 if( pConvertor->stack_pos == 0 ) {
                     pConvertor->flags |= CONVERTOR_COMPLETED;
                     goto complete_loop;  /* completed */
@@ -230,15 +249,8 @@ int opal_convertor_generic_simple_position( opal_convertor_t* pConvertor,
                 pStack--;
                 pos_desc++;
             } else {
-                if( pStack->index == -1 ) {
-                    pStack->disp += extent;
-                    pos_desc = 0;  /* back to the first element */
-                } else {
-                    assert( OPAL_DATATYPE_LOOP == description[pStack->index].loop.common.type );
-                    pStack->disp += description[pStack->index].loop.extent;
-                    pos_desc = pStack->index;  /* go back to the loop start itself to give a chance 
-                                                * to move forward by entire loops */
-                }
+                pStack->disp += (full_loops + 1) * loop_extent;
+                pos_desc = pStack->index + 1;  /* back to the first element of the loop */
             }
             base_pointer = pConvertor->pBaseBuf + pStack->disp;
             UPDATE_INTERNAL_COUNTERS( description, pos_desc, pElem, count_desc );
@@ -249,7 +261,7 @@ int opal_convertor_generic_simple_position( opal_convertor_t* pConvertor,
         if( OPAL_DATATYPE_LOOP == pElem->elem.common.type ) {
             ptrdiff_t local_disp = (ptrdiff_t)base_pointer;
             ddt_endloop_desc_t* end_loop = (ddt_endloop_desc_t*)(pElem + pElem->loop.items);
-            size_t full_loops = iov_len_local / end_loop->size;
+            full_loops = iov_len_local / end_loop->size;
             full_loops = count_desc <= full_loops ? count_desc : full_loops;
             if( full_loops ) {
                 base_pointer  += full_loops * pElem->loop.extent;
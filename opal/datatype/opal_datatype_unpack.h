@@ -24,6 +24,9 @@
 #undef MEMCPY_CSUM
 #define MEMCPY_CSUM( DST, SRC, BLENGTH, CONVERTOR ) \
     CONVERTOR->cbmemcpy( (DST), (SRC), (BLENGTH), (CONVERTOR) )
+#undef MEMCPY_STRIDED_CSUM
+#define MEMCPY_STRIDED_CSUM( DST, DST_STRIDE, SRC, SRC_STRIDE, BLENGTH, COUNT, CONVERTOR ) \
+    MEMCPY_STRIDED_CSUM_BY_BLOCK( (DST), (DST_STRIDE), (SRC), (SRC_STRIDE), (BLENGTH), (COUNT), (CONVERTOR) )
 #endif
 
 /**
@@ -104,31 +107,36 @@ unpack_predefined_data( opal_convertor_t* CONVERTOR,
     *(COUNT) -= cando_count;
     
     if( 1 == _elem->blocklen ) {  /* Do as many full blocklen as possible */
-        for(; cando_count > 0; cando_count--) {
+        if( 0 != cando_count ) {
             OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
                                              (CONVERTOR)->pDesc, (CONVERTOR)->count );
-            DO_DEBUG( opal_output( 0, "unpack memcpy( %p, %p, %lu ) => space %lu [blen = 1]\n",
-                                   (void*)_memory, (void*)_packed, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE) - (_packed - *(packed))) ); );
-            MEMCPY_CSUM( _memory, _packed, blocklen_bytes, (CONVERTOR) );
-            _packed     += blocklen_bytes;
-            _memory     += _elem->extent;
+            OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(cando_count - 1) * _elem->extent, blocklen_bytes,
+                                             (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+            DO_DEBUG( opal_output( 0, "unpack strided memcpy( %p, %p, %lu x %lu ) => space %lu [blen = 1]\n",
+                                   (void*)_memory, (void*)_packed, (unsigned long)cando_count, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE)) ); );
+            MEMCPY_STRIDED_CSUM( _memory, _elem->extent, _packed, blocklen_bytes,
+                                 blocklen_bytes, cando_count, (CONVERTOR) );
+            _packed += cando_count * blocklen_bytes;
+            _memory += (ptrdiff_t)cando_count * _elem->extent;
         }
         goto update_and_return;
     }
 
     if( (1 < _elem->count) && (_elem->blocklen <= cando_count) ) {
+        size_t nblocks = cando_count / _elem->blocklen;  /* Do as many full blocklen as possible */
         blocklen_bytes *= _elem->blocklen;
 
-        do { /* Do as many full blocklen as possible */
-            OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
-                                             (CONVERTOR)->pDesc, (CONVERTOR)->count );
-            DO_DEBUG( opal_output( 0, "unpack 2. memcpy( %p, %p, %lu ) => space %lu\n",
-                                   (void*)_memory, (void*)_packed, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE) - (_packed - *(packed))) ); );
-            MEMCPY_CSUM( _memory, _packed, blocklen_bytes, (CONVERTOR) );
-            _packed     += blocklen_bytes;
-            _memory     += _elem->extent;
-            cando_count -= _elem->blocklen;
-        } while (_elem->blocklen <= cando_count);
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, blocklen_bytes, (CONVERTOR)->pBaseBuf,
+                                         (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(nblocks - 1) * _elem->extent, blocklen_bytes,
+                                         (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        DO_DEBUG( opal_output( 0, "unpack 2. strided memcpy( %p, %p, %lu x %lu ) => space %lu\n",
+                               (void*)_memory, (void*)_packed, (unsigned long)nblocks, (unsigned long)blocklen_bytes, (unsigned long)(*(SPACE)) ); );
+        MEMCPY_STRIDED_CSUM( _memory, _elem->extent, _packed, blocklen_bytes,
+                             blocklen_bytes, nblocks, (CONVERTOR) );
+        _packed     += nblocks * blocklen_bytes;
+        _memory     += (ptrdiff_t)nblocks * _elem->extent;
+        cando_count -= nblocks * _elem->blocklen;
     }
 
     /**
@@ -167,14 +175,17 @@ static inline void unpack_contiguous_loop( opal_convertor_t* CONVERTOR,
 
     if( (_copy_loops * _end_loop->size) > *(SPACE) )
         _copy_loops = (*(SPACE) / _end_loop->size);
-    for(size_t _i = 0; _i < _copy_loops; _i++ ) {
+    if( 0 != _copy_loops ) {
         OPAL_DATATYPE_SAFEGUARD_POINTER( _memory, _end_loop->size, (CONVERTOR)->pBaseBuf,
-                                    (CONVERTOR)->pDesc, (CONVERTOR)->count );
-        DO_DEBUG( opal_output( 0, "unpack 3. memcpy( %p, %p, %lu ) => space %lu\n",
-                               (void*)_memory, (void*)*(packed), (unsigned long)_end_loop->size, (unsigned long)(*(SPACE) - _i * _end_loop->size) ); );
-        MEMCPY_CSUM( _memory, *(packed), _end_loop->size, (CONVERTOR) );
-        *(packed) += _end_loop->size;
-        _memory   += _loop->extent;
+                                         (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        OPAL_DATATYPE_SAFEGUARD_POINTER( _memory + (ptrdiff_t)(_copy_loops - 1) * _loop->extent, _end_loop->size,
+                                         (CONVERTOR)->pBaseBuf, (CONVERTOR)->pDesc, (CONVERTOR)->count );
+        DO_DEBUG( opal_output( 0, "unpack 3. strided memcpy( %p, %p, %lu x %lu ) => space %lu\n",
+                               (void*)_memory, (void*)*(packed), (unsigned long)_copy_loops, (unsigned long)_end_loop->size, (unsigned long)(*(SPACE)) ); );
+        MEMCPY_STRIDED_CSUM( _memory, _loop->extent, *(packed), _end_loop->size,
+                             _end_loop->size, _copy_loops, (CONVERTOR) );
+        *(packed) += _copy_loops * _end_loop->size;
+        _memory   += (ptrdiff_t)_copy_loops * _loop->extent;
     }
     *(memory)  = _memory - _end_loop->first_elem_disp;
     *(SPACE)  -= _copy_loops * _end_loop->size;
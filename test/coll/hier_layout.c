@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                    of Tennessee Research Foundation.  All rights
+ *                    reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Checks the collectives of coll/hier on communicators whose processes
+ * are spread unevenly over the nodes, or interleaved between them, or
+ * with a single process on some nodes. All processes must agree on
+ * whether the hierarchical algorithms are used, otherwise the
+ * collectives mismatch or deadlock. Run on several nodes with a
+ * different number of processes on each, e.g.
+ *
+ *   mpirun --host a:2,b:1 --mca coll_hier_priority 100 ./hier_layout
+ *   mpirun --host a:3,b:1,c:2 --map-by node --mca coll_hier_priority 100 ./hier_layout
+ *
+ * Each layout is derived from MPI_COMM_WORLD: in order, reversed, every
+ * other process, and all but the first process.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COUNT 1000
+
+static int check(const char *layout, const char *coll, int ok, MPI_Comm comm)
+{
+    int all_ok;
+
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    if (!all_ok) {
+        int rank;
+        MPI_Comm_rank(comm, &rank);
+        if (0 == rank) {
+            printf("%-12s %-10s [NOT PASSED]\n", layout, coll);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int test_comm(const char *layout, MPI_Comm comm)
+{
+    int rank, size, root, i, j, ok, errors = 0;
+    int *buf, *rbuf;
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    buf = (int*)malloc(COUNT * sizeof(int));
+    rbuf = (int*)malloc((size_t)size * COUNT * sizeof(int));
+
+    MPI_Barrier(comm);
+
+    for (root = 0; root < size; root++) {
+        for (i = 0; i < COUNT; i++) buf[i] = (rank == root) ? i + root : -1;
+        MPI_Bcast(buf, COUNT, MPI_INT, root, comm);
+        for (ok = 1, i = 0; i < COUNT; i++) ok &= (buf[i] == i + root);
+        errors += check(layout, "bcast", ok, comm);
+
+        for (i = 0; i < COUNT; i++) buf[i] = rank + i;
+        MPI_Reduce(buf, rbuf, COUNT, MPI_INT, MPI_SUM, root, comm);
+        for (ok = 1, i = 0; rank == root && i < COUNT; i++)
+            ok &= (rbuf[i] == size * (size - 1) / 2 + size * i);
+        errors += check(layout, "reduce", ok, comm);
+
+        MPI_Gather(buf, COUNT, MPI_INT, rbuf, COUNT, MPI_INT, root, comm);
+        for (ok = 1, j = 0; rank == root && j < size; j++)
+            for (i = 0; i < COUNT; i++) ok &= (rbuf[j * COUNT + i] == j + i);
+        errors += check(layout, "gather", ok, comm);
+
+        if (rank == root) {
+            for (j = 0; j < size; j++)
+                for (i = 0; i < COUNT; i++) rbuf[j * COUNT + i] = 2 * j + i;
+        }
+        MPI_Scatter(rbuf, COUNT, MPI_INT, buf, COUNT, MPI_INT, root, comm);
+        for (ok = 1, i = 0; i < COUNT; i++) ok &= (buf[i] == 2 * rank + i);
+        errors += check(layout, "scatter", ok, comm);
+    }
+
+    for (i = 0; i < COUNT; i++) buf[i] = rank + i;
+    MPI_Allreduce(buf, rbuf, COUNT, MPI_INT, MPI_SUM, comm);
+    for (ok = 1, i = 0; i < COUNT; i++) ok &= (rbuf[i] == size * (size - 1) / 2 + size * i);
+    errors += check(layout, "allreduce", ok, comm);
+
+    MPI_Allgather(buf, COUNT, MPI_INT, rbuf, COUNT, MPI_INT, comm);
+    for (ok = 1, j = 0; j < size; j++)
+        for (i = 0; i < COUNT; i++) ok &= (rbuf[j * COUNT + i] == j + i);
+    errors += check(layout, "allgather", ok, comm);
+
+    MPI_Barrier(comm);
+    if (0 == rank && 0 == errors) {
+        printf("%-12s %d processes [PASSED]\n", layout, size);
+    }
+    free(buf);
+    free(rbuf);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    int rank, size, errors = 0;
+    MPI_Comm comm;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    errors += test_comm("world", MPI_COMM_WORLD);
+
+    MPI_Comm_split(MPI_COMM_WORLD, 0, size - rank, &comm);
+    errors += test_comm("reversed", comm);
+    MPI_Comm_free(&comm);
+
+    MPI_Comm_split(MPI_COMM_WORLD, rank % 2, rank, &comm);
+    if (0 == rank % 2) {
+        errors += test_comm("even", comm);
+    }
+    MPI_Comm_free(&comm);
+
+    MPI_Comm_split(MPI_COMM_WORLD, (0 == rank) ? MPI_UNDEFINED : 0, rank, &comm);
+    if (MPI_COMM_NULL != comm) {
+        errors += test_comm("no_first", comm);
+        MPI_Comm_free(&comm);
+    }
+
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
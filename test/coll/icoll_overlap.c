@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                    of Tennessee Research Foundation.  All rights
+ *                    reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measures how much of a non-blocking collective overlaps with a
+ * computation that does not call into MPI, e.g. to compare the inline
+ * progress of coll/libnbc with its progress thread, which requires
+ * MPI_THREAD_MULTIPLE:
+ *
+ *   mpirun -np 4 ./icoll_overlap
+ *   mpirun -np 4 --mca coll_libnbc_progress_thread 1 ./icoll_overlap
+ *
+ * For each collective and message size, the time t_comm of the collective
+ * alone is measured, then the collective is started, the process computes
+ * for t_comm, and waits for the collective to complete, which takes
+ * t_total. The overlap is 100 * (2 * t_comm - t_total) / t_comm, 100%
+ * meaning that the collective completed entirely during the computation.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SIZE (1 << 20)
+#define ITERATIONS 20
+
+typedef int (*icoll_fn_t)(void *sbuf, void *rbuf, int count, MPI_Request *req);
+
+static int do_ialltoall(void *sbuf, void *rbuf, int count, MPI_Request *req)
+{
+    int size;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    return MPI_Ialltoall(sbuf, count / size, MPI_BYTE, rbuf, count / size, MPI_BYTE,
+                         MPI_COMM_WORLD, req);
+}
+
+static int do_iallreduce(void *sbuf, void *rbuf, int count, MPI_Request *req)
+{
+    return MPI_Iallreduce(sbuf, rbuf, count / sizeof(float), MPI_FLOAT, MPI_SUM,
+                          MPI_COMM_WORLD, req);
+}
+
+static int do_ibcast(void *sbuf, void *rbuf, int count, MPI_Request *req)
+{
+    return MPI_Ibcast(sbuf, count, MPI_BYTE, 0, MPI_COMM_WORLD, req);
+}
+
+/* computes for the given time without calling into the MPI library
+ * (MPI_Wtime does not progress the communications) */
+static void compute(double duration)
+{
+    double start = MPI_Wtime();
+    volatile double x = 1.0;
+
+    while (MPI_Wtime() - start < duration) {
+        x = x * 1.0000001 + 0.0000001;
+    }
+}
+
+static void measure(const char *name, icoll_fn_t fn, void *sbuf, void *rbuf, int count)
+{
+    double start, t_comm = 0.0, t_total = 0.0, t;
+    MPI_Request req;
+    int i, rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    /* the collective alone, including a warm up */
+    for (i = 0; i <= ITERATIONS; i++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        start = MPI_Wtime();
+        fn(sbuf, rbuf, count, &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        if (i > 0) t_comm += MPI_Wtime() - start;
+    }
+    t_comm /= ITERATIONS;
+    MPI_Allreduce(MPI_IN_PLACE, &t_comm, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    /* the collective overlapped with a computation as long as it */
+    for (i = 0; i < ITERATIONS; i++) {
+        MPI_Barrier(MPI_COMM_WORLD);
+        start = MPI_Wtime();
+        fn(sbuf, rbuf, count, &req);
+        compute(t_comm);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+        t_total += MPI_Wtime() - start;
+    }
+    t_total /= ITERATIONS;
+    MPI_Allreduce(MPI_IN_PLACE, &t_total, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    if (0 == rank) {
+        t = 100.0 * (2.0 * t_comm - t_total) / t_comm;
+        if (t < 0.0) t = 0.0;
+        printf("%-12s %10d %14.2f %14.2f %10.1f\n", name, count,
+               t_comm * 1e6, t_total * 1e6, t);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char *sbuf, *rbuf;
+    int count, rank, size, provided;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    sbuf = (char *)calloc(MAX_SIZE, 1);
+    rbuf = (char *)calloc(MAX_SIZE, 1);
+
+    if (0 == rank) {
+        printf("# %d processes\n", size);
+        printf("%-12s %10s %14s %14s %10s\n", "# collective", "bytes",
+               "t_comm (us)", "t_total (us)", "overlap %");
+    }
+    for (count = 1024 * size; count <= MAX_SIZE; count *= 4) {
+        measure("ialltoall", do_ialltoall, sbuf, rbuf, count);
+    }
+    for (count = 1024; count <= MAX_SIZE; count *= 4) {
+        measure("iallreduce", do_iallreduce, sbuf, rbuf, count);
+    }
+    for (count = 1024; count <= MAX_SIZE; count *= 4) {
+        measure("ibcast", do_ibcast, sbuf, rbuf, count);
+    }
+
+    free(sbuf);
+    free(rbuf);
+    MPI_Finalize();
+    return 0;
+}
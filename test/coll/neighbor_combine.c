@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Checks MPI_Ineighbor_allgather and MPI_Ineighbor_alltoall on
+ * distributed graphs, whose messages coll/libnbc combines per remote node
+ * when they are small enough. Each result is checked against the expected
+ * values, and rank 0 prints a checksum of all the results, which must not
+ * depend on whether the messages are combined. Run on several nodes with
+ * several processes each, once with the combining forced off and once
+ * forced on, and compare the outputs:
+ *
+ *   mpirun --host a:4,b:4 --map-by node --mca coll_libnbc_priority 100 \
+ *          --mca coll_libnbc_neighbor_combine_size 0 ./neighbor_combine
+ *   mpirun --host a:4,b:4 --map-by node --mca coll_libnbc_priority 100 \
+ *          --mca coll_libnbc_neighbor_combine_size 1048576 ./neighbor_combine
+ *
+ * neighbor_combine.sh runs both and compares them.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_DEGREE 6
+
+static const int counts[] = { 1, 7, 64, 1000 };
+
+/*
+ * The ring graph sends to the next ranks, the parity graph from each rank
+ * to all the ranks of the other parity, so that most of the destinations
+ * share their node with other destinations.
+ */
+static int neighbors(const char *graph, int rank, int size, int out, int *nbrs)
+{
+    int i, n = 0;
+
+    if ('r' == graph[0]) {
+        int degree = size - 1 < MAX_DEGREE ? size - 1 : MAX_DEGREE;
+        for (i = 1; i <= degree; ++i) {
+            nbrs[n++] = (rank + (out ? i : size - i)) % size;
+        }
+    } else {
+        for (i = 0; i < size; ++i) {
+            if (i % 2 != rank % 2) {
+                nbrs[n++] = i;
+            }
+        }
+    }
+    return n;
+}
+
+static int test_coll(const char *graph, int alltoall, int count, MPI_Comm comm,
+                     int indegree, const int *srcs, int outdegree, const int *dsts)
+{
+    int rank, size, i, j, k, ok = 1, all_ok;
+    int *sbuf, *rbuf;
+    unsigned long long sum = 0, all_sum;
+    const char *coll = alltoall ? "ineighbor_alltoall" : "ineighbor_allgather";
+    MPI_Request req;
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    sbuf = (int*)malloc((size_t)(alltoall ? outdegree : 1) * count * sizeof(int) + sizeof(int));
+    rbuf = (int*)malloc((size_t)indegree * count * sizeof(int) + sizeof(int));
+
+    for (j = 0; j < (alltoall ? outdegree : 1); ++j) {
+        for (k = 0; k < count; ++k) {
+            sbuf[j * count + k] = ((rank * size + (alltoall ? dsts[j] : 0)) % 1000) * 10000 + k;
+        }
+    }
+    for (i = 0; i < indegree * count; ++i) {
+        rbuf[i] = -1;
+    }
+
+    if (alltoall) {
+        MPI_Ineighbor_alltoall(sbuf, count, MPI_INT, rbuf, count, MPI_INT, comm, &req);
+    } else {
+        MPI_Ineighbor_allgather(sbuf, count, MPI_INT, rbuf, count, MPI_INT, comm, &req);
+    }
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+
+    for (j = 0; j < indegree; ++j) {
+        for (k = 0; k < count; ++k) {
+            int expected = ((srcs[j] * size + (alltoall ? rank : 0)) % 1000) * 10000 + k;
+            if (rbuf[j * count + k] != expected) {
+                if (ok) {
+                    printf("%d: %s %s count %d: got %d from %d at %d, expected %d\n",
+                           rank, graph, coll, count, rbuf[j * count + k], srcs[j], k, expected);
+                }
+                ok = 0;
+            }
+            sum += (unsigned long long)rbuf[j * count + k] * (j + 1);
+        }
+    }
+    free(sbuf);
+    free(rbuf);
+
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    MPI_Reduce(&sum, &all_sum, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, comm);
+    if (0 == rank) {
+        printf("%-6s %-18s %5d %20llu %s\n", graph, coll, count, all_sum,
+               all_ok ? "[PASSED]" : "[NOT PASSED]");
+    }
+    return !all_ok;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *graphs[] = { "ring", "parity" };
+    int rank, size, g, c, indegree, outdegree, errors = 0;
+    int *srcs, *dsts;
+    MPI_Comm comm;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    srcs = (int*)malloc(size * sizeof(int));
+    dsts = (int*)malloc(size * sizeof(int));
+
+    for (g = 0; g < 2; ++g) {
+        indegree = neighbors(graphs[g], rank, size, 0, srcs);
+        outdegree = neighbors(graphs[g], rank, size, 1, dsts);
+        MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD, indegree, srcs, MPI_UNWEIGHTED,
+                                       outdegree, dsts, MPI_UNWEIGHTED, MPI_INFO_NULL,
+                                       0, &comm);
+        for (c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); ++c) {
+            errors += test_coll(graphs[g], 0, counts[c], comm,
+                                indegree, srcs, outdegree, dsts);
+            errors += test_coll(graphs[g], 1, counts[c], comm,
+                                indegree, srcs, outdegree, dsts);
+        }
+        MPI_Comm_free(&comm);
+    }
+
+    free(srcs);
+    free(dsts);
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+#!/bin/sh
+
+#
+# Copyright (c) 2026      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+#
+# Runs neighbor_combine with the combining of the neighbor collectives of
+# coll/libnbc forced off and forced on, and compares the results. The
+# combining only happens between nodes, so give mpirun several nodes with
+# several processes each:
+#
+#   ./neighbor_combine.sh "--host a:4,b:4 --map-by node" [neighbor_combine]
+#
+
+hosts=$1
+prog=${2:-./neighbor_combine}
+mca="--mca coll_libnbc_priority 100"
+status=0
+
+mpirun $hosts $mca --mca coll_libnbc_neighbor_combine_size 0 $prog > neighbor_combine.off.$$ || status=1
+mpirun $hosts $mca --mca coll_libnbc_neighbor_combine_size 1048576 $prog > neighbor_combine.on.$$ || status=1
+if [ 0 -eq $status ] && cmp -s neighbor_combine.off.$$ neighbor_combine.on.$$; then
+    echo "combining off and on [PASSED]"
+else
+    diff neighbor_combine.off.$$ neighbor_combine.on.$$
+    echo "combining off and on [NOT PASSED]"
+    status=1
+fi
+rm -f neighbor_combine.off.$$ neighbor_combine.on.$$
+exit $status
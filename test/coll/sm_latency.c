@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                    of Tennessee Research Foundation.  All rights
+ *                    reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measures the latency of the barrier and of the allreduces of a few
+ * bytes, e.g. to check the flag based algorithms of coll/sm, with one
+ * process per core of a node:
+ *
+ *   mpirun -np 64 --bind-to core --mca coll_sm_priority 100 ./sm_latency
+ *
+ * The latency is the average time of an operation over many back to
+ * back operations, the largest over the processes.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WARMUP 1000
+#define ITERATIONS 100000
+
+static double measure(int bytes)
+{
+    double sbuf[8], rbuf[8], start, t;
+    int i, count = bytes / sizeof(double);
+
+    memset(sbuf, 0, sizeof(sbuf));
+    for (i = 0; i < WARMUP + ITERATIONS; i++) {
+        if (WARMUP == i) {
+            start = MPI_Wtime();
+        }
+        if (0 == count) {
+            MPI_Barrier(MPI_COMM_WORLD);
+        } else {
+            MPI_Allreduce(sbuf, rbuf, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        }
+    }
+    t = (MPI_Wtime() - start) / ITERATIONS;
+    MPI_Allreduce(MPI_IN_PLACE, &t, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    return t;
+}
+
+int main(int argc, char *argv[])
+{
+    int sizes[] = {0, 8, 16, 64}, rank, size, i;
+    double t;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (0 == rank) {
+        printf("# %d processes\n", size);
+        printf("%-12s %10s %14s\n", "# collective", "bytes", "latency (us)");
+    }
+    for (i = 0; i < (int) (sizeof(sizes) / sizeof(sizes[0])); i++) {
+        t = measure(sizes[i]);
+        if (0 == rank) {
+            printf("%-12s %10d %14.3f\n", 0 == sizes[i] ? "barrier" : "allreduce",
+                   sizes[i], t * 1e6);
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
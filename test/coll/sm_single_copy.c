@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Checks the single-copy bcast and allreduce of coll/sm, which read the
+ * buffers of the other processes through Cross Memory Attach above the
+ * single_copy_threshold. Lower the threshold so that the small counts
+ * use them as well, and run on a single node, e.g.
+ *
+ *   mpirun -np 5 --mca coll_sm_priority 100 \
+ *          --mca coll_sm_single_copy_threshold 1024 ./sm_single_copy
+ *
+ * The counts are not multiples of the number of processes (the
+ * allreduce cuts the data into one slice per process) and the largest
+ * ones span several of the pieces the slices are reduced by. The
+ * non-contiguous bcast and the user-defined operation (which is not
+ * commutative, so the slices must be reduced in rank order) check the
+ * fallbacks and the ordering.
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int counts[] = { 300, 4099, 100003, 1000001 };
+
+static int check(const char *coll, int count, int ok)
+{
+    int rank, all_ok;
+
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (0 == rank) {
+        printf("%-20s %8d %s\n", coll, count, all_ok ? "[PASSED]" : "[NOT PASSED]");
+    }
+    return !all_ok;
+}
+
+/* keeps the left operand: the result is the data of rank 0 */
+static void left_op(void *in, void *inout, int *len, MPI_Datatype *dtype)
+{
+    int i;
+
+    (void)dtype;
+    for (i = 0; i < *len; i++) {
+        ((int*)inout)[i] = ((int*)in)[i];
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int rank, size, root, c, i, count, ok, errors = 0;
+    int *ibuf, *ires;
+    double *dres;
+    MPI_Datatype vector;
+    MPI_Op left;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Op_create(left_op, 0, &left);
+
+    for (c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); c++) {
+        count = counts[c];
+        ibuf = (int*)malloc(2 * (size_t)count * sizeof(int));
+        ires = (int*)malloc((size_t)count * sizeof(int));
+        dres = (double*)malloc((size_t)count * sizeof(double));
+
+        /* contiguous bcast from every root */
+        for (ok = 1, root = 0; root < size; root++) {
+            for (i = 0; i < count; i++) {
+                ibuf[i] = (rank == root) ? root * 7 + i : -1;
+            }
+            MPI_Bcast(ibuf, count, MPI_INT, root, MPI_COMM_WORLD);
+            for (i = 0; i < count; i++) {
+                if (ibuf[i] != root * 7 + i) { ok = 0; break; }
+            }
+        }
+        errors += check("bcast", count, ok);
+
+        /* non-contiguous bcast (every other int) */
+        MPI_Type_vector(count, 1, 2, MPI_INT, &vector);
+        MPI_Type_commit(&vector);
+        root = size - 1;
+        for (i = 0; i < 2 * count; i++) {
+            ibuf[i] = (rank == root || i % 2) ? i : -1;
+        }
+        MPI_Bcast(ibuf, 1, vector, root, MPI_COMM_WORLD);
+        for (ok = 1, i = 0; i < 2 * count; i++) {
+            if (ibuf[i] != i) { ok = 0; break; }
+        }
+        MPI_Type_free(&vector);
+        errors += check("bcast vector", count, ok);
+
+        /* allreduce sum of ints */
+        for (i = 0; i < count; i++) {
+            ibuf[i] = rank + i % 1000;
+        }
+        MPI_Allreduce(ibuf, ires, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        for (ok = 1, i = 0; i < count; i++) {
+            if (ires[i] != size * (size - 1) / 2 + size * (i % 1000)) { ok = 0; break; }
+        }
+        errors += check("allreduce sum", count, ok);
+
+        /* in place allreduce max of doubles */
+        for (i = 0; i < count; i++) {
+            dres[i] = (double)((rank + i) % size) + 0.5;
+        }
+        MPI_Allreduce(MPI_IN_PLACE, dres, count, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        for (ok = 1, i = 0; i < count; i++) {
+            if (dres[i] != (double)(size - 1) + 0.5) { ok = 0; break; }
+        }
+        errors += check("allreduce max", count, ok);
+
+        /* non commutative user operation */
+        for (i = 0; i < count; i++) {
+            ibuf[i] = rank * 1000 + i % 1000;
+        }
+        MPI_Allreduce(ibuf, ires, count, MPI_INT, left, MPI_COMM_WORLD);
+        for (ok = 1, i = 0; i < count; i++) {
+            if (ires[i] != i % 1000) { ok = 0; break; }
+        }
+        errors += check("allreduce user op", count, ok);
+
+        free(ibuf);
+        free(ires);
+        free(dres);
+    }
+
+    MPI_Op_free(&left);
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
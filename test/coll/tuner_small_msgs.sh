@@ -0,0 +1,40 @@
+#!/bin/sh
+
+#
+# Copyright (c) 2026      The University of Tennessee and The University
+#                         of Tennessee Research Foundation.  All rights
+#                         reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+#
+# Runs ompi_coll_tuner with message sizes smaller than one element per
+# peer on several process counts. The tuner then exchanges one element
+# with each peer, more than the largest message size, and must size its
+# buffers accordingly. Run it on a build with memory checking (e.g.
+# valgrind or -fsanitize=address) to catch overflows:
+#
+#   ./tuner_small_msgs.sh [tuner] [process counts]
+#
+
+tuner=${1:-ompi_coll_tuner}
+nps=${2:-"3 8 16"}
+rules=tuner_small_msgs.$$.rules
+status=0
+
+for np in $nps; do
+    # the rules file must cover at least one collective
+    if mpirun --oversubscribe -n $np $tuner -o $rules -m 1:16 -r 2 > /dev/null &&
+       [ -s $rules ] && ! grep -q "^0 # number of collectives" $rules; then
+        echo "$np processes [PASSED]"
+    else
+        echo "$np processes [NOT PASSED]"
+        status=1
+    fi
+    rm -f $rules
+done
+exit $status
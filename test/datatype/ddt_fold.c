@@ -0,0 +1,193 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Datatypes described by an explicit list of blocks that repeat a pattern
+ * must be folded into loops at commit. Check that the optimized description
+ * is indeed shorter, and that pack, unpack and repositioning of the convertor
+ * still follow the original type map.
+ */
+
+#include "ompi_config.h"
+#include "opal/datatype/opal_convertor.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "opal/runtime/opal.h"
+#include "mpi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NB_BLOCKS 1000
+
+typedef struct {
+    int       nb;
+    int       length[3 * NB_BLOCKS];   /* in bytes */
+    MPI_Aint  disp[3 * NB_BLOCKS];
+} type_map_t;
+
+static type_map_t map;
+
+static int check_type( const char* name, MPI_Datatype ddt, int count, size_t max_used )
+{
+    ompi_datatype_t* pdt = (ompi_datatype_t*)ddt;
+    opal_convertor_t* conv;
+    MPI_Aint lb, extent;
+    size_t length, position, offset;
+    int size, pos, c, b, errors = 0;
+    char *src, *dst, *expected, *packed, *reference;
+    struct iovec iov;
+    uint32_t iov_count;
+
+    MPI_Type_get_extent(ddt, &lb, &extent);
+    MPI_Type_size(ddt, &size);
+    length = (size_t)size * count;
+    src = (char*)malloc(extent * count);
+    dst = (char*)calloc(extent, count);
+    expected = (char*)calloc(extent, count);
+    packed = (char*)malloc(length);
+    reference = (char*)malloc(length);
+    for( long i = 0; i < extent * count; i++ ) src[i] = (char)(i * 7 + i / 253);
+
+    for( offset = 0, c = 0; c < count; c++ ) {
+        for( b = 0; b < map.nb; b++ ) {
+            memcpy(reference + offset, src + c * extent + map.disp[b], map.length[b]);
+            memcpy(expected + c * extent + map.disp[b], src + c * extent + map.disp[b], map.length[b]);
+            offset += map.length[b];
+        }
+    }
+
+    if( pdt->super.opt_desc.used > max_used ) {
+        printf("%s: optimized description has %zu entries (expected at most %zu)\n",
+               name, pdt->super.opt_desc.used, max_used);
+        errors++;
+    }
+
+    pos = 0;
+    MPI_Pack(src, count, ddt, packed, (int)length, &pos, MPI_COMM_SELF);
+    if( memcmp(packed, reference, length) ) {
+        printf("%s: packed data differs\n", name);
+        errors++;
+    }
+    pos = 0;
+    MPI_Unpack(reference, (int)length, &pos, dst, count, ddt, MPI_COMM_SELF);
+    if( memcmp(dst, expected, extent * count) ) {
+        printf("%s: unpacked data differs\n", name);
+        errors++;
+    }
+
+    /* pack the second half first, from a repositioned convertor */
+    memset(packed, 0, length);
+    conv = opal_convertor_create( opal_local_arch, 0 );
+    opal_convertor_prepare_for_send( conv, &(pdt->super), count, src );
+    for( int half = 1; half >= 0; half-- ) {
+        position = half * (length / 2);
+        opal_convertor_set_position( conv, &position );
+        iov.iov_base = packed + position;
+        iov.iov_len = half ? (length - position) : (length / 2);
+        iov_count = 1;
+        opal_convertor_pack( conv, &iov, &iov_count, &iov.iov_len );
+    }
+    OBJ_RELEASE( conv );
+    if( memcmp(packed, reference, length) ) {
+        printf("%s: data packed out of order differs\n", name);
+        errors++;
+    }
+
+    printf("%-16s desc %5zu optimized %3zu %s\n", name, pdt->super.desc.used,
+           pdt->super.opt_desc.used, errors ? "[NOT PASSED]" : "[PASSED]");
+    free(src); free(dst); free(expected); free(packed); free(reference);
+    return errors;
+}
+
+int main( int argc, char* argv[] )
+{
+    int blocklens[NB_BLOCKS], displs[NB_BLOCKS], ones[NB_BLOCKS], i, errors = 0;
+    MPI_Aint hdispls[NB_BLOCKS];
+    MPI_Datatype types[NB_BLOCKS], ddt, tmp, st;
+
+    MPI_Init(&argc, &argv);
+
+    /* Fortran style indexed: alternating blocks of 2 and 1 doubles */
+    for( i = 0; i < NB_BLOCKS; i++ ) {
+        blocklens[i] = (i & 1) ? 1 : 2;
+        displs[i] = (i / 2) * 10 + ((i & 1) ? 5 : 0);
+        map.length[i] = blocklens[i] * sizeof(double);
+        map.disp[i] = displs[i] * sizeof(double);
+    }
+    map.nb = NB_BLOCKS;
+    MPI_Type_indexed(NB_BLOCKS, blocklens, displs, MPI_DOUBLE, &ddt);
+    MPI_Type_commit(&ddt);
+    errors += check_type("indexed", ddt, 3, 4);
+    MPI_Type_free(&ddt);
+
+    /* the same pattern preceded and followed by different blocks */
+    for( i = 0; i < NB_BLOCKS; i++ ) {
+        blocklens[i] = (i & 1) ? 1 : 2;
+        displs[i] = 4 + (i / 2) * 10 + ((i & 1) ? 5 : 0);
+    }
+    blocklens[0] = 3; displs[0] = 0;
+    blocklens[NB_BLOCKS - 1] = 4;
+    for( i = 0; i < NB_BLOCKS; i++ ) {
+        map.length[i] = blocklens[i] * sizeof(int);
+        map.disp[i] = displs[i] * sizeof(int);
+    }
+    MPI_Type_indexed(NB_BLOCKS, blocklens, displs, MPI_INT, &ddt);
+    MPI_Type_commit(&ddt);
+    errors += check_type("indexed_edges", ddt, 2, 6);
+    MPI_Type_free(&ddt);
+
+    /* a resized struct replicated by hand at a constant stride */
+    {
+        int bl[3] = {3, 1, 2};
+        MPI_Aint d[3] = {0, 8, 16};
+        MPI_Datatype ty[3] = {MPI_CHAR, MPI_INT, MPI_DOUBLE};
+        MPI_Type_create_struct(3, bl, d, ty, &tmp);
+        MPI_Type_create_resized(tmp, 0, 40, &st);
+        MPI_Type_free(&tmp);
+    }
+    for( i = 0; i < NB_BLOCKS; i++ ) {
+        ones[i] = 1;
+        types[i] = st;
+        hdispls[i] = i * 48;
+        map.length[3 * i] = 3;      map.disp[3 * i] = i * 48;
+        map.length[3 * i + 1] = 4;  map.disp[3 * i + 1] = i * 48 + 8;
+        map.length[3 * i + 2] = 16; map.disp[3 * i + 2] = i * 48 + 16;
+    }
+    map.nb = 3 * NB_BLOCKS;
+    MPI_Type_create_struct(NB_BLOCKS, ones, hdispls, types, &ddt);
+    MPI_Type_commit(&ddt);
+    errors += check_type("struct", ddt, 2, 5);
+    MPI_Type_free(&ddt);
+    MPI_Type_create_hindexed(NB_BLOCKS, ones, hdispls, st, &ddt);
+    MPI_Type_commit(&ddt);
+    errors += check_type("hindexed", ddt, 2, 5);
+    MPI_Type_free(&ddt);
+    MPI_Type_free(&st);
+
+    /* adjacent blocks of different types, folded into a contiguous loop */
+    for( i = 0; i < NB_BLOCKS; i++ ) {
+        ones[i] = (i & 1) ? 2 : 1;
+        types[i] = (i & 1) ? MPI_SHORT : MPI_INT;
+        hdispls[i] = (i / 2) * 16 + ((i & 1) ? 4 : 0);
+        map.length[i] = 4;
+        map.disp[i] = hdispls[i];
+    }
+    map.nb = NB_BLOCKS;
+    MPI_Type_create_struct(NB_BLOCKS, ones, hdispls, types, &ddt);
+    MPI_Type_commit(&ddt);
+    errors += check_type("contiguous_loop", ddt, 3, 3);
+    MPI_Type_free(&ddt);
+
+    MPI_Finalize();
+    return errors ? 1 : 0;
+}
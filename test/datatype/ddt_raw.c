@@ -29,6 +29,7 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif
@@ -140,6 +141,120 @@ static int local_copy_ddt_raw( ompi_datatype_t* pdt, int count, int iov_num )
     return OMPI_SUCCESS;
 }
 
+/**
+ * Extract the complete list of contiguous blocks with opal_convertor_raw, merging
+ * the blocks split between two calls.
+ */
+static struct iovec* get_raw_blocks( ompi_datatype_t* pdt, int count, uint32_t* nb_blocks )
+{
+    struct iovec iov[5], *blocks = NULL;
+    opal_convertor_t* convertor;
+    uint32_t iov_count, i, max_blocks = 0;
+    size_t max_data;
+    int rc;
+
+    *nb_blocks = 0;
+    convertor = opal_convertor_create( remote_arch, 0 );
+    opal_convertor_prepare_for_send( convertor, &(pdt->super), count, NULL );
+    do {
+        iov_count = 5;
+        rc = opal_convertor_raw( convertor, iov, &iov_count, &max_data );
+        for( i = 0; i < iov_count; i++ ) {
+            if( (0 != *nb_blocks) &&
+                ((char*)blocks[*nb_blocks-1].iov_base + blocks[*nb_blocks-1].iov_len == (char*)iov[i].iov_base) ) {
+                blocks[*nb_blocks-1].iov_len += iov[i].iov_len;
+                continue;
+            }
+            if( *nb_blocks == max_blocks ) {
+                max_blocks = 2 * max_blocks + 16;
+                blocks = (struct iovec*)realloc( blocks, max_blocks * sizeof(struct iovec) );
+            }
+            blocks[(*nb_blocks)++] = iov[i];
+        }
+    } while( 0 == rc );
+    OBJ_RELEASE( convertor );
+    return blocks;
+}
+
+/**
+ * Check the iovec windows generated from the cached memory layout of the datatype
+ * against the blocks generated by opal_convertor_raw, for windows starting at
+ * various positions, and then check that opal_convertor_raw generates the same
+ * blocks once the cache is available.
+ */
+static int check_iovec_window( ompi_datatype_t* pdt, int count )
+{
+    struct iovec *blocks, *cached, iov[3];
+    uint32_t nb_blocks, nb_cached, iov_count, b, i;
+    size_t total = count * pdt->super.size, position, length, offset;
+    int errors = 0;
+
+    blocks = get_raw_blocks( pdt, count, &nb_blocks );
+    for( position = 0; position < total; position += 1 + (total / 97) ) {
+        /* find the block holding the position */
+        for( b = 0, offset = position; offset >= blocks[b].iov_len; offset -= blocks[b++].iov_len );
+        iov_count = 3;
+        length = total;
+        opal_datatype_iovec_window( &(pdt->super), count, NULL, position, iov, &iov_count, &length );
+        for( i = 0; i < iov_count; i++ ) {
+            if( iov[i].iov_base != (char*)blocks[b].iov_base + offset ) {
+                printf( "window at %" PRIsize_t ": iovec %u starts at %p instead of %p\n", position, i,
+                        iov[i].iov_base, (void*)((char*)blocks[b].iov_base + offset) );
+                errors++;
+                break;
+            }
+            /* move forward in the blocks by the length of the iovec */
+            for( length = iov[i].iov_len; length >= blocks[b].iov_len - offset; ) {
+                length -= blocks[b].iov_len - offset;
+                offset = 0;
+                if( ++b == nb_blocks ) break;
+            }
+            offset += length;
+        }
+        if( errors ) break;
+    }
+
+    /* the raw extraction now uses the cache */
+    cached = get_raw_blocks( pdt, count, &nb_cached );
+    if( (nb_cached != nb_blocks) || memcmp( cached, blocks, nb_blocks * sizeof(struct iovec) ) ) {
+        printf( "raw extraction from the cache differs (%u blocks instead of %u)\n", nb_cached, nb_blocks );
+        errors++;
+    }
+    free( blocks );
+    free( cached );
+
+    /* pack what is left after a raw extraction from the cache */
+    {
+        opal_convertor_t* convertor;
+        char *buffer, *packed, *reference;
+        size_t max_data;
+        ptrdiff_t extent = (count - 1) * (pdt->super.ub - pdt->super.lb) +
+                           (pdt->super.true_ub - pdt->super.true_lb);
+
+        buffer = malloc( extent );
+        for( position = 0; position < (size_t)extent; position++ ) buffer[position] = (char)position;
+        packed = malloc( total );
+        reference = malloc( total );
+        convertor = opal_convertor_create( remote_arch, 0 );
+        opal_convertor_prepare_for_send( convertor, &(pdt->super), count, buffer - pdt->super.true_lb );
+        iov[0].iov_base = reference; iov[0].iov_len = total; iov_count = 1;
+        opal_convertor_pack( convertor, iov, &iov_count, &max_data );
+        opal_convertor_prepare_for_send( convertor, &(pdt->super), count, buffer - pdt->super.true_lb );
+        iov_count = 3;
+        opal_convertor_raw( convertor, iov, &iov_count, &length );
+        iov[0].iov_base = packed; iov[0].iov_len = total - length; iov_count = 1;
+        opal_convertor_pack( convertor, iov, &iov_count, &max_data );
+        if( (max_data != total - length) || memcmp( packed, reference + length, max_data ) ) {
+            printf( "pack after a raw extraction of %" PRIsize_t " bytes differs\n", length );
+            errors++;
+        }
+        OBJ_RELEASE( convertor );
+        free( buffer ); free( packed ); free( reference );
+    }
+    printf( "iovec window %s\n", errors ? "[NOT PASSED]" : "[PASSED]" );
+    return errors;
+}
+
 /**
  * Go over a set of datatypes and copy them using the raw functionality provided by the
  * convertor. The goal of this test is to stress the convertor using several more or less
@@ -154,7 +269,7 @@ static int local_copy_ddt_raw( ompi_datatype_t* pdt, int count, int iov_num )
 int main( int argc, char* argv[] )
 {
     ompi_datatype_t *pdt, *pdt1, *pdt2, *pdt3;
-    int rc, length = 500, iov_num = 5;
+    int rc, length = 500, iov_num = 5, errors = 0;
 
     opal_init_util (NULL, NULL);
     ompi_datatype_init();
@@ -181,6 +296,7 @@ int main( int argc, char* argv[] )
     if( outputFlags & CHECK_PACK_UNPACK ) {
         local_copy_ddt_raw(pdt, 1, iov_num);
     }
+    errors += check_iovec_window(pdt, 3);
     OBJ_RELEASE( pdt ); assert( pdt == NULL );
 
     printf( "\n\n#\n * TEST UPPER MATRIX\n #\n\n" );
@@ -279,6 +395,7 @@ int main( int argc, char* argv[] )
     if( outputFlags & CHECK_PACK_UNPACK ) {
         local_copy_ddt_raw(pdt, 1, iov_num);
     }
+    errors += check_iovec_window(pdt, 2);
     printf( ">>--------------------------------------------<<\n" );
     OBJ_RELEASE( pdt ); assert( pdt == NULL );
 
@@ -287,6 +404,7 @@ int main( int argc, char* argv[] )
     if( outputFlags & CHECK_PACK_UNPACK ) {
         local_copy_ddt_raw(pdt, 4500, iov_num);
     }
+    errors += check_iovec_window(pdt, 4500);
     printf( ">>--------------------------------------------<<\n" );
     OBJ_RELEASE( pdt ); assert( pdt == NULL );
 
@@ -306,6 +424,7 @@ int main( int argc, char* argv[] )
         }
         local_copy_ddt_raw(pdt, 4500, iov_num);
     }
+    errors += check_iovec_window(pdt, 10);
     printf( ">>--------------------------------------------<<\n" );
     OBJ_RELEASE( pdt ); assert( pdt == NULL );
 
@@ -321,5 +440,5 @@ int main( int argc, char* argv[] )
     ompi_datatype_finalize();
     opal_finalize_util ();
 
-    return OMPI_SUCCESS;
+    return (0 == errors) ? OMPI_SUCCESS : OMPI_ERROR;
 }
@@ -0,0 +1,167 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check and time MPI_Pack and MPI_Unpack of large non-contiguous buffers
+ * when they are split across several threads (opal_ddt_parallel_threads).
+ * The number of threads is changed through the MPI_T control variable,
+ * the data packed and unpacked with several threads must be identical
+ * to the data packed and unpacked by a single thread.
+ *   mpirun -n 1 ./pack_threads [max threads]
+ */
+
+#include "mpi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EDGE        256   /* the cube is EDGE^3 doubles, 128MB */
+#define ITERATIONS  5
+
+static int threads_cvar_index = -1;
+static MPI_T_cvar_handle threads_handle;
+
+static int set_threads(int nthreads)
+{
+    return MPI_T_cvar_write(threads_handle, &nthreads);
+}
+
+static double get_time(void)
+{
+    return MPI_Wtime();
+}
+
+/* Every other double, one element per block */
+static MPI_Datatype create_column(void)
+{
+    MPI_Datatype ddt;
+
+    MPI_Type_vector(EDGE * EDGE * EDGE / 2, 1, 2, MPI_DOUBLE, &ddt);
+    MPI_Type_commit(&ddt);
+    return ddt;
+}
+
+/* Every other plane of the cube, large contiguous blocks */
+static MPI_Datatype create_planes(void)
+{
+    MPI_Datatype ddt;
+
+    MPI_Type_vector(EDGE / 2, EDGE * EDGE, 2 * EDGE * EDGE, MPI_DOUBLE, &ddt);
+    MPI_Type_commit(&ddt);
+    return ddt;
+}
+
+/* Mixed predefined types, so that the ranges rarely start on an element boundary */
+static MPI_Datatype create_struct(void)
+{
+    int blocklens[3] = {3, 1, 2};
+    MPI_Aint displs[3] = {0, 8, 16};
+    MPI_Datatype types[3] = {MPI_CHAR, MPI_INT, MPI_DOUBLE}, tmp, ddt;
+
+    MPI_Type_create_struct(3, blocklens, displs, types, &tmp);
+    MPI_Type_create_resized(tmp, 0, 40, &ddt);
+    MPI_Type_free(&tmp);
+    MPI_Type_commit(&ddt);
+    return ddt;
+}
+
+static int test_ddt(const char *name, MPI_Datatype ddt, int count, int max_threads)
+{
+    MPI_Aint lb, extent;
+    int size, pos, i, t, errors = 0;
+    char *src, *dst, *expected, *packed, *reference;
+    double start, pack_time, unpack_time;
+
+    MPI_Type_get_extent(ddt, &lb, &extent);
+    MPI_Type_size(ddt, &size);
+    src = (char*)malloc(extent * count);
+    dst = (char*)malloc(extent * count);
+    expected = (char*)calloc(extent, count);
+    packed = (char*)malloc((size_t)size * count);
+    reference = (char*)malloc((size_t)size * count);
+    for (i = 0; i < extent * count; i++) src[i] = (char)(i * 7 + i / 4099);
+
+    set_threads(1);
+    pos = 0;
+    MPI_Pack(src, count, ddt, reference, size * count, &pos, MPI_COMM_SELF);
+    pos = 0;
+    MPI_Unpack(reference, size * count, &pos, expected, count, ddt, MPI_COMM_SELF);
+
+    printf("%-8s %10d bytes\n", name, size * count);
+    for (t = 1; t <= max_threads; t *= 2) {
+        set_threads(t);
+        pack_time = unpack_time = 0.0;
+        for (i = 0; i < ITERATIONS; i++) {
+            memset(packed, 0, (size_t)size * count);
+            pos = 0;
+            start = get_time();
+            MPI_Pack(src, count, ddt, packed, size * count, &pos, MPI_COMM_SELF);
+            pack_time += get_time() - start;
+            if (pos != size * count || memcmp(packed, reference, (size_t)size * count)) {
+                printf("  %d threads: packed data differs\n", t);
+                errors++;
+                break;
+            }
+            memset(dst, 0, extent * count);
+            pos = 0;
+            start = get_time();
+            MPI_Unpack(packed, size * count, &pos, dst, count, ddt, MPI_COMM_SELF);
+            unpack_time += get_time() - start;
+            if (pos != size * count || memcmp(dst, expected, extent * count)) {
+                printf("  %d threads: unpacked data differs\n", t);
+                errors++;
+                break;
+            }
+        }
+        printf("  %2d threads  pack %8.2f GB/s  unpack %8.2f GB/s\n", t,
+               (double)size * count * ITERATIONS / pack_time / 1e9,
+               (double)size * count * ITERATIONS / unpack_time / 1e9);
+    }
+    free(src); free(dst); free(expected); free(packed); free(reference);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_Datatype ddt;
+    int provided, count, errors = 0, max_threads = 8;
+
+    if (argc > 1) max_threads = atoi(argv[1]);
+
+    MPI_T_init_thread(MPI_THREAD_SINGLE, &provided);
+    MPI_Init(&argc, &argv);
+    if (MPI_SUCCESS != MPI_T_cvar_get_index("opal_ddt_parallel_threads", &threads_cvar_index) ||
+        MPI_SUCCESS != MPI_T_cvar_handle_alloc(threads_cvar_index, NULL, &threads_handle, &count)) {
+        printf("opal_ddt_parallel_threads is not available\n");
+        MPI_Finalize();
+        MPI_T_finalize();
+        return 77;
+    }
+
+    ddt = create_column();
+    errors += test_ddt("column", ddt, 1, max_threads);
+    MPI_Type_free(&ddt);
+
+    ddt = create_planes();
+    errors += test_ddt("planes", ddt, 1, max_threads);
+    MPI_Type_free(&ddt);
+
+    ddt = create_struct();
+    errors += test_ddt("struct", ddt, 1 << 21, max_threads);
+    MPI_Type_free(&ddt);
+
+    MPI_T_cvar_handle_free(&threads_handle);
+    MPI_Finalize();
+    MPI_T_finalize();
+    return errors ? 1 : 0;
+}
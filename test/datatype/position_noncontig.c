@@ -1,6 +1,6 @@
 /* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
 /*
- * Copyright (c) 2004-2017 The University of Tennessee and The University
+ * Copyright (c) 2004-2019 The University of Tennessee and The University
  *                         of Tennessee Research Foundation.  All rights
  *                         reserved.
  * Copyright (c) 2011-2013 Cisco Systems, Inc.  All rights reserved.
@@ -180,6 +180,73 @@ unpack_segments( ompi_datatype_t* datatype, int count,
     return 0;
 }
 
+/**
+ * Pack and unpack in shuffled segments a datatype made of nested loops, and
+ * compare the result with a single unpack of the data packed at once. Every
+ * segment starts in the middle of an inner loop, so positioning has to jump
+ * over the remaining iterations of the inner and outer loops.
+ */
+static int
+test_nested_loops( int count )
+{
+    ddt_segment_t* segments;
+    ompi_datatype_t *inner, *outer;
+    opal_convertor_t* convertor;
+    int *send_buffer, *recv_buffer, *expected, *packed;
+    int i, seg_count, errors = 0;
+    size_t extent, length;
+    struct iovec iov;
+    uint32_t iov_count;
+
+    ompi_datatype_create_vector(7, 1, 3, MPI_INT, &inner);
+    ompi_datatype_create_hvector(count, 1, 32 * sizeof(int), inner, &outer);
+    ompi_datatype_commit(&outer);
+
+    extent = 32 * count;
+    send_buffer = malloc(extent * sizeof(int));
+    recv_buffer = malloc(extent * sizeof(int));
+    expected = malloc(extent * sizeof(int));
+    packed = malloc(7 * count * sizeof(int));
+    for (i = 0; i < (int)extent; ++i) {
+        send_buffer[i] = i;
+        recv_buffer[i] = expected[i] = 0xdeadbeef;
+    }
+
+    /* the reference, packed and unpacked at once */
+    convertor = opal_convertor_create( opal_local_arch, 0 );
+    opal_convertor_prepare_for_send( convertor, &(outer->super), 1, send_buffer );
+    iov.iov_base = packed; iov.iov_len = length = 7 * count * sizeof(int); iov_count = 1;
+    opal_convertor_pack( convertor, &iov, &iov_count, &length );
+    OBJ_RELEASE(convertor);
+    convertor = opal_convertor_create( opal_local_arch, 0 );
+    opal_convertor_prepare_for_recv( convertor, &(outer->super), 1, expected );
+    iov.iov_base = packed; iov.iov_len = length; iov_count = 1;
+    opal_convertor_unpack( convertor, &iov, &iov_count, &length );
+    OBJ_RELEASE(convertor);
+
+    create_segments( outer, 1, fragment_size, &segments, &seg_count );
+    shuffle_segments( segments, seg_count );
+    pack_segments( outer, 1, fragment_size, segments, seg_count, send_buffer );
+    unpack_segments( outer, 1, fragment_size, segments, seg_count, recv_buffer );
+
+    for( i = 0; i < (int)extent; i++ ) {
+        if( recv_buffer[i] != expected[i] ) {
+            if( 0 == errors )
+                printf("nested loops: error at index %4d: 0x%08x != 0x%08x\n", i, recv_buffer[i], expected[i]);
+            errors++;
+        }
+    }
+
+    for( i = 0; i < seg_count; i++ ) {
+        free( segments[i].buffer );
+    }
+    free(segments);
+    free(send_buffer); free(recv_buffer); free(expected); free(packed);
+    ompi_datatype_destroy(&outer);
+    ompi_datatype_destroy(&inner);
+    return errors;
+}
+
 #if (OPAL_ENABLE_DEBUG == 1) && (OPAL_C_HAVE_VISIBILITY == 0)
 extern bool opal_ddt_unpack_debug;
 extern bool opal_ddt_pack_debug;
@@ -239,7 +306,6 @@ int main( int argc, char* argv[] )
             errors++;
         }
     }
-    printf( "Found %d errors\n", errors );
     free(send_buffer); free(recv_buffer);
 
     for( i = 0; i < seg_count; i++ ) {
@@ -247,6 +313,9 @@ int main( int argc, char* argv[] )
     }
     free(segments);
 
+    errors += test_nested_loops( 1000 );
+    printf( "Found %d errors\n", errors );
+
     ompi_datatype_finalize();
     opal_finalize_util ();
 
@@ -0,0 +1,194 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check and time the reduction functions selected for the predefined
+ * MPI_Op against the base (scalar) functions of the op framework,
+ * for all the (operation, type) pairs and a range of message sizes.
+ * The two and three buffer functions are checked for every count up to
+ * two of the widest vectors (so that all the vector loops are run with
+ * and without a scalar tail), the two buffer functions are then checked
+ * on larger counts, and timed with -t. Compare with and without a
+ * specialized component, e.g.:
+ *   mpirun -n 1 ./reduce_local -t
+ *   mpirun -n 1 --mca op ^avx ./reduce_local -t
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+#include "ompi/op/op.h"
+#include "ompi/mca/op/base/functions.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_COUNT   (1 << 6)
+#define MAX_VBYTES  64      /* AVX-512 */
+#define MAX_COUNT   (1 << 22)
+#define TOTAL_BYTES (1 << 28)
+
+typedef struct {
+    const char *name;
+    MPI_Op op;
+} test_op_t;
+
+typedef struct {
+    const char *name;
+    MPI_Datatype dtype;
+    size_t size;
+    bool is_float;
+} test_type_t;
+
+static void fill(void *buf, const test_type_t *type, size_t count, int seed)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        /* Small positive values, to avoid overflows and rounding
+           differences between the two implementations */
+        int v = (int)((i * 7 + seed) % 5) + 1;
+        switch (type->size) {
+        case 1: ((uint8_t*)buf)[i] = (uint8_t)v; break;
+        case 2: ((uint16_t*)buf)[i] = (uint16_t)v; break;
+        case 4:
+            if (type->is_float) ((float*)buf)[i] = (float)v;
+            else ((uint32_t*)buf)[i] = (uint32_t)v;
+            break;
+        case 8:
+            if (type->is_float) ((double*)buf)[i] = (double)v;
+            else ((uint64_t*)buf)[i] = (uint64_t)v;
+            break;
+        }
+    }
+}
+
+/*
+ * Compare the selected two and three buffer functions with the base
+ * functions on count elements, returns the number of differences.
+ */
+static int check(const test_op_t *top, const test_type_t *type, int count,
+                 char *in, char *inout, char *expected)
+{
+    ompi_op_t *op = (ompi_op_t*)top->op;
+    ompi_datatype_t *dtype = (ompi_datatype_t*)type->dtype;
+    int type_id = ompi_op_ddt_map[dtype->id], errors = 0;
+    ompi_op_base_handler_fn_t base_fn = ompi_op_base_functions[op->o_f_to_c_index][type_id];
+    ompi_op_base_3buff_handler_fn_t base_3buff_fn =
+        ompi_op_base_3buff_functions[op->o_f_to_c_index][type_id];
+    size_t bytes = (size_t)count * type->size;
+
+    fill(in, type, count, 1);
+    fill(expected, type, count, 2);
+    memcpy(inout, expected, bytes);
+    base_fn(in, expected, &count, &dtype, NULL);
+    MPI_Reduce_local(in, inout, count, type->dtype, top->op);
+    if (0 != memcmp(inout, expected, bytes)) {
+        printf("ERROR: %s %s count %d differs from the base function\n",
+               top->name, type->name, count);
+        errors++;
+    }
+
+    if (NULL != base_3buff_fn) {
+        /* in op inout -> expected, then in op inout -> in + bytes */
+        fill(inout, type, count, 2);
+        base_3buff_fn(in, inout, expected, &count, &dtype, NULL);
+        ompi_3buff_op_reduce(op, in, inout, in + bytes, count, dtype);
+        if (0 != memcmp(in + bytes, expected, bytes)) {
+            printf("ERROR: %s %s count %d differs from the base function (3 buffers)\n",
+                   top->name, type->name, count);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char* argv[])
+{
+    test_op_t ops[] = {
+        { "sum", MPI_SUM }, { "prod", MPI_PROD }, { "max", MPI_MAX }, { "min", MPI_MIN },
+        { "band", MPI_BAND }, { "bor", MPI_BOR }, { "bxor", MPI_BXOR },
+    };
+    test_type_t types[] = {
+        { "int8", MPI_INT8_T, 1, false }, { "uint8", MPI_UINT8_T, 1, false },
+        { "int16", MPI_INT16_T, 2, false }, { "uint16", MPI_UINT16_T, 2, false },
+        { "int32", MPI_INT32_T, 4, false }, { "uint32", MPI_UINT32_T, 4, false },
+        { "int64", MPI_INT64_T, 8, false }, { "uint64", MPI_UINT64_T, 8, false },
+        { "float", MPI_FLOAT, 4, true }, { "double", MPI_DOUBLE, 8, true },
+    };
+    int nops = sizeof(ops) / sizeof(ops[0]), ntypes = sizeof(types) / sizeof(types[0]);
+    int o, t, r, reps, count, type_id, timing, errors = 0;
+    char *in, *inout, *expected;
+    double tstart, t_selected, t_base;
+    ompi_op_base_handler_fn_t base_fn;
+
+    MPI_Init(&argc, &argv);
+    timing = (argc > 1 && 0 == strcmp(argv[1], "-t"));
+
+    /* room for the output of the three buffer functions after the input */
+    in = (char*)malloc(2 * MAX_COUNT * sizeof(double));
+    inout = (char*)malloc(MAX_COUNT * sizeof(double));
+    expected = (char*)malloc(MAX_COUNT * sizeof(double));
+
+    if (timing) {
+        printf("%-6s %-7s %10s %14s %14s %8s\n",
+               "op", "type", "count", "selected(us)", "base(us)", "speedup");
+    }
+    for (o = 0; o < nops; o++) {
+        for (t = 0; t < ntypes; t++) {
+            ompi_op_t *op = (ompi_op_t*)ops[o].op;
+            ompi_datatype_t *dtype = (ompi_datatype_t*)types[t].dtype;
+
+            type_id = ompi_op_ddt_map[dtype->id];
+            if (-1 == type_id) continue;
+            base_fn = ompi_op_base_functions[op->o_f_to_c_index][type_id];
+            if (NULL == base_fn) continue;  /* e.g. bitwise ops on floats */
+
+            /* Correctness of the vector loops and their scalar tails */
+            for (count = 1; count < 2 * MAX_VBYTES / (int)types[t].size; count++) {
+                errors += check(&ops[o], &types[t], count, in, inout, expected);
+            }
+
+            for (count = MIN_COUNT; count <= MAX_COUNT; count *= 4) {
+                reps = TOTAL_BYTES / (count * (int)types[t].size);
+                if (reps < 5) reps = 5;
+
+                /* Correctness */
+                errors += check(&ops[o], &types[t], count, in, inout, expected);
+                if (!timing) continue;
+
+                /* Performance */
+                tstart = MPI_Wtime();
+                for (r = 0; r < reps; r++) {
+                    MPI_Reduce_local(in, inout, count, types[t].dtype, ops[o].op);
+                }
+                t_selected = (MPI_Wtime() - tstart) / reps;
+                tstart = MPI_Wtime();
+                for (r = 0; r < reps; r++) {
+                    base_fn(in, inout, &count, &dtype, NULL);
+                }
+                t_base = (MPI_Wtime() - tstart) / reps;
+
+                printf("%-6s %-7s %10d %14.3f %14.3f %8.2f\n",
+                       ops[o].name, types[t].name, count,
+                       t_selected * 1e6, t_base * 1e6, t_base / t_selected);
+            }
+        }
+    }
+
+    free(in);
+    free(inout);
+    free(expected);
+
+    MPI_Finalize();
+    return (0 == errors) ? 0 : 1;
+}
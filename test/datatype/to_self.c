@@ -121,6 +121,37 @@ create_optimized_indexed_constant_gap_ddt( int number,  /* number of repetitions
     return dt;
 }
 
+/* The faces exchanged by a 3D stencil on a (n x n x n) block of doubles
+ * with a halo of one: orthogonal to the first dimension the face is
+ * contiguous, to the second it is made of rows, and to the last one of
+ * single elements. */
+static MPI_Datatype
+create_halo_face_ddt( int n, int face )
+{
+    int sizes[3] = {n, n, n}, subsizes[3] = {n, n, n}, starts[3] = {0, 0, 0};
+    MPI_Datatype dt;
+
+    subsizes[face] = 1;
+    MPI_Type_create_subarray( 3, sizes, subsizes, starts, MPI_ORDER_C, MPI_DOUBLE, &dt );
+    MPI_Type_commit( &dt );
+    MPI_DDT_DUMP( dt );
+    return dt;
+}
+
+/* A 2D column of a (n x n) block: n doubles with a stride of n */
+static MPI_Datatype
+create_halo_column_ddt( int n )
+{
+    MPI_Datatype dt, vector;
+
+    MPI_Type_vector( n, 1, n, MPI_DOUBLE, &vector );
+    MPI_Type_create_resized( vector, 0, n * n * sizeof(double), &dt );
+    MPI_Type_free( &vector );
+    MPI_Type_commit( &dt );
+    MPI_DDT_DUMP( dt );
+    return dt;
+}
+
 typedef struct {
    int i[2];
    float f;
@@ -209,6 +240,7 @@ create_indexed_gap_optimized_ddt( void )
 #define DO_OPTIMIZED_INDEXED_GAP          0x00000008
 #define DO_STRUCT_CONSTANT_GAP_RESIZED    0x00000010
 #define DO_STRUCT_MERGED_WITH_GAP_RESIZED 0x00000020
+#define DO_HALO_FACES                     0x00000040
 
 #define DO_PACK                         0x01000000
 #define DO_UNPACK                       0x02000000
@@ -504,7 +536,7 @@ static int do_test_for_ddt( int doop, MPI_Datatype sddt, MPI_Datatype rddt, int
 
 int main( int argc, char* argv[] )
 {
-    int run_tests = DO_STRUCT_MERGED_WITH_GAP_RESIZED;  /* do all datatype tests by default */
+    int run_tests = DO_STRUCT_MERGED_WITH_GAP_RESIZED | DO_HALO_FACES;  /* do all datatype tests by default */
     int rank, size;
     MPI_Datatype ddt;
 
@@ -573,6 +605,21 @@ int main( int argc, char* argv[] )
         MPI_Type_free( &ddt );
     }
 
+    if( run_tests & DO_HALO_FACES ) {
+        printf( "\nhalo column (2D, 64 x 64)\n\n" );
+        ddt = create_halo_column_ddt( 64 );
+        do_test_for_ddt( run_tests, ddt, ddt, MAX_LENGTH );
+        MPI_Type_free( &ddt );
+
+        for( int face = 2; face >= 0; face-- ) {
+            const char* shape[] = { "contiguous", "rows", "single elements" };
+            printf( "\nhalo face of %s (3D, 32 x 32 x 32)\n\n", shape[face] );
+            ddt = create_halo_face_ddt( 32, face );
+            do_test_for_ddt( run_tests, ddt, ddt, MAX_LENGTH );
+            MPI_Type_free( &ddt );
+        }
+    }
+
     MPI_Finalize ();
     exit(0);
 }